@@ -15,13 +15,23 @@ HEADERS += src/calert.h
 HEADERS += src/cbasickeystore.h
 HEADERS += src/cblock.h
 HEADERS += src/cblockindex.h
+HEADERS += src/cblockindexmap.h
+HEADERS += src/cblockimporter.h
+HEADERS += src/cblockassembler.h
+HEADERS += src/cservedblockcache.h
+HEADERS += src/crollingbloomfilter.h
+HEADERS += src/prevector.h
+HEADERS += src/csecuredatastream.h
+HEADERS += src/cblockindexsnapshot.h
 HEADERS += src/cblocklocator.h
 HEADERS += src/cchainparams.h
 HEADERS += src/cconsensusvote.h
+HEADERS += src/cconsensusvotequeue.h
 HEADERS += src/ccrypter.h
 HEADERS += src/ccryptokeystore.h
 HEADERS += src/cdbenv.h
 HEADERS += src/cdb.h
+HEADERS += src/cdbbatch.h
 HEADERS += src/cdiskblockindex.h
 HEADERS += src/cdiskblockpos.h
 HEADERS += src/cdisktxpos.h
@@ -47,8 +57,10 @@ HEADERS += src/cmainparams.h
 HEADERS += src/cmainsignals.h
 HEADERS += src/cmasterkey.h
 HEADERS += src/cmasternodedb.h
+HEADERS += src/cmasternodejournal.h
 HEADERS += src/cmasternode.h
 HEADERS += src/cmasternodeman.h
+HEADERS += src/cmasternodebroadcast.h
 HEADERS += src/cmasternodepayments.h
 HEADERS += src/cmasternodepaymentwinner.h
 HEADERS += src/cmerkletx.h
@@ -80,6 +92,7 @@ HEADERS += src/csporkmanager.h
 HEADERS += src/csporkmessage.h
 HEADERS += src/cstealthaddress.h
 HEADERS += src/cstealthkeymetadata.h
+HEADERS += src/cstealthscanner.h
 HEADERS += src/ctestnetparams.h
 HEADERS += src/ctransaction.h
 HEADERS += src/ctransactionlock.h
@@ -193,16 +206,21 @@ HEADERS += src/enums/txnouttype.h
 
 HEADERS += src/thread.h
 HEADERS += src/thread/cmutexlock.h
+HEADERS += src/thread/clocksite.h
+HEADERS += src/thread/clockstats.h
 HEADERS += src/thread/csemaphore.h
 HEADERS += src/thread/csemaphoregrant.h
+HEADERS += src/thread/cthreadpool.h
 HEADERS += src/thread/safety.h
 
 HEADERS += src/smsg/address.h
 HEADERS += src/smsg/batchscanner.h
 HEADERS += src/smsg/bucket.h
+HEADERS += src/smsg/bucketstore.h
 HEADERS += src/smsg/cdigitalnoteaddress_b.h
 HEADERS += src/smsg/ckeyid_b.h
 HEADERS += src/smsg/crypter.h
+HEADERS += src/smsg/decryptengine.h
 HEADERS += src/smsg/db.h
 HEADERS += src/smsg/messagedata.h
 HEADERS += src/smsg/options.h
@@ -230,6 +248,7 @@ HEADERS += src/net/secmsgnode.h
 HEADERS += src/uint/uint_base.h
 HEADERS += src/uint/uint160.h
 HEADERS += src/uint/uint256.h
+HEADERS += src/uint/arith_uint256.h
 HEADERS += src/uint/uint512.h
 
 HEADERS += src/support/cleanse.h
@@ -245,6 +264,7 @@ HEADERS += src/json/json_spirit_error_position.h
 HEADERS += src/json/json_spirit.h
 
 HEADERS += src/crypto/common/common.h
+HEADERS += src/crypto/common/cpufeatures.h
 HEADERS += src/crypto/common/hmac_sha256.h
 HEADERS += src/crypto/common/hmac_sha512.h
 HEADERS += src/crypto/common/ripemd160.h
@@ -255,6 +275,7 @@ HEADERS += src/crypto/common/sph_bmw.h
 HEADERS += src/crypto/common/sph_echo.h
 HEADERS += src/crypto/common/sph_types.h
 HEADERS += src/crypto/bmw/bmw512.h
+HEADERS += src/crypto/bmw/bmw512_lanes.h
 HEADERS += src/crypto/echo/echo512.h
 
 HEADERS += src/qt/bitcoingui.h
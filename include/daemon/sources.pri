@@ -30,6 +30,7 @@ SOURCES += src/chash160.cpp
 SOURCES += src/chashwriter.cpp
 SOURCES += src/cdb.cpp
 SOURCES += src/cdbenv.cpp
+SOURCES += src/cdbbatch.cpp
 SOURCES += src/cinpoint.cpp
 SOURCES += src/coutpoint.cpp
 SOURCES += src/ctxin.cpp
@@ -37,11 +38,13 @@ SOURCES += src/ctxout.cpp
 SOURCES += src/csporkmanager.cpp
 SOURCES += src/csporkmessage.cpp
 SOURCES += src/cconsensusvote.cpp
+SOURCES += src/cconsensusvotequeue.cpp
 SOURCES += src/ctransactionlock.cpp
 SOURCES += src/cunsignedalert.cpp
 SOURCES += src/cstealthkeymetadata.cpp
 SOURCES += src/ckeymetadata.cpp
 SOURCES += src/cstealthaddress.cpp
+SOURCES += src/cstealthscanner.cpp
 SOURCES += src/cscriptcompressor.cpp
 SOURCES += src/cscriptvisitor.cpp
 SOURCES += src/cscript.cpp
@@ -62,6 +65,14 @@ SOURCES += src/cvalidationstate.cpp
 SOURCES += src/cblocklocator.cpp
 SOURCES += src/cdiskblockindex.cpp
 SOURCES += src/cblockindex.cpp
+SOURCES += src/cblockindexmap.cpp
+SOURCES += src/cblockimporter.cpp
+SOURCES += src/cblockassembler.cpp
+SOURCES += src/cservedblockcache.cpp
+SOURCES += src/crollingbloomfilter.cpp
+SOURCES += src/prevector.cpp
+SOURCES += src/csecuredatastream.cpp
+SOURCES += src/cblockindexsnapshot.cpp
 SOURCES += src/cdiskblockpos.cpp
 SOURCES += src/cblock.cpp
 SOURCES += src/ctxoutcompressor.cpp
@@ -148,7 +159,9 @@ SOURCES += src/rpcmnengine.cpp
 
 SOURCES += src/cmasternode.cpp
 SOURCES += src/cmasternodeman.cpp
+SOURCES += src/cmasternodebroadcast.cpp
 SOURCES += src/cmasternodedb.cpp
+SOURCES += src/cmasternodejournal.cpp
 SOURCES += src/cmasternodepaymentwinner.cpp
 SOURCES += src/cmasternodepayments.cpp
 SOURCES += src/cmasternodeconfig.cpp
@@ -165,18 +178,25 @@ SOURCES += src/allocators/lockedpagemanager.cpp
 SOURCES += src/allocators/memorypagelocker.cpp
 SOURCES += src/allocators/secure_allocator.cpp
 SOURCES += src/allocators/zero_after_free_allocator.cpp
+SOURCES += src/allocators/stream_allocator.cpp
+SOURCES += src/allocators/streambufferpool.cpp
 
 SOURCES += src/thread.cpp
 SOURCES += src/thread/cmutexlock.cpp
+SOURCES += src/thread/clocksite.cpp
+SOURCES += src/thread/clockstats.cpp
 SOURCES += src/thread/csemaphore.cpp
 SOURCES += src/thread/csemaphoregrant.cpp
+SOURCES += src/thread/cthreadpool.cpp
 
 SOURCES += src/smsg/address.cpp
 SOURCES += src/smsg/batchscanner.cpp
 SOURCES += src/smsg/bucket.cpp
+SOURCES += src/smsg/bucketstore.cpp
 SOURCES += src/smsg/ckeyid_b.cpp
 SOURCES += src/smsg/cdigitalnoteaddress_b.cpp
 SOURCES += src/smsg/crypter.cpp
+SOURCES += src/smsg/decryptengine.cpp
 SOURCES += src/smsg/db.cpp
 SOURCES += src/smsg/options.cpp
 SOURCES += src/smsg/token.cpp
@@ -195,29 +215,29 @@ SOURCES += src/net/cnode.cpp
 SOURCES += src/uint/uint_base.cpp
 SOURCES += src/uint/uint160.cpp
 SOURCES += src/uint/uint256.cpp
+SOURCES += src/uint/arith_uint256.cpp
 SOURCES += src/uint/uint512.cpp
 
 SOURCES += src/support/cleanse.cpp
 
-SOURCES += src/serialize/base.cpp
-SOURCES += src/serialize/read.cpp
-SOURCES += src/serialize/write.cpp
-SOURCES += src/serialize/string.cpp
-SOURCES += src/serialize/vector.cpp
-SOURCES += src/serialize/pair.cpp
-SOURCES += src/serialize/tuple.cpp
-SOURCES += src/serialize/map.cpp
-SOURCES += src/serialize/set.cpp
 
 SOURCES += src/crypto/common/hmac_sha256.cpp
 SOURCES += src/crypto/common/hmac_sha512.cpp
 SOURCES += src/crypto/common/ripemd160.cpp
 SOURCES += src/crypto/common/sha1.cpp
 SOURCES += src/crypto/common/sha256.cpp
+SOURCES += src/crypto/common/sha256_shani.cpp
+SOURCES += src/crypto/common/sha256_avx2.cpp
 SOURCES += src/crypto/common/sha512.cpp
+SOURCES += src/crypto/common/cpufeatures.cpp
 SOURCES += src/crypto/common/aes_helper.c
 SOURCES += src/crypto/common/bmw.c
 SOURCES += src/crypto/common/echo.c
+SOURCES += src/crypto/bmw/bmw512.cpp
+SOURCES += src/crypto/bmw/bmw512_sse41.cpp
+SOURCES += src/crypto/bmw/bmw512_avx2.cpp
+SOURCES += src/crypto/echo/echo512.cpp
+SOURCES += src/crypto/echo/echo512_aesni.cpp
 
 SOURCES += src/rpcmintblock.cpp
 SOURCES += src/rpcdebug.cpp
@@ -0,0 +1,35 @@
+#include "allocators/streambufferpool.h"
+#include "support/cleanse.h"
+
+#include "allocators/stream_allocator.h"
+
+template<typename T>
+T* stream_allocator<T>::allocate(std::size_t n, const void *hint)
+{
+	if (fSecure)
+	{
+		return std::allocator<T>::allocate(n);
+	}
+
+	return static_cast<T*>(StreamBufferPool::Instance().Allocate(sizeof(T) * n));
+}
+
+template<typename T>
+void stream_allocator<T>::deallocate(T* p, std::size_t n)
+{
+	if (fSecure)
+	{
+		if (p != NULL)
+		{
+			memory_cleanse(p, sizeof(T) * n);
+		}
+
+		std::allocator<T>::deallocate(p, n);
+
+		return;
+	}
+
+	StreamBufferPool::Instance().Release(p, sizeof(T) * n);
+}
+
+template struct stream_allocator<char>;
@@ -0,0 +1,79 @@
+#ifndef STREAM_ALLOCATOR_H
+#define STREAM_ALLOCATOR_H
+
+#include <memory>
+#include <type_traits>
+
+//
+// Allocator of serialization stream buffers. By default it takes them from
+// StreamBufferPool and gives them back without clearing them, which is what
+// blocks, transactions and network messages need. A secure allocator clears
+// its buffers before freeing them, like zero_after_free_allocator, for
+// streams that may hold private keys.
+//
+// The mode goes with the buffer when a stream is moved, swapped or assigned,
+// so data read into a secure stream is always freed by a secure allocator.
+//
+template<typename T>
+struct stream_allocator : public std::allocator<T>
+{
+    typedef std::allocator<T> base;
+    typedef typename base::size_type size_type;
+    typedef typename base::difference_type  difference_type;
+    typedef typename base::pointer pointer;
+    typedef typename base::const_pointer const_pointer;
+    typedef typename base::reference reference;
+    typedef typename base::const_reference const_reference;
+    typedef typename base::value_type value_type;
+
+    typedef std::true_type propagate_on_container_copy_assignment;
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::true_type propagate_on_container_swap;
+    typedef std::false_type is_always_equal;
+
+	template<typename _Other>
+	struct rebind
+    {
+		typedef stream_allocator<_Other> other;
+	};
+
+    bool fSecure;
+
+    stream_allocator() throw() : fSecure(false)
+	{
+
+	}
+
+    explicit stream_allocator(bool fSecureIn) throw() : fSecure(fSecureIn)
+	{
+
+	}
+
+    stream_allocator(const stream_allocator& a) throw() : base(a), fSecure(a.fSecure)
+	{
+
+	}
+
+	template <typename U>
+    stream_allocator(const stream_allocator<U>& a) throw() : base(a), fSecure(a.fSecure)
+	{
+
+	}
+
+    stream_allocator& operator=(const stream_allocator& a) = default;
+
+    T* allocate(std::size_t n, const void *hint = 0);
+    void deallocate(T* p, std::size_t n);
+
+    bool operator==(const stream_allocator& a) const
+	{
+		return fSecure == a.fSecure;
+	}
+
+    bool operator!=(const stream_allocator& a) const
+	{
+		return fSecure != a.fSecure;
+	}
+};
+
+#endif // STREAM_ALLOCATOR_H
@@ -0,0 +1,103 @@
+#include <new>
+#include <cstring>
+
+#include "allocators/streambufferpool.h"
+
+StreamBufferPool::StreamBufferPool() : nCachedBytes(0)
+{
+	memset(&stats, 0, sizeof(stats));
+}
+
+StreamBufferPool& StreamBufferPool::Instance()
+{
+	// Left to the OS at exit, see the class comment
+	static StreamBufferPool* pool = new StreamBufferPool();
+
+	return *pool;
+}
+
+int StreamBufferPool::GetClass(size_t nSize)
+{
+	int nClass = 0;
+
+	while (nClass < NUM_CLASSES && ((size_t)1 << (nClass + MIN_CLASS_BITS)) < nSize)
+	{
+		nClass++;
+	}
+
+	return nClass;
+}
+
+void* StreamBufferPool::Allocate(size_t nSize)
+{
+	int nClass = GetClass(nSize);
+
+	{
+		boost::mutex::scoped_lock lock(mutex);
+
+		stats.nAllocs++;
+
+		if (nClass == NUM_CLASSES)
+		{
+			stats.nOversize++;
+		}
+		else if (!vFree[nClass].empty())
+		{
+			void* p = vFree[nClass].back();
+
+			vFree[nClass].pop_back();
+
+			nCachedBytes -= (size_t)1 << (nClass + MIN_CLASS_BITS);
+			stats.nHits++;
+			stats.nBytesRecycled += nSize;
+
+			return p;
+		}
+	}
+
+	if (nClass == NUM_CLASSES)
+	{
+		return ::operator new(nSize);
+	}
+
+	return ::operator new((size_t)1 << (nClass + MIN_CLASS_BITS));
+}
+
+void StreamBufferPool::Release(void* p, size_t nSize)
+{
+	if (p == NULL)
+	{
+		return;
+	}
+
+	int nClass = GetClass(nSize);
+
+	if (nClass < NUM_CLASSES)
+	{
+		size_t nClassSize = (size_t)1 << (nClass + MIN_CLASS_BITS);
+
+		boost::mutex::scoped_lock lock(mutex);
+
+		if (nCachedBytes + nClassSize <= MAX_CACHED_BYTES &&
+			(vFree[nClass].empty() || (vFree[nClass].size() + 1) * nClassSize <= MAX_CLASS_CACHED_BYTES))
+		{
+			vFree[nClass].push_back(p);
+			nCachedBytes += nClassSize;
+
+			return;
+		}
+	}
+
+	::operator delete(p);
+}
+
+StreamBufferPool::Stats StreamBufferPool::GetStats()
+{
+	boost::mutex::scoped_lock lock(mutex);
+
+	Stats ret = stats;
+
+	ret.nCachedBytes = nCachedBytes;
+
+	return ret;
+}
@@ -0,0 +1,67 @@
+#ifndef STREAMBUFFERPOOL_H
+#define STREAMBUFFERPOOL_H
+
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+#include <boost/thread/mutex.hpp>
+
+/**
+ * Free lists for the buffers of network and chain data streams.
+ *
+ * Buffers are rounded up to a power of two between 64 bytes and 16 MB and
+ * put back on the list of their size when the stream lets go of them, so a
+ * node receiving blocks and transactions reuses the same few buffers
+ * instead of going to malloc for each message. Nothing is zeroed: the data
+ * is public. Streams holding keys use the zeroing allocator instead, see
+ * stream_allocator.
+ *
+ * Like LockedPageManager it is created on first use, and it is never
+ * destroyed so that streams in static objects can still free into it.
+ */
+class StreamBufferPool
+{
+public:
+	// Buffers of 2^MIN_CLASS_BITS up to 2^MAX_CLASS_BITS bytes are pooled
+	static const int MIN_CLASS_BITS = 6;
+	static const int MAX_CLASS_BITS = 24;
+	static const int NUM_CLASSES = MAX_CLASS_BITS - MIN_CLASS_BITS + 1;
+
+	// Idle bytes kept per size, though always at least one buffer
+	static const size_t MAX_CLASS_CACHED_BYTES = 4 * 1024 * 1024;
+
+	// And in all
+	static const size_t MAX_CACHED_BYTES = 32 * 1024 * 1024;
+
+	struct Stats
+	{
+		uint64_t nAllocs;
+		uint64_t nHits;
+		uint64_t nOversize;
+		uint64_t nBytesRecycled;
+		size_t nCachedBytes;
+	};
+
+private:
+	boost::mutex mutex;
+	std::vector<void*> vFree[NUM_CLASSES];
+	size_t nCachedBytes;
+	Stats stats;
+
+	StreamBufferPool();
+
+	static int GetClass(size_t nSize);
+
+public:
+	static StreamBufferPool& Instance();
+
+	/** Room for at least nSize bytes, with whatever it held before */
+	void* Allocate(size_t nSize);
+
+	/** Takes back a buffer from Allocate(nSize) */
+	void Release(void* p, size_t nSize);
+
+	Stats GetStats();
+};
+
+#endif // STREAMBUFFERPOOL_H
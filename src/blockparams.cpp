@@ -3,6 +3,7 @@
 #include <boost/random/mersenne_twister.hpp>
 #include <boost/random/uniform_int_distribution.hpp>
 
+#include "uint/arith_uint256.h"
 #include "cchainparams.h"
 #include "chainparams.h"
 #include "checkpoints.h"
@@ -43,8 +44,8 @@ double VRFup3 = 2;
 double TerminalAverage = 0;
 double TerminalFactor = 10000;
 double debugTerminalAverage = 0;
-CBigNum newBN = 0;
-CBigNum oldBN = 0;
+unsigned int newBN = 0;
+unsigned int oldBN = 0;
 int64_t VLrate1 = 0;
 int64_t VLrate2 = 0;
 int64_t VLrate3 = 0;
@@ -76,9 +77,9 @@ bool fDryRun;
 bool fCRVreset;
 const CBlockIndex* pindexPrev = 0;
 const CBlockIndex* BlockVelocityType = 0;
-CBigNum bnVelocity = 0;
-CBigNum bnOld;
-CBigNum bnNew;
+arith_uint256 bnVelocity = 0;
+arith_uint256 bnOld;
+arith_uint256 bnNew;
 std::string difType ("");
 unsigned int retarget = DIFF_VRX; // Default with VRX
 
@@ -361,8 +362,14 @@ void VRX_Simulate_Retarget()
     TerminalFactor *= TerminalAverage;
     difficultyfactor = TerminalFactor;
     bnOld.SetCompact(BlockVelocityType->nBits);
-    bnNew = bnOld / difficultyfactor;
-    bnNew *= 10000;
+    // TerminalAverage is at least 0.5 / 720, difficultyfactor is positive
+    bnNew = bnOld / arith_uint256(difficultyfactor);
+    
+    // A product past 256 bits is above both limits, VRX_Retarget caps it
+    if (!bnNew.MulChecked(10000))
+    {
+        bnNew = ~arith_uint256(0);
+    }
     
 	// Reset TerminalFactor for actual retarget
     TerminalFactor = 10000;
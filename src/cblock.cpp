@@ -1,10 +1,12 @@
 #include "compat.h"
 
+#include <memory>
 #include <boost/thread.hpp>
 #include <boost/algorithm/string/replace.hpp>
 
 #include "util.h"
 #include "crypto/bmw/bmw512.h"
+#include "crypto/common/sha256.h"
 #include "ctransaction.h"
 #include "txdb-leveldb.h"
 #include "blocksizecalculator.h"
@@ -16,6 +18,8 @@
 #include "checkpoints.h"
 #include "cblocklocator.h"
 #include "cwallet.h"
+#include "init.h"
+#include "cdbbatch.h"
 #include "script.h"
 #include "cinv.h"
 #include "net/cnode.h"
@@ -48,8 +52,11 @@
 #include "ctxindex.h"
 #include "util/backwards.h"
 #include "cautofile.h"
+#include "cdatastream.h"
 #include "fork.h"
 #include "cflatdata.h"
+#include "crollingbloomfilter.h"
+#include "cblockassembler.h"
 
 #include "cblock.h"
 
@@ -197,7 +204,7 @@ uint256 CBlock::GetHash() const
 {
 	if (nVersion > 6)
 	{
-		return Hash_bmw512(BEGIN(nVersion), END(nNonce));
+		return Hash_bmw512_80((const unsigned char*)&nVersion);
 	}
 	else
 	{
@@ -207,7 +214,7 @@ uint256 CBlock::GetHash() const
 
 uint256 CBlock::GetPoWHash() const
 {
-	return Hash_bmw512(BEGIN(nVersion), END(nNonce));
+	return Hash_bmw512_80((const unsigned char*)&nVersion);
 }
 
 int64_t CBlock::GetBlockTime() const
@@ -263,26 +270,31 @@ int64_t CBlock::GetMaxTransactionTime() const
 uint256 CBlock::BuildMerkleTree() const
 {
 	vMerkleTree.clear();
+	vMerkleTree.reserve(2 * vtx.size() + 16);
 
 	for(const CTransaction& tx : vtx)
 	{
 		vMerkleTree.push_back(tx.GetHash());
 	}
 
+	// The pairs of a level are consecutive 64 byte inputs in vMerkleTree,
+	// so a level is hashed in one SHA256D64 call. An odd last node is
+	// paired with itself.
 	int j = 0;
 	for (int nSize = vtx.size(); nSize > 1; nSize = (nSize + 1) / 2)
 	{
-		for (int i = 0; i < nSize; i += 2)
+		int nPairs = nSize / 2;
+
+		vMerkleTree.resize(j + nSize + (nSize + 1) / 2);
+		SHA256D64(vMerkleTree[j+nSize].begin(), vMerkleTree[j].begin(), nPairs);
+
+		if (nSize & 1)
 		{
-			int i2 = std::min(i+1, nSize-1);
-			vMerkleTree.push_back(
-				Hash(
-					BEGIN(vMerkleTree[j+i]),
-					END(vMerkleTree[j+i]),
-					BEGIN(vMerkleTree[j+i2]),
-					END(vMerkleTree[j+i2])
-				)
-			);
+			unsigned char pair[64];
+
+			memcpy(pair, vMerkleTree[j+nSize-1].begin(), 32);
+			memcpy(pair + 32, vMerkleTree[j+nSize-1].begin(), 32);
+			SHA256D64(vMerkleTree[j+nSize+nPairs].begin(), pair, 1);
 		}
 		j += nSize;
 	}
@@ -320,14 +332,19 @@ uint256 CBlock::CheckMerkleBranch(uint256 hash, const std::vector<uint256>& vMer
 
 	for(const uint256& otherside : vMerkleBranch)
 	{
+		unsigned char pair[64];
+
 		if (nIndex & 1)
 		{
-			hash = Hash(BEGIN(otherside), END(otherside), BEGIN(hash), END(hash));
+			memcpy(pair, otherside.begin(), 32);
+			memcpy(pair + 32, hash.begin(), 32);
 		}
 		else
 		{
-			hash = Hash(BEGIN(hash), END(hash), BEGIN(otherside), END(otherside));
+			memcpy(pair, hash.begin(), 32);
+			memcpy(pair + 32, otherside.begin(), 32);
 		}
+		SHA256D64(hash.begin(), pair, 1);
 		nIndex >>= 1;
 	}
 
@@ -344,8 +361,13 @@ bool CBlock::WriteToDisk(unsigned int& nFileRet, unsigned int& nBlockPosRet)
 		return error("CBlock::WriteToDisk() : AppendBlockFile failed");
 	}
 
+	// Serialize once and take the size from the result, rather than walking
+	// every transaction a second time just to count the bytes
+	CDataStream ssBlock(SER_DISK, CLIENT_VERSION);
+	ssBlock << *this;
+
 	// Write index header
-	unsigned int nSize = fileout.GetSerializeSize(*this);
+	unsigned int nSize = ssBlock.size();
 	fileout << FLATDATA(Params().MessageStart()) << nSize;
 
 	// Write block
@@ -357,7 +379,7 @@ bool CBlock::WriteToDisk(unsigned int& nFileRet, unsigned int& nBlockPosRet)
 	}
 
 	nBlockPosRet = fileOutPos;
-	fileout << *this;
+	fileout << ssBlock;
 
 	// Flush stdio buffers and commit to disk before returning
 	fflush(fileout);
@@ -715,9 +737,32 @@ bool CBlock::ConnectBlock(CTxDB& txdb, CBlockIndex* pindex, bool fJustCheck)
 	}
 
 	// Watch for transactions paying to me
-	for(CTransaction& tx : vtx)
 	{
-		SyncWithWallets(tx, this);
+#ifdef ENABLE_WALLET
+		// What the wallet takes from this block goes into one wallet.dat
+		// transaction, under the cs_wallet SyncTransaction takes anyway
+		std::unique_ptr<CCriticalBlock> lockWallet;
+		std::unique_ptr<CDBBatch> batch;
+		
+		if (pwalletMain)
+		{
+			lockWallet.reset(new CCriticalBlock(pwalletMain->cs_wallet, "pwalletMain->cs_wallet", __FILE__, __LINE__));
+			batch.reset(new CDBBatch(pwalletMain->strWalletFile));
+		}
+#endif
+		
+		for(CTransaction& tx : vtx)
+		{
+			SyncWithWallets(tx, this);
+		}
+		
+#ifdef ENABLE_WALLET
+		// the block stays connected, only what the wallet learnt from it is lost
+		if (batch && !batch->Commit())
+		{
+			LogPrintf("ConnectBlock() : wallet changes for block %s were not saved\n", GetHash().ToString());
+		}
+#endif
 	}
 
 	return true;
@@ -838,7 +883,13 @@ bool CBlock::SetBestChain(CTxDB& txdb, CBlockIndex* pindexNew)
 	}
 
 	// New best block
-	hashBestChain = hash;
+	{
+		boost::lock_guard<boost::mutex> lock(csBestBlock);
+		
+		hashBestChain = hash;
+		cvBlockChange.notify_all();
+	}
+	
 	pindexBest = pindexNew;
 	pblockindexFBBHLast = NULL;
 	nBestHeight = pindexBest->nHeight;
@@ -922,7 +973,7 @@ bool CBlock::AddToBlockIndex(unsigned int nFile, unsigned int nBlockPos, const u
 	}
 	
 	pindexNew->phashBlock = &hash;
-	std::map<uint256, CBlockIndex*>::iterator miPrev = mapBlockIndex.find(hashPrevBlock);
+	CBlockIndexMap::iterator miPrev = mapBlockIndex.find(hashPrevBlock);
 	
 	if (miPrev != mapBlockIndex.end())
 	{
@@ -955,7 +1006,7 @@ bool CBlock::AddToBlockIndex(unsigned int nFile, unsigned int nBlockPos, const u
 	pindexNew->bnStakeModifierV2 = ComputeStakeModifierV2(pindexNew->pprev, IsProofOfWork() ? hash : vtx[1].vin[0].prevout.hash);
 
 	// Add to mapBlockIndex
-	std::map<uint256, CBlockIndex*>::iterator mi = mapBlockIndex.insert(std::make_pair(hash, pindexNew)).first;
+	CBlockIndexMap::iterator mi = mapBlockIndex.insert(std::make_pair(hash, pindexNew)).first;
 	
 	if (pindexNew->IsProofOfStake())
 	{
@@ -1593,7 +1644,7 @@ bool CBlock::AcceptBlock()
 	}
 
 	// Get prev block index
-	std::map<uint256, CBlockIndex*>::iterator mi = mapBlockIndex.find(hashPrevBlock);
+	CBlockIndexMap::iterator mi = mapBlockIndex.find(hashPrevBlock);
 	if (mi == mapBlockIndex.end())
 	{
 		return DoS(10, error("AcceptBlock() : prev block not found"));
@@ -2022,7 +2073,11 @@ bool CBlock::SetBestChainInner(CTxDB& txdb, CBlockIndex *pindexNew)
 	for(CTransaction& tx : vtx)
 	{
 		mempool.remove(tx);
+		
+		recentConfirmedTransactions.insert(tx.GetHash());
 	}
+	
+	blockAssembler.BlockConnected(*this, pindexNew);
 
 	return true;
 }
@@ -0,0 +1,317 @@
+#include "compat.h"
+
+#include "main_extern.h"
+#include "cblock.h"
+#include "cblockindex.h"
+#include "ctransaction.h"
+#include "ctxin.h"
+#include "ctxout.h"
+#include "ctxindex.h"
+#include "ctxmempool.h"
+#include "coutpoint.h"
+#include "txdb-leveldb.h"
+#include "enums/serialize_type.h"
+#include "serialize.h"
+#include "version.h"
+#include "util.h"
+
+#include "cblockassembler.h"
+
+double CBlockAssembler::CCandidate::GetPriority(int nHeight) const
+{
+	return ((double)nValueInChain * nHeight - dValueInHeight) / nTxSize;
+}
+
+CBlockAssembler::CBlockAssembler() : pindexTip(NULL), nHits(0), nMisses(0)
+{
+	
+}
+
+void CBlockAssembler::SyncTip()
+{
+	if (pindexTip != pindexBest)
+	{
+		Clear();
+		
+		pindexTip = pindexBest;
+	}
+}
+
+CBlockAssembler::CCandidate& CBlockAssembler::Insert(const uint256& hash, const CTransaction& tx)
+{
+	std::map<uint256, CCandidate>::iterator it = mapCandidates.find(hash);
+	
+	if (it != mapCandidates.end())
+	{
+		Erase(it);
+	}
+	
+	CCandidate& candidate = mapCandidates[hash];
+	
+	candidate.nValueIn = 0;
+	candidate.nValueInChain = 0;
+	candidate.dValueInHeight = 0;
+	candidate.vInChainUnread.clear();
+	candidate.nTxSize = ::GetSerializeSize(tx, SER_NETWORK, PROTOCOL_VERSION);
+	candidate.fSigsChecked = false;
+	
+	return candidate;
+}
+
+void CBlockAssembler::Erase(std::map<uint256, CCandidate>::iterator it)
+{
+	for (const std::pair<const uint256, int64_t>& item : it->second.mapDependsOn)
+	{
+		std::map<uint256, std::set<uint256> >::iterator mi = mapDependers.find(item.first);
+		
+		if (mi == mapDependers.end())
+		{
+			continue;
+		}
+		
+		mi->second.erase(it->first);
+		
+		if (mi->second.empty())
+		{
+			mapDependers.erase(mi);
+		}
+	}
+	
+	mapCandidates.erase(it);
+}
+
+void CBlockAssembler::AddInputInChain(CCandidate& candidate, int64_t nValue, int nDepth)
+{
+	// Inputs not in the main chain count as confirmed in the next block,
+	// as GetDepthInMainChain gives them no age
+	int nHeight = pindexTip->nHeight + 1 - nDepth;
+	
+	candidate.nValueInChain += nValue;
+	candidate.dValueInHeight += (double)nValue * nHeight;
+}
+
+void CBlockAssembler::ReadInputsInChain(CCandidate& candidate)
+{
+	for (const std::pair<CDiskTxPos, int64_t>& item : candidate.vInChainUnread)
+	{
+		AddInputInChain(candidate, item.second, CTxIndex(item.first, 0).GetDepthInMainChain());
+	}
+	
+	candidate.vInChainUnread.clear();
+}
+
+void CBlockAssembler::TxAccepted(const CTransaction& tx, const mapPrevTx_t& mapInputs)
+{
+	SyncTip();
+	
+	if (!pindexTip)
+	{
+		return;
+	}
+	
+	uint256 hash = tx.GetHash();
+	CCandidate& candidate = Insert(hash, tx);
+	
+	// Inputs from the same transaction share its depth, read by Get
+	std::map<uint256, size_t> mapUnread;
+	
+	for (const CTxIn& txin : tx.vin)
+	{
+		mapPrevTx_t::const_iterator mi = mapInputs.find(txin.prevout.hash);
+		
+		if (mi == mapInputs.end() || txin.prevout.n >= mi->second.second.vout.size())
+		{
+			Erase(mapCandidates.find(hash));
+			
+			return;
+		}
+		
+		int64_t nValue = mi->second.second.vout[txin.prevout.n].nValue;
+		
+		candidate.nValueIn += nValue;
+		
+		if (mempool.exists(txin.prevout.hash))
+		{
+			candidate.mapDependsOn[txin.prevout.hash] += nValue;
+			mapDependers[txin.prevout.hash].insert(hash);
+			
+			continue;
+		}
+		
+		std::map<uint256, size_t>::iterator itUnread = mapUnread.find(txin.prevout.hash);
+		
+		if (itUnread == mapUnread.end())
+		{
+			itUnread = mapUnread.insert(std::make_pair(txin.prevout.hash, candidate.vInChainUnread.size())).first;
+			
+			candidate.vInChainUnread.push_back(std::make_pair(mi->second.first.pos, (int64_t)0));
+		}
+		
+		candidate.vInChainUnread[itUnread->second].second += nValue;
+	}
+	
+	// AcceptToMemoryPool verified them against the standard flags
+	candidate.fSigsChecked = true;
+}
+
+void CBlockAssembler::BlockConnected(const CBlock& block, const CBlockIndex* pindex)
+{
+	if (pindexTip != pindex->pprev)
+	{
+		Clear();
+	}
+	
+	pindexTip = pindex;
+	
+	for (const CTransaction& tx : block.vtx)
+	{
+		uint256 hash = tx.GetHash();
+		std::map<uint256, CCandidate>::iterator it = mapCandidates.find(hash);
+		
+		if (it != mapCandidates.end())
+		{
+			Erase(it);
+		}
+		
+		// Children of tx spend confirmed outputs now
+		std::map<uint256, std::set<uint256> >::iterator mi = mapDependers.find(hash);
+		
+		if (mi == mapDependers.end())
+		{
+			continue;
+		}
+		
+		for (const uint256& hashChild : mi->second)
+		{
+			std::map<uint256, CCandidate>::iterator itChild = mapCandidates.find(hashChild);
+			
+			if (itChild == mapCandidates.end())
+			{
+				continue;
+			}
+			
+			CCandidate& candidate = itChild->second;
+			std::map<uint256, int64_t>::iterator itParent = candidate.mapDependsOn.find(hash);
+			
+			if (itParent == candidate.mapDependsOn.end())
+			{
+				continue;
+			}
+			
+			AddInputInChain(candidate, itParent->second, 1);
+			
+			candidate.mapDependsOn.erase(itParent);
+		}
+		
+		mapDependers.erase(mi);
+	}
+}
+
+void CBlockAssembler::Clear()
+{
+	mapCandidates.clear();
+	mapDependers.clear();
+	
+	pindexTip = NULL;
+}
+
+const CBlockAssembler::CCandidate* CBlockAssembler::Get(CTxDB& txdb, const CTransaction& tx)
+{
+	SyncTip();
+	
+	uint256 hash = tx.GetHash();
+	std::map<uint256, CCandidate>::iterator it = mapCandidates.find(hash);
+	
+	if (it != mapCandidates.end())
+	{
+		nHits++;
+		
+		ReadInputsInChain(it->second);
+		
+		return &it->second;
+	}
+	
+	nMisses++;
+	
+	CCandidate& candidate = Insert(hash, tx);
+	
+	for (const CTxIn& txin : tx.vin)
+	{
+		// Read prev transaction
+		CTransaction txPrev;
+		CTxIndex txindex;
+		
+		if (!txPrev.ReadFromDisk(txdb, txin.prevout, txindex))
+		{
+			// This should never happen; all transactions in the memory
+			// pool should connect to either transactions in the chain
+			// or other transactions in the memory pool.
+			std::map<uint256, CTransaction>::const_iterator mi = mempool.mapTx.find(txin.prevout.hash);
+			
+			if (mi == mempool.mapTx.end() || txin.prevout.n >= mi->second.vout.size())
+			{
+				LogPrintf("ERROR: mempool transaction missing input\n");
+				
+				Erase(mapCandidates.find(hash));
+				
+				return NULL;
+			}
+			
+			int64_t nValue = mi->second.vout[txin.prevout.n].nValue;
+			
+			candidate.nValueIn += nValue;
+			candidate.mapDependsOn[txin.prevout.hash] += nValue;
+			mapDependers[txin.prevout.hash].insert(hash);
+			
+			continue;
+		}
+		
+		int64_t nValue = txPrev.vout[txin.prevout.n].nValue;
+		
+		candidate.nValueIn += nValue;
+		
+		AddInputInChain(candidate, nValue, txindex.GetDepthInMainChain());
+	}
+	
+	return &candidate;
+}
+
+void CBlockAssembler::SetSigsChecked(const uint256& hash)
+{
+	std::map<uint256, CCandidate>::iterator it = mapCandidates.find(hash);
+	
+	if (it != mapCandidates.end())
+	{
+		it->second.fSigsChecked = true;
+	}
+}
+
+void CBlockAssembler::Prune(const CTxMemPool& pool)
+{
+	std::map<uint256, CCandidate>::iterator it = mapCandidates.begin();
+	
+	while (it != mapCandidates.end())
+	{
+		std::map<uint256, CCandidate>::iterator itErase = it++;
+		
+		if (!pool.mapTx.count(itErase->first))
+		{
+			Erase(itErase);
+		}
+	}
+}
+
+size_t CBlockAssembler::size() const
+{
+	return mapCandidates.size();
+}
+
+uint64_t CBlockAssembler::GetHits() const
+{
+	return nHits;
+}
+
+uint64_t CBlockAssembler::GetMisses() const
+{
+	return nMisses;
+}
@@ -0,0 +1,108 @@
+#ifndef CBLOCKASSEMBLER_H
+#define CBLOCKASSEMBLER_H
+
+#include <map>
+#include <set>
+#include <vector>
+#include <stdint.h>
+
+#include "uint/uint256.h"
+#include "cdisktxpos.h"
+#include "types/mapprevtx_t.h"
+
+class CBlock;
+class CBlockIndex;
+class CTransaction;
+class CTxDB;
+class CTxMemPool;
+
+/** What CreateNewBlock needs to know about the memory pool transactions,
+ * kept from one block template to the next.
+ *
+ * Building the priority queue used to read the previous transaction and
+ * the block header of every input of every memory pool transaction. Here
+ * an entry is made once, from the inputs AcceptToMemoryPool already
+ * fetched, and is brought up to date when a block confirms one of its
+ * parents. The block headers of its confirmed inputs are only read when a
+ * template first asks for it, so nodes that do not mine never read them. Entries are dropped when their transaction leaves the memory
+ * pool, and all of them when the best chain is reorganized.
+ *
+ * Protected by cs_main.
+ */
+class CBlockAssembler
+{
+public:
+	struct CCandidate
+	{
+		// All inputs, and those confirmed in the chain
+		int64_t nValueIn;
+		int64_t nValueInChain;
+		
+		// Sum of value * height of the confirmed inputs
+		double dValueInHeight;
+		
+		// Confirmed inputs whose height Get has yet to read, by the position
+		// of their transaction and the value spent from it
+		std::vector<std::pair<CDiskTxPos, int64_t> > vInChainUnread;
+		
+		// Memory pool parents and the value spent from each
+		std::map<uint256, int64_t> mapDependsOn;
+		
+		unsigned int nTxSize;
+		
+		// Signatures were verified by AcceptToMemoryPool or an earlier template
+		bool fSigsChecked;
+		
+		/** Priority as sum(valuein * age) / txsize, in a block at nHeight */
+		double GetPriority(int nHeight) const;
+	};
+
+private:
+	std::map<uint256, CCandidate> mapCandidates;
+	
+	// Transactions that spend outputs of a memory pool transaction
+	std::map<uint256, std::set<uint256> > mapDependers;
+	
+	// Best block the entries are up to date with
+	const CBlockIndex* pindexTip;
+	
+	uint64_t nHits;
+	uint64_t nMisses;
+	
+	void SyncTip();
+	CCandidate& Insert(const uint256& hash, const CTransaction& tx);
+	void Erase(std::map<uint256, CCandidate>::iterator it);
+	void AddInputInChain(CCandidate& candidate, int64_t nValue, int nDepth);
+	void ReadInputsInChain(CCandidate& candidate);
+
+public:
+	CBlockAssembler();
+	
+	/** tx is about to be added to the memory pool, mapInputs are the
+	 * inputs AcceptToMemoryPool fetched for it
+	 */
+	void TxAccepted(const CTransaction& tx, const mapPrevTx_t& mapInputs);
+	
+	/** block was connected to the best chain at pindex */
+	void BlockConnected(const CBlock& block, const CBlockIndex* pindex);
+	
+	/** Forgets all entries, the chain they were made against is gone */
+	void Clear();
+	
+	/** Entry of the memory pool transaction tx, made from the disk if there
+	 * is none. NULL if tx spends an output that can't be found.
+	 */
+	const CCandidate* Get(CTxDB& txdb, const CTransaction& tx);
+	
+	/** tx was connected to a block template, its signatures are valid */
+	void SetSigsChecked(const uint256& hash);
+	
+	/** Drops the entries of transactions that left the memory pool */
+	void Prune(const CTxMemPool& pool);
+	
+	size_t size() const;
+	uint64_t GetHits() const;
+	uint64_t GetMisses() const;
+};
+
+#endif // CBLOCKASSEMBLER_H
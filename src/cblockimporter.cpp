@@ -0,0 +1,294 @@
+#include "compat.h"
+
+#include <cstring>
+#include <boost/thread/thread.hpp>
+
+#include "util.h"
+#include "main.h"
+#include "main_const.h"
+#include "main_extern.h"
+#include "message_start_size.h"
+#include "cchainparams.h"
+#include "chainparams.h"
+#include "cdatastream.h"
+#include "ctransaction.h"
+#include "ctxin.h"
+#include "ctxout.h"
+#include "crypto/common/common.h"
+#include "enums/serialize_type.h"
+#include "thread.h"
+#include "types/ccriticalsection.h"
+
+#include "cblockimporter.h"
+
+// Blocks handed to the pool in one task
+static const size_t IMPORT_BATCH_BLOCKS = 64;
+
+// Or fewer when they add up to this many bytes
+static const size_t IMPORT_BATCH_BYTES = 16 * 1024 * 1024;
+
+CBlockImporter::CBlockImporter(const unsigned char* pBeginIn, size_t nLengthIn, int nThreads) :
+		pBegin(pBeginIn), nLength(nLengthIn), fReaderDone(false), fStop(false), nLoaded(0), pool("loadblk", nThreads)
+{
+	// enough parsed batches ahead to keep every parser busy
+	nMaxBatches = 4 * std::max(nThreads, 1);
+}
+
+void CBlockImporter::ReadThread()
+{
+	const unsigned char* pchMessageStart = Params().MessageStart();
+	std::shared_ptr<CImportBatch> batch;
+	size_t nBatchBytes = 0;
+	uint64_t nPos = 0;
+
+	for (;;)
+	{
+		const unsigned char* pFound = NULL;
+
+		if (nPos + MESSAGE_START_SIZE + 4 <= nLength)
+		{
+			pFound = (const unsigned char*)memchr(pBegin + nPos, pchMessageStart[0], nLength - nPos - MESSAGE_START_SIZE - 3);
+		}
+
+		if (pFound)
+		{
+			nPos = pFound - pBegin;
+
+			unsigned int nSize = ReadLE32(pFound + MESSAGE_START_SIZE);
+
+			if (memcmp(pFound, pchMessageStart, MESSAGE_START_SIZE) != 0 || nSize == 0 || nSize > MAX_BLOCK_SIZE ||
+				nPos + MESSAGE_START_SIZE + 4 + nSize > nLength)
+			{
+				nPos++;
+
+				continue;
+			}
+
+			if (!batch)
+			{
+				batch.reset(new CImportBatch());
+				batch->fReady = false;
+				nBatchBytes = 0;
+			}
+
+			batch->vBlocks.push_back(CImportBlock());
+			batch->vBlocks.back().nPos = nPos + MESSAGE_START_SIZE + 4;
+			batch->vBlocks.back().nSize = nSize;
+			batch->vBlocks.back().fParsed = false;
+
+			nBatchBytes += nSize;
+			nPos += MESSAGE_START_SIZE + 4 + nSize;
+		}
+
+		bool fEnd = pFound == NULL;
+
+		if (batch && (fEnd || batch->vBlocks.size() == IMPORT_BATCH_BLOCKS || nBatchBytes >= IMPORT_BATCH_BYTES))
+		{
+			{
+				boost::unique_lock<boost::mutex> lock(mutex);
+
+				while (!fStop && queue.size() >= nMaxBatches)
+				{
+					cond.wait(lock);
+				}
+
+				if (fStop)
+				{
+					return;
+				}
+
+				queue.push_back(batch);
+			}
+
+			pool.Submit(std::bind(&CBlockImporter::Parse, this, batch));
+			batch.reset();
+		}
+
+		if (fEnd)
+		{
+			break;
+		}
+	}
+
+	boost::unique_lock<boost::mutex> lock(mutex);
+
+	fReaderDone = true;
+	cond.notify_all();
+}
+
+bool CBlockImporter::ParseBlock(uint64_t nPos, unsigned int nSize, CBlock& block, uint256& hash) const
+{
+	try
+	{
+		CDataStream ss((const char*)pBegin + nPos, (const char*)pBegin + nPos + nSize, SER_DISK, CLIENT_VERSION);
+
+		ss >> block;
+	}
+	catch (std::exception &e)
+	{
+		LogPrintf("%s : Deserialize error at %u - %s\n", __func__, nPos, e.what());
+
+		return false;
+	}
+
+	// CheckBlock would turn it down as well, without the pool's help
+	if (block.BuildMerkleTree() != block.hashMerkleRoot)
+	{
+		LogPrintf("%s : Merkle root mismatch at %u\n", __func__, nPos);
+
+		return false;
+	}
+
+	hash = block.GetHash();
+
+	return true;
+}
+
+void CBlockImporter::Parse(std::shared_ptr<CImportBatch> batch)
+{
+	for (CImportBlock& item : batch->vBlocks)
+	{
+		item.fParsed = ParseBlock(item.nPos, item.nSize, item.block, item.hash);
+	}
+
+	boost::unique_lock<boost::mutex> lock(mutex);
+
+	batch->fReady = true;
+	cond.notify_all();
+}
+
+void CBlockImporter::Connect(CBlock& block, const uint256& hash, uint64_t nPos, unsigned int nSize)
+{
+	{
+		LOCK(cs_main);
+
+		// reindexing or importing a file that overlaps the chain we have
+		if (mapBlockIndex.count(hash))
+		{
+			return;
+		}
+
+		if (!mapBlockIndex.count(block.hashPrevBlock))
+		{
+			mapPending.insert(std::make_pair(block.hashPrevBlock, std::make_pair(nPos, nSize)));
+
+			return;
+		}
+
+		if (!ProcessBlock(NULL, &block))
+		{
+			return;
+		}
+	}
+
+	nLoaded++;
+
+	// Children that showed up earlier in the file are read again
+	std::vector<uint256> vWorkQueue;
+	vWorkQueue.push_back(hash);
+
+	for (size_t i = 0; i < vWorkQueue.size(); i++)
+	{
+		std::vector<std::pair<uint64_t, unsigned int>> vChildren;
+
+		{
+			std::multimap<uint256, std::pair<uint64_t, unsigned int>>::iterator mi = mapPending.lower_bound(vWorkQueue[i]);
+
+			while (mi != mapPending.end() && mi->first == vWorkQueue[i])
+			{
+				vChildren.push_back(mi->second);
+				mapPending.erase(mi++);
+			}
+		}
+
+		for (const std::pair<uint64_t, unsigned int>& child : vChildren)
+		{
+			CBlock blockChild;
+			uint256 hashChild;
+
+			if (!ParseBlock(child.first, child.second, blockChild, hashChild))
+			{
+				continue;
+			}
+
+			LOCK(cs_main);
+
+			if (!mapBlockIndex.count(hashChild) && ProcessBlock(NULL, &blockChild))
+			{
+				nLoaded++;
+				vWorkQueue.push_back(hashChild);
+			}
+		}
+	}
+}
+
+int CBlockImporter::Run()
+{
+	boost::thread reader(&CBlockImporter::ReadThread, this);
+
+	try
+	{
+		for (;;)
+		{
+			std::shared_ptr<CImportBatch> batch;
+
+			{
+				boost::unique_lock<boost::mutex> lock(mutex);
+
+				while (!fReaderDone && queue.empty())
+				{
+					cond.wait(lock);
+				}
+
+				if (queue.empty())
+				{
+					break;
+				}
+
+				batch = queue.front();
+
+				while (!batch->fReady)
+				{
+					cond.wait(lock);
+				}
+
+				queue.pop_front();
+				cond.notify_all();
+			}
+
+			for (CImportBlock& item : batch->vBlocks)
+			{
+				boost::this_thread::interruption_point();
+
+				if (item.fParsed)
+				{
+					Connect(item.block, item.hash, item.nPos, item.nSize);
+				}
+			}
+		}
+	}
+	catch (...)
+	{
+		{
+			boost::unique_lock<boost::mutex> lock(mutex);
+
+			fStop = true;
+			cond.notify_all();
+		}
+
+		reader.join();
+		pool.Stop();
+
+		throw;
+	}
+
+	reader.join();
+	pool.Stop();
+
+	return nLoaded;
+}
+
+size_t CBlockImporter::PendingCount() const
+{
+	return mapPending.size();
+}
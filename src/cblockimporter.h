@@ -0,0 +1,76 @@
+#ifndef CBLOCKIMPORTER_H
+#define CBLOCKIMPORTER_H
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <vector>
+#include <stdint.h>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include "cblock.h"
+#include "uint/uint256.h"
+#include "thread/cthreadpool.h"
+
+/** Imports the blocks of a bootstrap.dat or -loadblock file that is
+ * mapped into memory.
+ *
+ * Three stages run at once: a reader thread finds the block boundaries,
+ * the pool deserializes batches of blocks and computes their hashes and
+ * Merkle roots, and Run() hands the blocks to ProcessBlock in file order.
+ *
+ * Blocks that come before their parent are remembered by their position
+ * in the file and read again once the parent is connected, instead of
+ * being held in memory.
+ */
+class CBlockImporter
+{
+private:
+	struct CImportBlock
+	{
+		uint64_t nPos;
+		unsigned int nSize;
+		bool fParsed;
+		uint256 hash;
+		CBlock block;
+	};
+
+	struct CImportBatch
+	{
+		std::vector<CImportBlock> vBlocks;
+		bool fReady;
+	};
+
+	const unsigned char* pBegin;
+	size_t nLength;
+
+	boost::mutex mutex;
+	boost::condition_variable cond;
+	std::deque<std::shared_ptr<CImportBatch>> queue;
+	bool fReaderDone;
+	bool fStop;
+	size_t nMaxBatches;
+
+	// blocks waiting for their parent, by the parent hash
+	std::multimap<uint256, std::pair<uint64_t, unsigned int>> mapPending;
+	int nLoaded;
+
+	CThreadPool pool;
+
+	void ReadThread();
+	void Parse(std::shared_ptr<CImportBatch> batch);
+	bool ParseBlock(uint64_t nPos, unsigned int nSize, CBlock& block, uint256& hash) const;
+	void Connect(CBlock& block, const uint256& hash, uint64_t nPos, unsigned int nSize);
+
+public:
+	CBlockImporter(const unsigned char* pBeginIn, size_t nLengthIn, int nThreads);
+
+	/** Imports the whole file, returns the number of blocks accepted */
+	int Run();
+
+	/** Blocks whose parent was neither in the file nor known before */
+	size_t PendingCount() const;
+};
+
+#endif // CBLOCKIMPORTER_H
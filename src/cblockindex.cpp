@@ -1,9 +1,14 @@
 #include "compat.h"
 
+#include <mutex>
+#include <new>
+#include <stdint.h>
+#include <stdlib.h>
+
 #include "cblock.h"
 #include "ctransaction.h"
 #include "cdiskblockpos.h"
-#include "cbignum.h"
+#include "uint/arith_uint256.h"
 #include "main_extern.h"
 #include "main_const.h"
 #include "util.h"
@@ -13,6 +18,52 @@
 
 #include "cblockindex.h"
 
+// Entries per chunk of the block index arena
+static const size_t BLOCKINDEX_ARENA_CHUNK = 4096;
+
+// Entry size rounded up to a cache line
+static const size_t BLOCKINDEX_ARENA_STRIDE = (sizeof(CBlockIndex) + 63) & ~(size_t)63;
+
+static std::mutex csBlockIndexArena;
+static unsigned char* pBlockIndexArenaNext = NULL;
+static unsigned char* pBlockIndexArenaEnd = NULL;
+
+void* CBlockIndex::operator new(size_t nSize)
+{
+	// CDiskBlockIndex and other derived classes are not block index entries
+	if (nSize != sizeof(CBlockIndex))
+	{
+		return ::operator new(nSize);
+	}
+
+	std::lock_guard<std::mutex> lock(csBlockIndexArena);
+
+	if (pBlockIndexArenaNext == pBlockIndexArenaEnd)
+	{
+		unsigned char* pChunk = (unsigned char*)malloc(BLOCKINDEX_ARENA_CHUNK * BLOCKINDEX_ARENA_STRIDE + 63);
+		if (!pChunk)
+		{
+			throw std::bad_alloc();
+		}
+
+		pBlockIndexArenaNext = (unsigned char*)(((uintptr_t)pChunk + 63) & ~(uintptr_t)63);
+		pBlockIndexArenaEnd = pBlockIndexArenaNext + BLOCKINDEX_ARENA_CHUNK * BLOCKINDEX_ARENA_STRIDE;
+	}
+
+	void* p = pBlockIndexArenaNext;
+	pBlockIndexArenaNext += BLOCKINDEX_ARENA_STRIDE;
+
+	return p;
+}
+
+void CBlockIndex::operator delete(void* p, size_t nSize)
+{
+	if (nSize != sizeof(CBlockIndex))
+	{
+		::operator delete(p);
+	}
+}
+
 CBlockIndex::CBlockIndex()
 {
 	phashBlock = NULL;
@@ -116,16 +167,20 @@ int64_t CBlockIndex::GetBlockTime() const
 /* Calculates trust score for a block given */
 uint256 CBlockIndex::GetBlockTrust() const
 {
-	CBigNum bnTarget;
+	bool fNegative;
+	bool fOverflow;
+	arith_uint256 bnTarget;
 
-	bnTarget.SetCompact(nBits);
+	bnTarget.SetCompact(nBits, &fNegative, &fOverflow);
 
-	if (bnTarget <= 0)
+	if (fNegative || fOverflow || bnTarget == 0)
 	{
 		return 0;
 	}
 
-	return ((CBigNum(1) << 256) / (bnTarget + 1)).getuint256();
+	// 2**256 / (bnTarget+1), computed as ~bnTarget / (bnTarget+1) + 1 as
+	// 2**256 does not fit in 256 bits
+	return (~bnTarget / (bnTarget + 1)) + 1;
 }
 
 bool CBlockIndex::IsInMainChain() const
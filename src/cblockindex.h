@@ -18,17 +18,14 @@ class CDiskBlockPos;
 class CBlockIndex
 {
 public:
+    // Fields read while walking the chain come first and share a cache
+    // line, entries are allocated 64 byte aligned (see operator new)
     const uint256* phashBlock;
     CBlockIndex* pprev;
     CBlockIndex* pnext;
-    unsigned int nFile;
-    unsigned int nBlockPos;
-    uint256 nChainTrust; // ppcoin: trust score of block chain
     int nHeight;
-
-    int64_t nMint;
-    int64_t nMoneySupply;
-
+    unsigned int nTime;
+    unsigned int nBits;
     unsigned int nFlags;  // ppcoin: block index flags
     enum
     {
@@ -42,6 +39,13 @@ public:
 		nMedianTimeSpan = 11
 	};
 	
+    uint256 nChainTrust; // ppcoin: trust score of block chain
+    unsigned int nFile;
+    unsigned int nBlockPos;
+
+    int64_t nMint;
+    int64_t nMoneySupply;
+
     uint64_t nStakeModifier; // hash modifier for proof-of-stake
     uint256 bnStakeModifierV2;
 
@@ -51,15 +55,18 @@ public:
 
     uint256 hashProof;
 
-    // block header
+    // block header (nTime and nBits are above)
     int nVersion;
     uint256 hashMerkleRoot;
-    unsigned int nTime;
-    unsigned int nBits;
     unsigned int nNonce;
     // (memory only) Sequencial id assigned to distinguish order in which blocks are received.
     uint32_t nSequenceId;
 
+    // Block index entries live until shutdown and are carved out of large
+    // chunks instead of one heap allocation each. Deleting one is a no-op.
+    static void* operator new(size_t nSize);
+    static void operator delete(void* p, size_t nSize);
+
     CBlockIndex();
     CBlockIndex(unsigned int nFileIn, unsigned int nBlockPosIn, CBlock& block);
 	
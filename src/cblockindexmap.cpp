@@ -0,0 +1,159 @@
+#include <algorithm>
+#include <random>
+
+#include "crypto/common/common.h"
+
+#include "cblockindexmap.h"
+
+// smallest table, must be a power of two
+static const size_t MIN_SLOTS = 1024;
+
+static inline uint64_t Mix(uint64_t h)
+{
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	h *= 0xc4ceb9fe1a85ec53ULL;
+	h ^= h >> 33;
+
+	return h;
+}
+
+CBlockIndexMap::CBlockIndexMap()
+{
+	// Block hashes are already random, the salt keeps a peer from
+	// choosing keys that collide in this process
+	std::random_device rd;
+	nSalt0 = ((uint64_t)rd() << 32) | rd();
+	nSalt1 = ((uint64_t)rd() << 32) | rd();
+}
+
+uint64_t CBlockIndexMap::HashKey(const uint256& key) const
+{
+	const unsigned char* p = key.begin();
+	uint64_t h = nSalt0;
+
+	for (int i = 0; i < 32; i += 8)
+	{
+		h = Mix(h ^ (ReadLE64(p + i) + nSalt1));
+	}
+
+	return h;
+}
+
+size_t CBlockIndexMap::FindSlot(const uint256& key, uint64_t nHash) const
+{
+	size_t nMask = vSlots.size() - 1;
+	uint32_t nTag = nHash >> 32;
+
+	for (size_t i = nHash & nMask; ; i = (i + 1) & nMask)
+	{
+		const Slot& slot = vSlots[i];
+
+		if (slot.nEntry == 0 || (slot.nTag == nTag && vEntries[slot.nEntry - 1].first == key))
+		{
+			return i;
+		}
+	}
+}
+
+void CBlockIndexMap::Rehash(size_t nSlots)
+{
+	Slot empty = {0, 0};
+
+	vSlots.assign(nSlots, empty);
+
+	size_t nMask = nSlots - 1;
+	for (size_t n = 0; n < vEntries.size(); n++)
+	{
+		uint64_t nHash = HashKey(vEntries[n].first);
+		size_t i = nHash & nMask;
+
+		while (vSlots[i].nEntry != 0)
+		{
+			i = (i + 1) & nMask;
+		}
+
+		vSlots[i].nTag = nHash >> 32;
+		vSlots[i].nEntry = n + 1;
+	}
+}
+
+void CBlockIndexMap::reserve(size_t nCount)
+{
+	// at most three quarters of the slots are used
+	size_t nSlots = std::max(vSlots.size(), MIN_SLOTS);
+	while (nSlots * 3 < nCount * 4)
+	{
+		nSlots *= 2;
+	}
+
+	if (nSlots != vSlots.size())
+	{
+		Rehash(nSlots);
+	}
+}
+
+CBlockIndexMap::iterator CBlockIndexMap::find(const uint256& key)
+{
+	if (vEntries.empty())
+	{
+		return end();
+	}
+
+	const Slot& slot = vSlots[FindSlot(key, HashKey(key))];
+
+	return slot.nEntry == 0 ? end() : vEntries.begin() + (slot.nEntry - 1);
+}
+
+CBlockIndexMap::const_iterator CBlockIndexMap::find(const uint256& key) const
+{
+	if (vEntries.empty())
+	{
+		return end();
+	}
+
+	const Slot& slot = vSlots[FindSlot(key, HashKey(key))];
+
+	return slot.nEntry == 0 ? end() : vEntries.begin() + (slot.nEntry - 1);
+}
+
+size_t CBlockIndexMap::count(const uint256& key) const
+{
+	return find(key) == end() ? 0 : 1;
+}
+
+std::pair<CBlockIndexMap::iterator, bool> CBlockIndexMap::insert(const value_type& value)
+{
+	reserve(vEntries.size() + 1);
+
+	uint64_t nHash = HashKey(value.first);
+	Slot& slot = vSlots[FindSlot(value.first, nHash)];
+
+	if (slot.nEntry != 0)
+	{
+		return std::make_pair(vEntries.begin() + (slot.nEntry - 1), false);
+	}
+
+	vEntries.push_back(value);
+	slot.nTag = nHash >> 32;
+	slot.nEntry = vEntries.size();
+
+	return std::make_pair(vEntries.end() - 1, true);
+}
+
+CBlockIndex*& CBlockIndexMap::operator[](const uint256& key)
+{
+	return insert(std::make_pair(key, (CBlockIndex*)NULL)).first->second;
+}
+
+void CBlockIndexMap::clear()
+{
+	vEntries.clear();
+	vSlots.clear();
+}
+
+size_t CBlockIndexMap::MemoryUsage() const
+{
+	return vSlots.capacity() * sizeof(Slot) + vEntries.size() * sizeof(value_type);
+}
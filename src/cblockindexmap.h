@@ -0,0 +1,75 @@
+#ifndef CBLOCKINDEXMAP_H
+#define CBLOCKINDEXMAP_H
+
+#include <deque>
+#include <vector>
+#include <utility>
+#include <stdint.h>
+
+#include "uint/uint256.h"
+
+class CBlockIndex;
+
+/** Hash table from block hash to block index entry, used for mapBlockIndex.
+ *
+ * Open addressing with linear probing over a table of 8 byte slots, keyed
+ * by a 64-bit hash of the block hash salted per process. The entries
+ * themselves are kept in insertion order in a deque, so references to them
+ * and the addresses of keys (CBlockIndex::phashBlock) stay valid when the
+ * table grows. Iterators do not: an insert invalidates all of them, so
+ * they must not be kept across one. Entries are never erased.
+ *
+ * It has the parts of the std::map interface the code uses: find, count,
+ * operator[], insert, size and iteration.
+ */
+class CBlockIndexMap
+{
+public:
+	typedef uint256 key_type;
+	typedef CBlockIndex* mapped_type;
+	typedef std::pair<const uint256, CBlockIndex*> value_type;
+	typedef std::deque<value_type>::iterator iterator;
+	typedef std::deque<value_type>::const_iterator const_iterator;
+
+private:
+	struct Slot
+	{
+		uint32_t nTag;   // high half of the key hash
+		uint32_t nEntry; // position in vEntries plus one, 0 when empty
+	};
+
+	std::deque<value_type> vEntries;
+	std::vector<Slot> vSlots;
+	uint64_t nSalt0;
+	uint64_t nSalt1;
+
+	uint64_t HashKey(const uint256& key) const;
+	size_t FindSlot(const uint256& key, uint64_t nHash) const;
+	void Rehash(size_t nSlots);
+
+public:
+	CBlockIndexMap();
+
+	iterator begin() { return vEntries.begin(); }
+	iterator end() { return vEntries.end(); }
+	const_iterator begin() const { return vEntries.begin(); }
+	const_iterator end() const { return vEntries.end(); }
+
+	size_t size() const { return vEntries.size(); }
+	bool empty() const { return vEntries.empty(); }
+
+	iterator find(const uint256& key);
+	const_iterator find(const uint256& key) const;
+	size_t count(const uint256& key) const;
+	std::pair<iterator, bool> insert(const value_type& value);
+	CBlockIndex*& operator[](const uint256& key);
+
+	/** Room for nCount entries without growing the table */
+	void reserve(size_t nCount);
+	void clear();
+
+	/** Bytes used by the table and the entries, not the CBlockIndex objects */
+	size_t MemoryUsage() const;
+};
+
+#endif // CBLOCKINDEXMAP_H
@@ -0,0 +1,366 @@
+#include "compat.h"
+
+#include <cstring>
+#include <limits>
+#include <boost/filesystem.hpp>
+#include <boost/unordered_map.hpp>
+
+#include "util.h"
+#include "main_extern.h"
+#include "chash256.h"
+#include "cchainparams.h"
+#include "chainparams.h"
+#include "cblockindex.h"
+#include "txdb-leveldb.h"
+#include "crypto/common/common.h"
+
+#include "cblockindexsnapshot.h"
+
+/*
+ * File layout, all numbers little endian:
+ *
+ *   header      network magic (4), "blkindexsnap" (12), version (4),
+ *               best chain hash (32), snapshot id (8), record count (4)
+ *   records     RECORD_SIZE bytes each
+ *   checksum    double SHA-256 of everything before it (32)
+ *
+ * Record:
+ *
+ *     0  block hash (32)          148  nStakeTime (4)
+ *    32  pprev record (4)         152  hashProof (32)
+ *    36  pnext record (4)         184  nVersion (4)
+ *    40  nFile (4)                188  hashMerkleRoot (32)
+ *    44  nBlockPos (4)            220  nTime (4)
+ *    48  nHeight (4)              224  nBits (4)
+ *    52  nMint (8)                228  nNonce (4)
+ *    60  nMoneySupply (8)         232  nChainTrust (32)
+ *    68  nFlags (4)
+ *    72  nStakeModifier (8)
+ *    80  bnStakeModifierV2 (32)
+ *   112  prevoutStake (32 + 4)
+ */
+static const char pchSnapshotMagic[12] = {'b', 'l', 'k', 'i', 'n', 'd', 'e', 'x', 's', 'n', 'a', 'p'};
+static const size_t HEADER_SIZE = 64;
+static const uint32_t NO_RECORD = 0xffffffff;
+
+static inline void WriteHash(unsigned char* p, const uint256& hash)
+{
+	memcpy(p, hash.begin(), 32);
+}
+
+static inline void ReadHash(const unsigned char* p, uint256& hash)
+{
+	memcpy(hash.begin(), p, 32);
+}
+
+CBlockIndexSnapshot::CBlockIndexSnapshot()
+{
+	pathSnapshot = GetDataDir() / "blkindex.snap";
+}
+
+void CBlockIndexSnapshot::Serialize(const CBlockIndexMap& mapIndex, const uint256& hashBest, uint64_t nId,
+		std::vector<unsigned char>& vchData)
+{
+	// records refer to each other by position instead of by hash, so
+	// loading them needs no lookups
+	boost::unordered_map<const CBlockIndex*, uint32_t> mapRecord;
+	uint32_t nRecord = 0;
+
+	for (const std::pair<const uint256, CBlockIndex*>& item : mapIndex)
+	{
+		mapRecord[item.second] = nRecord++;
+	}
+
+	vchData.assign(HEADER_SIZE + mapIndex.size() * RECORD_SIZE + 32, 0);
+
+	unsigned char* p = &vchData[0];
+	memcpy(p, Params().MessageStart(), 4);
+	memcpy(p + 4, pchSnapshotMagic, sizeof(pchSnapshotMagic));
+	WriteLE32(p + 16, CURRENT_VERSION);
+	WriteHash(p + 20, hashBest);
+	WriteLE64(p + 52, nId);
+	WriteLE32(p + 60, mapIndex.size());
+	p += HEADER_SIZE;
+
+	for (const std::pair<const uint256, CBlockIndex*>& item : mapIndex)
+	{
+		const CBlockIndex* pindex = item.second;
+
+		WriteHash(p, item.first);
+		WriteLE32(p + 32, pindex->pprev ? mapRecord[pindex->pprev] : NO_RECORD);
+		WriteLE32(p + 36, pindex->pnext ? mapRecord[pindex->pnext] : NO_RECORD);
+		WriteLE32(p + 40, pindex->nFile);
+		WriteLE32(p + 44, pindex->nBlockPos);
+		WriteLE32(p + 48, pindex->nHeight);
+		WriteLE64(p + 52, pindex->nMint);
+		WriteLE64(p + 60, pindex->nMoneySupply);
+		WriteLE32(p + 68, pindex->nFlags);
+		WriteLE64(p + 72, pindex->nStakeModifier);
+		WriteHash(p + 80, pindex->bnStakeModifierV2);
+		WriteHash(p + 112, pindex->prevoutStake.hash);
+		WriteLE32(p + 144, pindex->prevoutStake.n);
+		WriteLE32(p + 148, pindex->nStakeTime);
+		WriteHash(p + 152, pindex->hashProof);
+		WriteLE32(p + 184, pindex->nVersion);
+		WriteHash(p + 188, pindex->hashMerkleRoot);
+		WriteLE32(p + 220, pindex->nTime);
+		WriteLE32(p + 224, pindex->nBits);
+		WriteLE32(p + 228, pindex->nNonce);
+		WriteHash(p + 232, pindex->nChainTrust);
+
+		p += RECORD_SIZE;
+	}
+
+	uint256 hash;
+	CHash256().Write(&vchData[0], vchData.size() - 32).Finalize(hash.begin());
+	WriteHash(p, hash);
+}
+
+CBlockIndexSnapshot::ReadResult CBlockIndexSnapshot::Deserialize(const std::vector<unsigned char>& vchData,
+		const uint256& hashBest, uint64_t nId, CBlockIndexMap& mapIndex)
+{
+	if (vchData.size() < HEADER_SIZE + 32)
+	{
+		return IncorrectFormat;
+	}
+
+	uint256 hashIn, hashTmp;
+	ReadHash(&vchData[vchData.size() - 32], hashIn);
+	CHash256().Write(&vchData[0], vchData.size() - 32).Finalize(hashTmp.begin());
+
+	if (hashIn != hashTmp)
+	{
+		return IncorrectHash;
+	}
+
+	const unsigned char* p = &vchData[0];
+
+	if (memcmp(p, Params().MessageStart(), 4))
+	{
+		return IncorrectMagicNumber;
+	}
+
+	if (memcmp(p + 4, pchSnapshotMagic, sizeof(pchSnapshotMagic)))
+	{
+		return IncorrectMagicMessage;
+	}
+
+	if (ReadLE32(p + 16) != (uint32_t)CURRENT_VERSION)
+	{
+		return IncorrectVersion;
+	}
+
+	uint256 hashBestIn;
+	ReadHash(p + 20, hashBestIn);
+
+	if (hashBestIn != hashBest || ReadLE64(p + 52) != nId)
+	{
+		return Stale;
+	}
+
+	uint32_t nCount = ReadLE32(p + 60);
+
+	if (!mapIndex.empty() || (vchData.size() - HEADER_SIZE - 32) / RECORD_SIZE != nCount ||
+		(vchData.size() - HEADER_SIZE - 32) % RECORD_SIZE != 0)
+	{
+		return IncorrectFormat;
+	}
+
+	const unsigned char* pRecords = p + HEADER_SIZE;
+
+	// Records link only to records in the file, so no pointer is left
+	// dangling once they are all in. Every record is checked before any
+	// entry is made, the arena never gives entries back.
+	std::vector<CBlockIndexMap::value_type*> vEntries(nCount);
+
+	mapIndex.reserve(nCount);
+
+	for (uint32_t i = 0; i < nCount; i++)
+	{
+		const unsigned char* r = pRecords + i * RECORD_SIZE;
+		uint32_t nPrev = ReadLE32(r + 32);
+		uint32_t nNext = ReadLE32(r + 36);
+		uint256 hash;
+
+		ReadHash(r, hash);
+
+		if ((nPrev != NO_RECORD && nPrev >= nCount) || (nNext != NO_RECORD && nNext >= nCount) || hash == 0)
+		{
+			mapIndex.clear();
+
+			return IncorrectFormat;
+		}
+
+		std::pair<CBlockIndexMap::iterator, bool> ret = mapIndex.insert(std::make_pair(hash, (CBlockIndex*)NULL));
+
+		if (!ret.second)
+		{
+			mapIndex.clear();
+
+			return IncorrectFormat;
+		}
+
+		// entries are not moved by later inserts, iterators are
+		vEntries[i] = &*ret.first;
+	}
+
+	// Entries come from the block index arena, in file order
+	std::vector<CBlockIndex*> vIndex(nCount);
+	for (uint32_t i = 0; i < nCount; i++)
+	{
+		vIndex[i] = new CBlockIndex();
+		vEntries[i]->second = vIndex[i];
+	}
+
+	for (uint32_t i = 0; i < nCount; i++)
+	{
+		const unsigned char* r = pRecords + i * RECORD_SIZE;
+		CBlockIndex* pindex = vIndex[i];
+		uint32_t nPrev = ReadLE32(r + 32);
+		uint32_t nNext = ReadLE32(r + 36);
+
+		pindex->phashBlock     = &vEntries[i]->first;
+		pindex->pprev          = nPrev == NO_RECORD ? NULL : vIndex[nPrev];
+		pindex->pnext          = nNext == NO_RECORD ? NULL : vIndex[nNext];
+		pindex->nFile          = ReadLE32(r + 40);
+		pindex->nBlockPos      = ReadLE32(r + 44);
+		pindex->nHeight        = ReadLE32(r + 48);
+		pindex->nMint          = ReadLE64(r + 52);
+		pindex->nMoneySupply   = ReadLE64(r + 60);
+		pindex->nFlags         = ReadLE32(r + 68);
+		pindex->nStakeModifier = ReadLE64(r + 72);
+		ReadHash(r + 80, pindex->bnStakeModifierV2);
+		ReadHash(r + 112, pindex->prevoutStake.hash);
+		pindex->prevoutStake.n = ReadLE32(r + 144);
+		pindex->nStakeTime     = ReadLE32(r + 148);
+		ReadHash(r + 152, pindex->hashProof);
+		pindex->nVersion       = ReadLE32(r + 184);
+		ReadHash(r + 188, pindex->hashMerkleRoot);
+		pindex->nTime          = ReadLE32(r + 220);
+		pindex->nBits          = ReadLE32(r + 224);
+		pindex->nNonce         = ReadLE32(r + 228);
+		ReadHash(r + 232, pindex->nChainTrust);
+	}
+
+	return Ok;
+}
+
+bool CBlockIndexSnapshot::Write(CTxDB& txdb)
+{
+	int64_t nStart = GetTimeMillis();
+	uint64_t nId = GetRand(std::numeric_limits<uint64_t>::max());
+	std::vector<unsigned char> vchData;
+
+	Serialize(mapBlockIndex, hashBestChain, nId, vchData);
+
+	// write to a temporary file first, a torn snapshot is never left behind
+	boost::filesystem::path pathTmp = pathSnapshot;
+	pathTmp += ".new";
+
+	FILE *file = fopen(pathTmp.string().c_str(), "wb");
+
+	if (!file)
+	{
+		return error("%s : Failed to open file %s", __func__, pathTmp.string());
+	}
+
+	if (fwrite(&vchData[0], 1, vchData.size(), file) != vchData.size())
+	{
+		fclose(file);
+
+		return error("%s : I/O error writing %s", __func__, pathTmp.string());
+	}
+
+	FileCommit(file);
+	fclose(file);
+
+	if (!RenameOver(pathTmp, pathSnapshot))
+	{
+		return error("%s : Rename to %s failed", __func__, pathSnapshot.string());
+	}
+
+	// The id goes into the database last: the snapshot is only picked up
+	// again if every index write before it made it to disk
+	if (!txdb.WriteBlockIndexSnapshotId(nId))
+	{
+		return error("%s : Failed to write snapshot id", __func__);
+	}
+
+	LogPrintf("Written %u block index entries to blkindex.snap  %dms\n", mapBlockIndex.size(), GetTimeMillis() - nStart);
+
+	return true;
+}
+
+CBlockIndexSnapshot::ReadResult CBlockIndexSnapshot::Read(CTxDB& txdb)
+{
+	int64_t nStart = GetTimeMillis();
+
+	uint64_t nId;
+	if (!txdb.ReadBlockIndexSnapshotId(nId))
+	{
+		boost::filesystem::remove(pathSnapshot);
+
+		return Stale;
+	}
+
+	// From here on the database can change, the snapshot is not used twice
+	txdb.EraseBlockIndexSnapshotId();
+
+	uint256 hashBest;
+	if (!txdb.ReadHashBestChain(hashBest))
+	{
+		boost::filesystem::remove(pathSnapshot);
+
+		return Stale;
+	}
+
+	FILE *file = fopen(pathSnapshot.string().c_str(), "rb");
+
+	if (!file)
+	{
+		error("%s : Failed to open file %s", __func__, pathSnapshot.string());
+
+		return FileError;
+	}
+
+	// one sequential read of the whole file
+	std::vector<unsigned char> vchData;
+
+	try
+	{
+		vchData.resize(boost::filesystem::file_size(pathSnapshot));
+	}
+	catch (std::exception &e)
+	{
+		fclose(file);
+
+		error("%s : I/O error - %s", __func__, e.what());
+
+		return FileError;
+	}
+
+	bool fRead = vchData.empty() || fread(&vchData[0], 1, vchData.size(), file) == vchData.size();
+
+	fclose(file);
+	boost::filesystem::remove(pathSnapshot);
+
+	if (!fRead)
+	{
+		error("%s : I/O error reading %s", __func__, pathSnapshot.string());
+
+		return FileError;
+	}
+
+	ReadResult result = Deserialize(vchData, hashBest, nId, mapBlockIndex);
+
+	if (result != Ok)
+	{
+		error("%s : Snapshot not usable (%d)", __func__, result);
+
+		return result;
+	}
+
+	LogPrintf("Loaded %u block index entries from blkindex.snap  %dms\n", mapBlockIndex.size(), GetTimeMillis() - nStart);
+
+	return Ok;
+}
@@ -0,0 +1,61 @@
+#ifndef CBLOCKINDEXSNAPSHOT_H
+#define CBLOCKINDEXSNAPSHOT_H
+
+#include <vector>
+#include <stdint.h>
+#include <boost/filesystem/path.hpp>
+
+#include "uint/uint256.h"
+#include "cblockindexmap.h"
+
+class CBlockIndex;
+class CTxDB;
+
+/** Flat file copy of the block index (blkindex.snap), written at shutdown
+ * and read back in one piece on the next start instead of scanning the
+ * blockindex records in LevelDB.
+ *
+ * The snapshot is only used once: reading it erases the id that ties it to
+ * the database, so after a crash or an older client touching the database
+ * the index is loaded from LevelDB again.
+ */
+class CBlockIndexSnapshot
+{
+private:
+	boost::filesystem::path pathSnapshot;
+
+public:
+	enum ReadResult
+	{
+		Ok,
+		FileError,
+		IncorrectHash,
+		IncorrectMagicMessage,
+		IncorrectMagicNumber,
+		IncorrectVersion,
+		IncorrectFormat,
+		Stale
+	};
+
+	static const int CURRENT_VERSION = 1;
+
+	// Fixed size of one block index record, see the layout in cblockindexsnapshot.cpp
+	static const size_t RECORD_SIZE = 264;
+
+	CBlockIndexSnapshot();
+
+	bool Write(CTxDB& txdb);
+	ReadResult Read(CTxDB& txdb);
+
+	/** Snapshot of mapIndex with its checksum, as it is stored in the file */
+	static void Serialize(const CBlockIndexMap& mapIndex, const uint256& hashBest, uint64_t nId,
+			std::vector<unsigned char>& vchData);
+
+	/** Fills the empty mapIndex from a snapshot taken at hashBest with id nId.
+	 * mapIndex is not changed if the snapshot is not usable.
+	 */
+	static ReadResult Deserialize(const std::vector<unsigned char>& vchData, const uint256& hashBest, uint64_t nId,
+			CBlockIndexMap& mapIndex);
+};
+
+#endif // CBLOCKINDEXSNAPSHOT_H
@@ -23,7 +23,7 @@ CBlockLocator::CBlockLocator(const CBlockIndex* pindex)
 
 CBlockLocator::CBlockLocator(uint256 hashBlock)
 {
-	std::map<uint256, CBlockIndex*>::iterator mi = mapBlockIndex.find(hashBlock);
+	CBlockIndexMap::iterator mi = mapBlockIndex.find(hashBlock);
 	
 	if (mi != mapBlockIndex.end())
 	{
@@ -140,7 +140,7 @@ int CBlockLocator::GetDistanceBack()
 	
 	for(const uint256& hash : vHave)
 	{
-		std::map<uint256, CBlockIndex*>::iterator mi = mapBlockIndex.find(hash);
+		CBlockIndexMap::iterator mi = mapBlockIndex.find(hash);
 		
 		if (mi != mapBlockIndex.end())
 		{
@@ -168,7 +168,7 @@ CBlockIndex* CBlockLocator::GetBlockIndex()
 	// Find the first block the caller has in the main chain
 	for(const uint256& hash : vHave)
 	{
-		std::map<uint256, CBlockIndex*>::iterator mi = mapBlockIndex.find(hash);
+		CBlockIndexMap::iterator mi = mapBlockIndex.find(hash);
 		
 		if (mi != mapBlockIndex.end())
 		{
@@ -189,7 +189,7 @@ uint256 CBlockLocator::GetBlockHash()
 	// Find the first block the caller has in the main chain
 	for(const uint256& hash : vHave)
 	{
-		std::map<uint256, CBlockIndex*>::iterator mi = mapBlockIndex.find(hash);
+		CBlockIndexMap::iterator mi = mapBlockIndex.find(hash);
 		
 		if (mi != mapBlockIndex.end())
 		{
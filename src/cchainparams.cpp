@@ -27,12 +27,12 @@ int CChainParams::GetDefaultPort() const
 	return nDefaultPort;
 }
 
-const CBigNum& CChainParams::ProofOfWorkLimit() const
+const arith_uint256& CChainParams::ProofOfWorkLimit() const
 {
 	return bnProofOfWorkLimit;
 }
 
-const CBigNum& CChainParams::ProofOfStakeLimit() const
+const arith_uint256& CChainParams::ProofOfStakeLimit() const
 {
 	return bnProofOfStakeLimit;
 }
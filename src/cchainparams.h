@@ -6,6 +6,7 @@
 
 #include "uint/uint256.h"
 #include "cbignum.h"
+#include "uint/arith_uint256.h"
 #include "message_start_size.h"
 #include "enums/cchainparams_network.h"
 #include "enums/cchainparams_base58type.h"
@@ -32,8 +33,8 @@ protected:
     std::vector<unsigned char> vAlertPubKey;
     int nDefaultPort;
     int nRPCPort;
-    CBigNum bnProofOfWorkLimit;
-    CBigNum bnProofOfStakeLimit;
+    arith_uint256 bnProofOfWorkLimit;
+    arith_uint256 bnProofOfStakeLimit;
     std::string strDataDir;
     std::vector<CDNSSeedData> vSeeds;
     std::vector<unsigned char> base58Prefixes[CChainParams_Base58Type::MAX_BASE58_TYPES];
@@ -56,8 +57,8 @@ public:
     const MessageStartChars& MessageStart() const;
     const std::vector<unsigned char>& AlertKey() const;
     int GetDefaultPort() const;
-	const CBigNum& ProofOfWorkLimit() const;
-    const CBigNum& ProofOfStakeLimit() const;
+	const arith_uint256& ProofOfWorkLimit() const;
+    const arith_uint256& ProofOfStakeLimit() const;
     virtual bool RequireRPCPassword() const;
     const std::string& DataDir() const;
 	const std::vector<CDNSSeedData>& DNSSeeds() const;
@@ -78,10 +78,6 @@ uint256 CConsensusVote::GetHash() const
 
 bool CConsensusVote::SignatureValid()
 {
-    std::string errorMessage;
-    std::string strMessage = txHash.ToString().c_str() + boost::lexical_cast<std::string>(nBlockHeight);
-    //LogPrintf("verify strMessage %s \n", strMessage.c_str());
-
     CMasternode* pmn = mnodeman.Find(vinMasternode);
 
     if(pmn == NULL)
@@ -91,7 +87,16 @@ bool CConsensusVote::SignatureValid()
         return false;
     }
 
-    if(!mnEngineSigner.VerifyMessage(pmn->pubkey2, vchMasterNodeSignature, strMessage, errorMessage))
+    return SignatureValid(pmn->pubkey2);
+}
+
+bool CConsensusVote::SignatureValid(const CPubKey& pubkeyMasternode)
+{
+    std::string errorMessage;
+    std::string strMessage = txHash.ToString().c_str() + boost::lexical_cast<std::string>(nBlockHeight);
+    //LogPrintf("verify strMessage %s \n", strMessage.c_str());
+
+    if(!mnEngineSigner.VerifyMessage(pubkeyMasternode, vchMasterNodeSignature, strMessage, errorMessage))
 	{
         LogPrintf("InstantX::CConsensusVote::SignatureValid() - Verify message failed\n");
         
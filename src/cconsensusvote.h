@@ -6,6 +6,8 @@
 #include "ctxin.h"
 #include "uint/uint256.h"
 
+class CPubKey;
+
 class CConsensusVote
 {
 public:
@@ -22,6 +24,8 @@ public:
 	
     uint256 GetHash() const;
     bool SignatureValid();
+    // with the key of the masternode already looked up, safe to call from any thread
+    bool SignatureValid(const CPubKey& pubkeyMasternode);
     bool Sign();
 };
 
@@ -0,0 +1,285 @@
+#include "compat.h"
+
+#include <algorithm>
+#include <functional>
+
+#include "util.h"
+#include "thread.h"
+#include "thread/cthreadpool.h"
+#include "net.h"
+#include "net/cnode.h"
+#include "cpubkey.h"
+#include "cmasternode.h"
+#include "cmasternodeman.h"
+#include "masternode.h"
+#include "masternode_extern.h"
+#include "blockparams.h"
+#include "version.h"
+
+#include "cconsensusvotequeue.h"
+
+// below this many signatures a batch is not worth handing to the pool
+static const size_t MIN_PARALLEL_VOTES = 4;
+// rank tables are rebuilt after this long, masternodes can stop being enabled
+static const int64_t RANK_TABLE_SECONDS = 60;
+static const size_t MAX_RANK_TABLES = 16;
+
+CConsensusVoteQueue::Item::Item(const CConsensusVote& voteIn, CNode* pfromIn, int64_t nTimeReceivedIn)
+		: vote(voteIn), pfrom(pfromIn), nTimeReceived(nTimeReceivedIn), nRank(-1), fSignatureValid(false)
+{
+
+}
+
+CConsensusVoteQueue::Stats::Stats() : nVotes(0), nUnknown(0), nNotInTop(0), nBadSignature(0), nCounted(0), nBatches(0),
+		nRankTables(0), nVerifyMicros(0), nWaitMicros(0), nLocks(0), nLockMicros(0), nMaxLockMicros(0)
+{
+
+}
+
+CConsensusVoteQueue::CConsensusVoteQueue()
+{
+
+}
+
+CConsensusVoteQueue::~CConsensusVoteQueue()
+{
+	StopThreads();
+}
+
+void CConsensusVoteQueue::StartThreads(int nThreads)
+{
+	StopThreads();
+
+	if (nThreads > 1)
+	{
+		pool.reset(new CThreadPool("ixverify", nThreads));
+	}
+}
+
+void CConsensusVoteQueue::StopThreads()
+{
+	if (pool)
+	{
+		pool->Stop();
+		pool.reset();
+	}
+}
+
+void CConsensusVoteQueue::Push(CNode* pfrom, const CConsensusVote& vote)
+{
+	{
+		LOCK(cs_vNodes);
+
+		pfrom->AddRef();
+	}
+
+	LOCK(cs);
+
+	vPending.push_back(Item(vote, pfrom, GetTimeMicros()));
+}
+
+bool CConsensusVoteQueue::Empty() const
+{
+	LOCK(cs);
+
+	return vPending.empty();
+}
+
+const CConsensusVoteQueue::RankTable* CConsensusVoteQueue::GetRankTable(int nBlockHeight)
+{
+	uint256 hashBlock = 0;
+
+	if (!GetBlockHash(hashBlock, nBlockHeight))
+	{
+		return NULL;
+	}
+
+	int nMasternodes = mnodeman.size();
+	std::map<int, RankTable>::iterator it = mapRankTables.find(nBlockHeight);
+
+	if (it != mapRankTables.end() &&
+		it->second.hashBlock == hashBlock &&
+		it->second.nMasternodes == nMasternodes &&
+		GetTime() - it->second.nTimeCreated < RANK_TABLE_SECONDS)
+	{
+		return &it->second;
+	}
+
+	RankTable& table = mapRankTables[nBlockHeight];
+
+	table.hashBlock = hashBlock;
+	table.nMasternodes = nMasternodes;
+	table.nTimeCreated = GetTime();
+
+	if (!mnodeman.GetMasternodeRankTable(nBlockHeight, MIN_INSTANTX_PROTO_VERSION, table.mapRanks))
+	{
+		mapRankTables.erase(nBlockHeight);
+
+		return NULL;
+	}
+
+	{
+		LOCK(cs);
+
+		stats.nRankTables++;
+	}
+
+	// Votes are for recent heights, the lowest one is the least likely to be asked for again
+	while (mapRankTables.size() > MAX_RANK_TABLES)
+	{
+		std::map<int, RankTable>::iterator itOldest = mapRankTables.begin();
+
+		if (itOldest->first == nBlockHeight)
+		{
+			itOldest++;
+		}
+
+		mapRankTables.erase(itOldest);
+	}
+
+	return &mapRankTables[nBlockHeight];
+}
+
+void CConsensusVoteQueue::Verify(std::vector<Item>& vItems)
+{
+	vItems.clear();
+
+	{
+		LOCK(cs);
+
+		vItems.swap(vPending);
+	}
+
+	if (vItems.empty())
+	{
+		return;
+	}
+
+	int64_t nTimeStart = GetTimeMicros();
+	uint64_t nUnknown = 0;
+	uint64_t nNotInTop = 0;
+
+	// The votes from the top masternodes, with the key each one has to be signed with
+	std::vector<size_t> vCheck;
+	std::vector<CPubKey> vPubKeys;
+
+	for (size_t i = 0; i < vItems.size(); i++)
+	{
+		Item& item = vItems[i];
+		const RankTable* ptable = GetRankTable(item.vote.nBlockHeight);
+
+		if (ptable != NULL)
+		{
+			std::map<COutPoint, int>::const_iterator mi = ptable->mapRanks.find(item.vote.vinMasternode.prevout);
+
+			if (mi != ptable->mapRanks.end())
+			{
+				item.nRank = mi->second;
+			}
+		}
+
+		if (item.nRank == -1)
+		{
+			nUnknown++;
+
+			continue;
+		}
+
+		if (item.nRank > INSTANTX_SIGNATURES_TOTAL)
+		{
+			nNotInTop++;
+
+			continue;
+		}
+
+		CMasternode* pmn = mnodeman.Find(item.vote.vinMasternode);
+
+		if (pmn == NULL)
+		{
+			continue;
+		}
+
+		vCheck.push_back(i);
+		vPubKeys.push_back(pmn->pubkey2);
+	}
+
+	std::function<void(size_t)> fnVerify = [&vItems, &vCheck, &vPubKeys](size_t n)
+	{
+		Item& item = vItems[vCheck[n]];
+
+		item.fSignatureValid = item.vote.SignatureValid(vPubKeys[n]);
+	};
+
+	if (pool && vCheck.size() >= MIN_PARALLEL_VOTES)
+	{
+		pool->ParallelFor(vCheck.size(), fnVerify);
+	}
+	else
+	{
+		for (size_t n = 0; n < vCheck.size(); n++)
+		{
+			fnVerify(n);
+		}
+	}
+
+	uint64_t nBadSignature = 0;
+
+	for (size_t i = 0; i < vItems.size(); i++)
+	{
+		if (vItems[i].nRank != -1 && vItems[i].nRank <= INSTANTX_SIGNATURES_TOTAL && !vItems[i].fSignatureValid)
+		{
+			nBadSignature++;
+		}
+	}
+
+	LOCK(cs);
+
+	stats.nVotes += vItems.size();
+	stats.nUnknown += nUnknown;
+	stats.nNotInTop += nNotInTop;
+	stats.nBadSignature += nBadSignature;
+	stats.nBatches++;
+	stats.nVerifyMicros += GetTimeMicros() - nTimeStart;
+}
+
+void CConsensusVoteQueue::Clear()
+{
+	std::vector<Item> vItems;
+
+	{
+		LOCK(cs);
+
+		vItems.swap(vPending);
+	}
+
+	LOCK(cs_vNodes);
+
+	for (Item& item : vItems)
+	{
+		item.pfrom->Release();
+	}
+}
+
+void CConsensusVoteQueue::RecordCounted(int64_t nWaitMicros)
+{
+	LOCK(cs);
+
+	stats.nCounted++;
+	stats.nWaitMicros += nWaitMicros;
+}
+
+void CConsensusVoteQueue::RecordLock(int64_t nLockMicros)
+{
+	LOCK(cs);
+
+	stats.nLocks++;
+	stats.nLockMicros += nLockMicros;
+	stats.nMaxLockMicros = std::max(stats.nMaxLockMicros, nLockMicros);
+}
+
+CConsensusVoteQueue::Stats CConsensusVoteQueue::GetStats() const
+{
+	LOCK(cs);
+
+	return stats;
+}
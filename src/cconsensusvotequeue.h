@@ -0,0 +1,109 @@
+#ifndef CCONSENSUSVOTEQUEUE_H
+#define CCONSENSUSVOTEQUEUE_H
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "cconsensusvote.h"
+#include "ctxin.h"
+#include "uint/uint256.h"
+#include "types/ccriticalsection.h"
+
+class CNode;
+class CThreadPool;
+
+/** InstantX votes waiting to be checked and counted.
+ *
+ * Votes come in faster than they can be checked one by one: a single lock
+ * brings INSTANTX_SIGNATURES_TOTAL votes, each relayed by several peers.
+ * The message handler queues them and, once per pass over its peers, Verify
+ * checks the whole batch. Ranks come from a table kept per block height, so
+ * the masternode scores are computed once per height rather than once per
+ * vote, and the signatures of the votes that pass go to worker threads.
+ * Counting the votes that verified is left to the caller, on its own thread.
+ */
+class CConsensusVoteQueue
+{
+public:
+	class Item
+	{
+	public:
+		CConsensusVote	vote;
+		CNode*			pfrom;
+		int64_t			nTimeReceived;
+		// -1 for an unknown masternode or block
+		int				nRank;
+		bool			fSignatureValid;
+
+		Item(const CConsensusVote& voteIn, CNode* pfromIn, int64_t nTimeReceivedIn);
+	};
+
+	class Stats
+	{
+	public:
+		uint64_t	nVotes;
+		uint64_t	nUnknown;
+		uint64_t	nNotInTop;
+		uint64_t	nBadSignature;
+		uint64_t	nCounted;
+		uint64_t	nBatches;
+		uint64_t	nRankTables;
+		int64_t		nVerifyMicros;
+		int64_t		nWaitMicros;
+		uint64_t	nLocks;
+		int64_t		nLockMicros;
+		int64_t		nMaxLockMicros;
+
+		Stats();
+	};
+
+private:
+	class RankTable
+	{
+	public:
+		uint256						hashBlock;
+		int							nMasternodes;
+		int64_t						nTimeCreated;
+		std::map<COutPoint, int>	mapRanks;
+	};
+
+	mutable CCriticalSection		cs;
+	std::vector<Item>				vPending;
+	Stats							stats;
+	std::unique_ptr<CThreadPool>	pool;
+
+	// Only used from the thread calling Verify
+	std::map<int, RankTable>		mapRankTables;
+
+	const RankTable* GetRankTable(int nBlockHeight);
+
+public:
+	CConsensusVoteQueue();
+	~CConsensusVoteQueue();
+
+	void StartThreads(int nThreads);
+	void StopThreads();
+
+	/** Queues a vote, holding a reference to the node it came from */
+	void Push(CNode* pfrom, const CConsensusVote& vote);
+	bool Empty() const;
+
+	/** Takes every queued vote and fills in its rank and, for the ones in the
+	 *  top INSTANTX_SIGNATURES_TOTAL, whether its signature is valid. The
+	 *  caller releases the nodes. */
+	void Verify(std::vector<Item>& vItems);
+
+	/** Drops the queued votes, releasing their nodes */
+	void Clear();
+
+	/** A vote was counted after waiting nWaitMicros in the queue */
+	void RecordCounted(int64_t nWaitMicros);
+	/** A lock got its last required vote nLockMicros after its first one */
+	void RecordLock(int64_t nLockMicros);
+
+	Stats GetStats() const;
+};
+
+#endif // CCONSENSUSVOTEQUEUE_H
@@ -102,6 +102,61 @@ bool CCryptoKeyStore::AddKeyPubKey(const CKey& key, const CPubKey &pubkey)
     return true;
 }
 
+bool CCryptoKeyStore::AddKeyPubKey(const CKey& key, const CPubKey &pubkey, const std::vector<unsigned char> &vchCryptedSecret)
+{
+    {
+        LOCK(cs_KeyStore);
+		
+        if (!IsCrypted())
+		{
+            return CBasicKeyStore::AddKeyPubKey(key, pubkey);
+		}
+		
+        if (IsLocked() || vchCryptedSecret.empty())
+		{
+            return false;
+		}
+		
+        if (!AddCryptedKey(pubkey, vchCryptedSecret))
+		{
+            return false;
+		}
+    }
+	
+    return true;
+}
+
+bool CCryptoKeyStore::EncryptKey(const CKey& key, const CPubKey &pubkey, std::vector<unsigned char> &vchCryptedSecret) const
+{
+    vchCryptedSecret.clear();
+	
+    {
+        LOCK(cs_KeyStore);
+		
+        if (!IsCrypted())
+		{
+            return true;
+		}
+		
+        if (IsLocked())
+		{
+            return false;
+		}
+		
+        CKeyingMaterial vchSecret(key.begin(), key.end());
+        
+		return EncryptSecret(vMasterKey, vchSecret, pubkey.GetHash(), vchCryptedSecret);
+    }
+}
+
+void CCryptoKeyStore::RemoveKey(const CKeyID &address)
+{
+	LOCK(cs_KeyStore);
+	
+	mapKeys.erase(address);
+	mapCryptedKeys.erase(address);
+}
+
 bool CCryptoKeyStore::HaveKey(const CKeyID &address) const
 {
 	{
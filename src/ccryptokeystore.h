@@ -33,6 +33,9 @@ protected:
 
     bool Unlock(const CKeyingMaterial& vMasterKeyIn);
 
+    // Drops a key whose write to disk was rolled back
+    void RemoveKey(const CKeyID &address);
+
 public:
     CCryptoKeyStore();
 	
@@ -42,6 +45,12 @@ public:
 
     virtual bool AddCryptedKey(const CPubKey &vchPubKey, const std::vector<unsigned char> &vchCryptedSecret);
     bool AddKeyPubKey(const CKey& key, const CPubKey &pubkey);
+    // Same with the secret already encrypted by EncryptKey, which is not
+    // looked at if the store is not crypted
+    bool AddKeyPubKey(const CKey& key, const CPubKey &pubkey, const std::vector<unsigned char> &vchCryptedSecret);
+    // Encrypts the secret of key as AddKeyPubKey would, vchCryptedSecret is
+    // left empty if the store is not crypted. Safe to call from any thread.
+    bool EncryptKey(const CKey& key, const CPubKey &pubkey, std::vector<unsigned char> &vchCryptedSecret) const;
     bool HaveKey(const CKeyID &address) const;
     bool GetKey(const CKeyID &address, CKey& keyOut) const;
     bool GetPubKey(const CKeyID &address, CPubKey& vchPubKeyOut) const;
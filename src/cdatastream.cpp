@@ -17,6 +17,7 @@
 #include "cpubkey.h"
 #include "cmasternodepaymentwinner.h"
 #include "cmasternodeman.h"
+#include "cmasternode.h"
 #include "cscript.h"
 #include "net/cservice.h"
 #include "ctxout.h"
@@ -54,6 +55,11 @@ CDataStream::CDataStream(int nTypeIn, int nVersionIn)
 	Init(nTypeIn, nVersionIn);
 }
 
+CDataStream::CDataStream(int nTypeIn, int nVersionIn, const vector_type::allocator_type& alloc) : vch(alloc)
+{
+	Init(nTypeIn, nVersionIn);
+}
+
 CDataStream::CDataStream(CDataStream::const_iterator pbegin, CDataStream::const_iterator pend, int nTypeIn, int nVersionIn) : vch(pbegin, pend)
 {
 	Init(nTypeIn, nVersionIn);
@@ -506,6 +512,7 @@ template CDataStream& CDataStream::operator<< <CKeyID>(CKeyID const&);
 template CDataStream& CDataStream::operator<< <CPubKey>(CPubKey const&);
 template CDataStream& CDataStream::operator<< <CMasternodePaymentWinner>(CMasternodePaymentWinner const&);
 template CDataStream& CDataStream::operator<< <CMasternodeMan>(CMasternodeMan const&);
+template CDataStream& CDataStream::operator<< <CMasternode>(CMasternode const&);
 template CDataStream& CDataStream::operator<< <CTxIn>(CTxIn const&);
 template CDataStream& CDataStream::operator<< <CScript>(CScript const&);
 template CDataStream& CDataStream::operator<< <CService>(CService const&);
@@ -575,6 +582,7 @@ template CDataStream& CDataStream::operator>><CKeyMetadata>(CKeyMetadata&);
 template CDataStream& CDataStream::operator>><CKeyPool>(CKeyPool&);
 template CDataStream& CDataStream::operator>><CMasterKey>(CMasterKey&);
 template CDataStream& CDataStream::operator>><CMasternodeMan>(CMasternodeMan&);
+template CDataStream& CDataStream::operator>><CMasternode>(CMasternode&);
 template CDataStream& CDataStream::operator>><CMessageHeader>(CMessageHeader&);
 template CDataStream& CDataStream::operator>><CMasternodePaymentWinner>(CMasternodePaymentWinner&);
 template CDataStream& CDataStream::operator>><CPubKey>(CPubKey&);
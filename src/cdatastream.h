@@ -17,6 +17,9 @@ protected:
 	unsigned int nReadPos;
 	short state;
 	short exceptmask;
+	
+	CDataStream(int nTypeIn, int nVersionIn, const vector_type::allocator_type& alloc);
+	
 public:
 	int nType;
 	int nVersion;
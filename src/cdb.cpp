@@ -21,7 +21,8 @@
 #include "cmasterkey.h"
 #include "ckeyid.h"
 #include "version.h"
-#include "cdatastream.h"
+#include "csecuredatastream.h"
+#include "cdbbatch.h"
 
 #include "cdb.h"
 
@@ -129,14 +130,18 @@ void CDB::Close()
 	activeTxn = NULL;
     pdb = NULL;
 
-    // Flush database activity from memory pool to disk log
+    // Flush database activity from memory pool to disk log, a batch does it
+    // once when it commits
     unsigned int nMinutes = 0;
     if (fReadOnly)
 	{
         nMinutes = 1;
 	}
 	
-    bitdb.dbenv.txn_checkpoint(nMinutes ? GetArg("-dblogsize", 100)*1024 : 0, nMinutes, 0);
+    if (!CDBBatch::GetTxn(strFile))
+	{
+        bitdb.dbenv.txn_checkpoint(nMinutes ? GetArg("-dblogsize", 100)*1024 : 0, nMinutes, 0);
+	}
 
     {
         LOCK(bitdb.cs_db);
@@ -154,7 +159,7 @@ bool CDB::Read(const K& key, T& value)
 	}
 	
 	// Key
-	CDataStream ssKey(SER_DISK, CLIENT_VERSION);
+	CSecureDataStream ssKey(SER_DISK, CLIENT_VERSION);
 	
 	ssKey.reserve(1000);
 	ssKey << key;
@@ -164,7 +169,7 @@ bool CDB::Read(const K& key, T& value)
 	// Read
 	Dbt datValue;
 	datValue.set_flags(DB_DBT_MALLOC);
-	int ret = pdb->get(activeTxn, &datKey, &datValue, 0);
+	int ret = pdb->get(GetTxn(), &datKey, &datValue, 0);
 	
 	memset(datKey.get_data(), 0, datKey.get_size());
 	
@@ -176,7 +181,7 @@ bool CDB::Read(const K& key, T& value)
 	// Unserialize value
 	try
 	{
-		CDataStream ssValue((char*)datValue.get_data(), (char*)datValue.get_data() + datValue.get_size(), SER_DISK, CLIENT_VERSION);
+		CSecureDataStream ssValue((char*)datValue.get_data(), (char*)datValue.get_data() + datValue.get_size(), SER_DISK, CLIENT_VERSION);
 		
 		ssValue >> value;
 	}
@@ -212,7 +217,7 @@ bool CDB::Write(const K& key, const T& value, bool fOverwrite)
 	}
 	
 	// Key
-	CDataStream ssKey(SER_DISK, CLIENT_VERSION);
+	CSecureDataStream ssKey(SER_DISK, CLIENT_VERSION);
 	
 	ssKey.reserve(1000);
 	ssKey << key;
@@ -220,7 +225,7 @@ bool CDB::Write(const K& key, const T& value, bool fOverwrite)
 	Dbt datKey(&ssKey[0], ssKey.size());
 
 	// Value
-	CDataStream ssValue(SER_DISK, CLIENT_VERSION);
+	CSecureDataStream ssValue(SER_DISK, CLIENT_VERSION);
 	
 	ssValue.reserve(10000);
 	ssValue << value;
@@ -228,7 +233,7 @@ bool CDB::Write(const K& key, const T& value, bool fOverwrite)
 	Dbt datValue(&ssValue[0], ssValue.size());
 
 	// Write
-	int ret = pdb->put(activeTxn, &datKey, &datValue, (fOverwrite ? 0 : DB_NOOVERWRITE));
+	int ret = pdb->put(GetTxn(), &datKey, &datValue, (fOverwrite ? 0 : DB_NOOVERWRITE));
 
 	// Clear memory in case it was a private key
 	memset(datKey.get_data(), 0, datKey.get_size());
@@ -271,7 +276,7 @@ bool CDB::Erase(const K& key)
 	}
 	
 	// Key
-	CDataStream ssKey(SER_DISK, CLIENT_VERSION);
+	CSecureDataStream ssKey(SER_DISK, CLIENT_VERSION);
 	
 	ssKey.reserve(1000);
 	ssKey << key;
@@ -279,7 +284,7 @@ bool CDB::Erase(const K& key)
 	Dbt datKey(&ssKey[0], ssKey.size());
 
 	// Erase
-	int ret = pdb->del(activeTxn, &datKey, 0);
+	int ret = pdb->del(GetTxn(), &datKey, 0);
 
 	// Clear memory
 	memset(datKey.get_data(), 0, datKey.get_size());
@@ -304,7 +309,7 @@ bool CDB::Exists(const K& key)
 	}
 	
 	// Key
-	CDataStream ssKey(SER_DISK, CLIENT_VERSION);
+	CSecureDataStream ssKey(SER_DISK, CLIENT_VERSION);
 	
 	ssKey.reserve(1000);
 	ssKey << key;
@@ -312,7 +317,7 @@ bool CDB::Exists(const K& key)
 	Dbt datKey(&ssKey[0], ssKey.size());
 
 	// Exists
-	int ret = pdb->exists(activeTxn, &datKey, 0);
+	int ret = pdb->exists(GetTxn(), &datKey, 0);
 
 	// Clear memory
 	memset(datKey.get_data(), 0, datKey.get_size());
@@ -320,6 +325,11 @@ bool CDB::Exists(const K& key)
 	return (ret == 0);
 }
 
+DbTxn* CDB::GetTxn()
+{
+	return activeTxn ? activeTxn : CDBBatch::GetTxn(strFile);
+}
+
 Dbc* CDB::GetCursor()
 {
 	if (!pdb)
@@ -328,7 +338,7 @@ Dbc* CDB::GetCursor()
 	}
 	
 	Dbc* pcursor = NULL;
-	int ret = pdb->cursor(NULL, &pcursor, 0);
+	int ret = pdb->cursor(GetTxn(), &pcursor, 0);
 	
 	if (ret != 0)
 	{
@@ -397,7 +407,8 @@ bool CDB::TxnBegin()
 		return false;
 	}
 	
-	DbTxn* ptxn = bitdb.TxnBegin();
+	// nested in the batch of this thread, if there is one
+	DbTxn* ptxn = bitdb.TxnBegin(DB_TXN_WRITE_NOSYNC, CDBBatch::GetTxn(strFile));
 	
 	if (!ptxn)
 	{
@@ -493,8 +504,8 @@ bool CDB::Rewrite(const std::string& strFile, const char* pszSkip)
 					{
                         while (fSuccess)
                         {
-                            CDataStream ssKey(SER_DISK, CLIENT_VERSION);
-                            CDataStream ssValue(SER_DISK, CLIENT_VERSION);
+                            CSecureDataStream ssKey(SER_DISK, CLIENT_VERSION);
+                            CSecureDataStream ssValue(SER_DISK, CLIENT_VERSION);
                             
 							int ret = db.ReadAtCursor(pcursor, ssKey, ssValue, DB_NEXT);
                             
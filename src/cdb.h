@@ -37,6 +37,9 @@ protected:
     template<typename K>
     bool Exists(const K& key);
     
+	// activeTxn, or the transaction of a CDBBatch this thread holds on the file
+	DbTxn* GetTxn();
+    
 	Dbc* GetCursor();
     int ReadAtCursor(Dbc* pcursor, CDataStream& ssKey, CDataStream& ssValue, unsigned int fFlags=DB_NEXT);
 
@@ -0,0 +1,117 @@
+#include "compat.h"
+
+#include <map>
+#include <boost/thread/tss.hpp>
+#include <db_cxx.h>
+
+#include "util.h"
+#include "thread.h"
+#include "db.h"
+#include "cdbenv.h"
+
+#include "cdbbatch.h"
+
+// Open batches of this thread by file
+static boost::thread_specific_ptr<std::map<std::string, DbTxn*> > ptrBatches;
+
+CDBBatch::CDBBatch(const std::string& strFileIn) : ptxn(NULL)
+{
+	if (strFileIn.empty() || GetTxn(strFileIn))
+	{
+		return; // not file backed, or nested in a batch on the same file
+	}
+	
+	{
+		LOCK(bitdb.cs_db);
+		
+		if (!bitdb.Open(GetDataDir()))
+		{
+			throw std::runtime_error("env open failed");
+		}
+		
+		// keeps the flush thread from closing the file under the transaction
+		++bitdb.mapFileUseCount[strFileIn];
+	}
+	
+	ptxn = bitdb.TxnBegin();
+	strFile = strFileIn;
+	
+	if (!ptxn)
+	{
+		LogPrintf("CDBBatch : cannot begin a transaction on %s, writing record by record\n", strFile);
+		
+		Release();
+		
+		return;
+	}
+	
+	if (!ptrBatches.get())
+	{
+		ptrBatches.reset(new std::map<std::string, DbTxn*>());
+	}
+	
+	(*ptrBatches)[strFile] = ptxn;
+}
+
+CDBBatch::~CDBBatch()
+{
+	if (!ptxn)
+	{
+		return;
+	}
+	
+	LogPrintf("CDBBatch : rolling back the uncommitted writes to %s\n", strFile);
+	
+	ptrBatches->erase(strFile);
+	ptxn->abort();
+	ptxn = NULL;
+	
+	Release();
+}
+
+bool CDBBatch::Commit()
+{
+	if (!ptxn)
+	{
+		return true;
+	}
+	
+	ptrBatches->erase(strFile);
+	
+	int ret = ptxn->commit(0);
+	
+	ptxn = NULL;
+	
+	// what CDB::Close does for every handle that wrote
+	bitdb.dbenv.txn_checkpoint(0, 0, 0);
+	
+	Release();
+	
+	if (ret != 0)
+	{
+		return error("CDBBatch::Commit() : %s on %s", DbEnv::strerror(ret), strFile);
+	}
+	
+	return true;
+}
+
+void CDBBatch::Release()
+{
+	LOCK(bitdb.cs_db);
+	
+	--bitdb.mapFileUseCount[strFile];
+}
+
+DbTxn* CDBBatch::GetTxn(const std::string& strFile)
+{
+	std::map<std::string, DbTxn*>* pmapBatches = ptrBatches.get();
+	
+	if (!pmapBatches || pmapBatches->empty())
+	{
+		return NULL;
+	}
+	
+	std::map<std::string, DbTxn*>::const_iterator mi = pmapBatches->find(strFile);
+	
+	return mi == pmapBatches->end() ? NULL : mi->second;
+}
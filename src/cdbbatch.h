@@ -0,0 +1,46 @@
+#ifndef CDBBATCH_H
+#define CDBBATCH_H
+
+#include <string>
+
+class DbTxn;
+
+/** Groups the writes this thread makes to one database file into a single
+ * Berkeley DB transaction while it is in scope, so a keypool refill or a
+ * rescan costs one commit and one checkpoint instead of one per record.
+ *
+ * Every CDB on the file used by the thread in the meantime reads and writes
+ * inside the transaction, whenever it was opened. Batches nest, only the
+ * outermost one commits.
+ *
+ * Other threads writing the file wait for the page locks of the batch, so it
+ * must be held under the lock that orders the writers of the file, cs_wallet
+ * for wallet.dat.
+ *
+ * The writes are kept only once Commit() succeeds. A batch that goes out of
+ * scope without a Commit(), on an early return or an exception, is rolled
+ * back.
+ */
+class CDBBatch
+{
+private:
+	std::string strFile;
+	DbTxn* ptxn;
+	
+	CDBBatch(const CDBBatch&);
+	void operator=(const CDBBatch&);
+	
+	void Release();
+
+public:
+	explicit CDBBatch(const std::string& strFileIn);
+	~CDBBatch();
+	
+	/** Commits the batch, the writes after it are not batched */
+	bool Commit();
+	
+	/** Transaction of the batch this thread holds on strFile, if any */
+	static DbTxn* GetTxn(const std::string& strFile);
+};
+
+#endif // CDBBATCH_H
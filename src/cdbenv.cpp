@@ -360,10 +360,10 @@ bool CDBEnv::RemoveDb(const std::string& strFile)
 	return (rc == 0);
 }
 
-DbTxn* CDBEnv::TxnBegin(int flags)
+DbTxn* CDBEnv::TxnBegin(int flags, DbTxn* pparent)
 {
 	DbTxn* ptxn = NULL;
-	int ret = dbenv.txn_begin(NULL, &ptxn, flags);
+	int ret = dbenv.txn_begin(pparent, &ptxn, flags);
 	
 	if (!ptxn || ret != 0)
 	{
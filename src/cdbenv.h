@@ -59,7 +59,7 @@ public:
     void CloseDb(const std::string& strFile);
     bool RemoveDb(const std::string& strFile);
 
-    DbTxn *TxnBegin(int flags=DB_TXN_WRITE_NOSYNC);
+    DbTxn *TxnBegin(int flags=DB_TXN_WRITE_NOSYNC, DbTxn *pparent=NULL);
 };
 
 #endif // CDBENV_H
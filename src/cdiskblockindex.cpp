@@ -1,5 +1,10 @@
 #include "compat.h"
 
+#include <string.h>
+
+#include "crypto/bmw/bmw512.h"
+#include "crypto/common/common.h"
+
 #include "cblock.h"
 #include "enums/serialize_type.h"
 #include "main_extern.h"
@@ -176,26 +181,78 @@ void CDiskBlockIndex::Unserialize(Stream& s, int nType, int nVersion)
 template void CDiskBlockIndex::Serialize<CDataStream>(CDataStream& s, int nType, int nVersion) const;
 template void CDiskBlockIndex::Unserialize<CDataStream>(CDataStream& s, int nType, int nVersion);
 
+bool CDiskBlockIndex::HaveCachedHash() const
+{
+	return fUseFastIndex && (nTime < GetAdjustedTime() - 24 * 60 * 60) && blockHash != 0;
+}
+
+/** The 80 byte header CBlock::GetHash hashes */
+void CDiskBlockIndex::GetHeader(unsigned char* pHeader) const
+{
+	WriteLE32(pHeader, nVersion);
+	memcpy(pHeader + 4, hashPrev.begin(), 32);
+	memcpy(pHeader + 36, hashMerkleRoot.begin(), 32);
+	WriteLE32(pHeader + 68, nTime);
+	WriteLE32(pHeader + 72, nBits);
+	WriteLE32(pHeader + 76, nNonce);
+}
+
 uint256 CDiskBlockIndex::GetBlockHash() const
 {
-	if (fUseFastIndex && (nTime < GetAdjustedTime() - 24 * 60 * 60) && blockHash != 0)
+	if (HaveCachedHash())
 	{
 		return blockHash;
 	}
 	
-	CBlock block;
-	block.nVersion        = nVersion;
-	block.hashPrevBlock   = hashPrev;
-	block.hashMerkleRoot  = hashMerkleRoot;
-	block.nTime           = nTime;
-	block.nBits           = nBits;
-	block.nNonce          = nNonce;
-
-	const_cast<CDiskBlockIndex*>(this)->blockHash = block.GetHash();
+	unsigned char header[80];
+	
+	GetHeader(header);
+	
+	const_cast<CDiskBlockIndex*>(this)->blockHash = Hash_bmw512_80(header);
 
 	return blockHash;
 }
 
+void CDiskBlockIndex::GetBlockHashes(std::vector<CDiskBlockIndex>& vIndex, std::vector<uint256>& vHashOut)
+{
+	std::vector<size_t> vCompute;
+	
+	vHashOut.resize(vIndex.size());
+	
+	for (size_t i = 0; i < vIndex.size(); i++)
+	{
+		if (vIndex[i].HaveCachedHash())
+		{
+			vHashOut[i] = vIndex[i].blockHash;
+		}
+		else
+		{
+			vCompute.push_back(i);
+		}
+	}
+	
+	if (vCompute.empty())
+	{
+		return;
+	}
+	
+	std::vector<unsigned char> vHeaders(80 * vCompute.size());
+	std::vector<uint256> vHashes(vCompute.size());
+	
+	for (size_t i = 0; i < vCompute.size(); i++)
+	{
+		vIndex[vCompute[i]].GetHeader(&vHeaders[80 * i]);
+	}
+	
+	Hash_bmw512_80(&vHeaders[0], vCompute.size(), &vHashes[0]);
+	
+	for (size_t i = 0; i < vCompute.size(); i++)
+	{
+		vIndex[vCompute[i]].blockHash = vHashes[i];
+		vHashOut[vCompute[i]] = vHashes[i];
+	}
+}
+
 std::string CDiskBlockIndex::ToString() const
 {
 	std::string str = "CDiskBlockIndex(";
@@ -2,6 +2,7 @@
 #define CDISKBLOCKINDEX_H
 
 #include <string>
+#include <vector>
 
 #include "cblockindex.h"
 #include "uint/uint256.h"
@@ -12,6 +13,9 @@ class CDiskBlockIndex : public CBlockIndex
 private:
     uint256 blockHash;
 
+    bool HaveCachedHash() const;
+    void GetHeader(unsigned char* pHeader) const;
+
 public:
     uint256 hashPrev;
     uint256 hashNext;
@@ -26,6 +30,9 @@ public:
     void Unserialize(Stream& s, int nType, int nVersion);
 
     uint256 GetBlockHash() const;
+    /** GetBlockHash of every entry, the headers that need hashing are hashed
+     *  several at a time. */
+    static void GetBlockHashes(std::vector<CDiskBlockIndex>& vIndex, std::vector<uint256>& vHashOut);
     std::string ToString() const;
 };
 
@@ -14,12 +14,12 @@ CHashWriter::CHashWriter(int nTypeIn, int nVersionIn) : nType(nTypeIn), nVersion
 
 void CHashWriter::Init()
 {
-	SHA256_Init(&ctx);
+	ctx.Reset();
 }
 
 CHashWriter& CHashWriter::write(const char *pch, size_t size)
 {
-	SHA256_Update(&ctx, pch, size);
+	ctx.Write((const unsigned char*)pch, size);
 	
 	return (*this);
 }
@@ -30,9 +30,9 @@ uint256 CHashWriter::GetHash()
 	uint256 hash1;
 	uint256 hash2;
 	
-	SHA256_Final((unsigned char*)&hash1, &ctx);
+	ctx.Finalize(hash1.begin());
 	
-	SHA256((unsigned char*)&hash1, sizeof(hash1), (unsigned char*)&hash2);
+	CSHA256().Write(hash1.begin(), sizeof(hash1)).Finalize(hash2.begin());
 	
 	return hash2;
 }
@@ -1,14 +1,14 @@
 #ifndef CHASHWRITER_H
 #define CHASHWRITER_H
 
-#include <openssl/sha.h>
+#include "crypto/common/sha256.h"
 
 class uint256;
 
 class CHashWriter
 {
 private:
-    SHA256_CTX ctx;
+    CSHA256 ctx;
 
 public:
     int nType;
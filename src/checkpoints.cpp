@@ -68,14 +68,14 @@ namespace Checkpoints
 		return checkpoints.rbegin()->first;
 	}
 
-	CBlockIndex* GetLastCheckpoint(const std::map<uint256, CBlockIndex*>& mapBlockIndex)
+	CBlockIndex* GetLastCheckpoint(const CBlockIndexMap& mapBlockIndex)
 	{
 		MapCheckpoints& checkpoints = (TestNet() ? mapCheckpointsTestnet : mapCheckpoints);
 
 		for(const MapCheckpoints::value_type& i : backwards<MapCheckpoints>(checkpoints))
 		{
 			const uint256& hash = i.second;
-			std::map<uint256, CBlockIndex*>::const_iterator t = mapBlockIndex.find(hash);
+			CBlockIndexMap::const_iterator t = mapBlockIndex.find(hash);
 			
 			if (t != mapBlockIndex.end())
 			{
@@ -6,6 +6,7 @@
 
 class uint256;
 class CBlockIndex;
+class CBlockIndexMap;
 
 /** Block-chain checkpoints are compiled-in sanity checks.
  * They are updated every release or three.
@@ -21,7 +22,7 @@ namespace Checkpoints
     int GetTotalBlocksEstimate();
 
     // Returns last CBlockIndex* in mapBlockIndex that is a checkpoint
-    CBlockIndex* GetLastCheckpoint(const std::map<uint256, CBlockIndex*>& mapBlockIndex);
+    CBlockIndex* GetLastCheckpoint(const CBlockIndexMap& mapBlockIndex);
 
     const CBlockIndex* AutoSelectSyncCheckpoint();
     bool CheckSync(int nHeight);
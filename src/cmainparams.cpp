@@ -52,8 +52,8 @@ CMainParams::CMainParams()
 	nDefaultPort = 18092;
 	nRPCPort = 18094;
 	
-	bnProofOfWorkLimit = CBigNum(~uint256(0) >> 14);
-	bnProofOfStakeLimit = CBigNum(~uint256(0) >> 16);
+	bnProofOfWorkLimit = ~arith_uint256(0) >> 14;
+	bnProofOfStakeLimit = ~arith_uint256(0) >> 16;
 
 	const char* pszTimestamp = "Elon Musk Wants to Embed AI-on-a-Chip Into Every Human Brain | JP Buntinx | January 18, 2019 | News, Technology | TheMerkle";
 	std::vector<CTxIn> vin;
@@ -0,0 +1,37 @@
+#include "compat.h"
+
+#include <boost/lexical_cast.hpp>
+
+#include "cmnenginesigner.h"
+#include "mnengine_extern.h"
+
+#include "cmasternodebroadcast.h"
+
+CMasternodeBroadcast::CMasternodeBroadcast() : sigTime(0), count(0), current(0), lastUpdated(0), protocolVersion(0),
+		donationPercentage(0), nodeFrom(-1), fSignatureValid(false)
+{
+	
+}
+
+std::string CMasternodeBroadcast::GetSignedMessage() const
+{
+	std::string vchPubKey(pubkey.begin(), pubkey.end());
+	std::string vchPubKey2(pubkey2.begin(), pubkey2.end());
+
+	return addr.ToString() +
+			boost::lexical_cast<std::string>(sigTime) +
+			vchPubKey +
+			vchPubKey2 +
+			boost::lexical_cast<std::string>(protocolVersion) +
+			donationAddress.ToString() +
+			boost::lexical_cast<std::string>(donationPercentage);
+}
+
+bool CMasternodeBroadcast::VerifySignature()
+{
+	std::string errorMessage = "";
+
+	fSignatureValid = mnEngineSigner.VerifyMessage(pubkey, vchSig, GetSignedMessage(), errorMessage);
+
+	return fSignatureValid;
+}
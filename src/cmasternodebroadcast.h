@@ -0,0 +1,48 @@
+#ifndef CMASTERNODEBROADCAST_H
+#define CMASTERNODEBROADCAST_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ctxin.h"
+#include "cpubkey.h"
+#include "script.h"
+#include "net/cnetaddr.h"
+#include "net/cservice.h"
+#include "types/nodeid.h"
+
+/** A "dsee" message: a masternode announcing itself, signed with its collateral key.
+ *  Queued by CMasternodeMan::ProcessMessage and checked in batches, so the
+ *  peer it came from is kept by id and address rather than by pointer.
+ */
+class CMasternodeBroadcast
+{
+public:
+	CTxIn vin;
+	CService addr;
+	std::vector<unsigned char> vchSig;
+	int64_t sigTime;
+	CPubKey pubkey;
+	CPubKey pubkey2;
+	int count;
+	int current;
+	int64_t lastUpdated;
+	int protocolVersion;
+	CScript donationAddress;
+	int donationPercentage;
+
+	NodeId nodeFrom;
+	CNetAddr addrFrom;
+	std::string strSubVerFrom;
+	bool fSignatureValid;
+
+	CMasternodeBroadcast();
+
+	/** The text vchSig signs */
+	std::string GetSignedMessage() const;
+	/** Checks vchSig against pubkey and sets fSignatureValid, safe to call from any thread */
+	bool VerifySignature();
+};
+
+#endif // CMASTERNODEBROADCAST_H
@@ -19,6 +19,8 @@ CMasternodeDB::CMasternodeDB()
 {
     pathMN = GetDataDir() / "mncache.dat";
     strMagicMessage = "MasternodeCache";
+    hashFile = 0;
+    nFileBytes = 0;
 }
 
 bool CMasternodeDB::Write(const CMasternodeMan& mnodemanToSave)
@@ -55,6 +57,9 @@ bool CMasternodeDB::Write(const CMasternodeMan& mnodemanToSave)
     FileCommit(fileout);
     fileout.fclose();
 
+    hashFile = hash;
+    nFileBytes = ssMasternodes.size();
+
     LogPrintf("Written info to mncache.dat  %dms\n", GetTimeMillis() - nStart);
     LogPrintf("  %s\n", mnodemanToSave.ToString());
 
@@ -156,6 +161,9 @@ CMasternodeDB::ReadResult CMasternodeDB::Read(CMasternodeMan& mnodemanToLoad)
 		return IncorrectFormat;
     }
 
+    hashFile = hashIn;
+    nFileBytes = fileSize;
+
     mnodemanToLoad.CheckAndRemove(); // clean out expired
     
 	LogPrintf("Loaded info from mncache.dat  %dms\n", GetTimeMillis() - nStart);
@@ -164,3 +172,12 @@ CMasternodeDB::ReadResult CMasternodeDB::Read(CMasternodeMan& mnodemanToLoad)
     return Ok;
 }
 
+uint256 CMasternodeDB::GetHash() const
+{
+    return hashFile;
+}
+
+uint64_t CMasternodeDB::GetSize() const
+{
+    return nFileBytes;
+}
@@ -1,8 +1,11 @@
 #ifndef MASTERNODEDB_H
 #define MASTERNODEDB_H
 
+#include <cstdint>
 #include <boost/filesystem/path.hpp>
 
+#include "uint/uint256.h"
+
 class CMasternodeMan;
 
 /** Access to the MN database (mncache.dat) */
@@ -11,6 +14,9 @@ class CMasternodeDB
 private:
     boost::filesystem::path pathMN;
     std::string strMagicMessage;
+    // checksum and size of the file last written or read, which the journal refers to
+    uint256 hashFile;
+    uint64_t nFileBytes;
 
 public:
 	enum ReadResult
@@ -28,6 +34,9 @@ public:
     
 	bool Write(const CMasternodeMan &mnodemanToSave);
     ReadResult Read(CMasternodeMan& mnodemanToLoad);
+    
+    uint256 GetHash() const;
+    uint64_t GetSize() const;
 };
 
 #endif // MASTERNODEDB_H
@@ -0,0 +1,352 @@
+#include <algorithm>
+#include <cstring>
+#include <boost/filesystem.hpp>
+
+#include "util.h"
+#include "cchainparams.h"
+#include "chainparams.h"
+#include "hash.h"
+#include "thread.h"
+#include "ctxin.h"
+#include "cmasternode.h"
+#include "cmasternodeman.h"
+#include "cdatastream.h"
+#include "cflatdata.h"
+#include "serialize.h"
+#include "uint/uint256.h"
+
+#include "cmasternodejournal.h"
+
+// a record is its size, its data and the first four bytes of the data's hash
+static const unsigned int MAX_JOURNAL_RECORD_SIZE = 64 * 1024;
+// below this a journal is never worth compacting
+static const uint64_t MIN_COMPACTION_BYTES = 64 * 1024;
+
+static unsigned int RecordChecksum(const CDataStream& ssData)
+{
+	uint256 hash = Hash(ssData.begin(), ssData.end());
+	unsigned int nChecksum = 0;
+
+	memcpy(&nChecksum, &hash, sizeof(nChecksum));
+
+	return nChecksum;
+}
+
+CMasternodeJournal::CMasternodeJournal() : file(NULL), nBytes(0), nRecords(0), nSnapshotBytes(0)
+{
+	strMagicMessage = "MasternodeJournal";
+}
+
+CMasternodeJournal::~CMasternodeJournal()
+{
+	Close();
+}
+
+bool CMasternodeJournal::Start(const uint256& hashSnapshot, uint64_t nSnapshotBytesIn)
+{
+	LOCK(cs);
+
+	Close();
+
+	pathJournal = GetDataDir() / "mncache-journal.dat";
+
+	CDataStream ssHeader(SER_DISK, CLIENT_VERSION);
+
+	ssHeader << strMagicMessage;
+	ssHeader << FLATDATA(Params().MessageStart());
+	ssHeader << hashSnapshot;
+
+	file = fopen(pathJournal.string().c_str(), "wb");
+
+	if (file == NULL)
+	{
+		return error("%s : Failed to open file %s", __func__, pathJournal.string());
+	}
+
+	if (fwrite(&ssHeader[0], 1, ssHeader.size(), file) != ssHeader.size())
+	{
+		Close();
+
+		return error("%s : Failed to write %s", __func__, pathJournal.string());
+	}
+
+	FileCommit(file);
+
+	nBytes = ssHeader.size();
+	nRecords = 0;
+	nSnapshotBytes = nSnapshotBytesIn;
+
+	return true;
+}
+
+int CMasternodeJournal::Replay(const uint256& hashSnapshot, uint64_t nSnapshotBytesIn, CMasternodeMan& mnodemanToLoad)
+{
+	int64_t nStart = GetTimeMillis();
+	std::vector<CDataStream> vRecords;
+
+	if (!Read(hashSnapshot, nSnapshotBytesIn, vRecords))
+	{
+		return -1;
+	}
+
+	// Applied without cs, mnodeman holds its own lock while writing here
+	for (CDataStream& ssRecord : vRecords)
+	{
+		int nType = 0;
+
+		ssRecord >> nType;
+
+		if (nType == RECORD_ENTRY)
+		{
+			CMasternode mn;
+
+			ssRecord >> mn;
+			mnodemanToLoad.Restore(mn);
+		}
+		else
+		{
+			CTxIn vin;
+
+			ssRecord >> vin;
+			mnodemanToLoad.Remove(vin);
+		}
+	}
+
+	LogPrintf("Replayed %u changes from mncache-journal.dat  %dms\n", vRecords.size(), GetTimeMillis() - nStart);
+
+	return (int)vRecords.size();
+}
+
+// Reads the records of the journal for this snapshot and reopens it for appending
+bool CMasternodeJournal::Read(const uint256& hashSnapshot, uint64_t nSnapshotBytesIn, std::vector<CDataStream>& vRecords)
+{
+	LOCK(cs);
+
+	Close();
+
+	pathJournal = GetDataDir() / "mncache-journal.dat";
+
+	boost::system::error_code ec;
+
+	if (!boost::filesystem::exists(pathJournal, ec))
+	{
+		return false;
+	}
+
+	FILE* filein = fopen(pathJournal.string().c_str(), "rb");
+
+	if (filein == NULL)
+	{
+		error("%s : Failed to open file %s", __func__, pathJournal.string());
+
+		return false;
+	}
+
+	std::vector<char> vchData(boost::filesystem::file_size(pathJournal, ec));
+
+	if (ec || (!vchData.empty() && fread(&vchData[0], 1, vchData.size(), filein) != vchData.size()))
+	{
+		fclose(filein);
+
+		error("%s : Failed to read file %s", __func__, pathJournal.string());
+
+		return false;
+	}
+
+	fclose(filein);
+
+	CDataStream ssJournal(vchData, SER_DISK, CLIENT_VERSION);
+	std::string strMagicMessageTmp;
+	unsigned char pchMsgTmp[4];
+	uint256 hashSnapshotTmp;
+
+	try
+	{
+		ssJournal >> strMagicMessageTmp;
+		ssJournal >> FLATDATA(pchMsgTmp);
+		ssJournal >> hashSnapshotTmp;
+	}
+	catch (std::exception &e)
+	{
+		return false;
+	}
+
+	if (strMagicMessageTmp != strMagicMessage ||
+		memcmp(pchMsgTmp, Params().MessageStart(), sizeof(pchMsgTmp)) ||
+		hashSnapshotTmp != hashSnapshot)
+	{
+		LogPrintf("%s : %s is not for this mncache.dat, ignoring it\n", __func__, pathJournal.string());
+
+		return false;
+	}
+
+	// Records up to the first torn or corrupt one, which is where appending resumes
+	uint64_t nGoodBytes = vchData.size() - ssJournal.size();
+
+	while (ssJournal.size() >= 2 * sizeof(unsigned int))
+	{
+		unsigned int nSize = 0;
+		unsigned int nChecksum = 0;
+
+		try
+		{
+			ssJournal >> nSize;
+
+			if (nSize > MAX_JOURNAL_RECORD_SIZE || ssJournal.size() < nSize + sizeof(nChecksum))
+			{
+				break;
+			}
+
+			CDataStream ssRecord(ssJournal.begin(), ssJournal.begin() + nSize, SER_DISK, CLIENT_VERSION);
+
+			ssJournal.ignore(nSize);
+			ssJournal >> nChecksum;
+
+			if (nChecksum != RecordChecksum(ssRecord))
+			{
+				break;
+			}
+
+			// read through once here, so a record that does not parse ends the journal
+			CDataStream ssCheck(ssRecord);
+			int nType = 0;
+
+			ssCheck >> nType;
+
+			if (nType == RECORD_ENTRY)
+			{
+				CMasternode mn;
+
+				ssCheck >> mn;
+			}
+			else if (nType == RECORD_REMOVE)
+			{
+				CTxIn vin;
+
+				ssCheck >> vin;
+			}
+			else
+			{
+				break;
+			}
+
+			vRecords.push_back(ssRecord);
+		}
+		catch (std::exception &e)
+		{
+			break;
+		}
+
+		nGoodBytes += sizeof(nSize) + nSize + sizeof(nChecksum);
+	}
+
+	if (nGoodBytes < vchData.size())
+	{
+		LogPrintf("%s : dropping %u bytes of unreadable records\n", __func__, vchData.size() - nGoodBytes);
+
+		boost::filesystem::resize_file(pathJournal, nGoodBytes, ec);
+	}
+
+	file = fopen(pathJournal.string().c_str(), "ab");
+
+	if (file == NULL)
+	{
+		error("%s : Failed to open file %s", __func__, pathJournal.string());
+
+		return false;
+	}
+
+	nBytes = nGoodBytes;
+	nRecords = vRecords.size();
+	nSnapshotBytes = nSnapshotBytesIn;
+
+	return true;
+}
+
+void CMasternodeJournal::Close()
+{
+	LOCK(cs);
+
+	if (file != NULL)
+	{
+		fclose(file);
+		file = NULL;
+	}
+}
+
+bool CMasternodeJournal::IsOpen() const
+{
+	LOCK(cs);
+
+	return file != NULL;
+}
+
+bool CMasternodeJournal::Append(const CDataStream& ssRecord)
+{
+	LOCK(cs);
+
+	if (file == NULL)
+	{
+		return false;
+	}
+
+	CDataStream ssOut(SER_DISK, CLIENT_VERSION);
+
+	ssOut << (unsigned int)ssRecord.size();
+	ssOut += ssRecord;
+	ssOut << RecordChecksum(ssRecord);
+
+	// A short write leaves a torn record, which Replay stops at
+	if (fwrite(&ssOut[0], 1, ssOut.size(), file) != ssOut.size() || fflush(file) != 0)
+	{
+		Close();
+
+		return error("%s : Failed to write %s", __func__, pathJournal.string());
+	}
+
+	nBytes += ssOut.size();
+	nRecords++;
+
+	return true;
+}
+
+bool CMasternodeJournal::WriteEntry(const CMasternode& mn)
+{
+	CDataStream ssRecord(SER_DISK, CLIENT_VERSION);
+
+	ssRecord << (int)RECORD_ENTRY;
+	ssRecord << mn;
+
+	return Append(ssRecord);
+}
+
+bool CMasternodeJournal::WriteRemove(const CTxIn& vin)
+{
+	CDataStream ssRecord(SER_DISK, CLIENT_VERSION);
+
+	ssRecord << (int)RECORD_REMOVE;
+	ssRecord << vin;
+
+	return Append(ssRecord);
+}
+
+bool CMasternodeJournal::NeedsCompaction() const
+{
+	LOCK(cs);
+
+	return file != NULL && nBytes > std::max(nSnapshotBytes, MIN_COMPACTION_BYTES);
+}
+
+uint64_t CMasternodeJournal::GetBytes() const
+{
+	LOCK(cs);
+
+	return nBytes;
+}
+
+uint64_t CMasternodeJournal::GetRecords() const
+{
+	LOCK(cs);
+
+	return nRecords;
+}
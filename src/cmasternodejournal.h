@@ -0,0 +1,74 @@
+#ifndef CMASTERNODEJOURNAL_H
+#define CMASTERNODEJOURNAL_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <boost/filesystem/path.hpp>
+
+#include "types/ccriticalsection.h"
+
+class uint256;
+class CMasternode;
+class CMasternodeMan;
+class CDataStream;
+class CTxIn;
+
+/** Changes to the masternode list since mncache.dat was written (mncache-journal.dat)
+ *
+ * mncache.dat holds the whole list and is only rewritten at shutdown, or
+ * once this journal has grown larger than it. In between, every entry that
+ * is added, updated or removed is appended here as one checksummed record,
+ * so a node that did not shut down cleanly gets its list back by replaying
+ * them instead of asking peers for all of it. The header carries the hash
+ * of the mncache.dat the records apply to, records written after another
+ * snapshot are never replayed.
+ */
+class CMasternodeJournal
+{
+private:
+	enum RecordType
+	{
+		RECORD_ENTRY = 0,
+		RECORD_REMOVE = 1
+	};
+
+	boost::filesystem::path pathJournal;
+	std::string strMagicMessage;
+
+	mutable CCriticalSection cs;
+	FILE* file;
+	uint64_t nBytes;
+	uint64_t nRecords;
+	uint64_t nSnapshotBytes;
+
+	bool Append(const CDataStream& ssRecord);
+	bool Read(const uint256& hashSnapshot, uint64_t nSnapshotBytesIn, std::vector<CDataStream>& vRecords);
+
+public:
+	CMasternodeJournal();
+	~CMasternodeJournal();
+
+	/** Starts an empty journal for the snapshot with this hash and size */
+	bool Start(const uint256& hashSnapshot, uint64_t nSnapshotBytesIn);
+
+	/** Applies the records written after the snapshot with this hash and keeps
+	 *  the journal open to add to it. Returns the number of records applied,
+	 *  or -1 if there is no journal for this snapshot. */
+	int Replay(const uint256& hashSnapshot, uint64_t nSnapshotBytesIn, CMasternodeMan& mnodemanToLoad);
+
+	void Close();
+	bool IsOpen() const;
+
+	bool WriteEntry(const CMasternode& mn);
+	bool WriteRemove(const CTxIn& vin);
+
+	/** Whether replaying would now cost more than rewriting mncache.dat */
+	bool NeedsCompaction() const;
+
+	uint64_t GetBytes() const;
+	uint64_t GetRecords() const;
+};
+
+#endif // CMASTERNODEJOURNAL_H
@@ -1,5 +1,8 @@
 #include "compat.h"
 
+#include <algorithm>
+#include <functional>
+#include <set>
 #include <boost/lexical_cast.hpp>
 
 #include "main.h"
@@ -31,15 +34,56 @@
 #include "cscriptid.h"
 #include "cstealthaddress.h"
 #include "thread.h"
+#include "thread/cthreadpool.h"
+#include "hash.h"
+#include "cdatastream.h"
+#include "coutpoint.h"
+#include "cmasternodedb.h"
+#include "cmasternodejournal.h"
+#include "cmasternodebroadcast.h"
 
 #include "cmasternodeman.h"
 
 /** Masternode manager */
 CCriticalSection cs_process_message;
 
+// below this many signatures a batch of dsee messages is verified on this thread
+static const size_t MIN_PARALLEL_BROADCASTS = 16;
+// list hashes kept for peers that synced with us, and peer lists we keep
+static const size_t MAX_ANNOUNCED_LIST_HASHES = 128;
+static const size_t MAX_PEER_MASTERNODE_LISTS = 1000;
+
 CMasternodeMan::CMasternodeMan()
 {
 	nDsqCount = 0;
+	nListVersion = 1;
+	nListVersionCached = 0;
+	hashListCached = 0;
+	fJournal = false;
+}
+
+CMasternodeMan::~CMasternodeMan()
+{
+	StopThreads();
+}
+
+void CMasternodeMan::StartThreads(int nThreads)
+{
+	StopThreads();
+
+	if (nThreads > 1)
+	{
+		pool.reset(new CThreadPool("mnverify", nThreads));
+	}
+}
+
+void CMasternodeMan::StopThreads()
+{
+	if (pool)
+	{
+		pool->Stop();
+		pool.reset();
+	}
 }
 
 bool CMasternodeMan::Add(CMasternode &mn)
@@ -58,6 +102,7 @@ bool CMasternodeMan::Add(CMasternode &mn)
 		LogPrint("masternode", "CMasternodeMan: Adding new masternode %s - %i now\n", mn.addr.ToString().c_str(), size() + 1);
 		
 		vMasternodes.push_back(mn);
+		EntryChanged(mn);
 		
 		return true;
 	}
@@ -97,6 +142,8 @@ void CMasternodeMan::Check()
 	{
         mn.Check();
 	}
+
+	UpdateListedEntries();
 }
 
 void CMasternodeMan::CheckAndRemove()
@@ -117,6 +164,7 @@ void CMasternodeMan::CheckAndRemove()
 		{
 			LogPrint("masternode", "CMasternodeMan: Removing inactive masternode %s - %i now\n", (*it).addr.ToString().c_str(), size() - 1);
 			
+			EntryRemoved((*it).vin);
 			it = vMasternodes.erase(it);
 		}
 		else
@@ -153,6 +201,12 @@ void CMasternodeMan::CheckAndRemove()
 		}
 	}
 
+	// peers we have not heard from in a while just get the whole list again
+	if(mPeerMasternodeList.size() > MAX_PEER_MASTERNODE_LISTS)
+	{
+		mPeerMasternodeList.clear();
+	}
+
 	// check which masternodes we've asked for
 	std::map<COutPoint, int64_t>::iterator it2 = mWeAskedForMasternodeListEntry.begin();
 	while(it2 != mWeAskedForMasternodeListEntry.end())
@@ -176,8 +230,12 @@ void CMasternodeMan::Clear()
 	mAskedUsForMasternodeList.clear();
 	mWeAskedForMasternodeList.clear();
 	mWeAskedForMasternodeListEntry.clear();
+	mapEntryVersion.clear();
+	mapAnnouncedListHashes.clear();
+	mPeerMasternodeList.clear();
 
 	nDsqCount = 0;
+	nListVersion++;
 }
 
 int CMasternodeMan::CountEnabled(int protocolVersion)
@@ -235,12 +293,116 @@ void CMasternodeMan::DsegUpdate(CNode* pnode)
 		}
 	}
 
-	pnode->PushMessage("dseg", CTxIn());
+	// tell the peer what our list hashes to, so it sends nothing if its list is the same, and
+	// which of its lists we got last time, so it only sends what changed since
+	std::map<CNetAddr, std::pair<uint64_t, uint256>>::iterator itList = mPeerMasternodeList.find(pnode->addr);
+
+	if (itList != mPeerMasternodeList.end())
+	{
+		pnode->PushMessage("dseg", CTxIn(), GetListHash(), itList->second.second, itList->second.first);
+	}
+	else
+	{
+		pnode->PushMessage("dseg", CTxIn(), GetListHash(), uint256(0), (uint64_t)0);
+	}
 
 	int64_t askAgain = GetTime() + MASTERNODES_DSEG_SECONDS;
 	mWeAskedForMasternodeList[pnode->addr] = askAgain;
 }
 
+void CMasternodeMan::SendListVersion(CNode* pnode, const uint256& hashList, int nEntries)
+{
+	LOCK(cs);
+
+	// remember what this version hashed to, so the peer can ask for the changes since next time
+	mapAnnouncedListHashes[nListVersion] = hashList;
+
+	while (mapAnnouncedListHashes.size() > MAX_ANNOUNCED_LIST_HASHES)
+	{
+		mapAnnouncedListHashes.erase(mapAnnouncedListHashes.begin());
+	}
+
+	pnode->PushMessage("mnlv", hashList, nListVersion, nEntries);
+}
+
+bool CMasternodeMan::IsListed(CMasternode& mn)
+{
+	return mn.IsEnabled() && !mn.addr.IsRFC1918();
+}
+
+void CMasternodeMan::EntryChanged(CMasternode& mn)
+{
+	LOCK(cs);
+
+	nListVersion++;
+
+	if (IsListed(mn))
+	{
+		mapEntryVersion[mn.vin.prevout] = nListVersion;
+	}
+	else
+	{
+		mapEntryVersion.erase(mn.vin.prevout);
+	}
+
+	if (fJournal)
+	{
+		mnodeJournal.WriteEntry(mn);
+	}
+}
+
+void CMasternodeMan::EntryRemoved(const CTxIn& vin)
+{
+	LOCK(cs);
+
+	nListVersion++;
+	mapEntryVersion.erase(vin.prevout);
+
+	if (fJournal)
+	{
+		mnodeJournal.WriteRemove(vin);
+	}
+}
+
+void CMasternodeMan::UpdateListedEntries()
+{
+	LOCK(cs);
+
+	// entries change state in Check, wherever that was called from
+	std::set<COutPoint> setListed;
+
+	for (CMasternode& mn : vMasternodes)
+	{
+		if (!IsListed(mn))
+		{
+			continue;
+		}
+
+		setListed.insert(mn.vin.prevout);
+
+		if (mapEntryVersion.count(mn.vin.prevout) == 0)
+		{
+			nListVersion++;
+			mapEntryVersion[mn.vin.prevout] = nListVersion;
+		}
+	}
+
+	std::map<COutPoint, uint64_t>::iterator it = mapEntryVersion.begin();
+
+	while (it != mapEntryVersion.end())
+	{
+		if (setListed.count(it->first) == 0)
+		{
+			nListVersion++;
+			mapEntryVersion.erase(it++);
+		}
+		else
+		{
+			++it;
+		}
+	}
+}
+
 CMasternode *CMasternodeMan::Find(const CTxIn &vin)
 {
 	LOCK(cs);
@@ -453,6 +615,55 @@ std::vector<CMasternode> CMasternodeMan::GetFullMasternodeVector()
 	return vMasternodes;
 }
 
+uint64_t CMasternodeMan::GetListVersion()
+{
+	LOCK(cs);
+
+	UpdateListedEntries();
+
+	return nListVersion;
+}
+
+uint256 CMasternodeMan::GetListHash()
+{
+	LOCK(cs);
+
+	UpdateListedEntries();
+
+	if (nListVersionCached == nListVersion)
+	{
+		return hashListCached;
+	}
+
+	// the same list hashes the same on every node, whatever order it was received in
+	std::vector<std::pair<COutPoint, int64_t>> vEntries;
+
+	vEntries.reserve(vMasternodes.size());
+
+	for(CMasternode& mn : vMasternodes)
+	{
+		if(IsListed(mn))
+		{
+			vEntries.push_back(std::make_pair(mn.vin.prevout, mn.sigTime));
+		}
+	}
+
+	std::sort(vEntries.begin(), vEntries.end());
+
+	CDataStream ss(SER_GETHASH, 0);
+
+	for(const std::pair<COutPoint, int64_t>& entry : vEntries)
+	{
+		ss << CTxIn(entry.first);
+		ss << entry.second;
+	}
+
+	hashListCached = Hash(ss.begin(), ss.end());
+	nListVersionCached = nListVersion;
+
+	return hashListCached;
+}
+
 int CMasternodeMan::GetMasternodeRank(const CTxIn& vin, int64_t nBlockHeight, int minProtocol, bool fOnlyActive)
 {
 	std::vector<std::pair<unsigned int, CTxIn>> vecMasternodeScores;
@@ -556,6 +767,58 @@ std::vector<std::pair<int, CMasternode>> CMasternodeMan::GetMasternodeRanks(int6
 	return vecMasternodeRanks;
 }
 
+bool CMasternodeMan::GetMasternodeRankTable(int64_t nBlockHeight, int minProtocol, std::map<COutPoint, int>& mapRanks)
+{
+	std::vector<std::pair<unsigned int, COutPoint>> vecMasternodeScores;
+
+	mapRanks.clear();
+
+	//make sure we know about this block
+	uint256 hash = 0;
+
+	if(!GetBlockHash(hash, nBlockHeight))
+	{
+		return false;
+	}
+
+	LOCK(cs);
+
+	for(CMasternode& mn : vMasternodes)
+	{
+		if(mn.protocolVersion < minProtocol)
+		{
+			continue;
+		}
+		
+		mn.Check();
+		
+		if(!mn.IsEnabled())
+		{
+			continue;
+		}
+
+		uint256 n = mn.CalculateScore(1, nBlockHeight);
+		unsigned int n2 = 0;
+		
+		memcpy(&n2, &n, sizeof(n2));
+
+		vecMasternodeScores.push_back(std::make_pair(n2, mn.vin.prevout));
+	}
+
+	sort(vecMasternodeScores.rbegin(), vecMasternodeScores.rend(), CompareValueOnly<COutPoint>());
+
+	int rank = 0;
+
+	for(std::pair<unsigned int, COutPoint>& s : vecMasternodeScores)
+	{
+		rank++;
+		
+		mapRanks.insert(std::make_pair(s.second, rank));
+	}
+
+	return true;
+}
+
 CMasternode* CMasternodeMan::GetMasternodeByRank(int nRank, int64_t nBlockHeight, int minProtocol, bool fOnlyActive)
 {
 	std::vector<std::pair<unsigned int, CTxIn>> vecMasternodeScores;
@@ -650,75 +913,46 @@ void CMasternodeMan::ProcessMessage(CNode* pfrom, std::string& strCommand, CData
 
 	if (strCommand == "dsee") //MNengine Election Entry
 	{
-		CTxIn vin;
-		CService addr;
-		CPubKey pubkey;
-		CPubKey pubkey2;
-		std::vector<unsigned char> vchSig;
-		int64_t sigTime;
-		int count;
-		int current;
-		int64_t lastUpdated;
-		int protocolVersion;
-		CScript donationAddress;
-		int donationPercentage;
-		std::string strMessage;
+		CMasternodeBroadcast mnb;
 
 		// 70047 and greater
-		vRecv >> vin
-				>> addr
-				>> vchSig
-				>> sigTime
-				>> pubkey
-				>> pubkey2
-				>> count
-				>> current
-				>> lastUpdated
-				>> protocolVersion
-				>> donationAddress
-				>> donationPercentage;
+		vRecv >> mnb.vin
+				>> mnb.addr
+				>> mnb.vchSig
+				>> mnb.sigTime
+				>> mnb.pubkey
+				>> mnb.pubkey2
+				>> mnb.count
+				>> mnb.current
+				>> mnb.lastUpdated
+				>> mnb.protocolVersion
+				>> mnb.donationAddress
+				>> mnb.donationPercentage;
 
 		// make sure signature isn't in the future (past is OK)
-		if (sigTime > GetAdjustedTime() + 60 * 60)
+		if (mnb.sigTime > GetAdjustedTime() + 60 * 60)
 		{
-			LogPrintf("dsee - Signature rejected, too far into the future %s\n", vin.ToString().c_str());
+			LogPrintf("dsee - Signature rejected, too far into the future %s\n", mnb.vin.ToString().c_str());
 			
 			return;
 		}
 
-		bool isLocal = addr.IsRFC1918() || addr.IsLocal();
-		//if(RegTest())
-		//{
-		//	isLocal = false;
-		//}
-		
-		std::string vchPubKey(pubkey.begin(), pubkey.end());
-		std::string vchPubKey2(pubkey2.begin(), pubkey2.end());
-
-		strMessage = addr.ToString() +
-						boost::lexical_cast<std::string>(sigTime) +
-						vchPubKey +
-						vchPubKey2 +
-						boost::lexical_cast<std::string>(protocolVersion) +
-						donationAddress.ToString() +
-						boost::lexical_cast<std::string>(donationPercentage);
-
-		if(donationPercentage < 0 || donationPercentage > 100)
+		if(mnb.donationPercentage < 0 || mnb.donationPercentage > 100)
 		{
-			LogPrintf("dsee - donation percentage out of range %d\n", donationPercentage);
+			LogPrintf("dsee - donation percentage out of range %d\n", mnb.donationPercentage);
 			
 			return;     
 		}
 		
-		if(protocolVersion < MIN_POOL_PEER_PROTO_VERSION)
+		if(mnb.protocolVersion < MIN_POOL_PEER_PROTO_VERSION)
 		{
-			LogPrintf("dsee - ignoring outdated masternode %s protocol version %d\n", vin.ToString().c_str(), protocolVersion);
+			LogPrintf("dsee - ignoring outdated masternode %s protocol version %d\n", mnb.vin.ToString().c_str(), mnb.protocolVersion);
 			
 			return;
 		}
 
 		CScript pubkeyScript;
-		pubkeyScript.SetDestination(pubkey.GetID());
+		pubkeyScript.SetDestination(mnb.pubkey.GetID());
 
 		if(pubkeyScript.size() != 25)
 		{
@@ -730,7 +964,7 @@ void CMasternodeMan::ProcessMessage(CNode* pfrom, std::string& strCommand, CData
 		}
 
 		CScript pubkeyScript2;
-		pubkeyScript2.SetDestination(pubkey2.GetID());
+		pubkeyScript2.SetDestination(mnb.pubkey2.GetID());
 
 		if(pubkeyScript2.size() != 25)
 		{
@@ -741,197 +975,34 @@ void CMasternodeMan::ProcessMessage(CNode* pfrom, std::string& strCommand, CData
 			return;
 		}
 
-		if(!vin.scriptSig.empty())
-		{
-			LogPrintf("dsee - Ignore Not Empty ScriptSig %s\n",vin.ToString().c_str());
-			
-			return;
-		}
-
-		std::string errorMessage = "";
-		
-		if(!mnEngineSigner.VerifyMessage(pubkey, vchSig, strMessage, errorMessage))
-		{
-			LogPrintf("dsee - WARNING - Could not verify masternode address signature\n");
-			
-			Misbehaving(pfrom->GetId(), 100);
-			
-			return;
-		}
-
-		//search existing masternode list, this is where we update existing masternodes with new dsee broadcasts
-		CMasternode* pmn = this->Find(vin);
-		
-		// if we are a masternode but with undefined vin and this dsee is ours (matches our Masternode privkey) then just skip this part
-		if(pmn != NULL && !(fMasterNode && activeMasternode.vin == CTxIn() && pubkey2 == activeMasternode.pubKeyMasternode))
-		{
-			// count == -1 when it's a new entry
-			//   e.g. We don't want the entry relayed/time updated when we're syncing the list
-			// mn.pubkey = pubkey, IsVinAssociatedWithPubkey is validated once below,
-			//   after that they just need to match
-			if(count == -1 && pmn->pubkey == pubkey && !pmn->UpdatedWithin(MASTERNODE_MIN_DSEE_SECONDS))
-			{
-				pmn->UpdateLastSeen();
-
-				if(pmn->sigTime < sigTime) //take the newest entry
-				{
-					if (!CheckNode((CAddress)addr))
-					{
-						pmn->isPortOpen = false;
-					}
-					else
-					{
-						pmn->isPortOpen = true;
-						addrman.Add(CAddress(addr), pfrom->addr, 2*60*60); // use this as a peer
-					}
-					
-					LogPrintf("dsee - Got updated entry for %s\n", addr.ToString().c_str());
-					
-					pmn->pubkey2 = pubkey2;
-					pmn->sigTime = sigTime;
-					pmn->sig = vchSig;
-					pmn->protocolVersion = protocolVersion;
-					pmn->addr = addr;
-					pmn->donationAddress = donationAddress;
-					pmn->donationPercentage = donationPercentage;
-					pmn->Check();
-					
-					if(pmn->IsEnabled())
-					{
-						mnodeman.RelayMasternodeEntry(
-							vin, addr, vchSig, sigTime, pubkey, pubkey2, count, current,
-							lastUpdated, protocolVersion, donationAddress, donationPercentage
-						);
-					}
-				}
-			}
-
-			return;
-		}
-
-		// make sure the vout that was signed is related to the transaction that spawned the masternode
-		//  - this is expensive, so it's only done once per masternode
-		if(!mnEngineSigner.IsVinAssociatedWithPubkey(vin, pubkey))
+		if(!mnb.vin.scriptSig.empty())
 		{
-			LogPrintf("dsee - Got mismatched pubkey and vin\n");
-			
-			Misbehaving(pfrom->GetId(), 100);
+			LogPrintf("dsee - Ignore Not Empty ScriptSig %s\n", mnb.vin.ToString().c_str());
 			
 			return;
 		}
 
-		LogPrint("masternode", "dsee - Got NEW masternode entry %s\n", addr.ToString().c_str());
+		mnb.nodeFrom = pfrom->GetId();
+		mnb.addrFrom = pfrom->addr;
+		mnb.strSubVerFrom = pfrom->cleanSubVer;
 
-		// make sure it's still unspent
-		//  - this is checked later by .check() in many places and by ThreadCheckMNenginePool()
+		// the same broadcast relayed by another peer was checked already
+		CMasternode* pmn = this->Find(mnb.vin);
 
-		CValidationState state;
-		CTransaction tx = CTransaction();
-		CTxOut vout = CTxOut(MNengine_POOL_MAX, mnEnginePool.collateralPubKey);
-		tx.vin.push_back(vin);
-		tx.vout.push_back(vout);
-		bool fAcceptable = false;
-		
-		{
-			TRY_LOCK(cs_main, lockMain);
-			
-			if(!lockMain)
-			{
-				return;
-			}
-			
-			fAcceptable = AcceptableInputs(mempool, tx, false, NULL);
-		}
-		
-		if(fAcceptable)
+		if(pmn != NULL && pmn->pubkey == mnb.pubkey && pmn->sigTime == mnb.sigTime && pmn->sig == mnb.vchSig)
 		{
-			LogPrint("masternode", "dsee - Accepted masternode entry %i %i\n", count, current);
-
-			if(GetInputAge(vin) < MASTERNODE_MIN_CONFIRMATIONS)
+			if(mnb.count != -1)
 			{
-				LogPrintf("dsee - Input must have least %d confirmations\n", MASTERNODE_MIN_CONFIRMATIONS);
-				
-				Misbehaving(pfrom->GetId(), 20);
-				
 				return;
 			}
 
-			// verify that sig time is legit in past
-			// should be at least not earlier than block when 2,000,000 DigitalNote tx got MASTERNODE_MIN_CONFIRMATIONS
-			uint256 hashBlock = 0;
-			GetTransaction(vin.prevout.hash, tx, hashBlock);
-			std::map<uint256, CBlockIndex*>::iterator mi = mapBlockIndex.find(hashBlock);
-			
-			if (mi != mapBlockIndex.end() && (*mi).second)
-			{
-				CBlockIndex* pMNIndex = (*mi).second; // block for 2,000,000 DigitalNote tx -> 1 confirmation
-				CBlockIndex* pConfIndex = FindBlockByHeight((pMNIndex->nHeight + MASTERNODE_MIN_CONFIRMATIONS - 1)); // block where tx got MASTERNODE_MIN_CONFIRMATIONS
-				
-				if(pConfIndex->GetBlockTime() > sigTime)
-				{
-					LogPrintf(
-						"dsee - Bad sigTime %d for masternode %20s %105s (%i conf block is at %d)\n",
-						sigTime,
-						addr.ToString(),
-						vin.ToString(),
-						MASTERNODE_MIN_CONFIRMATIONS,
-						pConfIndex->GetBlockTime()
-					);
-					
-					return;
-				}
-			}
-			
-			// use this as a peer
-			addrman.Add(CAddress(addr), pfrom->addr, 2*60*60);
-
-			//doesn't support multisig addresses
-			if(donationAddress.IsPayToScriptHash())
-			{
-				donationAddress = CScript();
-				donationPercentage = 0;
-			}
-
-			// add our masternode
-			CMasternode mn(addr, vin, pubkey, vchSig, sigTime, pubkey2, protocolVersion, donationAddress, donationPercentage);
-			mn.UpdateLastSeen(lastUpdated);
-			this->Add(mn);
-
-			// if it matches our masternodeprivkey, then we've been remotely activated
-			if(pubkey2 == activeMasternode.pubKeyMasternode && protocolVersion == PROTOCOL_VERSION)
-			{
-				activeMasternode.EnableHotColdMasterNode(vin, addr);
-			}
-
-			if(count == -1 && !isLocal)
-			{
-				mnodeman.RelayMasternodeEntry(
-					vin, addr, vchSig, sigTime, pubkey, pubkey2, count, current,
-					lastUpdated, protocolVersion, donationAddress, donationPercentage
-				);
-			}
+			mnb.fSignatureValid = true;
 		}
-		else
-		{
-			LogPrintf("dsee - Rejected masternode entry %s\n", addr.ToString().c_str());
 
-			int nDoS = 0;
-			
-			if (state.IsInvalid(nDoS))
-			{
-				LogPrintf(
-					"dsee - %s from %s %s was not accepted into the memory pool\n",
-					tx.GetHash().ToString().c_str(),
-					pfrom->addr.ToString().c_str(),
-					pfrom->cleanSubVer.c_str()
-				);
-				
-				if (nDoS > 0)
-				{
-					Misbehaving(pfrom->GetId(), nDoS);
-				}
-			}
-		}
+		// the signature is checked with the rest of the batch in ProcessQueuedBroadcasts
+		LOCK(cs);
+
+		vQueuedBroadcasts.push_back(mnb);
 	}
 	else if (strCommand == "dseep") //MNengine Election Entry Ping
 	{
@@ -1074,6 +1145,18 @@ void CMasternodeMan::ProcessMessage(CNode* pfrom, std::string& strCommand, CData
 		CTxIn vin;
 		vRecv >> vin;
 
+		// newer peers add the hash of their list, then the hash and version of the list they got from us last time
+		uint256 hashPeer = 0;
+		uint256 hashKnown = 0;
+		uint64_t nVersionKnown = 0;
+		bool fVersioned = false;
+
+		if(!vRecv.empty())
+		{
+			vRecv >> hashPeer >> hashKnown >> nVersionKnown;
+			fVersioned = true;
+		}
+
 		if(vin == CTxIn()) //only should ask for this once
 		{
 			//local network
@@ -1100,6 +1183,31 @@ void CMasternodeMan::ProcessMessage(CNode* pfrom, std::string& strCommand, CData
 			}
 		} //else, asking for a specific node which is ok
 
+		LOCK(cs);
+
+		uint256 hashList = GetListHash();
+		// 0 sends the whole list
+		uint64_t nSince = 0;
+
+		if(vin == CTxIn() && fVersioned)
+		{
+			if(hashPeer == hashList)
+			{
+				LogPrint("masternode", "dseg - %s already has masternode list version %d\n", pfrom->addr.ToString().c_str(), nListVersion);
+				
+				SendListVersion(pfrom, hashList, 0);
+				
+				return;
+			}
+			
+			std::map<uint64_t, uint256>::iterator itKnown = mapAnnouncedListHashes.find(nVersionKnown);
+			
+			if(itKnown != mapAnnouncedListHashes.end() && itKnown->second == hashKnown)
+			{
+				nSince = nVersionKnown;
+			}
+		}
+
 		int count = this->size();
 		int i = 0;
 
@@ -1112,14 +1220,25 @@ void CMasternodeMan::ProcessMessage(CNode* pfrom, std::string& strCommand, CData
 			
 			if(mn.IsEnabled())
 			{
-				LogPrint("masternode", "dseg - Sending masternode entry - %s \n", mn.addr.ToString().c_str());
-				
 				if(vin == CTxIn())
 				{
+					std::map<COutPoint, uint64_t>::iterator itVersion = mapEntryVersion.find(mn.vin.prevout);
+					
+					if(nSince != 0 && itVersion != mapEntryVersion.end() && itVersion->second <= nSince)
+					{
+						i++;
+						
+						continue; //the peer has this one
+					}
+					
+					LogPrint("masternode", "dseg - Sending masternode entry - %s \n", mn.addr.ToString().c_str());
+					
 					pfrom->PushMessage("dsee", mn.vin, mn.addr, mn.sig, mn.sigTime, mn.pubkey, mn.pubkey2, count, i, mn.lastTimeSeen, mn.protocolVersion, mn.donationAddress, mn.donationPercentage);
 				}
 				else if (vin == mn.vin)
 				{
+					LogPrint("masternode", "dseg - Sending masternode entry - %s \n", mn.addr.ToString().c_str());
+					
 					pfrom->PushMessage("dsee", mn.vin, mn.addr, mn.sig, mn.sigTime, mn.pubkey, mn.pubkey2, count, i, mn.lastTimeSeen, mn.protocolVersion, mn.donationAddress, mn.donationPercentage);
 					
 					LogPrintf("dseg - Sent 1 masternode entries to %s\n", pfrom->addr.ToString().c_str());
@@ -1131,7 +1250,296 @@ void CMasternodeMan::ProcessMessage(CNode* pfrom, std::string& strCommand, CData
 			}
 		}
 
-		LogPrintf("dseg - Sent %d masternode entries to %s\n", i, pfrom->addr.ToString().c_str());
+		if(vin == CTxIn() && fVersioned)
+		{
+			SendListVersion(pfrom, hashList, i);
+		}
+
+		if(nSince != 0)
+		{
+			LogPrintf("dseg - Sent masternode entries changed since version %d to %s\n", nSince, pfrom->addr.ToString().c_str());
+		}
+		else
+		{
+			LogPrintf("dseg - Sent %d masternode entries to %s\n", i, pfrom->addr.ToString().c_str());
+		}
+	}
+	else if (strCommand == "mnlv") //Masternode list version, follows the entries sent for a dseg
+	{
+		uint256 hashList;
+		uint64_t nVersion;
+		int nEntries;
+
+		vRecv >> hashList >> nVersion >> nEntries;
+
+		LOCK(cs);
+
+		mPeerMasternodeList[pfrom->addr] = std::make_pair(nVersion, hashList);
+
+		LogPrint("masternode", "mnlv - %s has masternode list version %d with %d entries\n", pfrom->addr.ToString().c_str(), nVersion, nEntries);
+	}
+}
+
+void CMasternodeMan::ProcessQueuedBroadcasts()
+{
+	std::vector<CMasternodeBroadcast> vBroadcasts;
+
+	{
+		LOCK(cs);
+
+		vBroadcasts.swap(vQueuedBroadcasts);
+	}
+
+	if (vBroadcasts.empty())
+	{
+		return;
+	}
+
+	// A list sync brings every entry at once, their signatures are checked side by side
+	std::vector<size_t> vCheck;
+
+	for (size_t i = 0; i < vBroadcasts.size(); i++)
+	{
+		if (!vBroadcasts[i].fSignatureValid)
+		{
+			vCheck.push_back(i);
+		}
+	}
+
+	std::function<void(size_t)> fnVerify = [&vBroadcasts, &vCheck](size_t n)
+	{
+		vBroadcasts[vCheck[n]].VerifySignature();
+	};
+
+	if (pool && vCheck.size() >= MIN_PARALLEL_BROADCASTS)
+	{
+		pool->ParallelFor(vCheck.size(), fnVerify);
+	}
+	else
+	{
+		for (size_t n = 0; n < vCheck.size(); n++)
+		{
+			fnVerify(n);
+		}
+	}
+
+	LOCK(cs_process_message);
+
+	for (CMasternodeBroadcast& mnb : vBroadcasts)
+	{
+		ProcessBroadcast(mnb);
+	}
+}
+
+void CMasternodeMan::ProcessBroadcast(CMasternodeBroadcast& mnb)
+{
+	CTxIn& vin = mnb.vin;
+	CService& addr = mnb.addr;
+	std::vector<unsigned char>& vchSig = mnb.vchSig;
+	int64_t sigTime = mnb.sigTime;
+	CPubKey& pubkey = mnb.pubkey;
+	CPubKey& pubkey2 = mnb.pubkey2;
+	int count = mnb.count;
+	int current = mnb.current;
+	int64_t lastUpdated = mnb.lastUpdated;
+	int protocolVersion = mnb.protocolVersion;
+	CScript donationAddress = mnb.donationAddress;
+	int donationPercentage = mnb.donationPercentage;
+
+	bool isLocal = addr.IsRFC1918() || addr.IsLocal();
+	//if(RegTest())
+	//{
+	//	isLocal = false;
+	//}
+
+	if(!mnb.fSignatureValid)
+	{
+		LogPrintf("dsee - WARNING - Could not verify masternode address signature\n");
+		
+		Misbehaving(mnb.nodeFrom, 100);
+		
+		return;
+	}
+
+	//search existing masternode list, this is where we update existing masternodes with new dsee broadcasts
+	CMasternode* pmn = this->Find(vin);
+	
+	// if we are a masternode but with undefined vin and this dsee is ours (matches our Masternode privkey) then just skip this part
+	if(pmn != NULL && !(fMasterNode && activeMasternode.vin == CTxIn() && pubkey2 == activeMasternode.pubKeyMasternode))
+	{
+		// count == -1 when it's a new entry
+		//   e.g. We don't want the entry relayed/time updated when we're syncing the list
+		// a newer entry from a list sync is still taken, a peer we synced with before
+		//   only sends us the entries that changed since
+		// mn.pubkey = pubkey, IsVinAssociatedWithPubkey is validated once below,
+		//   after that they just need to match
+		if(pmn->pubkey == pubkey && (count != -1 || !pmn->UpdatedWithin(MASTERNODE_MIN_DSEE_SECONDS)))
+		{
+			if(count == -1)
+			{
+				pmn->UpdateLastSeen();
+			}
+
+			if(pmn->sigTime < sigTime) //take the newest entry
+			{
+				if (!CheckNode((CAddress)addr))
+				{
+					pmn->isPortOpen = false;
+				}
+				else
+				{
+					pmn->isPortOpen = true;
+					addrman.Add(CAddress(addr), mnb.addrFrom, 2*60*60); // use this as a peer
+				}
+				
+				LogPrintf("dsee - Got updated entry for %s\n", addr.ToString().c_str());
+				
+				pmn->pubkey2 = pubkey2;
+				pmn->sigTime = sigTime;
+				pmn->sig = vchSig;
+				pmn->protocolVersion = protocolVersion;
+				pmn->addr = addr;
+				pmn->donationAddress = donationAddress;
+				pmn->donationPercentage = donationPercentage;
+				pmn->Check();
+				
+				EntryChanged(*pmn);
+				
+				if(count == -1 && pmn->IsEnabled())
+				{
+					mnodeman.RelayMasternodeEntry(
+						vin, addr, vchSig, sigTime, pubkey, pubkey2, count, current,
+						lastUpdated, protocolVersion, donationAddress, donationPercentage
+					);
+				}
+			}
+		}
+
+		return;
+	}
+
+	// make sure the vout that was signed is related to the transaction that spawned the masternode
+	//  - this is expensive, so it's only done once per masternode
+	if(!mnEngineSigner.IsVinAssociatedWithPubkey(vin, pubkey))
+	{
+		LogPrintf("dsee - Got mismatched pubkey and vin\n");
+		
+		Misbehaving(mnb.nodeFrom, 100);
+		
+		return;
+	}
+
+	LogPrint("masternode", "dsee - Got NEW masternode entry %s\n", addr.ToString().c_str());
+
+	// make sure it's still unspent
+	//  - this is checked later by .check() in many places and by ThreadCheckMNenginePool()
+
+	CValidationState state;
+	CTransaction tx = CTransaction();
+	CTxOut vout = CTxOut(MNengine_POOL_MAX, mnEnginePool.collateralPubKey);
+	tx.vin.push_back(vin);
+	tx.vout.push_back(vout);
+	bool fAcceptable = false;
+	
+	{
+		TRY_LOCK(cs_main, lockMain);
+		
+		if(!lockMain)
+		{
+			return;
+		}
+		
+		fAcceptable = AcceptableInputs(mempool, tx, false, NULL);
+	}
+	
+	if(fAcceptable)
+	{
+		LogPrint("masternode", "dsee - Accepted masternode entry %i %i\n", count, current);
+
+		if(GetInputAge(vin) < MASTERNODE_MIN_CONFIRMATIONS)
+		{
+			LogPrintf("dsee - Input must have least %d confirmations\n", MASTERNODE_MIN_CONFIRMATIONS);
+			
+			Misbehaving(mnb.nodeFrom, 20);
+			
+			return;
+		}
+
+		// verify that sig time is legit in past
+		// should be at least not earlier than block when 2,000,000 DigitalNote tx got MASTERNODE_MIN_CONFIRMATIONS
+		uint256 hashBlock = 0;
+		GetTransaction(vin.prevout.hash, tx, hashBlock);
+		CBlockIndexMap::iterator mi = mapBlockIndex.find(hashBlock);
+		
+		if (mi != mapBlockIndex.end() && (*mi).second)
+		{
+			CBlockIndex* pMNIndex = (*mi).second; // block for 2,000,000 DigitalNote tx -> 1 confirmation
+			CBlockIndex* pConfIndex = FindBlockByHeight((pMNIndex->nHeight + MASTERNODE_MIN_CONFIRMATIONS - 1)); // block where tx got MASTERNODE_MIN_CONFIRMATIONS
+			
+			if(pConfIndex->GetBlockTime() > sigTime)
+			{
+				LogPrintf(
+					"dsee - Bad sigTime %d for masternode %20s %105s (%i conf block is at %d)\n",
+					sigTime,
+					addr.ToString(),
+					vin.ToString(),
+					MASTERNODE_MIN_CONFIRMATIONS,
+					pConfIndex->GetBlockTime()
+				);
+				
+				return;
+			}
+		}
+		
+		// use this as a peer
+		addrman.Add(CAddress(addr), mnb.addrFrom, 2*60*60);
+
+		//doesn't support multisig addresses
+		if(donationAddress.IsPayToScriptHash())
+		{
+			donationAddress = CScript();
+			donationPercentage = 0;
+		}
+
+		// add our masternode
+		CMasternode mn(addr, vin, pubkey, vchSig, sigTime, pubkey2, protocolVersion, donationAddress, donationPercentage);
+		mn.UpdateLastSeen(lastUpdated);
+		this->Add(mn);
+
+		// if it matches our masternodeprivkey, then we've been remotely activated
+		if(pubkey2 == activeMasternode.pubKeyMasternode && protocolVersion == PROTOCOL_VERSION)
+		{
+			activeMasternode.EnableHotColdMasterNode(vin, addr);
+		}
+
+		if(count == -1 && !isLocal)
+		{
+			mnodeman.RelayMasternodeEntry(
+				vin, addr, vchSig, sigTime, pubkey, pubkey2, count, current,
+				lastUpdated, protocolVersion, donationAddress, donationPercentage
+			);
+		}
+	}
+	else
+	{
+		LogPrintf("dsee - Rejected masternode entry %s\n", addr.ToString().c_str());
+
+		int nDoS = 0;
+		
+		if (state.IsInvalid(nDoS))
+		{
+			LogPrintf(
+				"dsee - %s from %s %s was not accepted into the memory pool\n",
+				tx.GetHash().ToString().c_str(),
+				mnb.addrFrom.ToString().c_str(),
+				mnb.strSubVerFrom.c_str()
+			);
+			
+			if (nDoS > 0)
+			{
+				Misbehaving(mnb.nodeFrom, nDoS);
+			}
+		}
 	}
 }
 
@@ -1168,6 +1576,7 @@ void CMasternodeMan::Remove(CTxIn vin)
 		{
 			LogPrint("masternode", "CMasternodeMan: Removing Masternode %s - %i now\n", (*it).addr.ToString().c_str(), size() - 1);
 
+			EntryRemoved((*it).vin);
 			vMasternodes.erase(it);
 
 			break;
@@ -1175,6 +1584,24 @@ void CMasternodeMan::Remove(CTxIn vin)
 	}
 }
 
+void CMasternodeMan::Restore(const CMasternode& mn)
+{
+	LOCK(cs);
+
+	CMasternode *pmn = Find(mn.vin);
+
+	if (pmn == NULL)
+	{
+		vMasternodes.push_back(mn);
+	}
+	else
+	{
+		*pmn = mn;
+	}
+
+	nListVersion++;
+}
+
 std::string CMasternodeMan::ToString() const
 {
     std::ostringstream info;
@@ -1183,6 +1610,7 @@ std::string CMasternodeMan::ToString() const
             ", peers who asked us for masternode list: " << (int)mAskedUsForMasternodeList.size() <<
             ", peers we asked for masternode list: " << (int)mWeAskedForMasternodeList.size() <<
             ", entries in Masternode list we asked for: " << (int)mWeAskedForMasternodeListEntry.size() <<
+            ", list version: " << nListVersion <<
             ", nDsqCount: " << (int)nDsqCount;
 
     return info.str();
@@ -1196,6 +1624,36 @@ int CMasternodeMan::size()
 	return vMasternodes.size();
 }
 
+bool CMasternodeMan::WriteToDisk(CMasternodeDB& mndb)
+{
+	// nothing can change between the snapshot and starting its journal
+	LOCK(cs);
+
+	if (!mndb.Write(*this))
+	{
+		return false;
+	}
+
+	if (fJournal)
+	{
+		mnodeJournal.Start(mndb.GetHash(), mndb.GetSize());
+	}
+
+	return true;
+}
+
+void CMasternodeMan::EnableJournal(CMasternodeDB& mndb)
+{
+	LOCK(cs);
+
+	fJournal = true;
+
+	if (!mnodeJournal.IsOpen())
+	{
+		WriteToDisk(mndb);
+	}
+}
+
 unsigned int CMasternodeMan::GetSerializeSize(int nType, int nVersion) const
 {
 	CSerActionGetSerializeSize ser_action;
@@ -1275,6 +1733,11 @@ void CMasternodeMan::Unserialize(Stream& s, int nType, int nVersion)
 		READWRITE(mWeAskedForMasternodeList);
 		READWRITE(mWeAskedForMasternodeListEntry);
 		READWRITE(nDsqCount);
+
+		// no peer has a list version from before, the entries get new ones on the next update
+		mapEntryVersion.clear();
+		mapAnnouncedListHashes.clear();
+		nListVersion++;
 	}
 }
 
@@ -1,9 +1,13 @@
 #ifndef CMASTERNODEMAN_H
 #define CMASTERNODEMAN_H
 
+#include <cstdint>
 #include <vector>
 #include <map>
+#include <memory>
 
+#include "uint/uint256.h"
+#include "cmasternodebroadcast.h"
 #include "types/ccriticalsection.h"
 
 class CNode;
@@ -15,6 +19,8 @@ class CTxIn;
 class CPubKey;
 class CDataStream;
 class CScript;
+class CMasternodeDB;
+class CThreadPool;
 
 class CMasternodeMan
 {
@@ -31,12 +37,44 @@ private:
     // which masternodes we've asked for
     std::map<COutPoint, int64_t> mWeAskedForMasternodeListEntry;
 
+    // bumped whenever an entry is added, updated, enabled, disabled or removed
+    uint64_t nListVersion;
+    // the entries dseg sends and the version each last changed or was enabled at
+    std::map<COutPoint, uint64_t> mapEntryVersion;
+    // our list hash at the versions we told peers about, so they can ask for what changed since
+    std::map<uint64_t, uint256> mapAnnouncedListHashes;
+    // the list version and hash each peer last told us about
+    std::map<CNetAddr, std::pair<uint64_t, uint256>> mPeerMasternodeList;
+    uint256 hashListCached;
+    uint64_t nListVersionCached;
+    // whether changes are written to mnodeJournal
+    bool fJournal;
+
+    // dsee messages waiting for ProcessQueuedBroadcasts
+    std::vector<CMasternodeBroadcast> vQueuedBroadcasts;
+    // verifies the signatures of large dsee batches, none when running on one thread
+    std::unique_ptr<CThreadPool> pool;
+
+    // whether dseg sends this entry to peers
+    static bool IsListed(CMasternode& mn);
+    void EntryChanged(CMasternode& mn);
+    void EntryRemoved(const CTxIn& vin);
+    // catch up mapEntryVersion with the entries enabled or disabled since the last call
+    void UpdateListedEntries();
+    void ProcessBroadcast(CMasternodeBroadcast& mnb);
+    // tell the peer a dseg was answered with our list at hashList, after nEntries entries
+    void SendListVersion(CNode* pnode, const uint256& hashList, int nEntries);
+
 public:
     // keep track of dsq count to prevent masternodes from gaming mnengine queue
     int64_t nDsqCount;
 	
     CMasternodeMan();
     CMasternodeMan(CMasternodeMan& other);
+    ~CMasternodeMan();
+
+    void StartThreads(int nThreads);
+    void StopThreads();
 
     // Add an entry
     bool Add(CMasternode &mn);
@@ -80,11 +118,26 @@ public:
 
     std::vector<std::pair<int, CMasternode>> GetMasternodeRanks(int64_t nBlockHeight, int minProtocol=0);
     int GetMasternodeRank(const CTxIn &vin, int64_t nBlockHeight, int minProtocol=0, bool fOnlyActive=true);
+    /// Rank of every enabled masternode at nBlockHeight, the same ranks GetMasternodeRank returns one at a time
+    bool GetMasternodeRankTable(int64_t nBlockHeight, int minProtocol, std::map<COutPoint, int>& mapRanks);
     CMasternode* GetMasternodeByRank(int nRank, int64_t nBlockHeight, int minProtocol=0, bool fOnlyActive=true);
 
     void ProcessMasternodeConnections();
 
     void ProcessMessage(CNode* pfrom, std::string& strCommand, CDataStream& vRecv);
+    /// Verify the signatures of the dsee messages queued since the last call together, then apply them
+    void ProcessQueuedBroadcasts();
+
+    /// Version and hash of the list, the hash covers the vin and sigTime of every entry dseg sends
+    uint64_t GetListVersion();
+    uint256 GetListHash();
+
+    /// Put back an entry read from disk, replacing the one with the same vin
+    void Restore(const CMasternode& mn);
+    /// Write the whole list to mncache.dat and start an empty journal for it
+    bool WriteToDisk(CMasternodeDB& mndb);
+    /// Write every change to mnodeJournal from now on, starting one if there is none
+    void EnableJournal(CMasternodeDB& mndb);
 	
     std::string ToString() const;
     int size();
@@ -150,7 +150,7 @@ int CMerkleTx::SetMerkleBranch(const CBlock* pblock)
 	}
 
 	// Is the tx in a block that's in the main chain
-	std::map<uint256, CBlockIndex*>::iterator mi = mapBlockIndex.find(hashBlock);
+	CBlockIndexMap::iterator mi = mapBlockIndex.find(hashBlock);
 
 	if (mi == mapBlockIndex.end())
 	{
@@ -215,7 +215,7 @@ int CMerkleTx::GetDepthInMainChainINTERNAL(CBlockIndex* &pindexRet) const
 	AssertLockHeld(cs_main);
 
 	// Find the block it claims to be in
-	std::map<uint256, CBlockIndex*>::iterator mi = mapBlockIndex.find(hashBlock);
+	CBlockIndexMap::iterator mi = mapBlockIndex.find(hashBlock);
 
 	if (mi == mapBlockIndex.end())
 	{
@@ -15,7 +15,7 @@ CRegTestParams::CRegTestParams()
 	pchMessageStart[1] = 0xbb;
 	pchMessageStart[2] = 0x0a;
 	pchMessageStart[3] = 0xa9;
-	bnProofOfWorkLimit = CBigNum(~uint256(0) >> 1);
+	bnProofOfWorkLimit = ~arith_uint256(0) >> 1;
 	genesis.nTime = timeRegNetGenesis;
 	genesis.nBits  = bnProofOfWorkLimit.GetCompact();
 	genesis.nNonce = 8;
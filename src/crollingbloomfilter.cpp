@@ -0,0 +1,114 @@
+#include "compat.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "util.h"
+#include "hash.h"
+#include "uint/uint256.h"
+
+#include "crollingbloomfilter.h"
+
+CRollingBloomFilter::CRollingBloomFilter(unsigned int nElements, double fpRate)
+{
+	double logFpRate = log(fpRate);
+
+	// The optimal number of hash functions is log(fpRate) / log(0.5), but
+	// restrict it to the range 1-50
+	nHashFuncs = std::max(1, std::min((int)round(logFpRate / log(0.5)), 50));
+
+	// Between 2 and 3 generations of nElements / 2 entries are in the filter
+	nEntriesPerGeneration = (nElements + 1) / 2;
+
+	uint32_t nMaxElements = nEntriesPerGeneration * 3;
+
+	// Bits needed to hold nMaxElements at fpRate with nHashFuncs hashes:
+	// fpRate = (1 - exp(-nHashFuncs * nMaxElements / nFilterBits)) ^ nHashFuncs
+	uint32_t nFilterBits = (uint32_t)ceil(-1.0 * nHashFuncs * nMaxElements / log(1.0 - exp(logFpRate / nHashFuncs)));
+
+	// Each 64 bit word of the filter is paired with a second one, together
+	// they hold the 2 bit generation of 64 entries
+	data.resize(((nFilterBits + 63) / 64) << 1);
+
+	reset();
+}
+
+uint32_t CRollingBloomFilter::Hash(int nHashNum, const uint256& hash) const
+{
+	return MurmurHash3(nHashNum * 0xFBA4C795 + nTweak, hash.begin(), sizeof(uint256));
+}
+
+void CRollingBloomFilter::insert(const uint256& hash)
+{
+	if (nEntriesThisGeneration == nEntriesPerGeneration)
+	{
+		nEntriesThisGeneration = 0;
+		nGeneration++;
+
+		if (nGeneration == 4)
+		{
+			nGeneration = 1;
+		}
+
+		uint64_t nGenerationMask1 = 0 - (uint64_t)(nGeneration & 1);
+		uint64_t nGenerationMask2 = 0 - (uint64_t)(nGeneration >> 1);
+
+		// Wipe old entries that used this generation number
+		for (size_t p = 0; p < data.size(); p += 2)
+		{
+			uint64_t p1 = data[p];
+			uint64_t p2 = data[p + 1];
+			uint64_t mask = (p1 ^ nGenerationMask1) | (p2 ^ nGenerationMask2);
+
+			data[p] = p1 & mask;
+			data[p + 1] = p2 & mask;
+		}
+	}
+
+	nEntriesThisGeneration++;
+
+	for (int n = 0; n < nHashFuncs; n++)
+	{
+		uint32_t h = Hash(n, hash);
+		int bit = h & 0x3F;
+
+		// The upper bits of h pick the word pair, the lower ones the bit in it
+		uint32_t pos = ((uint64_t)h * data.size()) >> 32;
+
+		data[pos & ~1U] = (data[pos & ~1U] & ~((uint64_t)1 << bit)) | ((uint64_t)(nGeneration & 1)) << bit;
+		data[pos | 1] = (data[pos | 1] & ~((uint64_t)1 << bit)) | ((uint64_t)(nGeneration >> 1)) << bit;
+	}
+}
+
+bool CRollingBloomFilter::contains(const uint256& hash) const
+{
+	for (int n = 0; n < nHashFuncs; n++)
+	{
+		uint32_t h = Hash(n, hash);
+		int bit = h & 0x3F;
+		uint32_t pos = ((uint64_t)h * data.size()) >> 32;
+
+		// An entry of generation 0 in both words is an empty one
+		if (!(((data[pos & ~1U] | data[pos | 1]) >> bit) & 1))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void CRollingBloomFilter::reset()
+{
+	nTweak = GetRand(std::numeric_limits<unsigned int>::max());
+	nEntriesThisGeneration = 0;
+	nGeneration = 1;
+
+	std::fill(data.begin(), data.end(), 0);
+}
+
+size_t CRollingBloomFilter::MemoryUsage() const
+{
+	return data.size() * sizeof(uint64_t);
+}
@@ -0,0 +1,44 @@
+#ifndef CROLLINGBLOOMFILTER_H
+#define CROLLINGBLOOMFILTER_H
+
+#include <vector>
+#include <stdint.h>
+
+class uint256;
+
+/** Bloom filter of fixed size that keeps about the last nElements hashes
+ * inserted into it.
+ *
+ * Entries are tagged with one of three generations. Each time nElements/2
+ * hashes have been inserted the oldest generation is wiped, so between
+ * nElements and 1.5 * nElements of the most recent hashes are kept and the
+ * false positive rate stays below fpRate no matter how many are inserted.
+ *
+ * The hash functions take a random tweak that is picked again on reset(),
+ * so peers can't build transactions that collide in our filter.
+ */
+class CRollingBloomFilter
+{
+private:
+	int nEntriesPerGeneration;
+	int nEntriesThisGeneration;
+	int nGeneration;
+	std::vector<uint64_t> data;
+	unsigned int nTweak;
+	int nHashFuncs;
+
+	uint32_t Hash(int nHashNum, const uint256& hash) const;
+
+public:
+	CRollingBloomFilter(unsigned int nElements, double fpRate);
+
+	void insert(const uint256& hash);
+	bool contains(const uint256& hash) const;
+
+	/** Forgets everything inserted and picks a new tweak */
+	void reset();
+
+	size_t MemoryUsage() const;
+};
+
+#endif // CROLLINGBLOOMFILTER_H
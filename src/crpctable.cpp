@@ -39,6 +39,7 @@ static const CRPCCommand vRPCCommands[] =
 	{ "getinfo",                &getinfo,                true,      false,     false },
 	{ "getvelocityinfo",        &getvelocityinfo,        true,      false,     false },
 	{ "getrawmempool",          &getrawmempool,          true,      false,     false },
+	{ "getmempoolinfo",         &getmempoolinfo,         true,      false,     false },
 	{ "getblock",               &getblock,               false,     false,     false },
 	{ "getblockbynumber",       &getblockbynumber,       false,     false,     false },
 	{ "getblockhash",           &getblockhash,           false,     false,     false },
@@ -93,7 +94,7 @@ static const CRPCCommand vRPCCommands[] =
 	{ "getwork",                &getwork,                true,      false,     true },
 	{ "getworkex",              &getworkex,              true,      false,     true },
 	{ "listaccounts",           &listaccounts,           false,     false,     true },
-	{ "getblocktemplate",       &getblocktemplate,       true,      false,     false },
+	{ "getblocktemplate",       &getblocktemplate,       true,      true,      false },
 	{ "submitblock",            &submitblock,            false,     false,     false },
 	{ "listsinceblock",         &listsinceblock,         false,     false,     true },
 	{ "dumpprivkey",            &dumpprivkey,            false,     false,     true },
@@ -135,7 +136,8 @@ static const CRPCCommand vRPCCommands[] =
 	{ "smsggetmessagesforaccount", &smsggetmessagesforaccount,            false,     false,     false },
 #endif // ENABLE_WALLET
 	{ "mintblock",              &mintblock,              false,     false,     false },
-	{ "debugrpcallowip",        &debugrpcallowip,        false,     false,     false }
+	{ "debugrpcallowip",        &debugrpcallowip,        false,     false,     false },
+	{ "getlockstats",           &getlockstats,           true,      true,      false }
 };
 
 CRPCTable::CRPCTable()
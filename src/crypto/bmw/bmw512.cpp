@@ -0,0 +1,145 @@
+#include <string.h>
+
+#include "crypto/common/common.h"
+#include "crypto/common/cpufeatures.h"
+
+#include "bmw512.h"
+
+#define BMW_V           uint64_t
+#define BMW_LANES       1
+#define BMW_SPLAT(x)    ((uint64_t)(x))
+#define BMW_SET(v,l,x)  ((v) = (x))
+#define BMW_GET(v,l)    (v)
+#define BMW_TARGET
+#define BMW_FN          Hash_bmw512_80x1_generic
+
+#include "bmw512_lanes.h"
+
+typedef void (*Hash80Fn)(const unsigned char* pHeaders, unsigned char* phashOut);
+
+#ifdef USE_X86_TARGET_ATTRIBUTES
+void Hash_bmw512_80x2_sse41(const unsigned char* pHeaders, unsigned char* phashOut);
+void Hash_bmw512_80x4_avx2(const unsigned char* pHeaders, unsigned char* phashOut);
+void Hash_bmw512_80x8_avx2(const unsigned char* pHeaders, unsigned char* phashOut);
+#endif
+
+namespace
+{
+/** Kernels of one implementation, NULL where it has no kernel of that width. */
+struct BMW512Kernels
+{
+    const char* pszName;
+    Hash80Fn fn8;
+    Hash80Fn fn4;
+    Hash80Fn fn2;
+};
+
+const BMW512Kernels kernelsGeneric = { "generic", NULL, NULL, NULL };
+#ifdef USE_X86_TARGET_ATTRIBUTES
+const BMW512Kernels kernelsSSE41 = { "sse4.1", NULL, NULL, Hash_bmw512_80x2_sse41 };
+const BMW512Kernels kernelsAVX2 = { "avx2", Hash_bmw512_80x8_avx2, Hash_bmw512_80x4_avx2, NULL };
+#endif
+
+const BMW512Kernels* AutoDetect()
+{
+#ifdef USE_X86_TARGET_ATTRIBUTES
+    if (CPUHasAVX2())
+        return &kernelsAVX2;
+    if (CPUHasSSE41())
+        return &kernelsSSE41;
+#endif
+    return &kernelsGeneric;
+}
+
+// Function local so block hashes computed during static initialisation,
+// e.g. of the genesis block, already see the detected implementation.
+const BMW512Kernels*& Current()
+{
+    static const BMW512Kernels* pKernels = AutoDetect();
+    return pKernels;
+}
+} // namespace
+
+void Hash_bmw512_80(const unsigned char* pHeaders, size_t nCount, uint256* phashOut)
+{
+    const BMW512Kernels* pKernels = Current();
+    unsigned char buf[8 * 32];
+
+    while (nCount > 0)
+    {
+        Hash80Fn fn = Hash_bmw512_80x1_generic;
+        size_t nLanes = 1;
+
+        if (pKernels->fn8 && nCount >= 8)
+        {
+            fn = pKernels->fn8;
+            nLanes = 8;
+        }
+        else if (pKernels->fn4 && nCount >= 4)
+        {
+            fn = pKernels->fn4;
+            nLanes = 4;
+        }
+        else if (pKernels->fn2 && nCount >= 2)
+        {
+            fn = pKernels->fn2;
+            nLanes = 2;
+        }
+
+        fn(pHeaders, buf);
+
+        for (size_t i = 0; i < nLanes; i++)
+            memcpy(phashOut[i].begin(), buf + 32 * i, 32);
+
+        pHeaders += 80 * nLanes;
+        phashOut += nLanes;
+        nCount -= nLanes;
+    }
+}
+
+uint256 Hash_bmw512_80(const unsigned char* pHeader)
+{
+    uint256 hash;
+
+    Hash_bmw512_80x1_generic(pHeader, hash.begin());
+
+    return hash;
+}
+
+void Hash_bmw512_80x4(const unsigned char* pHeaders, uint256* phashOut)
+{
+    Hash_bmw512_80(pHeaders, 4, phashOut);
+}
+
+void Hash_bmw512_80x8(const unsigned char* pHeaders, uint256* phashOut)
+{
+    Hash_bmw512_80(pHeaders, 8, phashOut);
+}
+
+std::string BMW512Implementation()
+{
+    return Current()->pszName;
+}
+
+bool BMW512SelectImplementation(const std::string& strName)
+{
+    const BMW512Kernels* pKernels = NULL;
+
+    if (strName.empty())
+        pKernels = AutoDetect();
+    else if (strName == kernelsGeneric.pszName)
+        pKernels = &kernelsGeneric;
+#ifdef USE_X86_TARGET_ATTRIBUTES
+    else if (strName == kernelsSSE41.pszName && CPUHasSSE41())
+        pKernels = &kernelsSSE41;
+    else if (strName == kernelsAVX2.pszName && CPUHasAVX2())
+        pKernels = &kernelsAVX2;
+#endif
+
+    if (pKernels == NULL)
+        return false;
+
+    Current() = pKernels;
+
+    return true;
+}
@@ -5,6 +5,9 @@
 #include "uint/uint256.h"
 #include "../common/sph_bmw.h"
 
+#include <stddef.h>
+#include <string>
+
 #ifndef QT_NO_DEBUG
 #include <string>
 #endif
@@ -46,8 +49,21 @@ inline uint256 Hash_bmw512(const T1 pbegin, const T1 pend)
 }
 
 
+/** BMW-512 of one 80 byte block header, the same value as Hash_bmw512 over
+ *  those bytes. The message is a single block, so this skips the sph buffering. */
+uint256 Hash_bmw512_80(const unsigned char* pHeader);
 
+/** Hash nCount consecutive 80 byte block headers into phashOut[0..nCount).
+ *  Runs 8, 4 or 2 headers at a time with the widest SIMD implementation the
+ *  CPU supports (AVX2, SSE4.1), the portable code otherwise. */
+void Hash_bmw512_80(const unsigned char* pHeaders, size_t nCount, uint256* phashOut);
+void Hash_bmw512_80x4(const unsigned char* pHeaders, uint256* phashOut);
+void Hash_bmw512_80x8(const unsigned char* pHeaders, uint256* phashOut);
 
-
+/** Name of the implementation in use: "avx2", "sse4.1" or "generic". */
+std::string BMW512Implementation();
+/** Force an implementation, for tests and benchmarks. An empty name selects
+ *  the detected one. Returns false if the CPU does not support it. */
+bool BMW512SelectImplementation(const std::string& strName);
 
 #endif // BMW512_H
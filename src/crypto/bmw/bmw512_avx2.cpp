@@ -0,0 +1,35 @@
+#include "crypto/common/cpufeatures.h"
+
+#ifdef USE_X86_TARGET_ATTRIBUTES
+
+#include <stdint.h>
+
+#include "crypto/common/common.h"
+
+// Four lanes fill a ymm register. The eight lane version is two registers
+// per word, the compiler interleaves the two independent chains.
+typedef uint64_t bmw512_v4 __attribute__((vector_size(32)));
+typedef uint64_t bmw512_v8 __attribute__((vector_size(64)));
+
+#define BMW_V           bmw512_v4
+#define BMW_LANES       4
+#define BMW_SPLAT(x)    (bmw512_v4{(uint64_t)(x), (uint64_t)(x), (uint64_t)(x), (uint64_t)(x)})
+#define BMW_SET(v,l,x)  ((v)[l] = (x))
+#define BMW_GET(v,l)    ((v)[l])
+#define BMW_TARGET      __attribute__((target("avx2")))
+#define BMW_FN          Hash_bmw512_80x4_avx2
+
+#include "bmw512_lanes.h"
+
+#define BMW_V           bmw512_v8
+#define BMW_LANES       8
+#define BMW_SPLAT(x)    (bmw512_v8{(uint64_t)(x), (uint64_t)(x), (uint64_t)(x), (uint64_t)(x), \
+                                   (uint64_t)(x), (uint64_t)(x), (uint64_t)(x), (uint64_t)(x)})
+#define BMW_SET(v,l,x)  ((v)[l] = (x))
+#define BMW_GET(v,l)    ((v)[l])
+#define BMW_TARGET      __attribute__((target("avx2")))
+#define BMW_FN          Hash_bmw512_80x8_avx2
+
+#include "bmw512_lanes.h"
+
+#endif // USE_X86_TARGET_ATTRIBUTES
@@ -0,0 +1,184 @@
+// BMW-512 of 80 byte block headers over BMW_LANES independent inputs at once.
+// Internal to the bmw512*.cpp files: each defines the lane type and the
+// target before including this, so one body compiles per instruction set.
+// The parameters are undefined again at the end, so it may be included more
+// than once per file.
+//
+//   BMW_V           type holding BMW_LANES uint64_t, supporting + - ^ << >> |
+//   BMW_LANES       number of headers hashed per call
+//   BMW_SPLAT(x)    BMW_V with every lane set to x
+//   BMW_SET(v,l,x)  set lane l of v to x
+//   BMW_GET(v,l)    lane l of v
+//   BMW_TARGET      function attributes for the instruction set, may be empty
+//   BMW_FN          name of the generated function
+//
+// The message is one padded block: the 80 header bytes, 0x80, zeros and the
+// bit length 640, so sph_bmw512 reduces to compress(IV, M) then
+// compress(final, h). The result is the first 256 bits of the digest, as
+// returned by Hash_bmw512.
+
+#ifndef BMW512_LANES_CONSTANTS
+#define BMW512_LANES_CONSTANTS
+
+static const uint64_t bmw512_iv[16] = {
+    0x8081828384858687ULL, 0x88898A8B8C8D8E8FULL, 0x9091929394959697ULL, 0x98999A9B9C9D9E9FULL,
+    0xA0A1A2A3A4A5A6A7ULL, 0xA8A9AAABACADAEAFULL, 0xB0B1B2B3B4B5B6B7ULL, 0xB8B9BABBBCBDBEBFULL,
+    0xC0C1C2C3C4C5C6C7ULL, 0xC8C9CACBCCCDCECFULL, 0xD0D1D2D3D4D5D6D7ULL, 0xD8D9DADBDCDDDEDFULL,
+    0xE0E1E2E3E4E5E6E7ULL, 0xE8E9EAEBECEDEEEFULL, 0xF0F1F2F3F4F5F6F7ULL, 0xF8F9FAFBFCFDFEFFULL
+};
+
+static const uint64_t bmw512_final[16] = {
+    0xaaaaaaaaaaaaaaa0ULL, 0xaaaaaaaaaaaaaaa1ULL, 0xaaaaaaaaaaaaaaa2ULL, 0xaaaaaaaaaaaaaaa3ULL,
+    0xaaaaaaaaaaaaaaa4ULL, 0xaaaaaaaaaaaaaaa5ULL, 0xaaaaaaaaaaaaaaa6ULL, 0xaaaaaaaaaaaaaaa7ULL,
+    0xaaaaaaaaaaaaaaa8ULL, 0xaaaaaaaaaaaaaaa9ULL, 0xaaaaaaaaaaaaaaaaULL, 0xaaaaaaaaaaaaaaabULL,
+    0xaaaaaaaaaaaaaaacULL, 0xaaaaaaaaaaaaaaadULL, 0xaaaaaaaaaaaaaaaeULL, 0xaaaaaaaaaaaaaaafULL
+};
+
+#endif // BMW512_LANES_CONSTANTS
+
+#define BMW_CONCAT(a, b)   BMW_CONCAT_(a, b)
+#define BMW_CONCAT_(a, b)  a ## b
+
+#define BMW_ROTL(x, n)  (((x) << (n)) | ((x) >> (64 - (n))))
+
+#define BMW_S0(x)  (((x) >> 1) ^ ((x) << 3) ^ BMW_ROTL(x,  4) ^ BMW_ROTL(x, 37))
+#define BMW_S1(x)  (((x) >> 1) ^ ((x) << 2) ^ BMW_ROTL(x, 13) ^ BMW_ROTL(x, 43))
+#define BMW_S2(x)  (((x) >> 2) ^ ((x) << 1) ^ BMW_ROTL(x, 19) ^ BMW_ROTL(x, 53))
+#define BMW_S3(x)  (((x) >> 2) ^ ((x) << 2) ^ BMW_ROTL(x, 28) ^ BMW_ROTL(x, 59))
+#define BMW_S4(x)  (((x) >> 1) ^ (x))
+#define BMW_S5(x)  (((x) >> 2) ^ (x))
+
+#define BMW_W(i0, op01, i1, op12, i2, op23, i3, op34, i4) \
+    ((m[i0] ^ h[i0]) op01 (m[i1] ^ h[i1]) op12 (m[i2] ^ h[i2]) \
+    op23 (m[i3] ^ h[i3]) op34 (m[i4] ^ h[i4]))
+
+#define BMW_ADD_ELT(j) \
+    ((BMW_ROTL(m[(j) & 15], ((j) & 15) + 1) \
+    + BMW_ROTL(m[((j) + 3) & 15], (((j) + 3) & 15) + 1) \
+    - BMW_ROTL(m[((j) + 10) & 15], (((j) + 10) & 15) + 1) \
+    + (uint64_t)((j) + 16) * 0x0555555555555555ULL) ^ h[((j) + 7) & 15])
+
+// Written out per index so every rotation count is a constant.
+#define BMW_EXPAND1(i) \
+    q[i] = BMW_S1(q[i - 16]) + BMW_S2(q[i - 15]) + BMW_S3(q[i - 14]) + BMW_S0(q[i - 13]) \
+         + BMW_S1(q[i - 12]) + BMW_S2(q[i - 11]) + BMW_S3(q[i - 10]) + BMW_S0(q[i - 9]) \
+         + BMW_S1(q[i - 8]) + BMW_S2(q[i - 7]) + BMW_S3(q[i - 6]) + BMW_S0(q[i - 5]) \
+         + BMW_S1(q[i - 4]) + BMW_S2(q[i - 3]) + BMW_S3(q[i - 2]) + BMW_S0(q[i - 1]) \
+         + BMW_ADD_ELT(i - 16)
+
+#define BMW_EXPAND2(i) \
+    q[i] = q[i - 16] + BMW_ROTL(q[i - 15], 5) + q[i - 14] + BMW_ROTL(q[i - 13], 11) \
+         + q[i - 12] + BMW_ROTL(q[i - 11], 27) + q[i - 10] + BMW_ROTL(q[i - 9], 32) \
+         + q[i - 8] + BMW_ROTL(q[i - 7], 37) + q[i - 6] + BMW_ROTL(q[i - 5], 43) \
+         + q[i - 4] + BMW_ROTL(q[i - 3], 53) + BMW_S4(q[i - 2]) + BMW_S5(q[i - 1]) \
+         + BMW_ADD_ELT(i - 16)
+
+static inline BMW_TARGET void BMW_CONCAT(BMW_FN, _compress)(const BMW_V* m, const BMW_V* h, BMW_V* dh)
+{
+    BMW_V q[32];
+
+    q[ 0] = BMW_S0(BMW_W( 5, -,  7, +, 10, +, 13, +, 14)) + h[ 1];
+    q[ 1] = BMW_S1(BMW_W( 6, -,  8, +, 11, +, 14, -, 15)) + h[ 2];
+    q[ 2] = BMW_S2(BMW_W( 0, +,  7, +,  9, -, 12, +, 15)) + h[ 3];
+    q[ 3] = BMW_S3(BMW_W( 0, -,  1, +,  8, -, 10, +, 13)) + h[ 4];
+    q[ 4] = BMW_S4(BMW_W( 1, +,  2, +,  9, -, 11, -, 14)) + h[ 5];
+    q[ 5] = BMW_S0(BMW_W( 3, -,  2, +, 10, -, 12, +, 15)) + h[ 6];
+    q[ 6] = BMW_S1(BMW_W( 4, -,  0, -,  3, -, 11, +, 13)) + h[ 7];
+    q[ 7] = BMW_S2(BMW_W( 1, -,  4, -,  5, -, 12, -, 14)) + h[ 8];
+    q[ 8] = BMW_S3(BMW_W( 2, -,  5, -,  6, +, 13, -, 15)) + h[ 9];
+    q[ 9] = BMW_S4(BMW_W( 0, -,  3, +,  6, -,  7, +, 14)) + h[10];
+    q[10] = BMW_S0(BMW_W( 8, -,  1, -,  4, -,  7, +, 15)) + h[11];
+    q[11] = BMW_S1(BMW_W( 8, -,  0, -,  2, -,  5, +,  9)) + h[12];
+    q[12] = BMW_S2(BMW_W( 1, +,  3, -,  6, -,  9, +, 10)) + h[13];
+    q[13] = BMW_S3(BMW_W( 2, +,  4, +,  7, +, 10, +, 11)) + h[14];
+    q[14] = BMW_S4(BMW_W( 3, -,  5, +,  8, -, 11, -, 12)) + h[15];
+    q[15] = BMW_S0(BMW_W(12, -,  4, -,  6, -,  9, +, 13)) + h[ 0];
+
+    BMW_EXPAND1(16); BMW_EXPAND1(17);
+    BMW_EXPAND2(18); BMW_EXPAND2(19); BMW_EXPAND2(20); BMW_EXPAND2(21);
+    BMW_EXPAND2(22); BMW_EXPAND2(23); BMW_EXPAND2(24); BMW_EXPAND2(25);
+    BMW_EXPAND2(26); BMW_EXPAND2(27); BMW_EXPAND2(28); BMW_EXPAND2(29);
+    BMW_EXPAND2(30); BMW_EXPAND2(31);
+
+    BMW_V xl = q[16] ^ q[17] ^ q[18] ^ q[19] ^ q[20] ^ q[21] ^ q[22] ^ q[23];
+    BMW_V xh = xl ^ q[24] ^ q[25] ^ q[26] ^ q[27] ^ q[28] ^ q[29] ^ q[30] ^ q[31];
+
+    dh[ 0] = ((xh <<  5) ^ (q[16] >>  5) ^ m[ 0]) + (xl ^ q[24] ^ q[ 0]);
+    dh[ 1] = ((xh >>  7) ^ (q[17] <<  8) ^ m[ 1]) + (xl ^ q[25] ^ q[ 1]);
+    dh[ 2] = ((xh >>  5) ^ (q[18] <<  5) ^ m[ 2]) + (xl ^ q[26] ^ q[ 2]);
+    dh[ 3] = ((xh >>  1) ^ (q[19] <<  5) ^ m[ 3]) + (xl ^ q[27] ^ q[ 3]);
+    dh[ 4] = ((xh >>  3) ^  q[20]        ^ m[ 4]) + (xl ^ q[28] ^ q[ 4]);
+    dh[ 5] = ((xh <<  6) ^ (q[21] >>  6) ^ m[ 5]) + (xl ^ q[29] ^ q[ 5]);
+    dh[ 6] = ((xh >>  4) ^ (q[22] <<  6) ^ m[ 6]) + (xl ^ q[30] ^ q[ 6]);
+    dh[ 7] = ((xh >> 11) ^ (q[23] <<  2) ^ m[ 7]) + (xl ^ q[31] ^ q[ 7]);
+    dh[ 8] = BMW_ROTL(dh[4],  9) + (xh ^ q[24] ^ m[ 8]) + ((xl << 8) ^ q[23] ^ q[ 8]);
+    dh[ 9] = BMW_ROTL(dh[5], 10) + (xh ^ q[25] ^ m[ 9]) + ((xl >> 6) ^ q[16] ^ q[ 9]);
+    dh[10] = BMW_ROTL(dh[6], 11) + (xh ^ q[26] ^ m[10]) + ((xl << 6) ^ q[17] ^ q[10]);
+    dh[11] = BMW_ROTL(dh[7], 12) + (xh ^ q[27] ^ m[11]) + ((xl << 4) ^ q[18] ^ q[11]);
+    dh[12] = BMW_ROTL(dh[0], 13) + (xh ^ q[28] ^ m[12]) + ((xl >> 3) ^ q[19] ^ q[12]);
+    dh[13] = BMW_ROTL(dh[1], 14) + (xh ^ q[29] ^ m[13]) + ((xl >> 4) ^ q[20] ^ q[13]);
+    dh[14] = BMW_ROTL(dh[2], 15) + (xh ^ q[30] ^ m[14]) + ((xl >> 7) ^ q[21] ^ q[14]);
+    dh[15] = BMW_ROTL(dh[3], 16) + (xh ^ q[31] ^ m[15]) + ((xl >> 2) ^ q[22] ^ q[15]);
+}
+
+/** Hash BMW_LANES consecutive 80 byte headers from pHeaders into phashOut. */
+BMW_TARGET void BMW_FN(const unsigned char* pHeaders, unsigned char* phashOut)
+{
+    BMW_V m[16], h[16], h2[16], h1[16];
+
+    for (int i = 0; i < 16; i++)
+    {
+        h[i] = BMW_SPLAT(bmw512_iv[i]);
+        m[i] = BMW_SPLAT(0);
+    }
+
+    for (int l = 0; l < BMW_LANES; l++)
+    {
+        const unsigned char* p = pHeaders + 80 * l;
+
+        for (int i = 0; i < 10; i++)
+            BMW_SET(m[i], l, ReadLE64(p + 8 * i));
+    }
+
+    m[10] = BMW_SPLAT(0x80);
+    m[15] = BMW_SPLAT(640);
+
+    BMW_CONCAT(BMW_FN, _compress)(m, h, h2);
+
+    for (int i = 0; i < 16; i++)
+    {
+        h[i] = BMW_SPLAT(bmw512_final[i]);
+    }
+
+    BMW_CONCAT(BMW_FN, _compress)(h2, h, h1);
+
+    for (int l = 0; l < BMW_LANES; l++)
+    {
+        unsigned char* p = phashOut + 32 * l;
+
+        for (int i = 0; i < 4; i++)
+            WriteLE64(p + 8 * i, BMW_GET(h1[8 + i], l));
+    }
+}
+
+#undef BMW_CONCAT
+#undef BMW_CONCAT_
+#undef BMW_ROTL
+#undef BMW_S0
+#undef BMW_S1
+#undef BMW_S2
+#undef BMW_S3
+#undef BMW_S4
+#undef BMW_S5
+#undef BMW_W
+#undef BMW_ADD_ELT
+#undef BMW_EXPAND1
+#undef BMW_EXPAND2
+
+#undef BMW_V
+#undef BMW_LANES
+#undef BMW_SPLAT
+#undef BMW_SET
+#undef BMW_GET
+#undef BMW_TARGET
+#undef BMW_FN
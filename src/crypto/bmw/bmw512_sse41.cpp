@@ -0,0 +1,21 @@
+#include "crypto/common/cpufeatures.h"
+
+#ifdef USE_X86_TARGET_ATTRIBUTES
+
+#include <stdint.h>
+
+#include "crypto/common/common.h"
+
+typedef uint64_t bmw512_v2 __attribute__((vector_size(16)));
+
+#define BMW_V           bmw512_v2
+#define BMW_LANES       2
+#define BMW_SPLAT(x)    (bmw512_v2{(uint64_t)(x), (uint64_t)(x)})
+#define BMW_SET(v,l,x)  ((v)[l] = (x))
+#define BMW_GET(v,l)    ((v)[l])
+#define BMW_TARGET      __attribute__((target("sse4.1")))
+#define BMW_FN          Hash_bmw512_80x2_sse41
+
+#include "bmw512_lanes.h"
+
+#endif // USE_X86_TARGET_ATTRIBUTES
@@ -0,0 +1,88 @@
+#include "cpufeatures.h"
+
+#ifdef USE_X86_TARGET_ATTRIBUTES
+#include <cpuid.h>
+#endif
+
+namespace
+{
+#ifdef USE_X86_TARGET_ATTRIBUTES
+struct CPUFeatures
+{
+    bool fSSE41;
+    bool fAVX2;
+    bool fAESNI;
+    bool fSHANI;
+
+    CPUFeatures() : fSSE41(false), fAVX2(false), fAESNI(false), fSHANI(false)
+    {
+        unsigned int eax, ebx, ecx, edx;
+
+        if (!__get_cpuid(0, &eax, &ebx, &ecx, &edx))
+            return;
+
+        unsigned int nMaxLeaf = eax;
+
+        __cpuid(1, eax, ebx, ecx, edx);
+
+        fSSE41 = (ecx >> 19) & 1;
+        fAESNI = (ecx >> 25) & 1;
+
+        // AVX registers are only usable if the OS enabled them in XCR0.
+        bool fOSXSAVE = (ecx >> 27) & 1;
+        bool fAVX = (ecx >> 28) & 1;
+        bool fYMM = false;
+
+        if (fOSXSAVE && fAVX)
+        {
+            unsigned int xcr0_lo, xcr0_hi;
+            __asm__ __volatile__("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+            fYMM = (xcr0_lo & 6) == 6;
+        }
+
+        if (nMaxLeaf >= 7)
+        {
+            __cpuid_count(7, 0, eax, ebx, ecx, edx);
+            fAVX2 = fYMM && ((ebx >> 5) & 1);
+            fSHANI = fSSE41 && ((ebx >> 29) & 1);
+        }
+    }
+};
+#else
+struct CPUFeatures
+{
+    bool fSSE41;
+    bool fAVX2;
+    bool fAESNI;
+    bool fSHANI;
+
+    CPUFeatures() : fSSE41(false), fAVX2(false), fAESNI(false), fSHANI(false) {}
+};
+#endif
+
+const CPUFeatures& GetCPUFeatures()
+{
+    static const CPUFeatures features;
+    return features;
+}
+} // namespace
+
+bool CPUHasSSE41()
+{
+    return GetCPUFeatures().fSSE41;
+}
+
+bool CPUHasAVX2()
+{
+    return GetCPUFeatures().fAVX2;
+}
+
+bool CPUHasAESNI()
+{
+    return GetCPUFeatures().fAESNI;
+}
+
+bool CPUHasSHANI()
+{
+    return GetCPUFeatures().fSHANI;
+}
@@ -0,0 +1,18 @@
+#ifndef TX_CRYPTO_CPUFEATURES_H
+#define TX_CRYPTO_CPUFEATURES_H
+
+#if (defined(__x86_64__) || defined(__amd64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+/** The compiler can build x86 SIMD functions with __attribute__((target)) */
+#define USE_X86_TARGET_ATTRIBUTES 1
+#endif
+
+/** Runtime detection of the x86 instruction set extensions the hash
+ *  implementations can use. Each also checks that the OS saves the register
+ *  state the extension needs. All return false on other architectures.
+ */
+bool CPUHasSSE41();
+bool CPUHasAVX2();
+bool CPUHasAESNI();
+bool CPUHasSHANI();
+
+#endif // TX_CRYPTO_CPUFEATURES_H
@@ -7,6 +7,7 @@
 
 #include <stdint.h>
 #include <stdlib.h>
+#include <string>
 
 /** A hasher class for SHA-256. */
 class CSHA256
@@ -25,4 +26,16 @@ public:
     CSHA256& Reset();
 };
 
+/** Compute the double SHA-256 of blocks 64-byte inputs, e.g. the child pairs
+ *  of a Merkle tree level.
+ *  out:    blocks * 32 bytes of output
+ *  in:     blocks * 64 bytes of input
+ */
+void SHA256D64(unsigned char* out, const unsigned char* in, size_t blocks);
+
+/** Name of the SHA-256 implementation in use: "shani+avx2", "shani", "avx2" or "generic" */
+std::string SHA256Implementation();
+/** Use the named implementation if the CPU supports it, "" for autodetection */
+bool SHA256SelectImplementation(const std::string& strName);
+
 #endif // BITCOIN_CRYPTO_SHA256_H
@@ -0,0 +1,130 @@
+// Double SHA-256 of eight 64-byte inputs at once, one per 32-bit lane of an
+// AVX2 register. Used for Merkle tree nodes, see SHA256D64 in sha256.cpp.
+
+#include "crypto/common/cpufeatures.h"
+
+#ifdef USE_X86_TARGET_ATTRIBUTES
+
+#include <stdint.h>
+
+#include "crypto/common/common.h"
+
+#define SHA_TARGET __attribute__((target("avx2")))
+
+namespace
+{
+typedef uint32_t v8u __attribute__((vector_size(32)));
+
+static const uint32_t K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+static const uint32_t IV[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+};
+
+static inline SHA_TARGET v8u Splat(uint32_t x) { v8u v = {x, x, x, x, x, x, x, x}; return v; }
+static inline SHA_TARGET v8u Ror(v8u x, int n) { return (x >> n) | (x << (32 - n)); }
+static inline SHA_TARGET v8u Ch(v8u x, v8u y, v8u z) { return z ^ (x & (y ^ z)); }
+static inline SHA_TARGET v8u Maj(v8u x, v8u y, v8u z) { return (x & y) | (z & (x | y)); }
+static inline SHA_TARGET v8u Sigma0(v8u x) { return Ror(x, 2) ^ Ror(x, 13) ^ Ror(x, 22); }
+static inline SHA_TARGET v8u Sigma1(v8u x) { return Ror(x, 6) ^ Ror(x, 11) ^ Ror(x, 25); }
+static inline SHA_TARGET v8u sigma0(v8u x) { return Ror(x, 7) ^ Ror(x, 18) ^ (x >> 3); }
+static inline SHA_TARGET v8u sigma1(v8u x) { return Ror(x, 17) ^ Ror(x, 19) ^ (x >> 10); }
+
+static inline SHA_TARGET void Round(v8u a, v8u b, v8u c, v8u& d, v8u e, v8u f, v8u g, v8u& h, int i, v8u w)
+{
+    v8u t1 = h + Sigma1(e) + Ch(e, f, g) + Splat(K[i]) + w;
+    v8u t2 = Sigma0(a) + Maj(a, b, c);
+    d += t1;
+    h = t1 + t2;
+}
+
+/** Message word i, w holds the last 16 */
+static inline SHA_TARGET v8u Msg(v8u* w, int i)
+{
+    if (i >= 16)
+        w[i & 15] += sigma1(w[(i - 2) & 15]) + w[(i - 7) & 15] + sigma0(w[(i - 15) & 15]);
+
+    return w[i & 15];
+}
+
+/** One compression of eight states, w is clobbered */
+static inline SHA_TARGET void Compress(v8u* s, v8u* w)
+{
+    v8u a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
+
+    for (int i = 0; i < 64; i += 8)
+    {
+        Round(a, b, c, d, e, f, g, h, i + 0, Msg(w, i + 0));
+        Round(h, a, b, c, d, e, f, g, i + 1, Msg(w, i + 1));
+        Round(g, h, a, b, c, d, e, f, i + 2, Msg(w, i + 2));
+        Round(f, g, h, a, b, c, d, e, i + 3, Msg(w, i + 3));
+        Round(e, f, g, h, a, b, c, d, i + 4, Msg(w, i + 4));
+        Round(d, e, f, g, h, a, b, c, i + 5, Msg(w, i + 5));
+        Round(c, d, e, f, g, h, a, b, i + 6, Msg(w, i + 6));
+        Round(b, c, d, e, f, g, h, a, i + 7, Msg(w, i + 7));
+    }
+
+    s[0] += a; s[1] += b; s[2] += c; s[3] += d;
+    s[4] += e; s[5] += f; s[6] += g; s[7] += h;
+}
+
+static inline SHA_TARGET void Initialize(v8u* s)
+{
+    for (int i = 0; i < 8; i++)
+        s[i] = Splat(IV[i]);
+}
+
+/** Word i of each of the eight 64-byte inputs */
+static inline SHA_TARGET v8u Read8(const unsigned char* in, int i)
+{
+    const unsigned char* p = in + 4 * i;
+    v8u v = {
+        ReadBE32(p), ReadBE32(p + 64), ReadBE32(p + 128), ReadBE32(p + 192),
+        ReadBE32(p + 256), ReadBE32(p + 320), ReadBE32(p + 384), ReadBE32(p + 448)
+    };
+
+    return v;
+}
+} // namespace
+
+SHA_TARGET void SHA256D64x8_avx2(unsigned char* out, const unsigned char* in)
+{
+    v8u s[8], w[16];
+
+    Initialize(s);
+    for (int i = 0; i < 16; i++)
+        w[i] = Read8(in, i);
+    Compress(s, w);
+
+    // Padding block of a 64 byte message
+    w[0] = Splat(0x80000000);
+    for (int i = 1; i < 15; i++)
+        w[i] = Splat(0);
+    w[15] = Splat(512);
+    Compress(s, w);
+
+    // Second hash, of the 32 byte first one
+    for (int i = 0; i < 8; i++)
+        w[i] = s[i];
+    w[8] = Splat(0x80000000);
+    for (int i = 9; i < 15; i++)
+        w[i] = Splat(0);
+    w[15] = Splat(256);
+    Initialize(s);
+    Compress(s, w);
+
+    for (int l = 0; l < 8; l++)
+        for (int i = 0; i < 8; i++)
+            WriteBE32(out + 32 * l + 4 * i, s[i][l]);
+}
+
+#endif // USE_X86_TARGET_ATTRIBUTES
@@ -0,0 +1,85 @@
+// SHA-256 compression using the x86 SHA extensions. Same results as
+// sha256::Transform in sha256.cpp, which is used on other CPUs.
+
+#include "crypto/common/cpufeatures.h"
+
+#ifdef USE_X86_TARGET_ATTRIBUTES
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <immintrin.h>
+
+#define SHA_TARGET __attribute__((target("sha,sse4.1")))
+
+namespace
+{
+alignas(16) static const uint32_t K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+/** Four rounds, with message words m and round constants K[i..i+3] */
+static inline SHA_TARGET void QuadRound(__m128i& abef, __m128i& cdgh, __m128i m, int i)
+{
+    __m128i msg = _mm_add_epi32(m, _mm_load_si128((const __m128i*)(K + i)));
+
+    cdgh = _mm_sha256rnds2_epu32(cdgh, abef, msg);
+    abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(msg, 0x0e));
+}
+
+/** Message words W[t..t+3] from m0 = W[t-16..t-13] .. m3 = W[t-4..t-1] */
+static inline SHA_TARGET __m128i Schedule(__m128i m0, __m128i m1, __m128i m2, __m128i m3)
+{
+    __m128i w = _mm_sha256msg1_epu32(m0, m1);
+
+    w = _mm_add_epi32(w, _mm_alignr_epi8(m3, m2, 4));
+
+    return _mm_sha256msg2_epu32(w, m3);
+}
+} // namespace
+
+SHA_TARGET void SHA256Transform_shani(uint32_t* s, const unsigned char* chunk, size_t blocks)
+{
+    const __m128i bswap = _mm_set_epi64x(0x0c0d0e0f08090a0bll, 0x0405060700010203ll);
+    __m128i m[4];
+
+    // The SHA instructions keep the state as ABEF and CDGH
+    __m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)s), 0xb1);
+    __m128i cdgh = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)(s + 4)), 0x1b);
+    __m128i abef = _mm_alignr_epi8(tmp, cdgh, 8);
+    cdgh = _mm_blend_epi16(cdgh, tmp, 0xf0);
+
+    for (; blocks > 0; blocks--, chunk += 64)
+    {
+        __m128i abefSave = abef;
+        __m128i cdghSave = cdgh;
+
+        for (int i = 0; i < 4; i++)
+        {
+            m[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(chunk + 16 * i)), bswap);
+            QuadRound(abef, cdgh, m[i], 4 * i);
+        }
+
+        for (int i = 4; i < 16; i++)
+        {
+            m[i & 3] = Schedule(m[i & 3], m[(i + 1) & 3], m[(i + 2) & 3], m[(i + 3) & 3]);
+            QuadRound(abef, cdgh, m[i & 3], 4 * i);
+        }
+
+        abef = _mm_add_epi32(abef, abefSave);
+        cdgh = _mm_add_epi32(cdgh, cdghSave);
+    }
+
+    tmp = _mm_shuffle_epi32(abef, 0x1b);
+    cdgh = _mm_shuffle_epi32(cdgh, 0xb1);
+    _mm_storeu_si128((__m128i*)s, _mm_blend_epi16(tmp, cdgh, 0xf0));
+    _mm_storeu_si128((__m128i*)(s + 4), _mm_alignr_epi8(cdgh, tmp, 8));
+}
+
+#endif // USE_X86_TARGET_ATTRIBUTES
@@ -0,0 +1,116 @@
+#include <string.h>
+
+#include "crypto/common/cpufeatures.h"
+
+#include "echo512.h"
+
+#ifdef USE_X86_TARGET_ATTRIBUTES
+void Hash_echo512_aesni(const unsigned char* data, size_t len, unsigned char* out);
+void Echo512KernelInit_aesni(const unsigned char* pPrefix, uint64_t W1[16][2]);
+void Echo512KernelHash_aesni(const unsigned char* pPrefix, const uint64_t W1[16][2],
+        uint32_t nTimeTx, unsigned char* out);
+#endif
+
+namespace
+{
+bool AutoDetect()
+{
+#ifdef USE_X86_TARGET_ATTRIBUTES
+    return CPUHasAESNI();
+#else
+    return false;
+#endif
+}
+
+// Function local so hashes computed during static initialisation already
+// see the detected implementation.
+bool& UseAESNI()
+{
+    static bool fAESNI = AutoDetect();
+    return fAESNI;
+}
+} // namespace
+
+uint256 Hash_echo512_bytes(const unsigned char* p, size_t len)
+{
+    uint512 hash[1];
+
+#ifdef USE_X86_TARGET_ATTRIBUTES
+    if (UseAESNI())
+    {
+        Hash_echo512_aesni(p, len, hash[0].begin());
+
+        return hash[0].trim256();
+    }
+#endif
+
+    sph_echo512_context ctx_echo;
+
+    sph_echo512_init(&ctx_echo);
+    sph_echo512(&ctx_echo, p, len);
+    sph_echo512_close(&ctx_echo, static_cast<void*>(&hash[0]));
+
+    return hash[0].trim256();
+}
+
+std::string Echo512Implementation()
+{
+    return UseAESNI() ? "aesni" : "generic";
+}
+
+bool Echo512SelectImplementation(const std::string& strName)
+{
+    if (strName.empty())
+        UseAESNI() = AutoDetect();
+    else if (strName == "generic")
+        UseAESNI() = false;
+    else if (strName == "aesni" && AutoDetect())
+        UseAESNI() = true;
+    else
+        return false;
+
+    return true;
+}
+
+CEcho512Kernel::CEcho512Kernel() : fAESNI(false)
+{
+    memset(prefix, 0, sizeof(prefix));
+    memset(W1, 0, sizeof(W1));
+}
+
+void CEcho512Kernel::Init(const unsigned char* pPrefix)
+{
+    memcpy(prefix, pPrefix, PREFIX_SIZE);
+    fAESNI = UseAESNI();
+
+#ifdef USE_X86_TARGET_ATTRIBUTES
+    if (fAESNI)
+    {
+        Echo512KernelInit_aesni(prefix, W1);
+    }
+#endif
+}
+
+uint256 CEcho512Kernel::Hash(uint32_t nTimeTx) const
+{
+#ifdef USE_X86_TARGET_ATTRIBUTES
+    if (fAESNI)
+    {
+        uint256 hash;
+
+        Echo512KernelHash_aesni(prefix, W1, nTimeTx, hash.begin());
+
+        return hash;
+    }
+#endif
+
+    unsigned char data[PREFIX_SIZE + 4];
+
+    memcpy(data, prefix, PREFIX_SIZE);
+    data[PREFIX_SIZE] = nTimeTx & 0xff;
+    data[PREFIX_SIZE + 1] = (nTimeTx >> 8) & 0xff;
+    data[PREFIX_SIZE + 2] = (nTimeTx >> 16) & 0xff;
+    data[PREFIX_SIZE + 3] = (nTimeTx >> 24) & 0xff;
+
+    return Hash_echo512_bytes(data, sizeof(data));
+}
@@ -5,9 +5,9 @@
 #include "uint/uint256.h"
 #include "../common/sph_echo.h"
 
-#ifndef QT_NO_DEBUG
+#include <stddef.h>
+#include <stdint.h>
 #include <string>
-#endif
 
 #ifdef GLOBALDEFINED
 #define GLOBAL
@@ -22,25 +22,46 @@ GLOBAL sph_echo512_context       z_echo;
     sph_echo512_init(&z_echo); \
 } while (0)*/
 
+/** ECHO-512 of len bytes, the first 256 bits of the digest. Uses AES-NI when
+ *  the CPU supports it, the sph code otherwise. */
+uint256 Hash_echo512_bytes(const unsigned char* p, size_t len);
+
 template<typename T1>
 inline uint256 Hash_echo512(const T1 pbegin, const T1 pend)
 
 {
-    sph_echo512_context       ctx_echo;
     static unsigned char pblank[1];
 
-#ifndef QT_NO_DEBUG
-    //std::string strhash;
-    //strhash = "";
-#endif
-    
-    uint512 hash[1];
+    return Hash_echo512_bytes((pbegin == pend ? pblank : reinterpret_cast<const unsigned char*>(&pbegin[0])), (pend - pbegin) * sizeof(pbegin[0]));
+}
 
-    sph_echo512_init(&ctx_echo);
-    sph_echo512 (&ctx_echo, (pbegin == pend ? pblank : static_cast<const void*>(&pbegin[0])), (pend - pbegin) * sizeof(pbegin[0]));
-    sph_echo512_close(&ctx_echo, static_cast<void*>(&hash[0]));
+/** Name of the implementation in use: "aesni" or "generic". */
+std::string Echo512Implementation();
+/** Force an implementation, for tests and benchmarks. An empty name selects
+ *  the detected one. Returns false if the CPU does not support it. */
+bool Echo512SelectImplementation(const std::string& strName);
 
-    return hash[0].trim256();
-}
+/** Hash_echo512 of the 76 byte proof-of-stake kernel
+ *      bnStakeModifierV2 (32) + txPrev.nTime (4) + prevout.hash (32) +
+ *      prevout.n (4) + nTimeTx (4)
+ *  for one staking output and varying nTimeTx. The input is a single ECHO
+ *  block, and with AES-NI Init already runs the first round on every word
+ *  except the one holding nTimeTx. */
+class CEcho512Kernel
+{
+public:
+    static const size_t PREFIX_SIZE = 72;
+
+    CEcho512Kernel();
+
+    /** pPrefix is the kernel input up to nTimeTx, PREFIX_SIZE bytes. */
+    void Init(const unsigned char* pPrefix);
+    uint256 Hash(uint32_t nTimeTx) const;
+
+private:
+    unsigned char prefix[PREFIX_SIZE];
+    uint64_t W1[16][2];
+    bool fAESNI;
+};
 
 #endif // ECHO512_H
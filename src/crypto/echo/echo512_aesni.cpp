@@ -0,0 +1,247 @@
+// ECHO-512 with the AES rounds done by AES-NI. Same results as the sph
+// code in crypto/common/echo.c, which is the fallback on other CPUs.
+
+#include "crypto/common/cpufeatures.h"
+
+#ifdef USE_X86_TARGET_ATTRIBUTES
+
+#include <stdint.h>
+#include <string.h>
+#include <wmmintrin.h>
+#include <emmintrin.h>
+
+#define ECHO_TARGET __attribute__((target("aes")))
+
+namespace
+{
+/** Round key of the j-th AES double round after counter (klo, khi) */
+static inline ECHO_TARGET __m128i KeyAt(uint64_t klo, uint64_t khi, unsigned int j)
+{
+    uint64_t lo = klo + j;
+
+    if (lo < klo)
+        khi++;
+
+    return _mm_set_epi64x((long long)khi, (long long)lo);
+}
+
+static inline ECHO_TARGET __m128i AES2(__m128i w, __m128i k)
+{
+    w = _mm_aesenc_si128(w, k);
+    return _mm_aesenc_si128(w, _mm_setzero_si128());
+}
+
+/** Multiply each byte by 2 in GF(2^8) */
+static inline ECHO_TARGET __m128i Mul2(__m128i x)
+{
+    __m128i hi = _mm_cmpgt_epi8(_mm_setzero_si128(), x);
+
+    return _mm_xor_si128(_mm_add_epi8(x, x), _mm_and_si128(hi, _mm_set1_epi8(0x1b)));
+}
+
+static inline ECHO_TARGET void MixColumn(__m128i* W, int ia, int ib, int ic, int id)
+{
+    __m128i a = W[ia];
+    __m128i b = W[ib];
+    __m128i c = W[ic];
+    __m128i d = W[id];
+    __m128i ab = _mm_xor_si128(a, b);
+    __m128i bc = _mm_xor_si128(b, c);
+    __m128i cd = _mm_xor_si128(c, d);
+    __m128i abx = Mul2(ab);
+    __m128i bcx = Mul2(bc);
+    __m128i cdx = Mul2(cd);
+
+    W[ia] = _mm_xor_si128(abx, _mm_xor_si128(bc, d));
+    W[ib] = _mm_xor_si128(bcx, _mm_xor_si128(a, cd));
+    W[ic] = _mm_xor_si128(cdx, _mm_xor_si128(ab, d));
+    W[id] = _mm_xor_si128(_mm_xor_si128(abx, bcx), _mm_xor_si128(_mm_xor_si128(cdx, ab), c));
+}
+
+static inline ECHO_TARGET void ShiftRows(__m128i* W)
+{
+    __m128i tmp;
+
+    tmp = W[1]; W[1] = W[5]; W[5] = W[9]; W[9] = W[13]; W[13] = tmp;
+    tmp = W[2]; W[2] = W[10]; W[10] = tmp;
+    tmp = W[6]; W[6] = W[14]; W[14] = tmp;
+    tmp = W[15]; W[15] = W[11]; W[11] = W[7]; W[7] = W[3]; W[3] = tmp;
+}
+
+static inline ECHO_TARGET void ShiftRowsMixColumns(__m128i* W)
+{
+    ShiftRows(W);
+    MixColumn(W, 0, 1, 2, 3);
+    MixColumn(W, 4, 5, 6, 7);
+    MixColumn(W, 8, 9, 10, 11);
+    MixColumn(W, 12, 13, 14, 15);
+}
+
+/** Rounds nFirst..nEnd-1 of the compression, counter (klo, khi) as at round 0 */
+static inline ECHO_TARGET void Rounds(__m128i* W, int nFirst, int nEnd, uint64_t klo, uint64_t khi)
+{
+    for (int r = nFirst; r < nEnd; r++)
+    {
+        for (int i = 0; i < 16; i++)
+            W[i] = AES2(W[i], KeyAt(klo, khi, 16 * r + i));
+
+        ShiftRowsMixColumns(W);
+    }
+}
+
+static ECHO_TARGET void Compress(__m128i* V, const unsigned char* block, uint64_t klo, uint64_t khi)
+{
+    __m128i W[16], M[8];
+
+    for (int i = 0; i < 8; i++)
+    {
+        M[i] = _mm_loadu_si128((const __m128i*)(block + 16 * i));
+        W[i] = V[i];
+        W[i + 8] = M[i];
+    }
+
+    Rounds(W, 0, 10, klo, khi);
+
+    for (int i = 0; i < 8; i++)
+        V[i] = _mm_xor_si128(_mm_xor_si128(V[i], M[i]), _mm_xor_si128(W[i], W[i + 8]));
+}
+
+static inline ECHO_TARGET __m128i IV512()
+{
+    return _mm_set_epi64x(0, 512);
+}
+
+// Layout of the single block holding a 76 byte stake kernel
+static const unsigned int KERNEL_SIZE = 76;
+static const uint64_t KERNEL_BITS = 8 * KERNEL_SIZE;
+} // namespace
+
+ECHO_TARGET void Hash_echo512_aesni(const unsigned char* data, size_t len, unsigned char* out)
+{
+    __m128i V[8];
+    uint64_t clo = 0, chi = 0;
+    unsigned char buf[128];
+
+    for (int i = 0; i < 8; i++)
+        V[i] = IV512();
+
+    for (; len >= 128; data += 128, len -= 128)
+    {
+        if ((clo += 1024) < 1024)
+            chi++;
+
+        Compress(V, data, clo, chi);
+    }
+
+    // Padding: 0x80, zeros, the 16 bit output size and the 128 bit message
+    // bit count. A block with no message bits is compressed with counter 0.
+    uint64_t elen = 8 * len;
+
+    if ((clo += elen) < elen)
+        chi++;
+
+    uint64_t klo = (elen == 0) ? 0 : clo;
+    uint64_t khi = (elen == 0) ? 0 : chi;
+
+    memcpy(buf, data, len);
+    buf[len] = 0x80;
+    memset(buf + len + 1, 0, sizeof(buf) - len - 1);
+
+    if (len + 1 > sizeof(buf) - 18)
+    {
+        Compress(V, buf, klo, khi);
+        klo = khi = 0;
+        memset(buf, 0, sizeof(buf));
+    }
+
+    buf[110] = 512 & 0xff;
+    buf[111] = 512 >> 8;
+
+    for (int i = 0; i < 8; i++)
+    {
+        buf[112 + i] = (unsigned char)(clo >> (8 * i));
+        buf[120 + i] = (unsigned char)(chi >> (8 * i));
+    }
+
+    Compress(V, buf, klo, khi);
+
+    for (int i = 0; i < 4; i++)
+        _mm_storeu_si128((__m128i*)(out + 16 * i), V[i]);
+}
+
+/** Words of the block after the first SubWords, except word 12 which holds
+ *  nTimeTx and is left as the raw message word. */
+ECHO_TARGET void Echo512KernelInit_aesni(const unsigned char* pPrefix, uint64_t W1[16][2])
+{
+    unsigned char block[128];
+    __m128i W[16];
+
+    memset(block, 0, sizeof(block));
+    memcpy(block, pPrefix, KERNEL_SIZE - 4);
+    block[KERNEL_SIZE] = 0x80;
+    block[110] = 512 & 0xff;
+    block[111] = 512 >> 8;
+
+    for (int i = 0; i < 8; i++)
+        block[112 + i] = (unsigned char)(KERNEL_BITS >> (8 * i));
+
+    for (int i = 0; i < 8; i++)
+    {
+        W[i] = IV512();
+        W[i + 8] = _mm_loadu_si128((const __m128i*)(block + 16 * i));
+    }
+
+    for (int i = 0; i < 16; i++)
+    {
+        if (i != 12)
+            W[i] = AES2(W[i], KeyAt(KERNEL_BITS, 0, i));
+
+        _mm_storeu_si128((__m128i*)W1[i], W[i]);
+    }
+}
+
+/** First 256 bits of the ECHO-512 of pPrefix + nTimeTx, from the words
+ *  Echo512KernelInit_aesni computed. */
+ECHO_TARGET void Echo512KernelHash_aesni(const unsigned char* pPrefix, const uint64_t W1[16][2],
+        uint32_t nTimeTx, unsigned char* out)
+{
+    __m128i W[16];
+
+    for (int i = 0; i < 16; i++)
+        W[i] = _mm_loadu_si128((const __m128i*)W1[i]);
+
+    // nTimeTx is bytes 72..75 of the block, the low half of the high 64 bits
+    // of word 12
+    W[12] = _mm_or_si128(W[12], _mm_set_epi64x((long long)nTimeTx, 0));
+    W[12] = AES2(W[12], KeyAt(KERNEL_BITS, 0, 12));
+    ShiftRowsMixColumns(W);
+
+    Rounds(W, 1, 9, KERNEL_BITS, 0);
+
+    // Only the first 256 bits of the digest are used, V[0] and V[1]. They
+    // need words 0, 1, 8 and 9 after the last round, i.e. columns 0 and 2,
+    // so the last round skips the words that shift into columns 1 and 3.
+    const unsigned int k = 16 * 9;
+    __m128i T[12];
+
+    T[0] = AES2(W[0], KeyAt(KERNEL_BITS, 0, k + 0));
+    T[1] = AES2(W[5], KeyAt(KERNEL_BITS, 0, k + 5));
+    T[2] = AES2(W[10], KeyAt(KERNEL_BITS, 0, k + 10));
+    T[3] = AES2(W[15], KeyAt(KERNEL_BITS, 0, k + 15));
+    T[8] = AES2(W[8], KeyAt(KERNEL_BITS, 0, k + 8));
+    T[9] = AES2(W[13], KeyAt(KERNEL_BITS, 0, k + 13));
+    T[10] = AES2(W[2], KeyAt(KERNEL_BITS, 0, k + 2));
+    T[11] = AES2(W[7], KeyAt(KERNEL_BITS, 0, k + 7));
+    MixColumn(T, 0, 1, 2, 3);
+    MixColumn(T, 8, 9, 10, 11);
+
+    for (int i = 0; i < 2; i++)
+    {
+        __m128i M = _mm_loadu_si128((const __m128i*)(pPrefix + 16 * i));
+        __m128i V = _mm_xor_si128(_mm_xor_si128(IV512(), M), _mm_xor_si128(T[i], T[i + 8]));
+
+        _mm_storeu_si128((__m128i*)(out + 16 * i), V);
+    }
+}
+
+#endif // USE_X86_TARGET_ATTRIBUTES
@@ -56,22 +56,21 @@ CScript::CScript()
 	
 }
 
-CScript::CScript(const CScript& b) : std::vector<unsigned char>(b.begin(), b.end())
+CScript::CScript(const CScript& b) : CScriptBase(b)
 {
 	
 }
 
-CScript::CScript(const_iterator pbegin, const_iterator pend) : std::vector<unsigned char>(pbegin, pend)
+CScript::CScript(const_iterator pbegin, const_iterator pend) : CScriptBase(pbegin, pend)
 {
 	
 }
 
-#ifndef _MSC_VER
-CScript::CScript(const unsigned char* pbegin, const unsigned char* pend) : std::vector<unsigned char>(pbegin, pend)
+CScript::CScript(std::vector<unsigned char>::const_iterator pbegin, std::vector<unsigned char>::const_iterator pend) :
+		CScriptBase(pbegin, pend)
 {
 	
 }
-#endif
 
 CScript& CScript::operator+=(const CScript& b)
 {
@@ -515,9 +514,9 @@ bool CScript::IsPayToScriptHash() const
 {
 	// Extra-fast test for pay-to-script-hash CScripts:
 	return (this->size() == 23 &&
-			this->at(0) == OP_HASH160 &&
-			this->at(1) == 0x14 &&
-			this->at(22) == OP_EQUAL);
+			(*this)[0] == OP_HASH160 &&
+			(*this)[1] == 0x14 &&
+			(*this)[22] == OP_EQUAL);
 }
 
 // Called by IsStandardTx and P2SH VerifyScript (which makes it consensus-critical).
@@ -656,12 +655,13 @@ std::string CScript::ToString(bool fShort) const
 
 CScriptID CScript::GetID() const
 {
-	return CScriptID(Hash160(*this));
+	return CScriptID(Hash160(begin(), end()));
 }
 
 void CScript::clear()
 {
-	// The default std::vector::clear() does not release memory.
-	std::vector<unsigned char>().swap(*this);
+	// The default prevector::clear() does not release memory.
+	CScriptBase::clear();
+	shrink_to_fit();
 }
 
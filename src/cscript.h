@@ -5,14 +5,20 @@
 
 #include "types/ctxdestination.h"
 #include "enums/opcodetype.h"
+#include "prevector.h"
 
 class uint160;
 class uint256;
 class CBigNum;
 class CPubKey;
 
+/** Scripts up to this size are stored inside the CScript, which covers
+ * P2PKH and P2SH outputs. Signature scripts go to the heap as before.
+ */
+typedef prevector<28, unsigned char> CScriptBase;
+
 /** Serialized script, used inside transaction inputs and outputs */
-class CScript : public std::vector<unsigned char>
+class CScript : public CScriptBase
 {
 protected:
     CScript& push_int64(int64_t n);
@@ -22,9 +28,7 @@ public:
     CScript();
     CScript(const CScript& b);
     CScript(const_iterator pbegin, const_iterator pend);
-#ifndef _MSC_VER
-    CScript(const unsigned char* pbegin, const unsigned char* pend);
-#endif
+    CScript(std::vector<unsigned char>::const_iterator pbegin, std::vector<unsigned char>::const_iterator pend);
 
     CScript& operator+=(const CScript& b);
     friend CScript operator+(const CScript& a, const CScript& b);
@@ -0,0 +1,19 @@
+#include "csecuredatastream.h"
+
+CSecureDataStream::CSecureDataStream(int nTypeIn, int nVersionIn) :
+		CDataStream(nTypeIn, nVersionIn, vector_type::allocator_type(true))
+{
+	
+}
+
+CSecureDataStream::CSecureDataStream(const char* pbegin, const char* pend, int nTypeIn, int nVersionIn) :
+		CDataStream(nTypeIn, nVersionIn, vector_type::allocator_type(true))
+{
+	vch.assign(pbegin, pend);
+}
+
+CSecureDataStream::CSecureDataStream(const std::vector<unsigned char>& vchIn, int nTypeIn, int nVersionIn) :
+		CDataStream(nTypeIn, nVersionIn, vector_type::allocator_type(true))
+{
+	vch.assign(vchIn.begin(), vchIn.end());
+}
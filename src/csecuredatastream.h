@@ -0,0 +1,22 @@
+#ifndef CSECUREDATASTREAM_H
+#define CSECUREDATASTREAM_H
+
+#include <vector>
+
+#include "cdatastream.h"
+
+/** CDataStream whose buffers are cleared before they are freed.
+ *
+ * Plain CDataStreams take their buffers from StreamBufferPool and don't
+ * clear them. Use this one for anything that may carry key material: wallet
+ * database records and the secure message store.
+ */
+class CSecureDataStream : public CDataStream
+{
+public:
+	explicit CSecureDataStream(int nTypeIn, int nVersionIn);
+	CSecureDataStream(const char* pbegin, const char* pend, int nTypeIn, int nVersionIn);
+	CSecureDataStream(const std::vector<unsigned char>& vchIn, int nTypeIn, int nVersionIn);
+};
+
+#endif // CSECUREDATASTREAM_H
@@ -0,0 +1,90 @@
+#include "thread.h"
+
+#include "cservedblockcache.h"
+
+CServedBlockCache::CServedBlockCache() : nBytes(0), nHits(0), nMisses(0)
+{
+
+}
+
+std::shared_ptr<const CServedBlock> CServedBlockCache::Get(const uint256& hash)
+{
+	LOCK(cs);
+
+	std::map<uint256, list_type::iterator>::iterator mi = mapBlocks.find(hash);
+
+	if (mi == mapBlocks.end())
+	{
+		nMisses++;
+
+		return std::shared_ptr<const CServedBlock>();
+	}
+
+	nHits++;
+
+	// Move to the front
+	lruBlocks.splice(lruBlocks.begin(), lruBlocks, mi->second);
+
+	return mi->second->second;
+}
+
+void CServedBlockCache::Insert(const uint256& hash, const std::shared_ptr<const CServedBlock>& pblock,
+		size_t nMaxBytes)
+{
+	LOCK(cs);
+
+	if (pblock->vchData.size() > nMaxBytes || mapBlocks.count(hash))
+	{
+		return;
+	}
+
+	lruBlocks.push_front(std::make_pair(hash, pblock));
+	mapBlocks[hash] = lruBlocks.begin();
+	nBytes += pblock->vchData.size();
+
+	while (nBytes > nMaxBytes)
+	{
+		const std::pair<uint256, std::shared_ptr<const CServedBlock> >& oldest = lruBlocks.back();
+
+		nBytes -= oldest.second->vchData.size();
+		mapBlocks.erase(oldest.first);
+		lruBlocks.pop_back();
+	}
+}
+
+void CServedBlockCache::Clear()
+{
+	LOCK(cs);
+
+	lruBlocks.clear();
+	mapBlocks.clear();
+	nBytes = 0;
+}
+
+size_t CServedBlockCache::size() const
+{
+	LOCK(cs);
+
+	return mapBlocks.size();
+}
+
+size_t CServedBlockCache::GetBytes() const
+{
+	LOCK(cs);
+
+	return nBytes;
+}
+
+uint64_t CServedBlockCache::GetHits() const
+{
+	LOCK(cs);
+
+	return nHits;
+}
+
+uint64_t CServedBlockCache::GetMisses() const
+{
+	LOCK(cs);
+
+	return nMisses;
+}
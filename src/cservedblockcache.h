@@ -0,0 +1,65 @@
+#ifndef CSERVEDBLOCKCACHE_H
+#define CSERVEDBLOCKCACHE_H
+
+#include <list>
+#include <map>
+#include <memory>
+#include <stdint.h>
+
+#include "uint/uint256.h"
+#include "types/cserializedata.h"
+#include "types/ccriticalsection.h"
+
+/** A block the way it goes out in a "block" message: the payload bytes,
+ * exactly as stored in the block file, and their message checksum.
+ */
+struct CServedBlock
+{
+	CSerializeData vchData;
+	unsigned int nChecksum;
+};
+
+/** The blocks most recently sent to peers, least recently used dropped first.
+ *
+ * Peers catching up ask for the same recent blocks one after the other.
+ * Keeping them in wire format means the second and later requests cost a
+ * copy into the send buffer, with no disk read and no checksum over the
+ * block. Entries are shared, so one that is evicted while it is being
+ * sent stays valid until the sender lets go of it.
+ *
+ * A block's bytes never change once it is stored, so nothing has to be
+ * invalidated on a reorganization.
+ */
+class CServedBlockCache
+{
+private:
+	typedef std::list<std::pair<uint256, std::shared_ptr<const CServedBlock> > > list_type;
+
+	mutable CCriticalSection cs;
+
+	// Most recently used first
+	list_type lruBlocks;
+	std::map<uint256, list_type::iterator> mapBlocks;
+	size_t nBytes;
+
+	uint64_t nHits;
+	uint64_t nMisses;
+
+public:
+	CServedBlockCache();
+
+	/** The block with this hash, or an empty pointer */
+	std::shared_ptr<const CServedBlock> Get(const uint256& hash);
+
+	/** Adds a block and drops the oldest ones until at most nMaxBytes are kept */
+	void Insert(const uint256& hash, const std::shared_ptr<const CServedBlock>& pblock, size_t nMaxBytes);
+
+	void Clear();
+
+	size_t size() const;
+	size_t GetBytes() const;
+	uint64_t GetHits() const;
+	uint64_t GetMisses() const;
+};
+
+#endif // CSERVEDBLOCKCACHE_H
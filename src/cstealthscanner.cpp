@@ -0,0 +1,138 @@
+#include <algorithm>
+#include <cstring>
+
+#include "cpubkey.h"
+#include "util.h"
+#include "support/cleanse.h"
+
+#include "cstealthscanner.h"
+
+CStealthScanMatch::~CStealthScanMatch()
+{
+	memory_cleanse(&sShared.e[0], ec_secret_size);
+}
+
+CStealthScanner::CStealthScanner() : ctx(GetStealthContext())
+{
+	
+}
+
+CStealthScanner::~CStealthScanner()
+{
+	Wipe();
+}
+
+void CStealthScanner::Wipe()
+{
+	for (CScanKey& key : vKeys)
+	{
+		memory_cleanse(&key.sScan.e[0], ec_secret_size);
+	}
+}
+
+void CStealthScanner::Reserve(size_t nKeys)
+{
+	if (nKeys <= vKeys.capacity())
+	{
+		return;
+	}
+	
+	// a vector that grows frees its old buffer with the scan secrets still in it
+	std::vector<CScanKey> vGrown;
+	
+	vGrown.reserve(nKeys);
+	vGrown.insert(vGrown.end(), vKeys.begin(), vKeys.end());
+	
+	Wipe();
+	vKeys.swap(vGrown);
+}
+
+bool CStealthScanner::Add(size_t nIndex, const data_chunk& scanSecret, const ec_point& spendPubkey)
+{
+	if (scanSecret.size() != ec_secret_size || spendPubkey.size() == 0)
+	{
+		return false;
+	}
+	
+	CScanKey key;
+	
+	key.nIndex = nIndex;
+	memcpy(&key.sScan.e[0], &scanSecret[0], ec_secret_size);
+	
+	if (!secp256k1_ec_pubkey_parse(ctx, &key.pkSpend, &spendPubkey[0], spendPubkey.size()))
+	{
+		LogPrintf("CStealthScanner::Add(): invalid spend pubkey.\n");
+		
+		memset(&key.sScan.e[0], 0, ec_secret_size);
+		
+		return false;
+	}
+	
+	if (vKeys.size() == vKeys.capacity())
+	{
+		Reserve(std::max<size_t>(8, 2 * vKeys.capacity()));
+	}
+	
+	vKeys.push_back(key);
+	
+	memset(&key.sScan.e[0], 0, ec_secret_size);
+	
+	return true;
+}
+
+size_t CStealthScanner::Size() const
+{
+	return vKeys.size();
+}
+
+bool CStealthScanner::IsEmpty() const
+{
+	return vKeys.empty();
+}
+
+bool CStealthScanner::Scan(const ec_point& ephemPubkey, std::vector<CStealthScanMatch>& vMatches) const
+{
+	vMatches.clear();
+	
+	if (ephemPubkey.size() != ec_compressed_size)
+	{
+		return false;
+	}
+	
+	secp256k1_pubkey P;
+	
+	if (!secp256k1_ec_pubkey_parse(ctx, &P, &ephemPubkey[0], ephemPubkey.size()))
+	{
+		return false;
+	}
+	
+	vMatches.reserve(vKeys.size());
+	
+	for (const CScanKey& key : vKeys)
+	{
+		CStealthScanMatch match;
+		
+		match.nIndex = key.nIndex;
+		
+		// -- c = H(dP)
+		if (StealthSharedSecret(ctx, key.sScan, P, match.sShared) != 0)
+		{
+			continue;
+		}
+		
+		// -- R' = R + cG
+		secp256k1_pubkey R = key.pkSpend;
+		
+		if (!secp256k1_ec_pubkey_tweak_add(ctx, &R, &match.sShared.e[0])
+			|| SerializeCompressed(ctx, R, match.pkExtracted) != 0)
+		{
+			continue;
+		}
+		
+		match.keyID = CPubKey(match.pkExtracted).GetID();
+		
+		vMatches.push_back(match);
+	}
+	
+	return !vMatches.empty();
+}
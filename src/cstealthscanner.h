@@ -0,0 +1,59 @@
+#ifndef CSTEALTHSCANNER_H
+#define CSTEALTHSCANNER_H
+
+#include <vector>
+#include <secp256k1.h>
+
+#include "types/ec_point.h"
+#include "ckeyid.h"
+#include "stealth.h"
+
+/** Result of matching one ephemeral pubkey against one scan key.
+ *  The shared secret is wiped when the match is destroyed, as are the copies
+ *  a vector of matches leaves behind when it grows or is cleared.
+ */
+class CStealthScanMatch
+{
+public:
+	size_t nIndex;          // index of the key as passed to CStealthScanner::Add
+	ec_secret sShared;      // c = H(dP)
+	ec_point pkExtracted;   // R' = R + cG
+	CKeyID keyID;           // Hash160 of R'
+	
+	~CStealthScanMatch();
+};
+
+/** Checks an ephemeral pubkey against a set of owned stealth addresses.
+ *  Scan secrets and spend pubkeys are parsed once when added, so each
+ *  ephemeral key costs one parse plus one ECDH and one tweak per address.
+ */
+class CStealthScanner
+{
+private:
+	class CScanKey
+	{
+	public:
+		size_t nIndex;
+		ec_secret sScan;
+		secp256k1_pubkey pkSpend;
+	};
+	
+	const secp256k1_context* ctx;
+	std::vector<CScanKey> vKeys;
+	
+	void Wipe();
+
+public:
+	CStealthScanner();
+	~CStealthScanner();
+	
+	/** Makes room for nKeys keys, so adding them never moves the ones already in */
+	void Reserve(size_t nKeys);
+	bool Add(size_t nIndex, const data_chunk& scanSecret, const ec_point& spendPubkey);
+	size_t Size() const;
+	bool IsEmpty() const;
+	
+	bool Scan(const ec_point& ephemPubkey, std::vector<CStealthScanMatch>& vMatches) const;
+};
+
+#endif // CSTEALTHSCANNER_H
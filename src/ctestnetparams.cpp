@@ -22,8 +22,8 @@ CTestNetParams::CTestNetParams()
 	pchMessageStart[1] = 0xbc;
 	pchMessageStart[2] = 0x1c;
 	pchMessageStart[3] = 0xf4;
-	bnProofOfWorkLimit = CBigNum(~uint256(0) >> 12);
-	bnProofOfStakeLimit = CBigNum(~uint256(0) >> 14);
+	bnProofOfWorkLimit = ~arith_uint256(0) >> 12;
+	bnProofOfStakeLimit = ~arith_uint256(0) >> 14;
 	vAlertPubKey = ParseHex("00f88735a49f1996be6b659c91a94fbfebeb5d517698712acdbef262f7c2f81f85d131a669df3be611393f454852a2d08c6314bba5ca3cbe5616262da3b1a6afed");
 	nDefaultPort = 28092;
 	nRPCPort = 28094;
@@ -10,6 +10,11 @@
 
 #include "ctransactionlock.h"
 
+CTransactionLock::CTransactionLock() : nBlockHeight(0), nExpiration(0), nTimeout(0), nTimeFirstVote(0), fComplete(false)
+{
+	
+}
+
 bool CTransactionLock::SignaturesValid()
 {
 	for(CConsensusVote vote : vecConsensusVotes)
@@ -1,6 +1,7 @@
 #ifndef CTRANSACTIONLOCK_H
 #define CTRANSACTIONLOCK_H
 
+#include <cstdint>
 #include <vector>
 
 #include "uint/uint256.h"
@@ -15,6 +16,11 @@ public:
     std::vector<CConsensusVote> vecConsensusVotes;
     int nExpiration;
     int nTimeout;
+    // when the first vote was received and whether enough have been counted, in microseconds
+    int64_t nTimeFirstVote;
+    bool fComplete;
+	
+    CTransactionLock();
 	
     bool SignaturesValid();
     int CountSignatures();
@@ -123,7 +123,7 @@ int CTxIndex::GetDepthInMainChain() const
 	}
 
 	// Find the block in the index
-	std::map<uint256, CBlockIndex*>::iterator mi = mapBlockIndex.find(block.GetHash());
+	CBlockIndexMap::iterator mi = mapBlockIndex.find(block.GetHash());
 
 	if (mi == mapBlockIndex.end())
 	{
@@ -35,6 +35,7 @@
 #include "smsg.h"
 #include "ckeymetadata.h"
 #include "cstealthkeymetadata.h"
+#include "cstealthscanner.h"
 #include "comparevalueonly.h"
 #include "ccrypter.h"
 #include "cmasterkey.h"
@@ -54,11 +55,37 @@
 #include "cblockindex.h"
 #include "ctxindex.h"
 #include "serialize.h"
+#include "cdbbatch.h"
+#include "thread/cthreadpool.h"
 
 #include "cwallet.h"
 
 class CMasternode;
 
+// Blocks scanned by ScanForWalletTransactions per wallet.dat transaction
+static const int WALLET_RESCAN_BATCH_BLOCKS = 1000;
+
+// Keys made by TopUpKeyPool per round on the pool and per wallet.dat transaction
+static const size_t KEYPOOL_GENERATE_CHUNK = 1000;
+
+// Fewer missing keys than this are made on the calling thread
+static const size_t KEYPOOL_PARALLEL_MIN = 64;
+
+/** A key made for the keypool, with its secret in the form it is saved in */
+struct CPoolKey
+{
+	CKey secret;
+	CPubKey pubkey;
+	CPrivKey vchPrivKey;
+	std::vector<unsigned char> vchCryptedSecret;
+	bool fOk;
+	
+	CPoolKey() : fOk(false)
+	{
+		
+	}
+};
+
 /**
 	Private Functions
 */
@@ -908,16 +935,7 @@ CPubKey CWallet::GenerateNewKey()
 
 	assert(secret.VerifyPubKey(pubkey));
 
-	// Create new metadata
-	int64_t nCreationTime = GetTime();
-	mapKeyMetadata[pubkey.GetID()] = CKeyMetadata(nCreationTime);
-
-	if (!nTimeFirstKey || nCreationTime < nTimeFirstKey)
-	{
-		nTimeFirstKey = nCreationTime;
-	}
-
-	if (!AddKeyPubKey(secret, pubkey))
+	if (!AddNewKey(secret, pubkey, CPrivKey(), std::vector<unsigned char>()))
 	{
 		throw std::runtime_error("CWallet::GenerateNewKey() : AddKey failed");
 	}
@@ -926,10 +944,20 @@ CPubKey CWallet::GenerateNewKey()
 }
 
 bool CWallet::AddKeyPubKey(const CKey& secret, const CPubKey &pubkey)
+{
+	return StoreKey(secret, pubkey, CPrivKey(), std::vector<unsigned char>());
+}
+
+bool CWallet::StoreKey(const CKey& secret, const CPubKey& pubkey, const CPrivKey& vchPrivKey,
+		const std::vector<unsigned char>& vchCryptedSecret)
 {
 	AssertLockHeld(cs_wallet); // mapKeyMetadata
 
-	if (!CCryptoKeyStore::AddKeyPubKey(secret, pubkey))
+	// the crypted secret is saved through AddCryptedKey
+	bool fAdded = vchCryptedSecret.empty() ? CCryptoKeyStore::AddKeyPubKey(secret, pubkey) :
+			CCryptoKeyStore::AddKeyPubKey(secret, pubkey, vchCryptedSecret);
+	
+	if (!fAdded)
 	{
 		return false;
 	}
@@ -950,12 +978,30 @@ bool CWallet::AddKeyPubKey(const CKey& secret, const CPubKey &pubkey)
 
 	if (!IsCrypted())
 	{
-		return CWalletDB(strWalletFile).WriteKey(pubkey, secret.GetPrivKey(), mapKeyMetadata[pubkey.GetID()]);
+		return CWalletDB(strWalletFile).WriteKey(pubkey, vchPrivKey.empty() ? secret.GetPrivKey() : vchPrivKey,
+				mapKeyMetadata[pubkey.GetID()]);
 	}
 
 	return true;
 }
 
+bool CWallet::AddNewKey(const CKey& secret, const CPubKey& pubkey, const CPrivKey& vchPrivKey,
+		const std::vector<unsigned char>& vchCryptedSecret)
+{
+	AssertLockHeld(cs_wallet); // mapKeyMetadata
+
+	// Create new metadata
+	int64_t nCreationTime = GetTime();
+	mapKeyMetadata[pubkey.GetID()] = CKeyMetadata(nCreationTime);
+
+	if (!nTimeFirstKey || nCreationTime < nTimeFirstKey)
+	{
+		nTimeFirstKey = nCreationTime;
+	}
+
+	return StoreKey(secret, pubkey, vchPrivKey, vchCryptedSecret);
+}
+
 bool CWallet::LoadKey(const CKey& key, const CPubKey &pubkey)
 {
 	return CCryptoKeyStore::AddKeyPubKey(key, pubkey);
@@ -1030,7 +1076,7 @@ bool CWallet::AddCScript(const CScript& redeemScript)
 		return true;
 	}
 
-	return CWalletDB(strWalletFile).WriteCScript(Hash160(redeemScript), redeemScript);
+	return CWalletDB(strWalletFile).WriteCScript(Hash160(redeemScript.begin(), redeemScript.end()), redeemScript);
 }
 
 bool CWallet::LoadCScript(const CScript& redeemScript)
@@ -1495,7 +1541,7 @@ void CWallet::GetKeyBirthTimes(std::map<CKeyID, int64_t> &mapKeyBirth) const
 	{
 		// iterate over all wallet transactions...
 		const CWalletTx &wtx = (*it).second;
-		std::map<uint256, CBlockIndex*>::const_iterator blit = mapBlockIndex.find(wtx.hashBlock);
+		CBlockIndexMap::const_iterator blit = mapBlockIndex.find(wtx.hashBlock);
 		
 		if (blit != mapBlockIndex.end() && blit->second->IsInMainChain())
 		{
@@ -1560,6 +1606,18 @@ void CWallet::MarkDirty()
 	}
 }
 
+void CWallet::LoadToWallet(const uint256& hash, CWalletTx& wtxIn)
+{
+	CWalletTx& wtx = mapWallet[hash];
+	
+	wtx = std::move(wtxIn);
+	wtx.BindWallet(this);
+	
+	wtxOrdered.insert(std::make_pair(wtx.nOrderPos, TxPair(&wtx, (CAccountingEntry*)0)));
+	
+	AddToSpends(hash);
+}
+
 bool CWallet::AddToWallet(const CWalletTx& wtxIn, bool fFromLoadWallet)
 {
 	uint256 hash = wtxIn.GetHash();
@@ -1840,27 +1898,38 @@ int CWallet::ScanForWalletTransactions(CBlockIndex* pindexStart, bool fUpdate)
 		
 		while (pindex)
 		{
-			// no need to read and scan block, if block was created before
-			// our wallet birthday (as adjusted for block time variability)
-			if (nTimeFirstKey && (pindex->nTime < (nTimeFirstKey - 7200)))
-			{
-				pindex = pindex->pnext;
-				
-				continue;
-			}
-
-			CBlock block;
-			block.ReadFromDisk(pindex, true);
+			// what is found is committed every WALLET_RESCAN_BATCH_BLOCKS blocks
+			CDBBatch batch(strWalletFile);
 			
-			for(CTransaction& tx : block.vtx)
+			for (int nBlocks = 0; pindex && nBlocks < WALLET_RESCAN_BATCH_BLOCKS; pindex = pindex->pnext)
 			{
-				if (AddToWalletIfInvolvingMe(tx, &block, fUpdate))
+				// no need to read and scan block, if block was created before
+				// our wallet birthday (as adjusted for block time variability)
+				if (nTimeFirstKey && (pindex->nTime < (nTimeFirstKey - 7200)))
 				{
-					ret++;
+					continue;
 				}
+
+				CBlock block;
+				block.ReadFromDisk(pindex, true);
+				
+				for(CTransaction& tx : block.vtx)
+				{
+					if (AddToWalletIfInvolvingMe(tx, &block, fUpdate))
+					{
+						ret++;
+					}
+				}
+				
+				nBlocks++;
 			}
 			
-			pindex = pindex->pnext;
+			if (!batch.Commit())
+			{
+				LogPrintf("CWallet::ScanForWalletTransactions() : stopped, the wallet cannot be written\n");
+				
+				break;
+			}
 		}
 	}
 
@@ -2718,6 +2787,16 @@ bool CWallet::CreateCoinStake(const CKeyStore& keystore, unsigned int nBits, int
 		static int nMaxStakeSearchInterval = 60;
 		bool fKernelFound = false;
 		
+		// Read the output and set up its kernel hash once for all the
+		// timestamps searched
+		COutPoint prevoutStake = COutPoint(pcoin.first->GetHash(), pcoin.second);
+		CStakeKernel kernel;
+		
+		if (!kernel.Init(pindexPrev, nBits, prevoutStake))
+		{
+			continue;
+		}
+		
 		for (unsigned int n = 0;
 			n < std::min(nSearchInterval, (int64_t)nMaxStakeSearchInterval) &&
 			!fKernelFound &&
@@ -2728,10 +2807,7 @@ bool CWallet::CreateCoinStake(const CKeyStore& keystore, unsigned int nBits, int
 			boost::this_thread::interruption_point();
 			// Search backward in time from the given txNew timestamp
 			// Search nSearchInterval seconds back up to nMaxStakeSearchInterval
-			COutPoint prevoutStake = COutPoint(pcoin.first->GetHash(), pcoin.second);
-			int64_t nBlockTime;
-			
-			if (CheckKernel(pindexPrev, nBits, txNew.nTime - n, prevoutStake, &nBlockTime))
+			if (kernel.Check(txNew.nTime - n))
 			{
 				// Found a kernel
 				LogPrint("coinstake", "CreateCoinStake : kernel found\n");
@@ -3817,10 +3893,12 @@ bool CWallet::FindStealthTransactions(const CTransaction& tx, mapValue_t& mapNar
 
 	ec_secret sSpendR;
 	ec_secret sSpend;
-	ec_secret sScan;
 	ec_secret sShared;
 
-	ec_point pkExtracted;
+	CStealthScanner scanner;
+	std::vector<const CStealthAddress*> vOwned;
+	std::vector<CStealthScanMatch> vMatches;
+	bool fScannerReady = false;
 
 	std::vector<uint8_t> vchEphemPK;
 	std::vector<uint8_t> vchDataB;
@@ -3868,19 +3946,42 @@ bool CWallet::FindStealthTransactions(const CTransaction& tx, mapValue_t& mapNar
 			continue;
 		}
 
-		int32_t nOutputId = -1;
 		nStealth++;
 		
+		if (!fScannerReady)
+		{
+			// -- parse the owned scan keys once per transaction, not per output
+			scanner.Reserve(stealthAddresses.size());
+			
+			for (setStealthAddresses_t::iterator it = stealthAddresses.begin(); it != stealthAddresses.end(); ++it)
+			{
+				if (it->scan_secret.size() != ec_secret_size)
+				{
+					continue; // stealth address is not owned
+				}
+				
+				if (scanner.Add(vOwned.size(), it->scan_secret, it->spend_pubkey))
+				{
+					vOwned.push_back(&(*it));
+				}
+			}
+			
+			fScannerReady = true;
+		}
+		
+		// -- one ECDH per owned address for this ephemeral key, matched against all outputs below
+		if (!scanner.Scan(vchEphemPK, vMatches))
+		{
+			continue;
+		}
+		
 		for(const CTxOut& txoutB : tx.vout)
 		{
-			nOutputId++;
-
 			if (&txoutB == &txout)
 			{
 				continue;
 			}
 			
-			bool txnMatch = false; // only 1 txn will match an ephem pk
 			//printf("txoutB scriptPubKey %s\n",  txoutB.scriptPubKey.ToString().c_str());
 
 			CTxDestination address;
@@ -3901,39 +4002,26 @@ bool CWallet::FindStealthTransactions(const CTransaction& tx, mapValue_t& mapNar
 				continue;
 			}
 			
-			for (setStealthAddresses_t::iterator it = stealthAddresses.begin(); it != stealthAddresses.end(); ++it)
+			bool txnMatch = false; // only 1 txn will match an ephem pk
+			
+			for (const CStealthScanMatch& match : vMatches)
 			{
-				if (it->scan_secret.size() != ec_secret_size)
+				if (ckidMatch != match.keyID)
 				{
-					continue; // stealth address is not owned
-				}
-				
-				//printf("it->Encodeded() %s\n",  it->Encoded().c_str());
-				memcpy(&sScan.e[0], &it->scan_secret[0], ec_secret_size);
-
-				if (StealthSecret(sScan, vchEphemPK, it->spend_pubkey, sShared, pkExtracted) != 0)
-				{
-					printf("StealthSecret failed.\n");
-					
 					continue;
 				}
 				
-				//printf("pkExtracted %"PRIszu": %s\n", pkExtracted.size(), HexStr(pkExtracted).c_str());
+				const CStealthAddress* it = vOwned[match.nIndex];
+				
+				//printf("pkExtracted %"PRIszu": %s\n", match.pkExtracted.size(), HexStr(match.pkExtracted).c_str());
 
-				CPubKey cpkE(pkExtracted);
+				CPubKey cpkE(match.pkExtracted);
 
 				if (!cpkE.IsValid())
 				{
 					continue;
 				}
 				
-				CKeyID ckidE = cpkE.GetID();
-
-				if (ckidMatch != ckidE)
-				{
-					continue;
-				}
-				
 				if (fDebug)
 				{
 					printf("Found stealth txn to address %s\n", it->Encoded().c_str());
@@ -3974,7 +4062,7 @@ bool CWallet::FindStealthTransactions(const CTransaction& tx, mapValue_t& mapNar
 					}
 					
 					memcpy(&sSpend.e[0], &it->spend_secret[0], ec_secret_size);
-
+					memcpy(&sShared.e[0], &match.sShared.e[0], ec_secret_size);
 
 					if (StealthSharedToSecretSpend(sShared, sSpend, sSpendR) != 0)
 					{
@@ -3983,14 +4071,6 @@ bool CWallet::FindStealthTransactions(const CTransaction& tx, mapValue_t& mapNar
 						continue;
 					}
 
-					ec_point pkTestSpendR;
-					if (SecretToPublicKey(sSpendR, pkTestSpendR) != 0)
-					{
-						printf("SecretToPublicKey() failed.\n");
-						
-						continue;
-					}
-
 					CSecret vchSecret;
 					vchSecret.resize(ec_secret_size);
 
@@ -4205,8 +4285,6 @@ bool CWallet::TopUpKeyPool(unsigned int nSize)
 			return false;
 		}
 		
-		CWalletDB walletdb(strWalletFile);
-
 		// Top up key pool
 		unsigned int nTargetSize;
 		fLiteMode = GetBoolArg("-litemode", false);
@@ -4224,26 +4302,135 @@ bool CWallet::TopUpKeyPool(unsigned int nSize)
 			nTargetSize = std::max(GetArg("-keypool", 1000), (int64_t)0);
 		}
 		
+		int nProgress = -1;
+		
+		if (setKeyPool.size() >= nTargetSize + 1)
+		{
+			return true;
+		}
+		
+		// Compressed public keys were introduced in version 0.6.0
+		bool fCompressed = CanSupportFeature(FEATURE_COMPRPUBKEY);
+		
+		if (fCompressed)
+		{
+			SetMinVersion(FEATURE_COMPRPUBKEY);
+		}
+		
+		// The keys are made and encrypted by the pool, then added one by one
+		// in pool order
+		size_t nMissing = nTargetSize + 1 - setKeyPool.size();
+		CThreadPool pool("keypool", nMissing >= KEYPOOL_PARALLEL_MIN ? CThreadPool::DefaultThreads() : 0);
+		std::vector<CPoolKey> vKeys;
+		size_t nAdded = 0;
+		
 		while (setKeyPool.size() < (nTargetSize + 1))
 		{
-			int64_t nEnd = 1;
-			if (!setKeyPool.empty())
+			// the keys of a chunk and their pool entries are committed together,
+			// one transaction for the whole refill would run out of locks
+			CDBBatch batch(strWalletFile);
+			CWalletDB walletdb(strWalletFile);
+			std::vector<int64_t> vAdded;
+			std::vector<CKeyID> vKeyIDs;
+			std::exception_ptr error;
+			
+			try
+			{
+				boost::this_thread::interruption_point();
+				
+				vKeys.clear();
+				vKeys.resize(std::min(nTargetSize + 1 - setKeyPool.size(), KEYPOOL_GENERATE_CHUNK));
+				
+				pool.ParallelFor(vKeys.size(), [&](size_t i)
+				{
+					CPoolKey& item = vKeys[i];
+					
+					item.secret.MakeNewKey(fCompressed);
+					item.pubkey = item.secret.GetPubKey();
+					item.fOk = item.secret.VerifyPubKey(item.pubkey) &&
+							EncryptKey(item.secret, item.pubkey, item.vchCryptedSecret);
+					
+					if (item.fOk && !IsCrypted())
+					{
+						item.vchPrivKey = item.secret.GetPrivKey();
+					}
+				});
+				
+				for (const CPoolKey& item : vKeys)
+				{
+					// the wallet was locked while the keys were made
+					if (!item.fOk || !AddNewKey(item.secret, item.pubkey, item.vchPrivKey, item.vchCryptedSecret))
+					{
+						throw std::runtime_error("TopUpKeyPool() : adding generated key failed");
+					}
+					
+					vKeyIDs.push_back(item.pubkey.GetID());
+					
+					int64_t nEnd = 1;
+					if (!setKeyPool.empty())
+					{
+						nEnd = *(--setKeyPool.end()) + 1;
+					}
+					
+					if (!walletdb.WritePool(nEnd, CKeyPool(item.pubkey)))
+					{
+						throw std::runtime_error("TopUpKeyPool() : writing generated key failed");
+					}
+					
+					setKeyPool.insert(nEnd);
+					vAdded.push_back(nEnd);
+					
+					// one message per percent, not per key
+					double dProgress = 100.f * nEnd / (nTargetSize + 1);
+					
+					if ((int)dProgress != nProgress)
+					{
+						nProgress = (int)dProgress;
+						
+						std::string strMsg = strprintf(ui_translate("Loading wallet... (%3.2f %%)"), dProgress);
+						uiInterface.InitMessage(strMsg);
+					}
+				}
+			}
+			catch (...)
 			{
-				nEnd = *(--setKeyPool.end()) + 1;
+				error = std::current_exception();
 			}
 			
-			if (!walletdb.WritePool(nEnd, CKeyPool(GenerateNewKey())))
+			// the keys of the chunk are only kept in memory if they are on disk,
+			// the chunks committed before stay
+			if (error || !batch.Commit())
 			{
-				throw std::runtime_error("TopUpKeyPool() : writing generated key failed");
+				for (const CKeyID& keyID : vKeyIDs)
+				{
+					RemoveKey(keyID);
+					mapKeyMetadata.erase(keyID);
+				}
+				
+				for (int64_t nIndex : vAdded)
+				{
+					setKeyPool.erase(nIndex);
+				}
+				
+				if (nAdded > 0)
+				{
+					LogPrintf("keypool added %u keys before failing, size=%u\n", nAdded, setKeyPool.size());
+				}
+				
+				if (error)
+				{
+					std::rethrow_exception(error);
+				}
+				
+				return false;
 			}
 			
-			setKeyPool.insert(nEnd);
-			
-			LogPrintf("keypool added key %d, size=%u\n", nEnd, setKeyPool.size());
-			
-			double dProgress = 100.f * nEnd / (nTargetSize + 1);
-			std::string strMsg = strprintf(ui_translate("Loading wallet... (%3.2f %%)"), dProgress);
-			uiInterface.InitMessage(strMsg);
+			nAdded += vAdded.size();
+		}
+		
+		if (nAdded > 0)
+		{
+			LogPrintf("keypool added %u keys, size=%u\n", nAdded, setKeyPool.size());
 		}
 	}
 
@@ -11,6 +11,7 @@
 #include "types/txitems.h"
 #include "types/isminefilter.h"
 #include "types/camount.h"
+#include "types/cprivkey.h"
 #include "enums/changetype.h"
 #include "enums/isminetype.h"
 #include "enums/dberrors.h"
@@ -99,6 +100,14 @@ private:
 	void AddToSpends(const COutPoint& outpoint, const uint256& wtxid);
     void AddToSpends(const uint256& wtxid);
     void SyncMetaData(std::pair<mmTxSpends_t::iterator, mmTxSpends_t::iterator>);
+    
+	// AddKeyPubKey, with what is saved of secret made beforehand by TopUpKeyPool.
+	// Left empty, vchPrivKey and vchCryptedSecret are made here.
+	bool StoreKey(const CKey& secret, const CPubKey& pubkey, const CPrivKey& vchPrivKey,
+			const std::vector<unsigned char>& vchCryptedSecret);
+	// Adds a key made by this wallet with its creation time, then stores it
+	bool AddNewKey(const CKey& secret, const CPubKey& pubkey, const CPrivKey& vchPrivKey,
+			const std::vector<unsigned char>& vchCryptedSecret);
 
 public:
 	/**
@@ -195,6 +204,8 @@ public:
     bool LoadKey(const CKey& key, const CPubKey &pubkey);
     // Load metadata (used by LoadWallet)
     bool LoadKeyMetadata(const CPubKey &pubkey, const CKeyMetadata &metadata);
+    // Moves a transaction read by LoadWallet into mapWallet
+    void LoadToWallet(const uint256& hash, CWalletTx& wtxIn);
     bool LoadMinVersion(int nVersion);
     // Adds an encrypted key to the store, and saves it to disk.
     bool AddCryptedKey(const CPubKey &vchPubKey, const std::vector<unsigned char> &vchCryptedSecret);
@@ -1,86 +1,59 @@
 #include <openssl/ripemd.h>
+#include <openssl/sha.h>
 
 #include "ctransaction.h"
 #include "ctxout.h"
 #include "chashwriter.h"
+#include "chash256.h"
 #include "uint/uint160.h"
 #include "uint/uint256.h"
 #include "types/ec_point.h"
 #include "serialize.h"
 #include "cdatastream.h"
+#include "crypto/common/common.h"
 
 #include "hash.h"
 
 template<typename T1>
 uint256 Hash(const T1 pbegin, const T1 pend)
 {
-    static unsigned char pblank[1];
-    uint256 hash1;
-    uint256 hash2;
-    
-	SHA256(
-		(pbegin == pend ? pblank : (unsigned char*)&pbegin[0]),
-		(pend - pbegin) * sizeof(pbegin[0]),
-		(unsigned char*)&hash1
-	);
-	
-    SHA256(
-		(unsigned char*)&hash1,
-		sizeof(hash1),
-		(unsigned char*)&hash2
-	);
-	
-    return hash2;
+	static const unsigned char pblank[1] = {};
+	uint256 hash;
+
+	CHash256()
+		.Write((pbegin == pend ? pblank : (const unsigned char*)&pbegin[0]), (pend - pbegin) * sizeof(pbegin[0]))
+		.Finalize(hash.begin());
+
+	return hash;
 }
 
 template<typename T1, typename T2>
 uint256 Hash(const T1 p1begin, const T1 p1end, const T2 p2begin, const T2 p2end)
 {
-    static unsigned char pblank[1];
-    uint256 hash1;
-    SHA256_CTX ctx;
-	
-	SHA256_Init(&ctx);
-	
-	SHA256_Update(&ctx, (p1begin == p1end ? pblank : (unsigned char*)&p1begin[0]), (p1end - p1begin) * sizeof(p1begin[0]));
-    SHA256_Update(&ctx, (p2begin == p2end ? pblank : (unsigned char*)&p2begin[0]), (p2end - p2begin) * sizeof(p2begin[0]));
-    
-	SHA256_Final((unsigned char*)&hash1, &ctx);
-    
-	uint256 hash2;
-    
-	SHA256(
-		(unsigned char*)&hash1,
-		sizeof(hash1),
-		(unsigned char*)&hash2
-	);
-    
-	return hash2;
+	static const unsigned char pblank[1] = {};
+	uint256 hash;
+
+	CHash256()
+		.Write((p1begin == p1end ? pblank : (const unsigned char*)&p1begin[0]), (p1end - p1begin) * sizeof(p1begin[0]))
+		.Write((p2begin == p2end ? pblank : (const unsigned char*)&p2begin[0]), (p2end - p2begin) * sizeof(p2begin[0]))
+		.Finalize(hash.begin());
+
+	return hash;
 }
 
 template<typename T1, typename T2, typename T3>
 uint256 Hash(const T1 p1begin, const T1 p1end, const T2 p2begin, const T2 p2end, const T3 p3begin, const T3 p3end)
 {
-	static unsigned char pblank[1];
-	uint256 hash1;
-	SHA256_CTX ctx;
-	uint256 hash2;
-
-	SHA256_Init(&ctx);
+	static const unsigned char pblank[1] = {};
+	uint256 hash;
 
-	SHA256_Update(&ctx, (p1begin == p1end ? pblank : (unsigned char*)&p1begin[0]), (p1end - p1begin) * sizeof(p1begin[0]));
-	SHA256_Update(&ctx, (p2begin == p2end ? pblank : (unsigned char*)&p2begin[0]), (p2end - p2begin) * sizeof(p2begin[0]));
-	SHA256_Update(&ctx, (p3begin == p3end ? pblank : (unsigned char*)&p3begin[0]), (p3end - p3begin) * sizeof(p3begin[0]));
+	CHash256()
+		.Write((p1begin == p1end ? pblank : (const unsigned char*)&p1begin[0]), (p1end - p1begin) * sizeof(p1begin[0]))
+		.Write((p2begin == p2end ? pblank : (const unsigned char*)&p2begin[0]), (p2end - p2begin) * sizeof(p2begin[0]))
+		.Write((p3begin == p3end ? pblank : (const unsigned char*)&p3begin[0]), (p3end - p3begin) * sizeof(p3begin[0]))
+		.Finalize(hash.begin());
 
-	SHA256_Final((unsigned char*)&hash1, &ctx);
-
-	SHA256(
-		(unsigned char*)&hash1,
-		sizeof(hash1),
-		(unsigned char*)&hash2
-	);
-
-	return hash2;
+	return hash;
 }
 
 template uint256 Hash<char*>(char*, char*);
@@ -181,6 +154,69 @@ int HMAC_SHA512_Final(unsigned char *pmd, HMAC_SHA512_CTX *pctx)
 	return SHA512_Final(pmd, &pctx->ctxOuter);
 }
 
+static inline uint32_t ROTL32(uint32_t x, int8_t r)
+{
+	return (x << r) | (x >> (32 - r));
+}
+
+unsigned int MurmurHash3(unsigned int nHashSeed, const unsigned char* pData, size_t nLen)
+{
+	// The following is MurmurHash3 (x86_32), see http://code.google.com/p/smhasher/source/browse/trunk/MurmurHash3.cpp
+	uint32_t h1 = nHashSeed;
+	const uint32_t c1 = 0xcc9e2d51;
+	const uint32_t c2 = 0x1b873593;
+
+	const size_t nblocks = nLen / 4;
+
+	//----------
+	// body
+	for (size_t i = 0; i < nblocks; ++i)
+	{
+		uint32_t k1 = ReadLE32(pData + i * 4);
+
+		k1 *= c1;
+		k1 = ROTL32(k1, 15);
+		k1 *= c2;
+
+		h1 ^= k1;
+		h1 = ROTL32(h1, 13);
+		h1 = h1 * 5 + 0xe6546b64;
+	}
+
+	//----------
+	// tail
+	const unsigned char* tail = pData + nblocks * 4;
+
+	uint32_t k1 = 0;
+
+	switch (nLen & 3)
+	{
+		case 3:
+			k1 ^= tail[2] << 16;
+			// fallthrough
+		case 2:
+			k1 ^= tail[1] << 8;
+			// fallthrough
+		case 1:
+			k1 ^= tail[0];
+			k1 *= c1;
+			k1 = ROTL32(k1, 15);
+			k1 *= c2;
+			h1 ^= k1;
+	}
+
+	//----------
+	// finalization
+	h1 ^= nLen;
+	h1 ^= h1 >> 16;
+	h1 *= 0x85ebca6b;
+	h1 ^= h1 >> 13;
+	h1 *= 0xc2b2ae35;
+	h1 ^= h1 >> 16;
+
+	return h1;
+}
+
 void BIP32Hash(const unsigned char chainCode[32], unsigned int nChild, unsigned char header,
 		const unsigned char data[32], unsigned char output[64])
 {
@@ -2,6 +2,7 @@
 #define HASH_H
 
 #include <vector>
+#include <stddef.h>
 
 #include "enums/serialize_type.h"
 #include "version.h"
@@ -31,6 +32,8 @@ int HMAC_SHA512_Init(HMAC_SHA512_CTX *pctx, const void *pkey, size_t len);
 int HMAC_SHA512_Update(HMAC_SHA512_CTX *pctx, const void *pdata, size_t len);
 int HMAC_SHA512_Final(unsigned char *pmd, HMAC_SHA512_CTX *pctx);
 
+unsigned int MurmurHash3(unsigned int nHashSeed, const unsigned char* pData, size_t nLen);
+
 void BIP32Hash(const unsigned char chainCode[32], unsigned int nChild, unsigned char header,
 		const unsigned char data[32], unsigned char output[64]);
 
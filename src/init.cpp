@@ -36,11 +36,14 @@
 #include "wallet.h"
 #include "version.h"
 #include "masternode_extern.h"
+#include "cmasternodeman.h"
+#include "cmasternodejournal.h"
 #include "cmasternodepayments.h"
 #include "spork.h"
 #include "cblock.h"
 #include "cblockindex.h"
 #include "txdb-leveldb.h"
+#include "cblockindexsnapshot.h"
 #include "ckeyid.h"
 #include "cnodestination.h"
 #include "cscriptid.h"
@@ -53,6 +56,10 @@
 #include "cactivemasternode.h"
 #include "cmnenginepool.h"
 #include "mnengine.h"
+#include "instantx.h"
+#include "cconsensusvotequeue.h"
+#include "thread/cthreadpool.h"
+#include "thread/clockstats.h"
 #include "ckeymetadata.h"
 #include "cstealthkeymetadata.h"
 #include "cmasterkey.h"
@@ -144,6 +151,13 @@ void Shutdown()
 
 	mempool.AddTransactionsUpdated(1);
 
+	// Wake getblocktemplate long polls, so the RPC threads can stop
+	{
+		boost::lock_guard<boost::mutex> lock(csBestBlock);
+		
+		cvBlockChange.notify_all();
+	}
+
 	StopRPCThreads();
 
 	DigitalNote::SMSG::Shutdown();
@@ -161,8 +175,16 @@ void Shutdown()
 	StopNode();
 
 	UnregisterNodeSignals(GetNodeSignals());
+	consensusVoteQueue.Clear();
+	consensusVoteQueue.StopThreads();
+	mnodeman.StopThreads();
 	DumpMasternodes();
 
+	if (fLockStats)
+	{
+		DumpLockStats();
+	}
+
 	{
 		LOCK(cs_main);
 #ifdef ENABLE_WALLET
@@ -171,6 +193,13 @@ void Shutdown()
 			pwalletMain->SetBestChain(CBlockLocator(pindexBest));
 		}
 #endif
+
+		// Only a fully loaded index is worth keeping
+		if (pindexBest && GetBoolArg("-blockindexsnapshot", true))
+		{
+			CTxDB txdb;
+			CBlockIndexSnapshot().Write(txdb);
+		}
     }
 
 #ifdef ENABLE_WALLET
@@ -319,6 +348,8 @@ std::string HelpMessage()
 	strUsage += "  -logtimestamps         " + ui_translate("Prepend debug output with timestamp") + "\n";
 	strUsage += "  -shrinkdebugfile       " + ui_translate("Shrink debug.log file on client startup (default: 1 when no -debug)") + "\n";
 	strUsage += "  -printtoconsole        " + ui_translate("Send trace/debug info to console instead of debug.log file") + "\n";
+	strUsage += "  -lockstats             " + ui_translate("Record how long each lock is waited for and held, see getlockstats (default: 0)") + "\n";
+	strUsage += "  -lockstatsinterval=<n> " + ui_translate("Log the locks waited for longest every <n> seconds with -lockstats, 0 to only log at shutdown (default: 600)") + "\n";
 	strUsage += "  -regtest               " + ui_translate("Enter regression test mode, which uses a special chain in which blocks can be "
 												"solved instantly. This is intended for regression testing tools and app development.") + "\n";
 	strUsage += "  -rpcuser=<user>        " + ui_translate("Username for JSON-RPC connections") + "\n";
@@ -344,8 +375,13 @@ std::string HelpMessage()
 	strUsage += "  -salvagewallet         " + ui_translate("Attempt to recover private keys from a corrupt wallet.dat") + "\n";
 	strUsage += "  -checkblocks=<n>       " + ui_translate("How many blocks to check at startup (default: 500, 0 = all)") + "\n";
 	strUsage += "  -checklevel=<n>        " + ui_translate("How thorough the block verification is (0-6, default: 1)") + "\n";
+	strUsage += "  -checkblockthreads=<n> " + ui_translate("Number of threads used to verify blocks at startup (default: number of cores)") + "\n";
+	strUsage += "  -blockindexsnapshot    " + ui_translate("Save the block index to blkindex.snap at shutdown and load it from there at startup (default: 1)") + "\n";
 	strUsage += "  -loadblock=<file>      " + ui_translate("Imports blocks from external blk000?.dat file") + "\n";
+	strUsage += "  -loadblockthreads=<n>  " + ui_translate("Number of threads used to parse blocks from bootstrap.dat and -loadblock files (default: number of cores)") + "\n";
 	strUsage += "  -maxorphanblocks=<n>   " + strprintf(ui_translate("Keep at most <n> unconnectable blocks in memory (default: %u)"), DEFAULT_MAX_ORPHAN_BLOCKS) + "\n";
+	strUsage += "  -maxorphantxsize=<n>   " + strprintf(ui_translate("Keep at most <n> MB of unconnectable transactions in memory (default: %u)"), DEFAULT_MAX_ORPHAN_TX_BYTES / 1000000) + "\n";
+	strUsage += "  -servedblockcache=<n>  " + strprintf(ui_translate("Keep the last <n> MB of blocks sent to peers in memory (default: %u)"), DEFAULT_SERVED_BLOCK_CACHE_BYTES / 1000000) + "\n";
 	strUsage += "  -backtoblock=<n>       " + ui_translate("Rollback local block chain to block height <n>") + "\n";
 	strUsage += "  -maxblockheight=<n>    " + ui_translate("Stop sync when block height reaches <n>") + "\n";
 
@@ -368,14 +404,17 @@ std::string HelpMessage()
 	strUsage += "  -masternodeprivkey=<n>     " + ui_translate("Set the masternode private key") + "\n";
 	strUsage += "  -masternodeaddr=<n>        " + ui_translate("Set external address:port to get to this masternode (example: address:port)") + "\n";
 	strUsage += "  -masternodeminprotocol=<n> " + ui_translate("Ignore masternodes less than version (example: 61401; default : 0)") + "\n";
+	strUsage += "  -mnverifythreads=<n>       " + ui_translate("Number of threads used to verify masternode announcements (default: number of cores)") + "\n";
 
 	strUsage += "\n" + ui_translate("InstantX options:") + "\n";
 	strUsage += "  -enableinstantx=<n>    " + ui_translate("Enable instantx, show confirmations for locked transactions (bool, default: true)") + "\n";
 	strUsage += "  -instantxdepth=<n>     " + strprintf(ui_translate("Show N confirmations for a successfully locked transaction (0-9999, default: %u)"), nInstantXDepth) + "\n"; 
+	strUsage += "  -ixverifythreads=<n>   " + ui_translate("Number of threads used to verify InstantX lock votes (default: number of cores)") + "\n";
 	strUsage += ui_translate("Secure messaging options:") + "\n" +
 		"  -nosmsg                                  " + ui_translate("Disable secure messaging.") + "\n" +
 		"  -debugsmsg                               " + ui_translate("Log extra debug messages.") + "\n" +
-		"  -smsgscanchain                           " + ui_translate("Scan the block chain for public key addresses on startup.") + "\n";
+		"  -smsgscanchain                           " + ui_translate("Scan the block chain for public key addresses on startup.") + "\n" +
+		"  -smsgscanthreads=<n>                     " + ui_translate("Number of threads used to trial-decrypt incoming messages (default: number of cores)") + "\n";
 	strUsage += "  -stakethreshold=<n> " + ui_translate("This will set the output size of your stakes to never be below this number (default: 100)") + "\n";
 	strUsage += "  -liveforktoggle=<n> " + ui_translate("Toggle experimental features via block height testing fork, (example: -command=<fork_height>)") + "\n";
 	strUsage += "  -mnadvrelay=<n> " + ui_translate("Toggle MasterNode Advanced Relay System via 1/0, (example: -command=<true/false>)") + "\n";
@@ -610,6 +649,7 @@ bool AppInit2(boost::thread_group& threadGroup)
 	
 	fPrintToConsole = GetBoolArg("-printtoconsole", false);
 	fLogTimestamps = GetBoolArg("-logtimestamps", true);
+	fLockStats = GetBoolArg("-lockstats", false);
 
 #ifdef ENABLE_WALLET
 	bool fDisableWallet = GetBoolArg("-disablewallet", false);
@@ -1118,7 +1158,7 @@ bool AppInit2(boost::thread_group& threadGroup)
 		std::string strMatch = mapArgs["-printblock"];
 		int nFound = 0;
 		
-		for (std::map<uint256, CBlockIndex*>::iterator mi = mapBlockIndex.begin(); mi != mapBlockIndex.end(); ++mi)
+		for (CBlockIndexMap::iterator mi = mapBlockIndex.begin(); mi != mapBlockIndex.end(); ++mi)
 		{
 			uint256 hash = (*mi).first;
 			
@@ -1446,6 +1486,18 @@ bool AppInit2(boost::thread_group& threadGroup)
 		}
 	}
 
+	// bring back the changes made since mncache.dat was last written
+	if (readResult == CMasternodeDB::Ok)
+	{
+		mnodeJournal.Replay(mndb.GetHash(), mndb.GetSize(), mnodeman);
+	}
+
+	if (readResult == CMasternodeDB::Ok ||
+		readResult == CMasternodeDB::FileError ||
+		readResult == CMasternodeDB::IncorrectFormat)
+	{
+		mnodeman.EnableJournal(mndb);
+	}
 
 	fMasterNode = GetBoolArg("-masternode", false);
 	
@@ -1524,6 +1576,12 @@ bool AppInit2(boost::thread_group& threadGroup)
 	LogPrintf("fLiteMode %d\n", fLiteMode);
 	LogPrintf("nInstantXDepth %d\n", nInstantXDepth);
 
+	if(!fLiteMode)
+	{
+		consensusVoteQueue.StartThreads(GetArg("-ixverifythreads", CThreadPool::DefaultThreads()));
+		mnodeman.StartThreads(GetArg("-mnverifythreads", CThreadPool::DefaultThreads()));
+	}
+
 	mnEnginePool.InitCollateralAddress();
 
 	threadGroup.create_thread(boost::bind(&ThreadCheckMNenginePool));
@@ -1566,6 +1624,18 @@ bool AppInit2(boost::thread_group& threadGroup)
 	
 	StartNode(threadGroup);
 
+	if (fLockStats && GetArg("-lockstatsinterval", 600) > 0)
+	{
+		threadGroup.create_thread(
+			boost::bind(
+				&LoopForever<void (*)()>,
+				"lockstats",
+				&DumpLockStats,
+				GetArg("-lockstatsinterval", 600) * 1000
+			)
+		);
+	}
+
 #ifdef ENABLE_WALLET
 	// InitRPCMining is needed here so getwork/getblocktemplate in the GUI debug console works properly.
 	InitRPCMining();
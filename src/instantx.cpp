@@ -20,6 +20,7 @@
 #include "ctransactionlock.h"
 #include "blockparams.h"
 #include "cconsensusvote.h"
+#include "cconsensusvotequeue.h"
 #include "main_const.h"
 #include "util/backwards.h"
 #include "cblockindex.h"
@@ -40,6 +41,7 @@ std::map<uint256, CTransactionLock> mapTxLocks;
 std::map<COutPoint, uint256> mapLockedInputs;
 std::map<uint256, int64_t> mapUnknownVotes; //track votes with no tx for DOS
 int nCompleteTXLocks;
+CConsensusVoteQueue consensusVoteQueue;
 
 //txlock - Locks transaction
 //
@@ -181,42 +183,75 @@ void ProcessMessageInstantX(CNode* pfrom, std::string& strCommand, CDataStream&
 
 		mapTxLockVote.insert(std::make_pair(ctx.GetHash(), ctx));
 
-		if(ProcessConsensusVote(pfrom, ctx))
+		// checked and counted by ProcessQueuedConsensusVotes, together with the rest of this round's votes
+		consensusVoteQueue.Push(pfrom, ctx);
+
+		return;
+	}
+}
+
+void ProcessQueuedConsensusVotes()
+{
+	if(consensusVoteQueue.Empty())
+	{
+		return;
+	}
+
+	std::vector<CConsensusVoteQueue::Item> vItems;
+
+	consensusVoteQueue.Verify(vItems);
+
+	for(CConsensusVoteQueue::Item& item : vItems)
+	{
+		CConsensusVote& ctx = item.vote;
+
+		if(!ProcessConsensusVote(item.pfrom, ctx, item.nRank, item.fSignatureValid, item.nTimeReceived))
 		{
-			//Spam/Dos protection
-			/*
-				Masternodes will sometimes propagate votes before the transaction is known to the client.
-				This tracks those messages and allows it at the same rate of the rest of the network, if
-				a peer violates it, it will simply be ignored
-			*/
-			if(!mapTxLockReq.count(ctx.txHash) && !mapTxLockReqRejected.count(ctx.txHash))
-			{
-				if(!mapUnknownVotes.count(ctx.vinMasternode.prevout.hash))
-				{
-					mapUnknownVotes[ctx.vinMasternode.prevout.hash] = GetTime()+(60*10);
-				}
+			continue;
+		}
 
-				if(mapUnknownVotes[ctx.vinMasternode.prevout.hash] > GetTime() &&
-					mapUnknownVotes[ctx.vinMasternode.prevout.hash] - GetAverageVoteTime() > 60*10)
-				{
-					LogPrintf(
-						"ProcessMessageInstantX::txlreq - masternode is spamming transaction votes: %s %s\n",
-						ctx.vinMasternode.ToString().c_str(),
-						ctx.txHash.ToString().c_str()
-					);
-					
-					return;
-				}
-				else
-				{
-					mapUnknownVotes[ctx.vinMasternode.prevout.hash] = GetTime()+(60*10);
-				}
+		consensusVoteQueue.RecordCounted(GetTimeMicros() - item.nTimeReceived);
+
+		//Spam/Dos protection
+		/*
+			Masternodes will sometimes propagate votes before the transaction is known to the client.
+			This tracks those messages and allows it at the same rate of the rest of the network, if
+			a peer violates it, it will simply be ignored
+		*/
+		if(!mapTxLockReq.count(ctx.txHash) && !mapTxLockReqRejected.count(ctx.txHash))
+		{
+			if(!mapUnknownVotes.count(ctx.vinMasternode.prevout.hash))
+			{
+				mapUnknownVotes[ctx.vinMasternode.prevout.hash] = GetTime()+(60*10);
 			}
 
-			RelayInventory(inv);
+			if(mapUnknownVotes[ctx.vinMasternode.prevout.hash] > GetTime() &&
+				mapUnknownVotes[ctx.vinMasternode.prevout.hash] - GetAverageVoteTime() > 60*10)
+			{
+				LogPrintf(
+					"ProcessMessageInstantX::txlreq - masternode is spamming transaction votes: %s %s\n",
+					ctx.vinMasternode.ToString().c_str(),
+					ctx.txHash.ToString().c_str()
+				);
+				
+				continue;
+			}
+			else
+			{
+				mapUnknownVotes[ctx.vinMasternode.prevout.hash] = GetTime()+(60*10);
+			}
 		}
 
-		return;
+		CInv inv(MSG_TXLOCK_VOTE, ctx.GetHash());
+
+		RelayInventory(inv);
+	}
+
+	LOCK(cs_vNodes);
+
+	for(CConsensusVoteQueue::Item& item : vItems)
+	{
+		item.pfrom->Release();
 	}
 }
 
@@ -393,18 +428,9 @@ void DoConsensusVote(CTransaction& tx, int64_t nBlockHeight)
 	RelayInventory(inv);
 }
 
-//received a consensus vote
-bool ProcessConsensusVote(CNode* pnode, CConsensusVote& ctx)
+//received a consensus vote, ranked and checked by consensusVoteQueue
+bool ProcessConsensusVote(CNode* pnode, CConsensusVote& ctx, int n, bool fSignatureValid, int64_t nTimeReceived)
 {
-	int n = mnodeman.GetMasternodeRank(ctx.vinMasternode, ctx.nBlockHeight, MIN_INSTANTX_PROTO_VERSION);
-
-	CMasternode* pmn = mnodeman.Find(ctx.vinMasternode);
-	
-	if(pmn != NULL)
-	{
-		LogPrint("instantx", "InstantX::ProcessConsensusVote - Masternode ADDR %s %d\n", pmn->addr.ToString().c_str(), n);
-	}
-
 	if(n == -1)
 	{
 		//can be caused by past versions trying to vote with an invalid protocol
@@ -422,7 +448,7 @@ bool ProcessConsensusVote(CNode* pnode, CConsensusVote& ctx)
 		return false;
 	}
 
-	if(!ctx.SignatureValid())
+	if(!fSignatureValid)
 	{
 		LogPrintf("InstantX::ProcessConsensusVote - Signature invalid\n");
 		
@@ -450,10 +476,6 @@ bool ProcessConsensusVote(CNode* pnode, CConsensusVote& ctx)
 		LogPrint("instantx", "InstantX::ProcessConsensusVote - Transaction Lock Exists %s !\n", ctx.txHash.ToString().c_str());
 	}
 
-	CBlockIndex* pindex;
-	CBlock block;
-	CTxDB txdb("r");
-	
 	//compile consessus vote
 	std::map<uint256, CTransactionLock>::iterator i = mapTxLocks.find(ctx.txHash);
 	
@@ -461,6 +483,11 @@ bool ProcessConsensusVote(CNode* pnode, CConsensusVote& ctx)
 	{
 		(*i).second.AddSignature(ctx);
 
+		if((*i).second.nTimeFirstVote == 0)
+		{
+			(*i).second.nTimeFirstVote = nTimeReceived;
+		}
+
 #ifdef ENABLE_WALLET
 		if(pwalletMain)
 		{
@@ -481,6 +508,13 @@ bool ProcessConsensusVote(CNode* pnode, CConsensusVote& ctx)
 				(*i).second.GetHash().ToString().c_str()
 			);
 
+			if(!(*i).second.fComplete)
+			{
+				(*i).second.fComplete = true;
+				
+				consensusVoteQueue.RecordLock(GetTimeMicros() - (*i).second.nTimeFirstVote);
+			}
+
 			CTransaction& tx = mapTxLockReq[ctx.txHash];
 			
 			if(!CheckForConflictingLocks(tx))
@@ -511,6 +545,10 @@ bool ProcessConsensusVote(CNode* pnode, CConsensusVote& ctx)
 				//if this tx lock was rejected, we need to remove the conflicting blocks
 				if(mapTxLockReqRejected.count((*i).second.txHash))
 				{
+					CBlockIndex* pindex;
+					CBlock block;
+					CTxDB txdb("r");
+					
 					//reprocess the last 15 blocks
 					block.DisconnectBlock(txdb, pindex);
 					tx.DisconnectInputs(txdb);
@@ -6,6 +6,7 @@
 #include <map>
 
 class CConsensusVote;
+class CConsensusVoteQueue;
 class CTransaction;
 class CTransactionLock;
 class uint256;
@@ -19,6 +20,7 @@ extern std::map<uint256, CConsensusVote> mapTxLockVote;
 extern std::map<uint256, CTransactionLock> mapTxLocks;
 extern std::map<COutPoint, uint256> mapLockedInputs;
 extern int nCompleteTXLocks;
+extern CConsensusVoteQueue consensusVoteQueue;
 
 
 int64_t CreateNewLock(CTransaction tx);
@@ -26,10 +28,12 @@ bool IsIXTXValid(const CTransaction& txCollateral);
 // if two conflicting locks are approved by the network, they will cancel out
 bool CheckForConflictingLocks(CTransaction& tx);
 void ProcessMessageInstantX(CNode* pfrom, std::string& strCommand, CDataStream& vRecv);
+//check and count the votes queued by ProcessMessageInstantX
+void ProcessQueuedConsensusVotes();
 //check if we need to vote on this transaction
 void DoConsensusVote(CTransaction& tx, int64_t nBlockHeight);
 //process consensus vote message
-bool ProcessConsensusVote(CNode* pnode, CConsensusVote& ctx);
+bool ProcessConsensusVote(CNode* pnode, CConsensusVote& ctx, int n, bool fSignatureValid, int64_t nTimeReceived);
 // keep transaction locks in memory for an hour
 void CleanTransactionLocksList();
 int64_t GetAverageVoteTime();
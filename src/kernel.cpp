@@ -11,7 +11,7 @@
 #include "ctxout.h"
 #include "ctxin.h"
 #include "ctransaction.h"
-#include "cbignum.h"
+#include "uint/arith_uint256.h"
 #include "script.h"
 #include "util.h"
 #include "cblockindex.h"
@@ -281,6 +281,26 @@ uint256 ComputeStakeModifierV2(const CBlockIndex* pindexPrev, const uint256& ker
 	return Hash_echo512(ss.begin(), ss.end());
 }
 
+// The base target of nBits weighted by the value of the staked output, as the
+// CBigNum product of both. Returns false if the product is negative, no hash
+// meets the target then. fOverflow is set if it does not fit in 256 bits,
+// every hash meets the target then, and target holds its low 256 bits.
+static bool GetWeightedTarget(unsigned int nBits, int64_t nValueIn, uint256& target, bool& fOverflow)
+{
+	bool fNegative;
+	arith_uint256 bnTarget;
+	uint64_t nValue = nValueIn < 0 ? -(uint64_t)nValueIn : (uint64_t)nValueIn;
+
+	bnTarget.SetCompact(nBits, &fNegative, &fOverflow);
+
+	bool fNonZero = nValue != 0 && (fOverflow || bnTarget != 0);
+
+	target = bnTarget * arith_uint256(nValue);
+	fOverflow = fNonZero && (fOverflow || !bnTarget.MulChecked(nValue));
+
+	return !fNonZero || fNegative == (nValueIn < 0);
+}
+
 // DigitalNote kernel protocol
 // coinstake must meet hash target according to the protocol:
 // kernel (input 0) must meet the formula
@@ -310,16 +330,9 @@ bool CheckStakeKernelHash(CBlockIndex* pindexPrev, unsigned int nBits, unsigned
 		return error("CheckStakeKernelHash() : nTime violation");
 	}
 
-	// Base target
-	CBigNum bnTarget;
-	bnTarget.SetCompact(nBits);
-
 	// Weighted target
-	int64_t nValueIn = txPrev.vout[prevout.n].nValue;
-	CBigNum bnWeight = CBigNum(nValueIn);
-	bnTarget *= bnWeight;
-
-	targetProofOfStake = bnTarget.getuint256();
+	bool fTargetOverflow;
+	bool fTargetPositive = GetWeightedTarget(nBits, txPrev.vout[prevout.n].nValue, targetProofOfStake, fTargetOverflow);
 
 	uint64_t nStakeModifier = pindexPrev->nStakeModifier;
 	uint256 bnStakeModifierV2 = pindexPrev->bnStakeModifierV2;
@@ -349,7 +362,7 @@ bool CheckStakeKernelHash(CBlockIndex* pindexPrev, unsigned int nBits, unsigned
 	}
 
 	// Now check if proof-of-stake hash meets target protocol
-	if (CBigNum(hashProofOfStake) > bnTarget)
+	if (!fTargetPositive || (!fTargetOverflow && hashProofOfStake > targetProofOfStake))
 	{
 		 return false;
 	}
@@ -430,8 +443,31 @@ bool CheckCoinStakeTimestamp(int nHeight, int64_t nTimeBlock, int64_t nTimeTx)
 
 bool CheckKernel(CBlockIndex* pindexPrev, unsigned int nBits, int64_t nTime, const COutPoint& prevout, int64_t* pBlockTime)
 {
-	uint256 hashProofOfStake, targetProofOfStake;
+	CStakeKernel kernel;
+	
+	if (!kernel.Init(pindexPrev, nBits, prevout))
+	{
+		return false;
+	}
+	
+	if (pBlockTime)
+	{
+		*pBlockTime = kernel.GetBlockTime();
+	}
+	
+	return kernel.Check(nTime);
+}
 
+CStakeKernel::CStakeKernel()
+{
+	fTargetOverflow = false;
+	fTargetNegative = false;
+	nTimeTxPrev = 0;
+	nBlockTime = 0;
+}
+
+bool CStakeKernel::Init(CBlockIndex* pindexPrev, unsigned int nBits, const COutPoint& prevout)
+{
 	CTxDB txdb("r");
 	CTransaction txPrev;
 	CTxIndex txindex;
@@ -455,11 +491,52 @@ bool CheckKernel(CBlockIndex* pindexPrev, unsigned int nBits, int64_t nTime, con
 		return false;
 	}
 	
-	if (pBlockTime)
+	nBlockTime = block.GetBlockTime();
+	nTimeTxPrev = txPrev.nTime;
+	
+	// Weighted target, as in CheckStakeKernelHash
+	fTargetNegative = !GetWeightedTarget(nBits, txPrev.vout[prevout.n].nValue, targetProofOfStake, fTargetOverflow);
+	
+	// Kernel hash input up to nTimeTx
+	CDataStream ss(SER_GETHASH, 0);
+	
+	ss << pindexPrev->bnStakeModifierV2;
+	ss << txPrev.nTime << prevout.hash << prevout.n;
+	
+	assert(ss.size() == CEcho512Kernel::PREFIX_SIZE);
+	
+	hasher.Init((const unsigned char*)&ss[0]);
+	
+	return true;
+}
+
+bool CStakeKernel::Check(unsigned int nTimeTx) const
+{
+	if (nTimeTx < nTimeTxPrev)  // Transaction timestamp violation
+	{
+		return error("CStakeKernel::Check() : nTime violation");
+	}
+	
+	uint256 hashProofOfStake = hasher.Hash(nTimeTx);
+	
+	if (fTargetNegative || (!fTargetOverflow && hashProofOfStake > targetProofOfStake))
+	{
+		return false;
+	}
+	
+	if (fDebug)
 	{
-		*pBlockTime = block.GetBlockTime();
+		LogPrintf("CStakeKernel::Check() : pass nTimeBlockFrom=%u nTimeTxPrev=%u nTimeTx=%u hashProof=%s\n",
+			nBlockTime, nTimeTxPrev, nTimeTx,
+			hashProofOfStake.ToString()
+		);
 	}
 	
-	return CheckStakeKernelHash(pindexPrev, nBits, block.GetBlockTime(), txPrev, prevout, nTime, hashProofOfStake, targetProofOfStake);
+	return true;
+}
+
+int64_t CStakeKernel::GetBlockTime() const
+{
+	return nBlockTime;
 }
 
@@ -4,8 +4,10 @@
 #include <cstdint>
 #include <cstddef>
 
+#include "crypto/echo/echo512.h"
+#include "uint/uint256.h"
+
 class CBlockIndex;
-class uint256;
 class CTransaction;
 class COutPoint;
 
@@ -40,4 +42,25 @@ int64_t GetWeight(int64_t nIntervalBeginning, int64_t nIntervalEnd);
 // Convenient for searching a kernel
 bool CheckKernel(CBlockIndex* pindexPrev, unsigned int nBits, int64_t nTime, const COutPoint& prevout, int64_t* pBlockTime = NULL);
 
+// CheckKernel for one staking output at many timestamps, as in the stake
+// search. Init reads the output and its block and sets up the kernel hash
+// once, Check then only hashes the timestamp.
+class CStakeKernel
+{
+private:
+	CEcho512Kernel hasher;
+	uint256 targetProofOfStake;
+	bool fTargetOverflow;
+	bool fTargetNegative;
+	unsigned int nTimeTxPrev;
+	int64_t nBlockTime;
+
+public:
+	CStakeKernel();
+	
+	bool Init(CBlockIndex* pindexPrev, unsigned int nBits, const COutPoint& prevout);
+	bool Check(unsigned int nTimeTx) const;
+	int64_t GetBlockTime() const;
+};
+
 #endif // KERNEL_H
@@ -9,6 +9,8 @@
 #include <boost/assign/list_of.hpp>
 #include <boost/bind.hpp>
 #include <boost/thread/thread.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
 
 #include "calert.h"
 #include "blocksizecalculator.h"
@@ -72,6 +74,11 @@
 #include "util/backwards.h"
 #include "cautofile.h"
 #include "serialize.h"
+#include "cblockimporter.h"
+#include "thread/cthreadpool.h"
+#include "crollingbloomfilter.h"
+#include "cblockassembler.h"
+#include "cservedblockcache.h"
 
 //
 // Global state
@@ -83,8 +90,10 @@ std::set<CWallet*> setpwalletRegistered;
 CCriticalSection cs_main;
 
 CTxMemPool mempool;
+CBlockAssembler blockAssembler;
+CServedBlockCache servedBlockCache;
 
-std::map<uint256, CBlockIndex*> mapBlockIndex;
+CBlockIndexMap mapBlockIndex;
 std::set<std::pair<COutPoint, unsigned int> > setStakeSeen;
 
 CBlockIndex* pindexGenesisBlock = NULL;
@@ -94,6 +103,10 @@ uint256 nBestInvalidTrust = 0;
 uint256 hashBestChain = 0;
 CBlockIndex* pindexBest = NULL;
 int64_t nTimeBestReceived = 0;
+
+// Notified when hashBestChain changes, for getblocktemplate long polls
+boost::mutex csBestBlock;
+boost::condition_variable cvBlockChange;
 bool fImporting = false;
 bool fReindex = false;
 bool fAddrIndex = false;
@@ -110,8 +123,33 @@ std::map<uint256, COrphanBlock*> mapOrphanBlocks;
 std::multimap<uint256, COrphanBlock*> mapOrphanBlocksByPrev;
 std::set<std::pair<COutPoint, unsigned int> > setStakeSeenOrphan;
 
-std::map<uint256, CTransaction> mapOrphanTransactions;
-std::map<uint256, std::set<uint256> > mapOrphanTransactionsByPrev;
+struct COrphanTx
+{
+	CTransaction tx;
+	NodeId fromPeer;
+	int64_t nTimeExpire;
+	size_t nSize;
+};
+std::map<uint256, COrphanTx> mapOrphanTransactions;
+std::map<COutPoint, std::set<uint256> > mapOrphanTransactionsByPrev;
+std::map<NodeId, size_t> mapOrphanBytesByPeer;
+size_t nOrphanTxBytes = 0;
+int64_t nNextOrphanTxSweep = 0;
+
+void static EraseOrphansFor(NodeId peer);
+
+// Transactions turned down since the best block last changed, and those
+// in the last blocks connected. Peers announcing them again are answered
+// from memory instead of the transaction index.
+static CRollingBloomFilter recentRejects(120000, 0.000001);
+static uint256 hashRecentRejectsChainTip;
+CRollingBloomFilter recentConfirmedTransactions(48000, 0.000001);
+
+// How often the filters saved a getdata and a revalidation, and how often
+// AlreadyHave had to look in the transaction index
+uint64_t nTxInvRecentRejectHits = 0;
+uint64_t nTxInvRecentConfirmedHits = 0;
+uint64_t nTxInvDiskLookups = 0;
 
 // Constant stuff for coinbase transactions we create:
 CScript COINBASE_FLAGS;
@@ -398,6 +436,8 @@ void FinalizeNode(NodeId nodeid)
 		mapBlocksToDownload.erase(hash);
 	}
 
+	EraseOrphansFor(nodeid);
+
 	mapNodeState.erase(nodeid);
 }
 
@@ -508,6 +548,8 @@ void RegisterNodeSignals(CNodeSignals& nodeSignals)
 	nodeSignals.GetHeight.connect(&GetHeight);
 	nodeSignals.ProcessMessages.connect(&ProcessMessages);
 	nodeSignals.SendMessages.connect(&SendMessages);
+	nodeSignals.ProcessQueued.connect(&ProcessQueuedConsensusVotes);
+	nodeSignals.ProcessQueued.connect(&ProcessQueuedMasternodeBroadcasts);
 	nodeSignals.InitializeNode.connect(&InitializeNode);
 	nodeSignals.FinalizeNode.connect(&FinalizeNode);
 }
@@ -517,6 +559,8 @@ void UnregisterNodeSignals(CNodeSignals& nodeSignals)
 	nodeSignals.GetHeight.disconnect(&GetHeight);
 	nodeSignals.ProcessMessages.disconnect(&ProcessMessages);
 	nodeSignals.SendMessages.disconnect(&SendMessages);
+	nodeSignals.ProcessQueued.disconnect(&ProcessQueuedConsensusVotes);
+	nodeSignals.ProcessQueued.disconnect(&ProcessQueuedMasternodeBroadcasts);
 	nodeSignals.InitializeNode.disconnect(&InitializeNode);
 	nodeSignals.FinalizeNode.disconnect(&FinalizeNode);
 }
@@ -543,7 +587,12 @@ bool AbortNode(const std::string &strMessage, const std::string &userMessage)
 // mapOrphanTransactions
 //
 
-bool AddOrphanTx(const CTransaction& tx)
+static size_t GetMaxOrphanTxBytes()
+{
+	return (size_t)std::max((int64_t)0, GetArg("-maxorphantxsize", DEFAULT_MAX_ORPHAN_TX_BYTES / 1000000)) * 1000000;
+}
+
+bool AddOrphanTx(const CTransaction& tx, NodeId peer)
 {
 	uint256 hash = tx.GetHash();
 
@@ -557,29 +606,53 @@ bool AddOrphanTx(const CTransaction& tx)
 	// large transaction with a missing parent then we assume
 	// it will rebroadcast it later, after the parent transaction(s)
 	// have been mined or received.
-	// 10,000 orphans, each of which is at most 5,000 bytes big is
-	// at most 500 megabytes of orphans:
+	// The pool as a whole is bounded by -maxorphantxsize, see LimitOrphanTxSize.
 
 	size_t nSize = tx.GetSerializeSize(SER_NETWORK, CTransaction::CURRENT_VERSION);
 
-	if (nSize > 5000)
+	if (nSize > MAX_ORPHAN_TX_SIZE)
 	{
 		LogPrint("mempool", "ignoring large orphan tx (size: %u, hash: %s)\n", nSize, hash.ToString());
 		
 		return false;
 	}
 
-	mapOrphanTransactions[hash] = tx;
+	// One peer can't push out the orphans everyone else sent us
+	size_t& nPeerBytes = mapOrphanBytesByPeer[peer];
+	
+	if (nPeerBytes + nSize > GetMaxOrphanTxBytes() / MAX_ORPHAN_TX_PEER_SHARE)
+	{
+		LogPrint("mempool", "ignoring orphan tx %s, peer=%d has %u bytes of orphans\n", hash.ToString(), peer, nPeerBytes);
+		
+		if (nPeerBytes == 0)
+		{
+			mapOrphanBytesByPeer.erase(peer);
+		}
+		
+		return false;
+	}
+
+	COrphanTx& orphan = mapOrphanTransactions[hash];
+	
+	orphan.tx = tx;
+	orphan.fromPeer = peer;
+	orphan.nTimeExpire = GetTime() + ORPHAN_TX_EXPIRE_TIME;
+	orphan.nSize = nSize;
+	
 	for(const CTxIn& txin : tx.vin)
 	{
-		mapOrphanTransactionsByPrev[txin.prevout.hash].insert(hash);
+		mapOrphanTransactionsByPrev[txin.prevout].insert(hash);
 	}
 
+	nOrphanTxBytes += nSize;
+	nPeerBytes += nSize;
+
 	LogPrint(
 		"mempool",
-		"stored orphan tx %s (mapsz %u)\n",
+		"stored orphan tx %s (mapsz %u, %u bytes)\n",
 		hash.ToString(),
-		mapOrphanTransactions.size()
+		mapOrphanTransactions.size(),
+		nOrphanTxBytes
 	);
 
 	return true;
@@ -587,15 +660,15 @@ bool AddOrphanTx(const CTransaction& tx)
 
 void static EraseOrphanTx(uint256 hash)
 {
-	std::map<uint256, CTransaction>::iterator it = mapOrphanTransactions.find(hash);
+	std::map<uint256, COrphanTx>::iterator it = mapOrphanTransactions.find(hash);
 	if (it == mapOrphanTransactions.end())
 	{
 		return;
 	}
 
-	for(const CTxIn& txin : it->second.vin)
+	for(const CTxIn& txin : it->second.tx.vin)
 	{
-		std::map<uint256, std::set<uint256> >::iterator itPrev = mapOrphanTransactionsByPrev.find(txin.prevout.hash);
+		std::map<COutPoint, std::set<uint256> >::iterator itPrev = mapOrphanTransactionsByPrev.find(txin.prevout);
 		
 		if (itPrev == mapOrphanTransactionsByPrev.end())
 		{
@@ -610,18 +683,90 @@ void static EraseOrphanTx(uint256 hash)
 		}
 	}
 
+	std::map<NodeId, size_t>::iterator itPeer = mapOrphanBytesByPeer.find(it->second.fromPeer);
+	
+	if (itPeer != mapOrphanBytesByPeer.end())
+	{
+		itPeer->second -= it->second.nSize;
+		
+		if (itPeer->second == 0)
+		{
+			mapOrphanBytesByPeer.erase(itPeer);
+		}
+	}
+	
+	nOrphanTxBytes -= it->second.nSize;
+	
 	mapOrphanTransactions.erase(it);
 }
 
-unsigned int LimitOrphanTxSize(unsigned int nMaxOrphans)
+void static EraseOrphansFor(NodeId peer)
 {
-	unsigned int nEvicted = 0;
+	if (!mapOrphanBytesByPeer.count(peer))
+	{
+		return;
+	}
+	
+	unsigned int nErased = 0;
+	std::map<uint256, COrphanTx>::iterator it = mapOrphanTransactions.begin();
+	
+	while (it != mapOrphanTransactions.end())
+	{
+		// EraseOrphanTx invalidates it
+		std::map<uint256, COrphanTx>::iterator itErase = it++;
+		
+		if (itErase->second.fromPeer == peer)
+		{
+			EraseOrphanTx(itErase->first);
+			
+			++nErased;
+		}
+	}
+	
+	LogPrint("mempool", "erased %u orphan tx from peer=%d\n", nErased, peer);
+}
 
-	while (mapOrphanTransactions.size() > nMaxOrphans)
+unsigned int LimitOrphanTxSize(unsigned int nMaxOrphans, size_t nMaxBytes)
+{
+	unsigned int nEvicted = 0;
+	int64_t nNow = GetTime();
+	
+	if (nNextOrphanTxSweep <= nNow)
+	{
+		// Sweep out expired orphan pool entries:
+		int64_t nMinExpTime = nNow + ORPHAN_TX_EXPIRE_TIME - ORPHAN_TX_EXPIRE_INTERVAL;
+		std::map<uint256, COrphanTx>::iterator it = mapOrphanTransactions.begin();
+		
+		while (it != mapOrphanTransactions.end())
+		{
+			std::map<uint256, COrphanTx>::iterator itErase = it++;
+			
+			if (itErase->second.nTimeExpire <= nNow)
+			{
+				EraseOrphanTx(itErase->first);
+				
+				++nEvicted;
+			}
+			else
+			{
+				nMinExpTime = std::min(itErase->second.nTimeExpire, nMinExpTime);
+			}
+		}
+		
+		// Sweep again 5 minutes after the next entry that expires in order to batch the linear scan.
+		nNextOrphanTxSweep = nMinExpTime + ORPHAN_TX_EXPIRE_INTERVAL;
+		
+		if (nEvicted > 0)
+		{
+			LogPrint("mempool", "expired %u orphan tx\n", nEvicted);
+		}
+	}
+	
+	while (mapOrphanTransactions.size() > nMaxOrphans || nOrphanTxBytes > nMaxBytes)
 	{
 		// Evict a random orphan:
 		uint256 randomhash = GetRandHash();
-		std::map<uint256, CTransaction>::iterator it = mapOrphanTransactions.lower_bound(randomhash);
+		std::map<uint256, COrphanTx>::iterator it = mapOrphanTransactions.lower_bound(randomhash);
 		
 		if (it == mapOrphanTransactions.end())
 		{
@@ -1179,6 +1324,8 @@ bool AcceptToMemoryPool(CTxMemPool& pool, CTransaction &tx, bool fLimitFree,
 		{
 			return error("AcceptToMemoryPool: : BUG! PLEASE REPORT THIS! ConnectInputs failed against MANDATORY but not STANDARD flags %s", hash.ToString());
 		}
+		
+		blockAssembler.TxAccepted(tx, mapInputs);
 	}
 
 	// Store transaction in memory
@@ -1631,17 +1778,19 @@ const CBlockIndex* GetLastBlockIndex(const CBlockIndex* pindex, bool fProofOfSta
 
 bool CheckProofOfWork(uint256 hash, unsigned int nBits)
 {
-	CBigNum bnTarget;
-	bnTarget.SetCompact(nBits);
+	bool fNegative;
+	bool fOverflow;
+	arith_uint256 bnTarget;
+	bnTarget.SetCompact(nBits, &fNegative, &fOverflow);
 
 	// Check range
-	if (bnTarget <= 0 || bnTarget > Params().ProofOfWorkLimit())
+	if (fNegative || fOverflow || bnTarget == 0 || bnTarget > Params().ProofOfWorkLimit())
 	{
 		return error("CheckProofOfWork() : nBits below minimum work");
 	}
 
 	// Check proof of work matches claimed amount
-	if (hash > bnTarget.getuint256())
+	if (hash > bnTarget)
 	{
 		return error("CheckProofOfWork() : hash doesn't match nBits");
 	}
@@ -1745,7 +1894,7 @@ bool BuildAddrIndex(const CScript &script, std::vector<uint160>& addrIds)
 
 	if (!fHaveData)
 	{
-		uint160 addrid = Hash160(script);
+		uint160 addrid = Hash160(script.begin(), script.end());
 		
 		addrIds.push_back(addrid);
 		
@@ -1943,11 +2092,17 @@ bool Reorganize(CTxDB& txdb, CBlockIndex* pindexNew)
 		AcceptToMemoryPool(mempool, tx, false, NULL);
 	}
 
+	// Transactions of the disconnected branch are not confirmed any more
+	recentConfirmedTransactions.reset();
+	blockAssembler.Clear();
+	
 	// Delete redundant memory transactions that are in the connected branch
 	for(CTransaction& tx : vDelete)
 	{
 		mempool.remove(tx);
 		mempool.removeConflicts(tx);
+		
+		recentConfirmedTransactions.insert(tx.GetHash());
 	}
 
 	LogPrintf("REORGANIZE: done\n");
@@ -2322,6 +2477,54 @@ FILE* AppendBlockFile(unsigned int& nFileRet)
 	}
 }
 
+bool ReadBlockBytesFromDisk(CSerializeData& vchBlock, const CBlockIndex* pindex)
+{
+	// CBlock::WriteToDisk puts the message start and the size just before the block
+	unsigned int nHeaderSize = MESSAGE_START_SIZE + sizeof(unsigned int);
+
+	if (pindex->nBlockPos < nHeaderSize)
+	{
+		return error("ReadBlockBytesFromDisk() : bad block position");
+	}
+
+	CAutoFile filein = CAutoFile(OpenBlockFile(pindex->nFile, pindex->nBlockPos - nHeaderSize, "rb"), SER_DISK, CLIENT_VERSION);
+
+	if (!filein)
+	{
+		return error("ReadBlockBytesFromDisk() : OpenBlockFile failed");
+	}
+
+	try
+	{
+		MessageStartChars pchMessageStart;
+		unsigned int nSize;
+
+		filein.read((char*)pchMessageStart, sizeof(pchMessageStart));
+		filein >> nSize;
+
+		if (memcmp(pchMessageStart, Params().MessageStart(), sizeof(pchMessageStart)) != 0 ||
+			nSize < 80 || nSize > MAX_MESSAGE_SIZE)
+		{
+			return error("ReadBlockBytesFromDisk() : bad index header at %u in file %u", pindex->nBlockPos, pindex->nFile);
+		}
+
+		vchBlock.resize(nSize);
+		filein.read(&vchBlock[0], nSize);
+	}
+	catch (std::exception &e)
+	{
+		return error("%s() : I/O error", __PRETTY_FUNCTION__);
+	}
+
+	// The first 80 bytes are the header, as CBlock::GetHash hashes them
+	if (Hash_bmw512_80((const unsigned char*)&vchBlock[0]) != pindex->GetBlockHash())
+	{
+		return error("ReadBlockBytesFromDisk() : hash doesn't match index");
+	}
+
+	return true;
+}
+
 bool LoadBlockIndex(bool fAllowNew)
 {
 	LOCK(cs_main);
@@ -2373,7 +2576,7 @@ void PrintBlockTree()
     // pre-compute tree structure
     std::map<CBlockIndex*, std::vector<CBlockIndex*> > mapNext;
     
-	for (std::map<uint256, CBlockIndex*>::iterator mi = mapBlockIndex.begin(); mi != mapBlockIndex.end(); ++mi)
+	for (CBlockIndexMap::iterator mi = mapBlockIndex.begin(); mi != mapBlockIndex.end(); ++mi)
     {
         CBlockIndex* pindex = (*mi).second;
         
@@ -2544,6 +2747,44 @@ bool LoadExternalBlockFile(FILE* fileIn)
 	return nLoaded > 0;
 }
 
+// Returns whether the file was read through, even if none of its blocks were new
+bool LoadExternalBlockFile(const boost::filesystem::path& path)
+{
+	int64_t nStart = GetTimeMillis();
+	
+	try
+	{
+		boost::interprocess::file_mapping mapping(path.string().c_str(), boost::interprocess::read_only);
+		boost::interprocess::mapped_region region(mapping, boost::interprocess::read_only);
+		
+		CBlockImporter importer((const unsigned char*)region.get_address(), region.get_size(),
+			GetArg("-loadblockthreads", CThreadPool::DefaultThreads()));
+		
+		int nLoaded = importer.Run();
+		
+		LogPrintf("Loaded %i blocks from external file in %dms, %u without a parent\n",
+			nLoaded, GetTimeMillis() - nStart, importer.PendingCount());
+		
+		return true;
+	}
+	catch (boost::interprocess::interprocess_exception &e)
+	{
+		// empty files and files too large for the address space
+		LogPrintf("%s : Cannot map %s (%s), reading it sequentially\n", __func__, path.string(), e.what());
+	}
+	
+	FILE *file = fopen(path.string().c_str(), "rb");
+	
+	if (!file)
+	{
+		return false;
+	}
+	
+	LoadExternalBlockFile(file);
+	
+	return true;
+}
+
 struct CImportingNow
 {
 	CImportingNow()
@@ -2568,12 +2809,7 @@ void ThreadImport(std::vector<boost::filesystem::path> vImportFiles)
 	// -loadblock=
 	for(boost::filesystem::path &path : vImportFiles)
 	{
-		FILE *file = fopen(path.string().c_str(), "rb");
-		
-		if (file)
-		{
-			LoadExternalBlockFile(file);
-		}
+		LoadExternalBlockFile(path);
 	}
 
 	// hardcoded $DATADIR/bootstrap.dat
@@ -2581,13 +2817,10 @@ void ThreadImport(std::vector<boost::filesystem::path> vImportFiles)
 
 	if (boost::filesystem::exists(pathBootstrap))
 	{
-		FILE *file = fopen(pathBootstrap.string().c_str(), "rb");
+		boost::filesystem::path pathBootstrapOld = GetDataDir() / "bootstrap.dat.old";
 		
-		if (file)
+		if (LoadExternalBlockFile(pathBootstrap))
 		{
-			boost::filesystem::path pathBootstrapOld = GetDataDir() / "bootstrap.dat.old";
-			
-			LoadExternalBlockFile(file);
 			RenameOver(pathBootstrap, pathBootstrapOld);
 		}
 	}
@@ -2671,7 +2904,40 @@ bool static AlreadyHave(CTxDB& txdb, const CInv& inv)
 			return mapMNengineBroadcastTxes.count(inv.hash);
 		
 		case MSG_TX:
-			return mempool.exists(inv.hash) || mapOrphanTransactions.count(inv.hash) || txdb.ContainsTx(inv.hash);
+		{
+			LOCK(cs_main);
+			
+			if (hashRecentRejectsChainTip != hashBestChain)
+			{
+				// A new block can make a rejected transaction valid, or
+				// confirm the inputs it was missing
+				hashRecentRejectsChainTip = hashBestChain;
+				recentRejects.reset();
+			}
+			
+			if (recentRejects.contains(inv.hash))
+			{
+				nTxInvRecentRejectHits++;
+				
+				return true;
+			}
+			
+			if (mempool.exists(inv.hash) || mapOrphanTransactions.count(inv.hash))
+			{
+				return true;
+			}
+			
+			if (recentConfirmedTransactions.contains(inv.hash))
+			{
+				nTxInvRecentConfirmedHits++;
+				
+				return true;
+			}
+			
+			nTxInvDiskLookups++;
+			
+			return txdb.ContainsTx(inv.hash);
+		}
 		
 		case MSG_BLOCK:
 			return mapBlockIndex.count(inv.hash) || mapOrphanBlocks.count(inv.hash);
@@ -2693,14 +2959,47 @@ bool static AlreadyHave(CTxDB& txdb, const CInv& inv)
 	return true;
 }
 
+static size_t GetMaxServedBlockBytes()
+{
+	return (size_t)std::max((int64_t)0, GetArg("-servedblockcache", DEFAULT_SERVED_BLOCK_CACHE_BYTES / 1000000)) * 1000000;
+}
+
+/** The block at pindex in wire format, from servedBlockCache or else from
+ * the block file. Does not need cs_main.
+ */
+static std::shared_ptr<const CServedBlock> GetServedBlock(const CBlockIndex* pindex)
+{
+	uint256 hash = pindex->GetBlockHash();
+	std::shared_ptr<const CServedBlock> pblock = servedBlockCache.Get(hash);
+
+	if (pblock)
+	{
+		return pblock;
+	}
+
+	std::shared_ptr<CServedBlock> pblockRead = std::make_shared<CServedBlock>();
+
+	if (!ReadBlockBytesFromDisk(pblockRead->vchData, pindex))
+	{
+		return std::shared_ptr<const CServedBlock>();
+	}
+
+	uint256 hashPayload = Hash_bmw512(pblockRead->vchData.begin(), pblockRead->vchData.end());
+
+	pblockRead->nChecksum = 0;
+	memcpy(&pblockRead->nChecksum, &hashPayload, sizeof(pblockRead->nChecksum));
+
+	servedBlockCache.Insert(hash, pblockRead, GetMaxServedBlockBytes());
+
+	return pblockRead;
+}
+
 void static ProcessGetData(CNode* pfrom)
 {
 	std::deque<CInv>::iterator it = pfrom->vRecvGetData.begin();
 
 	std::vector<CInv> vNotFound;
 
-	LOCK(cs_main);
-
 	while (it != pfrom->vRecvGetData.end())
 	{
 		// Don't bother if send buffer is too full to respond anyway
@@ -2718,16 +3017,34 @@ void static ProcessGetData(CNode* pfrom)
 
 			if (inv.type == MSG_BLOCK || inv.type == MSG_FILTERED_BLOCK)
 			{
-				// Send block from disk
-				std::map<uint256, CBlockIndex*>::iterator mi = mapBlockIndex.find(inv.hash);
+				// Only the lookup needs cs_main. Block index entries are never
+				// freed and a stored block never moves, so the block is read
+				// and sent without holding it.
+				const CBlockIndex* pindex = NULL;
 				
-				if (mi != mapBlockIndex.end())
 				{
-					CBlock block;
-					block.ReadFromDisk((*mi).second);
+					LOCK(cs_main);
+					
+					CBlockIndexMap::iterator mi = mapBlockIndex.find(inv.hash);
+					
+					if (mi != mapBlockIndex.end())
+					{
+						pindex = (*mi).second;
+					}
+				}
+				
+				if (pindex != NULL)
+				{
+					// Send the stored bytes as they are, the disk and network formats are the same
+					std::shared_ptr<const CServedBlock> pblock = GetServedBlock(pindex);
+					
+					if (pblock)
+					{
+						pfrom->PushMessageRaw("block", pblock->vchData, pblock->nChecksum);
+					}
+					
+					LOCK(cs_main);
 					
-					pfrom->PushMessage("block", block);
-
 					// Trigger them to send a getblocks request for the next batch of inventory
 					if (inv.hash == pfrom->hashContinue)
 					{
@@ -2744,6 +3061,8 @@ void static ProcessGetData(CNode* pfrom)
 			}
 			else if (inv.IsKnownType())
 			{
+				LOCK(cs_main);
+				
 				if(fDebug)
 				{
 					LogPrintf("ProcessGetData -- Starting \n");
@@ -2859,7 +3178,11 @@ void static ProcessGetData(CNode* pfrom)
 			}
 
 			// Track requests for our stuff.
-			g_signals.Inventory(inv.hash);
+			{
+				LOCK(cs_main);
+				
+				g_signals.Inventory(inv.hash);
+			}
 
 			if (inv.type == MSG_BLOCK  || inv.type == MSG_FILTERED_BLOCK)
 			{
@@ -3313,7 +3636,7 @@ bool static ProcessMessage(CNode* pfrom, std::string strCommand, CDataStream& vR
 		if (locator.IsNull())
 		{
 			// If locator is null, return the hashStop block
-			std::map<uint256, CBlockIndex*>::iterator mi = mapBlockIndex.find(hashStop);
+			CBlockIndexMap::iterator mi = mapBlockIndex.find(hashStop);
 			
 			if (mi == mapBlockIndex.end())
 			{
@@ -3351,8 +3674,9 @@ bool static ProcessMessage(CNode* pfrom, std::string strCommand, CDataStream& vR
 	}
 	else if (strCommand == "tx"|| strCommand == "dstx")
 	{
-		std::vector<uint256> vWorkQueue;
+		std::vector<COutPoint> vWorkQueue;
 		std::vector<uint256> vEraseQueue;
+		std::set<uint256> setOrphanDone;
 		CTransaction tx;
 
 		//masternode signed transaction
@@ -3446,12 +3770,16 @@ bool static ProcessMessage(CNode* pfrom, std::string strCommand, CDataStream& vR
 		if (AcceptToMemoryPool(mempool, tx, true, &fMissingInputs, false, ignoreFees))
 		{
 			RelayTransaction(tx, inv.hash);
-			vWorkQueue.push_back(inv.hash);
-
-			// Recursively process any orphan transactions that depended on this one
+			
+			for (unsigned int i = 0; i < tx.vout.size(); i++)
+			{
+				vWorkQueue.push_back(COutPoint(inv.hash, i));
+			}
+			
+			// Recursively process any orphan transactions that spend the new outputs
 			for (unsigned int i = 0; i < vWorkQueue.size(); i++)
 			{
-				std::map<uint256, std::set<uint256>>::iterator itByPrev = mapOrphanTransactionsByPrev.find(vWorkQueue[i]);
+				std::map<COutPoint, std::set<uint256> >::iterator itByPrev = mapOrphanTransactionsByPrev.find(vWorkQueue[i]);
 				
 				if (itByPrev == mapOrphanTransactionsByPrev.end())
 				{
@@ -3461,7 +3789,14 @@ bool static ProcessMessage(CNode* pfrom, std::string strCommand, CDataStream& vR
 				for (std::set<uint256>::iterator mi = itByPrev->second.begin(); mi != itByPrev->second.end(); ++mi)
 				{
 					const uint256& orphanTxHash = *mi;
-					CTransaction& orphanTx = mapOrphanTransactions[orphanTxHash];
+					
+					// An orphan spending several of the new outputs is settled once
+					if (setOrphanDone.count(orphanTxHash))
+					{
+						continue;
+					}
+					
+					CTransaction& orphanTx = mapOrphanTransactions[orphanTxHash].tx;
 					bool fMissingInputs2 = false;
 
 					if (AcceptToMemoryPool(mempool, orphanTx, true, &fMissingInputs2))
@@ -3469,14 +3804,22 @@ bool static ProcessMessage(CNode* pfrom, std::string strCommand, CDataStream& vR
 						LogPrint("mempool", "   accepted orphan tx %s\n", orphanTxHash.ToString());
 						
 						RelayTransaction(orphanTx, orphanTxHash);
-						vWorkQueue.push_back(orphanTxHash);
+						
+						for (unsigned int j = 0; j < orphanTx.vout.size(); j++)
+						{
+							vWorkQueue.push_back(COutPoint(orphanTxHash, j));
+						}
+						
 						vEraseQueue.push_back(orphanTxHash);
+						setOrphanDone.insert(orphanTxHash);
 					}
 					else if (!fMissingInputs2)
 					{
 						// Has inputs but not accepted to mempool
 						// Probably non-standard or insufficient fee/priority
 						vEraseQueue.push_back(orphanTxHash);
+						setOrphanDone.insert(orphanTxHash);
+						recentRejects.insert(orphanTxHash);
 						
 						LogPrint("mempool", "   removed orphan tx %s\n", orphanTxHash.ToString());
 					}
@@ -3490,16 +3833,21 @@ bool static ProcessMessage(CNode* pfrom, std::string strCommand, CDataStream& vR
 		}
 		else if (fMissingInputs)
 		{
-			AddOrphanTx(tx);
+			AddOrphanTx(tx, pfrom->GetId());
 
 			// DoS prevention: do not allow mapOrphanTransactions to grow unbounded
-			unsigned int nEvicted = LimitOrphanTxSize(MAX_ORPHAN_TRANSACTIONS);
+			unsigned int nEvicted = LimitOrphanTxSize(MAX_ORPHAN_TRANSACTIONS, GetMaxOrphanTxBytes());
 			
 			if (nEvicted > 0)
 			{
 				LogPrint("mempool", "mapOrphan overflow, removed %u tx\n", nEvicted);
 			}
 		}
+		else
+		{
+			// Don't fetch and check it again before the next block
+			recentRejects.insert(inv.hash);
+		}
 		
 		if(strCommand == "dstx")
 		{
@@ -9,6 +9,7 @@
 #include "types/mapprevtx_t.h"
 #include "types/ctxdestination.h"
 #include "types/nodeid.h"
+#include "types/cserializedata.h"
 
 struct CNodeStateStats;
 class CValidationState;
@@ -74,6 +75,8 @@ bool ProcessBlock(CNode* pfrom, CBlock* pblock);
 bool CheckDiskSpace(uint64_t nAdditionalBytes=0);
 FILE* OpenBlockFile(unsigned int nFile, unsigned int nBlockPos, const char* pszMode="rb");
 FILE* AppendBlockFile(unsigned int& nFileRet);
+/** Reads a stored block as it is in the block file, without deserializing it */
+bool ReadBlockBytesFromDisk(CSerializeData& vchBlock, const CBlockIndex* pindex);
 bool LoadBlockIndex(bool fAllowNew=true);
 void PrintBlockTree();
 CBlockIndex* FindBlockByHeight(int nHeight);
@@ -28,6 +28,18 @@ static const unsigned int MAX_P2SH_SIGOPS = 15;
 static unsigned int MAX_TX_SIGOPS = MAX_BLOCK_SIGOPS/5;
 /** The maximum number of orphan transactions kept in memory */
 static const unsigned int MAX_ORPHAN_TRANSACTIONS = MAX_BLOCK_SIZE/100;
+/** Orphan transactions larger than this are not kept */
+static const unsigned int MAX_ORPHAN_TX_SIZE = 5000;
+/** Default for -maxorphantxsize, total size in bytes of the orphan transactions kept in memory */
+static const int64_t DEFAULT_MAX_ORPHAN_TX_BYTES = 5 * 1000 * 1000;
+/** One peer's orphans may use at most this fraction (1/n) of the orphan pool */
+static const unsigned int MAX_ORPHAN_TX_PEER_SHARE = 4;
+/** Seconds an orphan transaction is kept before it expires */
+static const int64_t ORPHAN_TX_EXPIRE_TIME = 20 * 60;
+/** Minimum seconds between sweeps for expired orphan transactions */
+static const int64_t ORPHAN_TX_EXPIRE_INTERVAL = 5 * 60;
+/** Default for -servedblockcache, bytes of recently served blocks kept in wire format */
+static const int64_t DEFAULT_SERVED_BLOCK_CACHE_BYTES = 64 * 1000 * 1000;
 /** Default for -maxorphanblocks, maximum number of orphan blocks kept in memory */
 static const unsigned int DEFAULT_MAX_ORPHAN_BLOCKS = 10000;
 /** Fees smaller than this (in satoshi) are considered zero fee (for transaction creation) */
@@ -2,8 +2,11 @@
 #define MAIN_EXTERN_H
 
 #include <set>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
 #include "types/ccriticalsection.h"
 #include "cmainsignals.h"
+#include "cblockindexmap.h"
 
 class CScript;
 class CTxMemPool;
@@ -11,11 +14,14 @@ class CBlockIndex;
 class uint256;
 class COutPoint;
 struct COrphanBlock;
+class CRollingBloomFilter;
+class CBlockAssembler;
+class CServedBlockCache;
 
 extern CScript COINBASE_FLAGS;
 extern CCriticalSection cs_main;
 extern CTxMemPool mempool;
-extern std::map<uint256, CBlockIndex*> mapBlockIndex;
+extern CBlockIndexMap mapBlockIndex;
 extern std::set<std::pair<COutPoint, unsigned int> > setStakeSeen;
 extern CBlockIndex* pindexGenesisBlock;
 extern unsigned int nNodeLifespan;
@@ -40,5 +46,13 @@ extern bool fLargeWorkForkFound;
 extern bool fLargeWorkInvalidChainFound;
 extern CMainSignals g_signals;
 extern CBlockIndex* pblockindexFBBHLast;
+extern CRollingBloomFilter recentConfirmedTransactions;
+extern CBlockAssembler blockAssembler;
+extern CServedBlockCache servedBlockCache;
+extern boost::mutex csBestBlock;
+extern boost::condition_variable cvBlockChange;
+extern uint64_t nTxInvRecentRejectHits;
+extern uint64_t nTxInvRecentConfirmedHits;
+extern uint64_t nTxInvDiskLookups;
 
 #endif // MAIN_EXTERN_H
@@ -5,6 +5,7 @@
 #include "cblockindex.h"
 #include "cmasternode.h"
 #include "cmasternodeman.h"
+#include "cmasternodejournal.h"
 #include "cmasternodepayments.h"
 #include "cmasternodepaymentwinner.h"
 
@@ -17,6 +18,7 @@ std::map<uint256, int> mapSeenMasternodeScanningErrors;
 std::map<int64_t, uint256> mapCacheBlockHashes;
 
 CMasternodeMan mnodeman;
+CMasternodeJournal mnodeJournal;
 
 CCriticalSection cs_masternodepayments;
 /** Object for who's going to get paid on which blocks */
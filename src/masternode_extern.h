@@ -7,12 +7,14 @@
 
 class uint256;
 class CMasternodeMan;
+class CMasternodeJournal;
 class CMasternodePayments;
 class CMasternodePaymentWinner;
 
 extern CCriticalSection cs_masternodes;
 extern std::map<int64_t, uint256> mapCacheBlockHashes;
 extern CMasternodeMan mnodeman;
+extern CMasternodeJournal mnodeJournal;
 extern CCriticalSection cs_masternodepayments;
 extern CMasternodePayments masternodePayments;
 extern std::map<uint256, CMasternodePaymentWinner> mapSeenMasternodeVotes;
@@ -42,8 +42,13 @@ void DumpMasternodes()
 
 	LogPrintf("Writting info to mncache.dat...\n");
 	
-	mndb.Write(mnodeman);
+	mnodeman.WriteToDisk(mndb);
 
 	LogPrintf("Masternode dump finished  %dms\n", GetTimeMillis() - nStart);
 }
 
+void ProcessQueuedMasternodeBroadcasts()
+{
+	mnodeman.ProcessQueuedBroadcasts();
+}
+
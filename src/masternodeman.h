@@ -5,5 +5,6 @@
 #define MASTERNODES_DSEG_SECONDS               (3*60*60)
 
 void DumpMasternodes();
+void ProcessQueuedMasternodeBroadcasts();
 
 #endif // MASTERNODEMAN_H
@@ -26,6 +26,7 @@
 #include "cbitcoinaddress.h"
 #include "chainparams.h"
 #include "cchainparams.h"
+#include "uint/arith_uint256.h"
 #include "cnodestination.h"
 #include "ckeyid.h"
 #include "cscriptid.h"
@@ -36,6 +37,7 @@
 #include "ctxindex.h"
 #include "enums/serialize_type.h"
 #include "serialize.h"
+#include "cblockassembler.h"
 
 #include "miner.h"
 
@@ -245,95 +247,53 @@ CBlock* CreateNewBlock(CReserveKey& reservekey, bool fProofOfStake, int64_t* pFe
 				continue;
 			}
 			
-			COrphan* porphan = NULL;
-			double dPriority = 0;
-			int64_t nTotalIn = 0;
-			bool fMissingInputs = false;
+			// Inputs are read from disk only the first time a transaction is seen
+			const CBlockAssembler::CCandidate* pcandidate = blockAssembler.Get(txdb, tx);
 			
-			for(const CTxIn& txin : tx.vin)
+			if (!pcandidate)
 			{
-				// Read prev transaction
-				CTransaction txPrev;
-				CTxIndex txindex;
-				
-				if (!txPrev.ReadFromDisk(txdb, txin.prevout, txindex))
-				{
-					#ifdef ENABLE_ORPHAN_TRANSACTIONS
-						// This should never happen; all transactions in the memory
-						// pool should connect to either transactions in the chain
-						// or other transactions in the memory pool.
-						if (!mempool.mapTx.count(txin.prevout.hash))
-						{
-							LogPrintf("ERROR: mempool transaction missing input\n");
-							
-							if (fDebug)
-							{
-								assert("mempool transaction missing input" == 0);
-							}
-							
-							fMissingInputs = true;
-							
-							if (porphan)
-							{
-								vOrphan.pop_back();
-							}
-							
-							break;
-						}
-
-						// Has to wait for dependencies
-						if (!porphan)
-						{
-							// Use list for automatic deletion
-							vOrphan.push_back(COrphan(&tx));
-							porphan = &vOrphan.back();
-						}
-						
-						mapDependers[txin.prevout.hash].push_back(porphan);
-						porphan->setDependsOn.insert(txin.prevout.hash);
-						nTotalIn += mempool.mapTx[txin.prevout.hash].vout[txin.prevout.n].nValue;
-					#else // ENABLE_ORPHAN_TRANSACTIONS
-						fMissingInputs = true;
-					#endif // ENABLE_ORPHAN_TRANSACTIONS
-					
-					continue;
-				}
+				#ifdef ENABLE_ORPHAN_TRANSACTIONS
+					if (fDebug)
+					{
+						assert("mempool transaction missing input" == 0);
+					}
+				#endif // ENABLE_ORPHAN_TRANSACTIONS
 				
-				int64_t nValueIn = txPrev.vout[txin.prevout.n].nValue;
-				nTotalIn += nValueIn;
-
-				int nConf = txindex.GetDepthInMainChain();
-				dPriority += (double)nValueIn * nConf;
-			}
-			
-			if (fMissingInputs)
-			{
 				continue;
 			}
 			
-			// Priority is sum(valuein * age) / txsize
-			unsigned int nTxSize = ::GetSerializeSize(tx, SER_NETWORK, PROTOCOL_VERSION);
-			dPriority /= nTxSize;
+			double dPriority = pcandidate->GetPriority(nHeight);
 
 			// This is a more accurate fee-per-kilobyte than is used by the client code, because the
 			// client code rounds up the size to the nearest 1K. That's good, because it gives an
 			// incentive to create smaller transactions.
-			double dFeePerKb =  double(nTotalIn-tx.GetValueOut()) / (double(nTxSize)/1000.0);
+			double dFeePerKb =  double(pcandidate->nValueIn-tx.GetValueOut()) / (double(pcandidate->nTxSize)/1000.0);
 			
-			#ifdef ENABLE_ORPHAN_TRANSACTIONS
-				if (porphan)
-				{
+			if (!pcandidate->mapDependsOn.empty())
+			{
+				#ifdef ENABLE_ORPHAN_TRANSACTIONS
+					// Has to wait for dependencies
+					vOrphan.push_back(COrphan(&tx));
+					
+					COrphan* porphan = &vOrphan.back();
+					
 					porphan->dPriority = dPriority;
 					porphan->dFeePerKb = dFeePerKb;
-				}
-				else
-				{
-					vecPriority.push_back(TxPriority(dPriority, dFeePerKb, &(*mi).second));
-				}
-			#else // ENABLE_ORPHAN_TRANSACTIONS
-				vecPriority.push_back(TxPriority(dPriority, dFeePerKb, &(*mi).second));
-			#endif // ENABLE_ORPHAN_TRANSACTIONS
+					
+					for (const std::pair<const uint256, int64_t>& item : pcandidate->mapDependsOn)
+					{
+						mapDependers[item.first].push_back(porphan);
+						porphan->setDependsOn.insert(item.first);
+					}
+				#endif // ENABLE_ORPHAN_TRANSACTIONS
+				
+				continue;
+			}
+			
+			vecPriority.push_back(TxPriority(dPriority, dFeePerKb, &(*mi).second));
 		}
+		
+		blockAssembler.Prune(mempool);
 
 		// Collect transactions into block
 		std::map<uint256, CTxIndex> mapTestPool;
@@ -414,11 +374,18 @@ CBlock* CreateNewBlock(CReserveKey& reservekey, bool fProofOfStake, int64_t* pFe
 			// Note that flags: we don't want to set mempool/IsStandard()
 			// policy here, but we still have to ensure that the block we
 			// create only contains transactions that are valid in new blocks.
-			if (!tx.ConnectInputs(txdb, mapInputs, mapTestPoolTmp, CDiskTxPos(1,1,1), pindexPrev, false, true, MANDATORY_SCRIPT_VERIFY_FLAGS))
+			// Signatures verified once, when the transaction entered the
+			// memory pool or went into an earlier template, are not again
+			const CBlockAssembler::CCandidate* pcandidate = blockAssembler.Get(txdb, tx);
+			bool fValidateSig = !pcandidate || !pcandidate->fSigsChecked;
+			
+			if (!tx.ConnectInputs(txdb, mapInputs, mapTestPoolTmp, CDiskTxPos(1,1,1), pindexPrev, false, true, MANDATORY_SCRIPT_VERIFY_FLAGS, fValidateSig))
 			{
 				continue;
 			}
 			
+			blockAssembler.SetSigsChecked(tx.GetHash());
+			
 			mapTestPoolTmp[tx.GetHash()] = CTxIndex(CDiskTxPos(1,1,1), tx.vout.size());
 			swap(mapTestPool, mapTestPoolTmp);
 
@@ -678,7 +645,7 @@ bool CheckWork(CBlock* pblock, CWallet& wallet, CReserveKey& reservekey)
 {
 	uint256 hashBlock = pblock->GetHash();
 	uint256 hashProof = pblock->GetPoWHash();
-	uint256 hashTarget = CBigNum().SetCompact(pblock->nBits).getuint256();
+	uint256 hashTarget = arith_uint256().SetCompact(pblock->nBits);
 
 	if(!pblock->IsProofOfWork())
 	{
@@ -26,6 +26,7 @@
 #include "masternode.h"
 #include "masternodeman.h"
 #include "masternode_extern.h"
+#include "cmasternodejournal.h"
 #include "ctxdsin.h"
 #include "ctxdsout.h"
 #include "cmnengineentry.h"
@@ -90,6 +91,12 @@ void ThreadCheckMNenginePool()
                 mnodeman.ProcessMasternodeConnections();
                 masternodePayments.CleanPaymentList();
                 CleanTransactionLocksList();
+				
+				// the journal has outgrown mncache.dat, start both over
+				if(mnodeJournal.NeedsCompaction())
+				{
+					DumpMasternodes();
+				}
             }
 
             //if(c % MASTERNODES_DUMP_SECONDS == 0)
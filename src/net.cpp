@@ -1989,6 +1989,8 @@ void ThreadMessageHandler()
 			boost::this_thread::interruption_point();
 		}
 
+		g_net_signals.ProcessQueued();
+
 		{
 			LOCK(cs_vNodes);
 			
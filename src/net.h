@@ -69,6 +69,8 @@ struct CNodeSignals
     boost::signals2::signal<int ()> GetHeight;
     boost::signals2::signal<bool (CNode*)> ProcessMessages;
     boost::signals2::signal<bool (CNode*, bool)> SendMessages;
+    // once per pass of the message handler, for work batched across peers
+    boost::signals2::signal<void ()> ProcessQueued;
     boost::signals2::signal<void (NodeId, const CNode*)> InitializeNode;
     boost::signals2::signal<void (NodeId)> FinalizeNode;
 };
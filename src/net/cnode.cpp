@@ -262,6 +262,19 @@ void CNode::EndMessage() UNLOCK_FUNCTION(cs_vSend)
 		return;
 	}
 
+	if (ssSend.size() == 0)
+		return;
+
+	// Checksum of the payload
+	uint256 hash = Hash_bmw512(ssSend.begin() + CMessageHeader::HEADER_SIZE, ssSend.end());
+	unsigned int nChecksum = 0;
+	memcpy(&nChecksum, &hash, sizeof(nChecksum));
+
+	EndMessage(nChecksum);
+}
+
+void CNode::EndMessage(unsigned int nChecksum) UNLOCK_FUNCTION(cs_vSend)
+{
 	if (ssSend.size() == 0)
 		return;
 
@@ -270,9 +283,6 @@ void CNode::EndMessage() UNLOCK_FUNCTION(cs_vSend)
 	memcpy((char*)&ssSend[CMessageHeader::MESSAGE_SIZE_OFFSET], &nSize, sizeof(nSize));
 
 	// Set the checksum
-	uint256 hash = Hash_bmw512(ssSend.begin() + CMessageHeader::HEADER_SIZE, ssSend.end());
-	unsigned int nChecksum = 0;
-	memcpy(&nChecksum, &hash, sizeof(nChecksum));
 	assert(ssSend.size () >= CMessageHeader::CHECKSUM_OFFSET + sizeof(nChecksum));
 	memcpy((char*)&ssSend[CMessageHeader::CHECKSUM_OFFSET], &nChecksum, sizeof(nChecksum));
 
@@ -289,6 +299,26 @@ void CNode::EndMessage() UNLOCK_FUNCTION(cs_vSend)
 	LEAVE_CRITICAL_SECTION(cs_vSend);
 }
 
+void CNode::PushMessageRaw(const char* pszCommand, const CSerializeData& vchPayload, unsigned int nChecksum)
+{
+	try
+	{
+		BeginMessage(pszCommand);
+		
+		if (!vchPayload.empty())
+		{
+			ssSend.write(&vchPayload[0], vchPayload.size());
+		}
+		
+		EndMessage(nChecksum);
+	}
+	catch (...)
+	{
+		AbortMessage();
+		throw;
+	}
+}
+
 void CNode::PushVersion()
 {
     /// when NTP implemented, change to just nTime = GetAdjustedTime()
@@ -138,8 +138,11 @@ public:
     void BeginMessage(const char* pszCommand) EXCLUSIVE_LOCK_FUNCTION(cs_vSend);
     void AbortMessage() UNLOCK_FUNCTION(cs_vSend);
     void EndMessage() UNLOCK_FUNCTION(cs_vSend);
+    void EndMessage(unsigned int nChecksum) UNLOCK_FUNCTION(cs_vSend);
     void PushVersion();
     void PushMessage(const char* pszCommand);
+    /** Sends a payload that is already serialized, with its checksum worked out beforehand */
+    void PushMessageRaw(const char* pszCommand, const CSerializeData& vchPayload, unsigned int nChecksum);
 
     template<typename T1>
 	void PushMessage(const char* pszCommand, const T1& a1)
@@ -0,0 +1,285 @@
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+#include "prevector.h"
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+void prevector<N, T, Size, Diff>::change_capacity(size_type new_capacity)
+{
+	if (new_capacity <= N)
+	{
+		if (!is_direct())
+		{
+			// the pointer shares its bytes with the direct storage
+			T* indirect = indirect_ptr(0);
+
+			memcpy(direct_ptr(0), indirect, size() * sizeof(T));
+			free(indirect);
+
+			_size -= N + 1;
+		}
+	}
+	else if (!is_direct())
+	{
+		char* new_indirect = static_cast<char*>(realloc(_union.indirect, sizeof(T) * new_capacity));
+
+		if (!new_indirect)
+		{
+			throw std::bad_alloc();
+		}
+
+		_union.indirect = new_indirect;
+		_union.capacity = new_capacity;
+	}
+	else
+	{
+		char* new_indirect = static_cast<char*>(malloc(sizeof(T) * new_capacity));
+
+		if (!new_indirect)
+		{
+			throw std::bad_alloc();
+		}
+
+		memcpy(new_indirect, direct_ptr(0), size() * sizeof(T));
+
+		_union.indirect = new_indirect;
+		_union.capacity = new_capacity;
+		_size += N + 1;
+	}
+}
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+prevector<N, T, Size, Diff>::prevector(size_type n) : _size(0)
+{
+	resize(n);
+}
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+prevector<N, T, Size, Diff>::prevector(size_type n, const T& val) : _size(0)
+{
+	assign(n, val);
+}
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+prevector<N, T, Size, Diff>::prevector(const prevector<N, T, Size, Diff>& other) : _size(0)
+{
+	// exactly as large as needed, like a copied std::vector
+	change_capacity(other.size());
+
+	_size += other.size();
+
+	memcpy(item_ptr(0), other.item_ptr(0), other.size() * sizeof(T));
+}
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+prevector<N, T, Size, Diff>::prevector(prevector<N, T, Size, Diff>&& other) : _size(0)
+{
+	swap(other);
+}
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+prevector<N, T, Size, Diff>::~prevector()
+{
+	if (!is_direct())
+	{
+		free(_union.indirect);
+	}
+}
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+prevector<N, T, Size, Diff>& prevector<N, T, Size, Diff>::operator=(const prevector<N, T, Size, Diff>& other)
+{
+	if (&other != this)
+	{
+		assign(other.begin(), other.end());
+	}
+
+	return *this;
+}
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+prevector<N, T, Size, Diff>& prevector<N, T, Size, Diff>::operator=(prevector<N, T, Size, Diff>&& other)
+{
+	swap(other);
+
+	return *this;
+}
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+void prevector<N, T, Size, Diff>::assign(size_type n, const T& val)
+{
+	T value = val;
+
+	clear();
+
+	if (capacity() < n)
+	{
+		change_capacity(n);
+	}
+
+	_size += n;
+
+	std::fill_n(item_ptr(0), n, value);
+}
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+void prevector<N, T, Size, Diff>::resize(size_type new_size)
+{
+	size_type cur_size = size();
+
+	if (cur_size >= new_size)
+	{
+		_size -= cur_size - new_size;
+
+		return;
+	}
+
+	if (new_size > capacity())
+	{
+		change_capacity(new_size);
+	}
+
+	std::fill(item_ptr(cur_size), item_ptr(new_size), T());
+
+	_size += new_size - cur_size;
+}
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+void prevector<N, T, Size, Diff>::reserve(size_type new_capacity)
+{
+	if (new_capacity > capacity())
+	{
+		change_capacity(new_capacity);
+	}
+}
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+void prevector<N, T, Size, Diff>::shrink_to_fit()
+{
+	change_capacity(size());
+}
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+void prevector<N, T, Size, Diff>::clear()
+{
+	resize(0);
+}
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+typename prevector<N, T, Size, Diff>::iterator prevector<N, T, Size, Diff>::insert(iterator pos, const T& value)
+{
+	// value may live in this vector and move when it grows
+	T copy = value;
+	size_type p = pos - begin();
+	size_type new_size = size() + 1;
+
+	if (capacity() < new_size)
+	{
+		change_capacity(new_size + (new_size >> 1));
+	}
+
+	T* ptr = item_ptr(p);
+
+	memmove(ptr + 1, ptr, (size() - p) * sizeof(T));
+	_size++;
+	*ptr = copy;
+
+	return ptr;
+}
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+void prevector<N, T, Size, Diff>::insert(iterator pos, size_type count, const T& value)
+{
+	T copy = value;
+	size_type p = pos - begin();
+	size_type new_size = size() + count;
+
+	if (capacity() < new_size)
+	{
+		change_capacity(new_size + (new_size >> 1));
+	}
+
+	T* ptr = item_ptr(p);
+
+	memmove(ptr + count, ptr, (size() - p) * sizeof(T));
+	_size += count;
+
+	std::fill_n(ptr, count, copy);
+}
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+typename prevector<N, T, Size, Diff>::iterator prevector<N, T, Size, Diff>::erase(iterator pos)
+{
+	return erase(pos, pos + 1);
+}
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+typename prevector<N, T, Size, Diff>::iterator prevector<N, T, Size, Diff>::erase(iterator first, iterator last)
+{
+	memmove(first, last, (end() - last) * sizeof(T));
+	_size -= last - first;
+
+	return first;
+}
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+void prevector<N, T, Size, Diff>::push_back(const T& value)
+{
+	T copy = value;
+	size_type new_size = size() + 1;
+
+	if (capacity() < new_size)
+	{
+		change_capacity(new_size + (new_size >> 1));
+	}
+
+	*item_ptr(size()) = copy;
+	_size++;
+}
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+void prevector<N, T, Size, Diff>::pop_back()
+{
+	_size--;
+}
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+void prevector<N, T, Size, Diff>::swap(prevector<N, T, Size, Diff>& other)
+{
+	// by value, references to packed members are not allowed
+	direct_or_indirect tmp_union = _union;
+	size_type tmp_size = _size;
+
+	_union = other._union;
+	_size = other._size;
+	other._union = tmp_union;
+	other._size = tmp_size;
+}
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+bool prevector<N, T, Size, Diff>::operator==(const prevector<N, T, Size, Diff>& other) const
+{
+	return size() == other.size() && std::equal(begin(), end(), other.begin());
+}
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+bool prevector<N, T, Size, Diff>::operator!=(const prevector<N, T, Size, Diff>& other) const
+{
+	return !(*this == other);
+}
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+bool prevector<N, T, Size, Diff>::operator<(const prevector<N, T, Size, Diff>& other) const
+{
+	// the order of std::vector, scripts are keys of maps and sets
+	return std::lexicographical_compare(begin(), end(), other.begin(), other.end());
+}
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+size_t prevector<N, T, Size, Diff>::allocated_memory() const
+{
+	return is_direct() ? 0 : sizeof(T) * _union.capacity;
+}
+
+template class prevector<28, unsigned char>;
@@ -0,0 +1,349 @@
+#ifndef PREVECTOR_H
+#define PREVECTOR_H
+
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+#include <stdint.h>
+
+#pragma pack(push, 1)
+/** Vector of trivially copyable elements that keeps up to N of them inside
+ * the object and only goes to the heap when it grows past that.
+ *
+ * It has the interface of std::vector for the parts the code uses, with
+ * plain pointers as iterators. Unlike std::vector, clear() and resize()
+ * keep the capacity, call shrink_to_fit() to give it back.
+ *
+ * _size holds the number of elements while they are stored directly and
+ * the number plus N + 1 once they are on the heap, so the object needs no
+ * flag of its own. For N = 28 and unsigned char it is 32 bytes, against 24
+ * for a std::vector that also pays a heap block for every non-empty value.
+ */
+template<unsigned int N, typename T, typename Size = uint32_t, typename Diff = int32_t>
+class prevector
+{
+	static_assert(std::is_trivially_copyable<T>::value, "prevector only holds trivially copyable types");
+
+public:
+	typedef Size size_type;
+	typedef Diff difference_type;
+	typedef T value_type;
+	typedef value_type& reference;
+	typedef const value_type& const_reference;
+	typedef value_type* pointer;
+	typedef const value_type* const_pointer;
+	typedef value_type* iterator;
+	typedef const value_type* const_iterator;
+	typedef std::reverse_iterator<iterator> reverse_iterator;
+	typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+private:
+	size_type _size;
+
+	union direct_or_indirect
+	{
+		char direct[sizeof(T) * N];
+
+		struct
+		{
+			size_type capacity;
+			char* indirect;
+		};
+	} _union;
+
+	T* direct_ptr(difference_type pos);
+	const T* direct_ptr(difference_type pos) const;
+	T* indirect_ptr(difference_type pos);
+	const T* indirect_ptr(difference_type pos) const;
+	bool is_direct() const;
+
+	void change_capacity(size_type new_capacity);
+	T* item_ptr(difference_type pos);
+	const T* item_ptr(difference_type pos) const;
+
+public:
+	prevector();
+	explicit prevector(size_type n);
+	explicit prevector(size_type n, const T& val);
+	prevector(const prevector<N, T, Size, Diff>& other);
+	prevector(prevector<N, T, Size, Diff>&& other);
+	~prevector();
+
+	template<typename InputIterator>
+	prevector(InputIterator first, InputIterator last);
+
+	prevector& operator=(const prevector<N, T, Size, Diff>& other);
+	prevector& operator=(prevector<N, T, Size, Diff>&& other);
+
+	void assign(size_type n, const T& val);
+
+	template<typename InputIterator>
+	void assign(InputIterator first, InputIterator last);
+
+	size_type size() const;
+	bool empty() const;
+	size_type capacity() const;
+
+	iterator begin();
+	const_iterator begin() const;
+	iterator end();
+	const_iterator end() const;
+	reverse_iterator rbegin();
+	const_reverse_iterator rbegin() const;
+	reverse_iterator rend();
+	const_reverse_iterator rend() const;
+
+	T& operator[](size_type pos);
+	const T& operator[](size_type pos) const;
+	T& front();
+	const T& front() const;
+	T& back();
+	const T& back() const;
+	T* data();
+	const T* data() const;
+
+	void resize(size_type new_size);
+	void reserve(size_type new_capacity);
+	void shrink_to_fit();
+	void clear();
+
+	iterator insert(iterator pos, const T& value);
+	void insert(iterator pos, size_type count, const T& value);
+
+	template<typename InputIterator>
+	void insert(iterator pos, InputIterator first, InputIterator last);
+
+	iterator erase(iterator pos);
+	iterator erase(iterator first, iterator last);
+	void push_back(const T& value);
+	void pop_back();
+	void swap(prevector<N, T, Size, Diff>& other);
+
+	bool operator==(const prevector<N, T, Size, Diff>& other) const;
+	bool operator!=(const prevector<N, T, Size, Diff>& other) const;
+	bool operator<(const prevector<N, T, Size, Diff>& other) const;
+
+	/** Heap bytes owned by this vector, 0 while the elements fit inside */
+	size_t allocated_memory() const;
+};
+#pragma pack(pop)
+
+//
+// Element access is used in every script loop, so it stays in the header
+// where it can be inlined. Everything that may allocate is in prevector.cpp.
+//
+template<unsigned int N, typename T, typename Size, typename Diff>
+inline T* prevector<N, T, Size, Diff>::direct_ptr(difference_type pos)
+{
+	return reinterpret_cast<T*>(_union.direct) + pos;
+}
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+inline const T* prevector<N, T, Size, Diff>::direct_ptr(difference_type pos) const
+{
+	return reinterpret_cast<const T*>(_union.direct) + pos;
+}
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+inline T* prevector<N, T, Size, Diff>::indirect_ptr(difference_type pos)
+{
+	return reinterpret_cast<T*>(_union.indirect) + pos;
+}
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+inline const T* prevector<N, T, Size, Diff>::indirect_ptr(difference_type pos) const
+{
+	return reinterpret_cast<const T*>(_union.indirect) + pos;
+}
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+inline bool prevector<N, T, Size, Diff>::is_direct() const
+{
+	return _size <= N;
+}
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+inline T* prevector<N, T, Size, Diff>::item_ptr(difference_type pos)
+{
+	return is_direct() ? direct_ptr(pos) : indirect_ptr(pos);
+}
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+inline const T* prevector<N, T, Size, Diff>::item_ptr(difference_type pos) const
+{
+	return is_direct() ? direct_ptr(pos) : indirect_ptr(pos);
+}
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+inline prevector<N, T, Size, Diff>::prevector() : _size(0)
+{
+
+}
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+template<typename InputIterator>
+prevector<N, T, Size, Diff>::prevector(InputIterator first, InputIterator last) : _size(0)
+{
+	assign(first, last);
+}
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+template<typename InputIterator>
+void prevector<N, T, Size, Diff>::assign(InputIterator first, InputIterator last)
+{
+	size_type n = std::distance(first, last);
+
+	if (capacity() < n)
+	{
+		change_capacity(n);
+	}
+
+	_size = is_direct() ? n : n + N + 1;
+
+	T* dst = item_ptr(0);
+
+	while (first != last)
+	{
+		*dst++ = *first++;
+	}
+}
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+template<typename InputIterator>
+void prevector<N, T, Size, Diff>::insert(iterator pos, InputIterator first, InputIterator last)
+{
+	size_type p = pos - begin();
+	difference_type count = std::distance(first, last);
+	size_type new_size = size() + count;
+
+	if (capacity() < new_size)
+	{
+		change_capacity(new_size + (new_size >> 1));
+	}
+
+	T* ptr = item_ptr(p);
+
+	memmove(ptr + count, ptr, (size() - p) * sizeof(T));
+	_size += count;
+
+	while (first != last)
+	{
+		*ptr++ = *first++;
+	}
+}
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+inline typename prevector<N, T, Size, Diff>::size_type prevector<N, T, Size, Diff>::size() const
+{
+	return is_direct() ? _size : _size - N - 1;
+}
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+inline bool prevector<N, T, Size, Diff>::empty() const
+{
+	return size() == 0;
+}
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+inline typename prevector<N, T, Size, Diff>::size_type prevector<N, T, Size, Diff>::capacity() const
+{
+	return is_direct() ? N : _union.capacity;
+}
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+inline typename prevector<N, T, Size, Diff>::iterator prevector<N, T, Size, Diff>::begin()
+{
+	return item_ptr(0);
+}
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+inline typename prevector<N, T, Size, Diff>::const_iterator prevector<N, T, Size, Diff>::begin() const
+{
+	return item_ptr(0);
+}
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+inline typename prevector<N, T, Size, Diff>::iterator prevector<N, T, Size, Diff>::end()
+{
+	return item_ptr(size());
+}
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+inline typename prevector<N, T, Size, Diff>::const_iterator prevector<N, T, Size, Diff>::end() const
+{
+	return item_ptr(size());
+}
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+inline typename prevector<N, T, Size, Diff>::reverse_iterator prevector<N, T, Size, Diff>::rbegin()
+{
+	return reverse_iterator(end());
+}
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+inline typename prevector<N, T, Size, Diff>::const_reverse_iterator prevector<N, T, Size, Diff>::rbegin() const
+{
+	return const_reverse_iterator(end());
+}
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+inline typename prevector<N, T, Size, Diff>::reverse_iterator prevector<N, T, Size, Diff>::rend()
+{
+	return reverse_iterator(begin());
+}
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+inline typename prevector<N, T, Size, Diff>::const_reverse_iterator prevector<N, T, Size, Diff>::rend() const
+{
+	return const_reverse_iterator(begin());
+}
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+inline T& prevector<N, T, Size, Diff>::operator[](size_type pos)
+{
+	return *item_ptr(pos);
+}
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+inline const T& prevector<N, T, Size, Diff>::operator[](size_type pos) const
+{
+	return *item_ptr(pos);
+}
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+inline T& prevector<N, T, Size, Diff>::front()
+{
+	return *item_ptr(0);
+}
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+inline const T& prevector<N, T, Size, Diff>::front() const
+{
+	return *item_ptr(0);
+}
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+inline T& prevector<N, T, Size, Diff>::back()
+{
+	return *item_ptr(size() - 1);
+}
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+inline const T& prevector<N, T, Size, Diff>::back() const
+{
+	return *item_ptr(size() - 1);
+}
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+inline T* prevector<N, T, Size, Diff>::data()
+{
+	return item_ptr(0);
+}
+
+template<unsigned int N, typename T, typename Size, typename Diff>
+inline const T* prevector<N, T, Size, Diff>::data() const
+{
+	return item_ptr(0);
+}
+
+#endif // PREVECTOR_H
@@ -16,6 +16,7 @@
 #include "rpcprotocol.h"
 #include "rpcrawtransaction.h"
 #include "serialize.h"
+#include "thread.h"
 
 double GetDifficulty(const CBlockIndex* blockindex)
 {
@@ -252,6 +253,30 @@ json_spirit::Value getrawmempool(const json_spirit::Array& params, bool fHelp)
 	return a;
 }
 
+json_spirit::Value getmempoolinfo(const json_spirit::Array& params, bool fHelp)
+{
+	if (fHelp || params.size() != 0)
+	{
+		throw std::runtime_error(
+			"getmempoolinfo\n"
+			"Returns the size of the memory pool and how many transaction announcements\n"
+			"were answered by the recently rejected and recently confirmed filters\n"
+			"instead of a lookup in the transaction index."
+		);
+	}
+
+	LOCK(cs_main);
+
+	json_spirit::Object obj;
+	
+	obj.push_back(json_spirit::Pair("size",                (uint64_t)mempool.size()));
+	obj.push_back(json_spirit::Pair("recentrejecthits",    nTxInvRecentRejectHits));
+	obj.push_back(json_spirit::Pair("recentconfirmedhits", nTxInvRecentConfirmedHits));
+	obj.push_back(json_spirit::Pair("disklookups",         nTxInvDiskLookups));
+	
+	return obj;
+}
+
 json_spirit::Value getblockhash(const json_spirit::Array& params, bool fHelp)
 {
 	if (fHelp || params.size() != 1)
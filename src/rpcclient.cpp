@@ -193,6 +193,7 @@ static const CRPCConvertParam vRPCConvertParams[] =
 	{ "searchrawtransactions", 1 },
 	{ "searchrawtransactions", 2 },
 	{ "searchrawtransactions", 3 },
+	{ "smsgscanchain", 0 },
 };
 
 class CRPCConvertTable
@@ -1,4 +1,9 @@
+#include <algorithm>
+#include <map>
+
 #include "util.h"
+#include "thread/clocksite.h"
+#include "thread/clockstats.h"
 #include "json/json_spirit_value.h"
 
 json_spirit::Value debugrpcallowip(const json_spirit::Array& params, bool fHelp)
@@ -12,4 +17,127 @@ json_spirit::Value debugrpcallowip(const json_spirit::Array& params, bool fHelp)
 	}
 	
 	return obj;
+}
+
+static json_spirit::Array LockHistogram(const uint64_t* pCounts)
+{
+	json_spirit::Array histogram;
+	int nBuckets = CLockSite::HISTOGRAM_BUCKETS;
+	
+	// the empty buckets past the last one used are left out
+	while (nBuckets > 0 && pCounts[nBuckets - 1] == 0)
+	{
+		nBuckets--;
+	}
+	
+	for (int i = 0; i < nBuckets; i++)
+	{
+		histogram.push_back(pCounts[i]);
+	}
+	
+	return histogram;
+}
+
+static json_spirit::Object LockCountsToJSON(const CLockSite::Counts& counts)
+{
+	json_spirit::Object obj;
+	
+	obj.push_back(json_spirit::Pair("locks", counts.nLocks));
+	obj.push_back(json_spirit::Pair("contended", counts.nContended));
+	obj.push_back(json_spirit::Pair("tryfailed", counts.nTryFailed));
+	obj.push_back(json_spirit::Pair("waitmicros", counts.nWaitMicros));
+	obj.push_back(json_spirit::Pair("maxwaitmicros", counts.nMaxWaitMicros));
+	obj.push_back(json_spirit::Pair("holdmicros", counts.nHoldMicros));
+	obj.push_back(json_spirit::Pair("maxholdmicros", counts.nMaxHoldMicros));
+	obj.push_back(json_spirit::Pair("waithistogram", LockHistogram(counts.vWaitHistogram)));
+	obj.push_back(json_spirit::Pair("holdhistogram", LockHistogram(counts.vHoldHistogram)));
+	
+	return obj;
+}
+
+json_spirit::Value getlockstats(const json_spirit::Array& params, bool fHelp)
+{
+	if (fHelp || params.size() > 1)
+	{
+		throw std::runtime_error(
+			"getlockstats ( \"name\" )\n"
+			"Returns how often each lock was taken, how often and how long callers\n"
+			"waited for it and how long it was held, summed over its call sites and\n"
+			"ordered by time spent waiting. With a name, also lists that lock's call\n"
+			"sites. Histogram bucket 0 counts times under 1us and bucket n times from\n"
+			"2^(n-1) up to 2^n us. Only collected when started with -lockstats."
+		);
+	}
+	
+	std::string strName = params.size() > 0 ? params[0].get_str() : "";
+	std::map<std::string, CLockSite::Counts> mapLocks;
+	std::vector<std::pair<uint64_t, const CLockSite*>> vSites;
+	
+	for (const CLockSite* pSite : lockStats.GetSites())
+	{
+		CLockSite::Counts counts = pSite->GetCounts();
+		
+		mapLocks[pSite->strName].Add(counts);
+		
+		if (pSite->strName == strName)
+		{
+			vSites.push_back(std::make_pair(counts.nWaitMicros, pSite));
+		}
+	}
+	
+	std::vector<std::pair<uint64_t, std::string>> vLocks;
+	
+	for (const std::pair<const std::string, CLockSite::Counts>& item : mapLocks)
+	{
+		if (strName.empty() || item.first == strName)
+		{
+			vLocks.push_back(std::make_pair(item.second.nWaitMicros, item.first));
+		}
+	}
+	
+	std::sort(vLocks.rbegin(), vLocks.rend());
+	std::sort(vSites.rbegin(), vSites.rend());
+	
+	json_spirit::Object result;
+	json_spirit::Array locks;
+	
+	for (const std::pair<uint64_t, std::string>& item : vLocks)
+	{
+		json_spirit::Object lock;
+		
+		lock.push_back(json_spirit::Pair("name", item.second));
+		
+		for (const json_spirit::Pair& pair : LockCountsToJSON(mapLocks[item.second]))
+		{
+			lock.push_back(pair);
+		}
+		
+		if (!strName.empty())
+		{
+			json_spirit::Array sites;
+			
+			for (const std::pair<uint64_t, const CLockSite*>& site : vSites)
+			{
+				json_spirit::Object obj;
+				
+				obj.push_back(json_spirit::Pair("site", site.second->ToString()));
+				
+				for (const json_spirit::Pair& pair : LockCountsToJSON(site.second->GetCounts()))
+				{
+					obj.push_back(pair);
+				}
+				
+				sites.push_back(obj);
+			}
+			
+			lock.push_back(json_spirit::Pair("sites", sites));
+		}
+		
+		locks.push_back(lock);
+	}
+	
+	result.push_back(json_spirit::Pair("enabled", fLockStats.load()));
+	result.push_back(json_spirit::Pair("locks", locks));
+	
+	return result;
 }
\ No newline at end of file
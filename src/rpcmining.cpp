@@ -8,6 +8,7 @@
 #include "rpcserver.h"
 #include "blockparams.h"
 #include "cchainparams.h"
+#include "uint/arith_uint256.h"
 #include "chainparams.h"
 #include "cmasternode.h"
 #include "cmasternodeman.h"
@@ -35,6 +36,8 @@
 #include "cstealthaddress.h"
 #include "cblockindex.h"
 #include "util.h"
+#include "thread.h"
+#include "cblockassembler.h"
 #include "enums/serialize_type.h"
 #include "ctxindex.h"
 #include "types/mapnewblock_t.h"
@@ -133,7 +136,7 @@ json_spirit::Value getmininginfo(const json_spirit::Array& params, bool fHelp)
 	// Define block rewards
 	int64_t nRewardPoW = (uint64_t)GetProofOfWorkReward(nBestHeight, 0);
 
-	json_spirit::Object obj, diff, weight;
+	json_spirit::Object obj, diff, weight, cache;
 
 	obj.push_back(json_spirit::Pair("blocks",        (int)nBestHeight));
 	obj.push_back(json_spirit::Pair("currentblocksize",(uint64_t)nLastBlockSize));
@@ -151,6 +154,12 @@ json_spirit::Value getmininginfo(const json_spirit::Array& params, bool fHelp)
 	obj.push_back(json_spirit::Pair("errors", GetWarnings("statusbar")));
 	obj.push_back(json_spirit::Pair("pooledtx", (uint64_t)mempool.size()));
 
+	cache.push_back(json_spirit::Pair("entries", (uint64_t)blockAssembler.size()));
+	cache.push_back(json_spirit::Pair("hits", blockAssembler.GetHits()));
+	cache.push_back(json_spirit::Pair("misses", blockAssembler.GetMisses()));
+
+	obj.push_back(json_spirit::Pair("templatecache", cache));
+
 	weight.push_back(json_spirit::Pair("minimum", (uint64_t)nWeight));
 	weight.push_back(json_spirit::Pair("maximum", (uint64_t)0));
 	weight.push_back(json_spirit::Pair("combined", (uint64_t)nWeight));
@@ -401,7 +410,7 @@ json_spirit::Value getworkex(const json_spirit::Array& params, bool fHelp)
 		
 		FormatHashBuffers(pblock, pmidstate, pdata, phash1);
 
-		uint256 hashTarget = CBigNum().SetCompact(pblock->nBits).getuint256();
+		uint256 hashTarget = arith_uint256().SetCompact(pblock->nBits);
 
 		CTransaction coinbaseTx = pblock->vtx[0];
 		std::vector<uint256> merkle = pblock->GetMerkleBranch(0);
@@ -581,7 +590,7 @@ json_spirit::Value getwork(const json_spirit::Array& params, bool fHelp)
 		
 		FormatHashBuffers(pblock, pmidstate, pdata, phash1);
 
-		uint256 hashTarget = CBigNum().SetCompact(pblock->nBits).getuint256();
+		uint256 hashTarget = arith_uint256().SetCompact(pblock->nBits);
 		json_spirit::Object result;
 		
 		result.push_back(json_spirit::Pair("midstate", HexStr(BEGIN(pmidstate), END(pmidstate)))); // deprecated
@@ -633,6 +642,8 @@ json_spirit::Value getblocktemplate(const json_spirit::Array& params, bool fHelp
 	{
 		throw std::runtime_error(
 			"getblocktemplate [params]\n"
+			"If params contains a \"longpollid\" from an earlier template, waits until\n"
+			"the best block changes, or a minute has passed and the memory pool has.\n"
 			"Returns data needed to construct a block to work on:\n"
 			"  \"version\" : block version\n"
 			"  \"previousblockhash\" : hash of current highest block\n"
@@ -648,6 +659,7 @@ json_spirit::Value getblocktemplate(const json_spirit::Array& params, bool fHelp
 			"  \"sizelimit\" : limit of block size\n"
 			"  \"bits\" : compressed target of next block\n"
 			"  \"height\" : height of the next block\n"
+			"  \"longpollid\" : id to wait for a newer template with\n"
 			"  \"payee\" : \"xxx\",                (string) required payee for the next block\n"
 			"  \"payee_amount\" : n,               (numeric) required amount to pay\n"
 			"  \"votes\" : [\n                     (array) show vote candidates\n"
@@ -661,11 +673,15 @@ json_spirit::Value getblocktemplate(const json_spirit::Array& params, bool fHelp
 	}
 
 	std::string strMode = "template";
+	json_spirit::Value lpval = json_spirit::Value::null;
+	
 	if (params.size() > 0)
 	{
 		const json_spirit::Object& oparam = params[0].get_obj();
 		const json_spirit::Value& modeval = find_value(oparam, "mode");
 		
+		lpval = find_value(oparam, "longpollid");
+		
 		if (modeval.type() == json_spirit::str_type)
 		{
 			strMode = modeval.get_str();
@@ -685,6 +701,55 @@ json_spirit::Value getblocktemplate(const json_spirit::Array& params, bool fHelp
 		throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid mode");
 	}
 
+	static unsigned int nTransactionsUpdatedLast;
+
+	if (lpval.type() != json_spirit::null_type)
+	{
+		// Wait to respond until either the best block changes, OR a minute has passed and there are more transactions
+		uint256 hashWatchedChain;
+		unsigned int nTransactionsUpdatedLastLP;
+
+		if (lpval.type() == json_spirit::str_type)
+		{
+			// Format: <hashBestChain><nTransactionsUpdatedLast>
+			std::string lpstr = lpval.get_str();
+
+			hashWatchedChain.SetHex(lpstr.substr(0, 64));
+			nTransactionsUpdatedLastLP = lpstr.size() > 64 ? atoi64(lpstr.substr(64)) : 0;
+		}
+		else
+		{
+			// NOTE: Spec does not specify behaviour for non-string longpollid, but this makes testing easier
+			hashWatchedChain = hashBestChain;
+			nTransactionsUpdatedLastLP = nTransactionsUpdatedLast;
+		}
+
+		// No lock is held here, the block and transaction handlers go on while we wait
+		boost::system_time checktxtime = boost::get_system_time() + boost::posix_time::minutes(1);
+		boost::unique_lock<boost::mutex> lock(csBestBlock);
+
+		while (hashBestChain == hashWatchedChain && !ShutdownRequested())
+		{
+			if (!cvBlockChange.timed_wait(lock, checktxtime))
+			{
+				// Timeout: Check transactions for update
+				if (mempool.GetTransactionsUpdated() != nTransactionsUpdatedLastLP)
+				{
+					break;
+				}
+
+				checktxtime += boost::posix_time::seconds(10);
+			}
+		}
+
+		if (ShutdownRequested())
+		{
+			throw JSONRPCError(RPC_CLIENT_NOT_CONNECTED, "Shutting down");
+		}
+	}
+
+	LOCK(cs_main);
+
 	if (vNodes.empty())
 	{
 		throw JSONRPCError(RPC_CLIENT_NOT_CONNECTED, "DigitalNote is not connected!");
@@ -701,7 +766,6 @@ json_spirit::Value getblocktemplate(const json_spirit::Array& params, bool fHelp
 	}
 
 	// Update block
-	static unsigned int nTransactionsUpdatedLast;
 	static CBlockIndex* pindexPrev;
 	static int64_t nStart;
 	static CBlock* pblock;
@@ -798,7 +862,7 @@ json_spirit::Value getblocktemplate(const json_spirit::Array& params, bool fHelp
 	json_spirit::Object aux;
 	aux.push_back(json_spirit::Pair("flags", HexStr(COINBASE_FLAGS.begin(), COINBASE_FLAGS.end())));
 
-	uint256 hashTarget = CBigNum().SetCompact(pblock->nBits).getuint256();
+	uint256 hashTarget = arith_uint256().SetCompact(pblock->nBits);
 
 	static json_spirit::Array aMutable;
 	if (aMutable.empty())
@@ -819,6 +883,7 @@ json_spirit::Value getblocktemplate(const json_spirit::Array& params, bool fHelp
 	result.push_back(json_spirit::Pair("version", pblock->nVersion));
 	result.push_back(json_spirit::Pair("previousblockhash", pblock->hashPrevBlock.GetHex()));
 	result.push_back(json_spirit::Pair("transactions", transactions));
+	result.push_back(json_spirit::Pair("longpollid", pindexPrev->GetBlockHash().GetHex() + i64tostr(nTransactionsUpdatedLast)));
 
 	// Check for payment upgrade fork
 	if (pindexBest->GetBlockTime() > 0 and pindexBest->GetBlockTime() > VERION_1_0_0_0_MANDATORY_UPDATE_START) // Monday, May 20, 2019 12:00:00 AM
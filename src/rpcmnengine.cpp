@@ -596,7 +596,7 @@ json_spirit::Value masternode(const json_spirit::Array& params, bool fHelp)
 		}
 		
 		CTxIn vin = CTxIn();
-		CPubKey pubkey = CScript();
+		CPubKey pubkey = CPubKey();
 		CKey key;
 		bool found = activeMasternode.GetMasterNodeVin(vin, pubkey, key);
 		
@@ -20,6 +20,11 @@
 #include "thread.h"
 #include "ui_interface.h"
 #include "rpcprotocol.h"
+#include "allocators/streambufferpool.h"
+#include "main_extern.h"
+#include "cservedblockcache.h"
+#include "instantx.h"
+#include "cconsensusvotequeue.h"
 
 typedef std::list<std::pair<std::string, std::vector<CService>>> addresslist_t;
 
@@ -423,7 +428,9 @@ json_spirit::Value getnettotals(const json_spirit::Array& params, bool fHelp)
 		throw std::runtime_error(
 			"getnettotals\n"
 			"Returns information about network traffic, including bytes in, bytes out,\n"
-			"and current time."
+			"current time, how often message and block buffers were reused, how\n"
+			"many blocks sent to peers came from memory rather than disk, and how\n"
+			"InstantX lock votes were verified and how long locks took to complete."
 		);
 	}
 
@@ -433,6 +440,43 @@ json_spirit::Value getnettotals(const json_spirit::Array& params, bool fHelp)
 	obj.push_back(json_spirit::Pair("totalbytessent", CNode::GetTotalBytesSent()));
 	obj.push_back(json_spirit::Pair("timemillis", GetTimeMillis()));
 
+	StreamBufferPool::Stats stats = StreamBufferPool::Instance().GetStats();
+	json_spirit::Object buffers;
+
+	buffers.push_back(json_spirit::Pair("allocations", stats.nAllocs));
+	buffers.push_back(json_spirit::Pair("reused", stats.nHits));
+	buffers.push_back(json_spirit::Pair("oversize", stats.nOversize));
+	buffers.push_back(json_spirit::Pair("bytesreused", stats.nBytesRecycled));
+	buffers.push_back(json_spirit::Pair("bytescached", (uint64_t)stats.nCachedBytes));
+	obj.push_back(json_spirit::Pair("streambuffers", buffers));
+
+	json_spirit::Object blocks;
+
+	blocks.push_back(json_spirit::Pair("cached", (uint64_t)servedBlockCache.size()));
+	blocks.push_back(json_spirit::Pair("bytescached", (uint64_t)servedBlockCache.GetBytes()));
+	blocks.push_back(json_spirit::Pair("hits", servedBlockCache.GetHits()));
+	blocks.push_back(json_spirit::Pair("diskreads", servedBlockCache.GetMisses()));
+	obj.push_back(json_spirit::Pair("servedblocks", blocks));
+
+	CConsensusVoteQueue::Stats ixstats = consensusVoteQueue.GetStats();
+	json_spirit::Object votes;
+
+	votes.push_back(json_spirit::Pair("votes", ixstats.nVotes));
+	votes.push_back(json_spirit::Pair("unknown", ixstats.nUnknown));
+	votes.push_back(json_spirit::Pair("notintop", ixstats.nNotInTop));
+	votes.push_back(json_spirit::Pair("badsignature", ixstats.nBadSignature));
+	votes.push_back(json_spirit::Pair("counted", ixstats.nCounted));
+	votes.push_back(json_spirit::Pair("batches", ixstats.nBatches));
+	votes.push_back(json_spirit::Pair("ranktables", ixstats.nRankTables));
+	votes.push_back(json_spirit::Pair("verifymillis", ixstats.nVerifyMicros / 1000.0));
+	votes.push_back(json_spirit::Pair("avgwaitmillis",
+		ixstats.nCounted ? ixstats.nWaitMicros / 1000.0 / ixstats.nCounted : 0.0));
+	votes.push_back(json_spirit::Pair("locks", ixstats.nLocks));
+	votes.push_back(json_spirit::Pair("avglockmillis",
+		ixstats.nLocks ? ixstats.nLockMicros / 1000.0 / ixstats.nLocks : 0.0));
+	votes.push_back(json_spirit::Pair("maxlockmillis", ixstats.nMaxLockMicros / 1000.0));
+	obj.push_back(json_spirit::Pair("instantx", votes));
+
 	return obj;
 }
 
@@ -126,7 +126,7 @@ void TxToJSON(const CTransaction& tx, const uint256 hashBlock, json_spirit::Obje
 	if (hashBlock != 0)
 	{
 		entry.push_back(json_spirit::Pair("blockhash", hashBlock.GetHex()));
-		std::map<uint256, CBlockIndex*>::iterator mi = mapBlockIndex.find(hashBlock);
+		CBlockIndexMap::iterator mi = mapBlockIndex.find(hashBlock);
 		
 		if (mi != mapBlockIndex.end() && (*mi).second)
 		{
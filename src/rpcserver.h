@@ -147,6 +147,7 @@ extern json_spirit::Value getblockcount(const json_spirit::Array& params, bool f
 extern json_spirit::Value getdifficulty(const json_spirit::Array& params, bool fHelp);
 extern json_spirit::Value settxfee(const json_spirit::Array& params, bool fHelp);
 extern json_spirit::Value getrawmempool(const json_spirit::Array& params, bool fHelp);
+extern json_spirit::Value getmempoolinfo(const json_spirit::Array& params, bool fHelp);
 extern json_spirit::Value getblockhash(const json_spirit::Array& params, bool fHelp);
 extern json_spirit::Value getblock(const json_spirit::Array& params, bool fHelp);
 extern json_spirit::Value getblockbynumber(const json_spirit::Array& params, bool fHelp);
@@ -182,5 +183,6 @@ extern json_spirit::Value cclistcoins(const json_spirit::Array& params, bool fHe
 
 extern json_spirit::Value mintblock(const json_spirit::Array& params, bool fHelp);
 extern json_spirit::Value debugrpcallowip(const json_spirit::Array& params, bool fHelp);
+extern json_spirit::Value getlockstats(const json_spirit::Array& params, bool fHelp);
 
 #endif // RPCSERVER_H
@@ -15,6 +15,8 @@
 #include "smsg/db.h"
 #include "smsg/stored.h"
 #include "smsg/messagedata.h"
+#include "smsg/decryptengine.h"
+#include "smsg/bucketstore.h"
 #include "thread.h"
 #include "util.h"
 #include "base58.h"
@@ -292,6 +294,7 @@ json_spirit::Value smsglocalkeys(const json_spirit::Array& params, bool fHelp)
 			return result;
 		}
 		
+		DigitalNote::SMSG::ext_decrypt_engine.Clear();
 		std::string sInfo;
 		
 		sInfo = std::string("Receive ") + (it->fReceiveEnabled ? "on, " : "off,");
@@ -348,6 +351,7 @@ json_spirit::Value smsglocalkeys(const json_spirit::Array& params, bool fHelp)
 			return result;
 		}
 		
+		DigitalNote::SMSG::ext_decrypt_engine.Clear();
 		std::string sInfo;
 		
 		sInfo = std::string("Receive ") + (it->fReceiveEnabled ? "on, " : "off,");
@@ -419,9 +423,13 @@ json_spirit::Value smsglocalkeys(const json_spirit::Array& params, bool fHelp)
 
 json_spirit::Value smsgscanchain(const json_spirit::Array& params, bool fHelp)
 {
-	if (fHelp || params.size() != 0)
+	if (fHelp || params.size() > 1)
 	{
-		throw std::runtime_error("smsgscanchain \nLook for public keys in the block chain.");
+		throw std::runtime_error(
+			"smsgscanchain [rescan=false]\n"
+			"Look for public keys in the block chain.\n"
+			"Continues from the last block scanned unless rescan is true."
+		);
 	}
 
 	if (!DigitalNote::SMSG::ext_enabled)
@@ -429,9 +437,16 @@ json_spirit::Value smsgscanchain(const json_spirit::Array& params, bool fHelp)
 		throw std::runtime_error("Secure messaging is disabled.");
 	}
 
+	bool fRescan = false;
+	
+	if (params.size() > 0)
+	{
+		fRescan = params[0].get_bool();
+	}
+
 	json_spirit::Object result;
 
-	if (!DigitalNote::SMSG::ScanBlockChain())
+	if (!DigitalNote::SMSG::ScanBlockChain(fRescan))
 	{
 		result.push_back(json_spirit::Pair("result", "Scan Chain Failed."));
 	}
@@ -970,7 +985,6 @@ json_spirit::Value smsgbuckets(const json_spirit::Array& params, bool fHelp)
 				std::set<DigitalNote::SMSG::Token>& tokenSet = it->second.setTokens;
 				
 				std::string sBucket = boost::lexical_cast<std::string>(it->first);
-				std::string sFile = sBucket + "_01.dat";
 				
 				snprintf(cbuf, sizeof(cbuf), "%" PRIszu, tokenSet.size());
 				std::string snContents(cbuf);
@@ -988,10 +1002,9 @@ json_spirit::Value smsgbuckets(const json_spirit::Array& params, bool fHelp)
 				objM.push_back(json_spirit::Pair("hash", sHash));
 				objM.push_back(json_spirit::Pair("last changed", getTimeString(it->second.timeChanged, cbuf, sizeof(cbuf))));
 				
-				boost::filesystem::path fullPath = GetDataDir() / "smsgStore" / sFile;
-
-
-				if (!boost::filesystem::exists(fullPath))
+				uint64_t nFBytes = DigitalNote::SMSG::ext_bucket_store.GetSize(it->first);
+				
+				if (nFBytes == 0)
 				{
 					// -- If there is a file for an empty bucket something is wrong.
 					if (tokenSet.size() == 0)
@@ -1005,17 +1018,8 @@ json_spirit::Value smsgbuckets(const json_spirit::Array& params, bool fHelp)
 				}
 				else
 				{
-					try
-					{    
-						uint64_t nFBytes = 0;
-						nFBytes = boost::filesystem::file_size(fullPath);
-						nBytes += nFBytes;
-						objM.push_back(json_spirit::Pair("file size", bytesReadable(nFBytes)));
-					}
-					catch (const boost::filesystem::filesystem_error& ex)
-					{
-						objM.push_back(json_spirit::Pair("file size, error", ex.what()));
-					}
+					nBytes += nFBytes;
+					objM.push_back(json_spirit::Pair("file size", bytesReadable(nFBytes)));
 				}
 				
 				result.push_back(json_spirit::Pair("bucket", objM));
@@ -1042,18 +1046,7 @@ json_spirit::Value smsgbuckets(const json_spirit::Array& params, bool fHelp)
 			
 			for (it = DigitalNote::SMSG::ext_buckets.begin(); it != DigitalNote::SMSG::ext_buckets.end(); ++it)
 			{
-				std::string sFile = boost::lexical_cast<std::string>(it->first) + "_01.dat";
-				
-				try
-				{
-					boost::filesystem::path fullPath = GetDataDir() / "smsgStore" / sFile;
-					boost::filesystem::remove(fullPath);
-				}
-				catch (const boost::filesystem::filesystem_error& ex)
-				{
-					//objM.push_back(json_spirit::Pair("file size, error", ex.what()));
-					printf("Error removing bucket file %s.\n", ex.what());
-				}
+				DigitalNote::SMSG::ext_bucket_store.Drop(it->first);
 			}
 			
 			DigitalNote::SMSG::ext_buckets.clear();
@@ -2294,7 +2294,7 @@ json_spirit::Value gettransaction(const json_spirit::Array& params, bool fHelp)
             else
             {
                 entry.push_back(json_spirit::Pair("blockhash", hashBlock.GetHex()));
-                std::map<uint256, CBlockIndex*>::iterator mi = mapBlockIndex.find(hashBlock);
+                CBlockIndexMap::iterator mi = mapBlockIndex.find(hashBlock);
                 
 				if (mi != mapBlockIndex.end() && (*mi).second)
                 {
@@ -3002,7 +3002,7 @@ bool SignSignature(const CKeyStore &keystore, const CScript& fromPubKey, CTransa
 		bool fSolved = Solver(keystore, subscript, hash2, nHashType, txin.scriptSig, subType) && subType != TX_SCRIPTHASH;
 		
 		// Append serialized subscript whether or not it is completely signed:
-		txin.scriptSig << static_cast<valtype>(subscript);
+		txin.scriptSig << valtype(subscript.begin(), subscript.end());
 		
 		if (!fSolved)
 		{
@@ -18,6 +18,19 @@
 #include "serialize/map.h"
 #include "serialize/set.h"
 
+// The definitions come after every overload above is declared, so that a
+// vector of pairs or a map of vectors finds the right one. They are all in
+// headers so the compiler can inline compact sizes and element loops into
+// the class serializers.
+#include "serialize/read_impl.h"
+#include "serialize/write_impl.h"
+#include "serialize/string_impl.h"
+#include "serialize/vector_impl.h"
+#include "serialize/pair_impl.h"
+#include "serialize/tuple_impl.h"
+#include "serialize/map_impl.h"
+#include "serialize/set_impl.h"
+
 template<typename Stream, typename T>
 inline unsigned int SerReadWrite(Stream& s, const T& obj, int nType, int nVersion, CSerActionGetSerializeSize ser_action)
 {
@@ -2,26 +2,108 @@
 #define SERIALIZE_BASE_H
 
 #include <vector>
+#include <limits>
 #include <cstdint>
+#include <cstddef>
 
+// Used to bypass the rule against non-const reference to temporary
+// where it makes sense with wrappers such as CFlatData or CTxDB
 template<typename T>
-T& REF(const T& val);
+inline T& REF(const T& val)
+{
+    return const_cast<T&>(val);
+}
 
+/**
+ * Used to acquire a non-const pointer "this" to generate bodies
+ * of const serialization operations from a template
+ */
 template<typename T>
-T* NCONST_PTR(const T* val);
+inline T* NCONST_PTR(const T* val)
+{
+    return const_cast<T*>(val);
+}
 
+/**
+ * Get begin pointer of vector (non-const version).
+ * @note These functions avoid the undefined case of indexing into an empty
+ * vector, as well as that of indexing after the end of the vector.
+ */
 template <class T, class TAl>
-T* begin_ptr(std::vector<T, TAl>& v);
+inline T* begin_ptr(std::vector<T, TAl>& v)
+{
+	return v.empty() ? NULL : &v[0];
+}
 
+/** Get begin pointer of vector (const version) */
 template <class T, class TAl>
-const T* begin_ptr(const std::vector<T, TAl>& v);
+inline const T* begin_ptr(const std::vector<T, TAl>& v)
+{
+	return v.empty() ? NULL : &v[0];
+}
 
+/** Get end pointer of vector (non-const version) */
 template <class T, class TAl>
-T* end_ptr(std::vector<T, TAl>& v);
+inline T* end_ptr(std::vector<T, TAl>& v)
+{
+	return v.empty() ? NULL : (&v[0] + v.size());
+}
 
+/** Get end pointer of vector (const version) */
 template <class T, class TAl>
-const T* end_ptr(const std::vector<T, TAl>& v);
+inline const T* end_ptr(const std::vector<T, TAl>& v)
+{
+	return v.empty() ? NULL : (&v[0] + v.size());
+}
 
-unsigned int GetSizeOfCompactSize(uint64_t nSize);
+//
+// Compact size
+//  size <  253        -- 1 byte
+//  size <= USHRT_MAX  -- 3 bytes  (253 + 2 bytes)
+//  size <= UINT_MAX   -- 5 bytes  (254 + 4 bytes)
+//  size >  UINT_MAX   -- 9 bytes  (255 + 8 bytes)
+//
+constexpr unsigned int GetSizeOfCompactSize(uint64_t nSize)
+{
+	if (nSize < 253)
+	{
+		return sizeof(unsigned char);
+	}
+	else if (nSize <= std::numeric_limits<unsigned short>::max())
+	{
+		return sizeof(unsigned char) + sizeof(unsigned short);
+	}
+	else if (nSize <= std::numeric_limits<unsigned int>::max())
+	{
+		return sizeof(unsigned char) + sizeof(unsigned int);
+	}
+	else
+	{
+		return sizeof(unsigned char) + sizeof(uint64_t);
+	}
+}
+
+//
+// Serialized size of a class that is the same for every object, type and
+// version, or 0 if it has to be asked. GetSerializeSize returns it without
+// calling into the class, so a vector of these costs one multiplication.
+//
+template<typename T>
+struct CFixedSerializeSize
+{
+	static const unsigned int value = 0;
+};
+
+class uint160;
+class uint256;
+class COutPoint;
+class CInv;
+class CDiskTxPos;
+
+template<> struct CFixedSerializeSize<uint160>		{ static const unsigned int value = 20; };
+template<> struct CFixedSerializeSize<uint256>		{ static const unsigned int value = 32; };
+template<> struct CFixedSerializeSize<COutPoint>	{ static const unsigned int value = 32 + 4; };
+template<> struct CFixedSerializeSize<CInv>			{ static const unsigned int value = 4 + 32; };
+template<> struct CFixedSerializeSize<CDiskTxPos>	{ static const unsigned int value = 3 * 4; };
 
 #endif // SERIALIZE_BASE_H
@@ -0,0 +1,52 @@
+#ifndef SERIALIZE_MAP_IMPL_H
+#define SERIALIZE_MAP_IMPL_H
+
+#include "serialize/base.h"
+#include "serialize/read.h"
+#include "serialize/write.h"
+#include "serialize/pair.h"
+#include "serialize/map.h"
+
+template<typename K, typename T, typename Pred, typename A>
+unsigned int GetSerializeSize(const std::map<K, T, Pred, A>& m, int nType, int nVersion)
+{
+	unsigned int nSize = GetSizeOfCompactSize(m.size());
+
+	for (typename std::map<K, T, Pred, A>::const_iterator mi = m.begin(); mi != m.end(); ++mi)
+	{
+		nSize += GetSerializeSize((*mi), nType, nVersion);
+	}
+	
+	return nSize;
+}
+
+template<typename Stream, typename K, typename T, typename Pred, typename A>
+void Serialize(Stream& os, const std::map<K, T, Pred, A>& m, int nType, int nVersion)
+{
+	WriteCompactSize(os, m.size());
+
+	for (typename std::map<K, T, Pred, A>::const_iterator mi = m.begin(); mi != m.end(); ++mi)
+	{
+		Serialize(os, (*mi), nType, nVersion);
+	}
+}
+
+template<typename Stream, typename K, typename T, typename Pred, typename A>
+void Unserialize(Stream& is, std::map<K, T, Pred, A>& m, int nType, int nVersion)
+{
+	m.clear();
+
+	unsigned int nSize = ReadCompactSize(is);
+	typename std::map<K, T, Pred, A>::iterator mi = m.begin();
+
+	for (unsigned int i = 0; i < nSize; i++)
+	{
+		std::pair<K, T> item;
+		
+		Unserialize(is, item, nType, nVersion);
+		
+		mi = m.insert(mi, item);
+	}
+}
+
+#endif // SERIALIZE_MAP_IMPL_H
@@ -0,0 +1,28 @@
+#ifndef SERIALIZE_PAIR_IMPL_H
+#define SERIALIZE_PAIR_IMPL_H
+
+#include "serialize/read.h"
+#include "serialize/write.h"
+#include "serialize/pair.h"
+
+template<typename K, typename T>
+unsigned int GetSerializeSize(const std::pair<K, T>& item, int nType, int nVersion)
+{
+	return GetSerializeSize(item.first, nType, nVersion) + GetSerializeSize(item.second, nType, nVersion);
+}
+
+template<typename Stream, typename K, typename T>
+void Serialize(Stream& os, const std::pair<K, T>& item, int nType, int nVersion)
+{
+	Serialize(os, item.first, nType, nVersion);
+	Serialize(os, item.second, nType, nVersion);
+}
+
+template<typename Stream, typename K, typename T>
+void Unserialize(Stream& is, std::pair<K, T>& item, int nType, int nVersion)
+{
+	Unserialize(is, item.first, nType, nVersion);
+	Unserialize(is, item.second, nType, nVersion);
+}
+
+#endif // SERIALIZE_PAIR_IMPL_H
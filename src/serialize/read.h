@@ -4,20 +4,20 @@
 #include <cstdint>
 
 // GetSerializeSize
-unsigned int GetSerializeSize(char a, int, int = 0);
-unsigned int GetSerializeSize(signed char a, int, int = 0);
-unsigned int GetSerializeSize(unsigned char a, int, int = 0);
-unsigned int GetSerializeSize(signed short a, int, int = 0);
-unsigned int GetSerializeSize(unsigned short a, int, int = 0);
-unsigned int GetSerializeSize(signed int a, int, int = 0);
-unsigned int GetSerializeSize(unsigned int a, int, int = 0);
-unsigned int GetSerializeSize(signed long a, int, int = 0);
-unsigned int GetSerializeSize(unsigned long a, int, int = 0);
-unsigned int GetSerializeSize(signed long long a, int, int = 0);
-unsigned int GetSerializeSize(unsigned long long a, int, int = 0);
-unsigned int GetSerializeSize(float a, int, int = 0);
-unsigned int GetSerializeSize(double a, int, int = 0);
-unsigned int GetSerializeSize(bool a, int, int = 0);
+constexpr unsigned int GetSerializeSize(char a, int, int = 0);
+constexpr unsigned int GetSerializeSize(signed char a, int, int = 0);
+constexpr unsigned int GetSerializeSize(unsigned char a, int, int = 0);
+constexpr unsigned int GetSerializeSize(signed short a, int, int = 0);
+constexpr unsigned int GetSerializeSize(unsigned short a, int, int = 0);
+constexpr unsigned int GetSerializeSize(signed int a, int, int = 0);
+constexpr unsigned int GetSerializeSize(unsigned int a, int, int = 0);
+constexpr unsigned int GetSerializeSize(signed long a, int, int = 0);
+constexpr unsigned int GetSerializeSize(unsigned long a, int, int = 0);
+constexpr unsigned int GetSerializeSize(signed long long a, int, int = 0);
+constexpr unsigned int GetSerializeSize(unsigned long long a, int, int = 0);
+constexpr unsigned int GetSerializeSize(float a, int, int = 0);
+constexpr unsigned int GetSerializeSize(double a, int, int = 0);
+constexpr unsigned int GetSerializeSize(bool a, int, int = 0);
 template<typename T>
 unsigned int GetSerializeSize(const T& a, long nType, int nVersion);
 
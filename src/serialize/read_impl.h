@@ -0,0 +1,248 @@
+#ifndef SERIALIZE_READ_IMPL_H
+#define SERIALIZE_READ_IMPL_H
+
+#include <ios>
+
+#include "main_const.h"
+#include "serialize/base.h"
+#include "serialize/read.h"
+
+//
+// GetSerializeSize
+//
+constexpr unsigned int GetSerializeSize(char a, int, int)
+{
+	return sizeof(a);
+}
+
+constexpr unsigned int GetSerializeSize(signed char a, int, int)
+{
+	return sizeof(a);
+}
+
+constexpr unsigned int GetSerializeSize(unsigned char a, int, int)
+{
+	return sizeof(a);
+}
+
+constexpr unsigned int GetSerializeSize(signed short a, int, int)
+{
+	return sizeof(a);
+}
+
+constexpr unsigned int GetSerializeSize(unsigned short a, int, int)
+{
+	return sizeof(a);
+}
+
+constexpr unsigned int GetSerializeSize(signed int a, int, int)
+{
+	return sizeof(a);
+}
+
+constexpr unsigned int GetSerializeSize(unsigned int a, int, int)
+{
+	return sizeof(a);
+}
+
+constexpr unsigned int GetSerializeSize(signed long a, int, int)
+{
+	return sizeof(a);
+}
+
+constexpr unsigned int GetSerializeSize(unsigned long a, int, int)
+{
+	return sizeof(a);
+}
+
+constexpr unsigned int GetSerializeSize(signed long long a, int, int)
+{
+	return sizeof(a);
+}
+
+constexpr unsigned int GetSerializeSize(unsigned long long a, int, int)
+{
+	return sizeof(a);
+}
+
+constexpr unsigned int GetSerializeSize(float a, int, int)
+{
+	return sizeof(a);
+}
+
+constexpr unsigned int GetSerializeSize(double a, int, int)
+{
+	return sizeof(a);
+}
+
+constexpr unsigned int GetSerializeSize(bool a, int, int)
+{
+	return sizeof(char);
+}
+
+template<typename T>
+unsigned int GetSerializeSize(const T& a, long nType, int nVersion)
+{
+	if (CFixedSerializeSize<T>::value != 0)
+	{
+		return CFixedSerializeSize<T>::value;
+	}
+	
+	return a.GetSerializeSize((int)nType, nVersion);
+}
+
+//
+// Unserialize
+//
+template<typename Stream>
+void Unserialize(Stream& s, char& a, int, int)
+{
+	READDATA(s, a);
+}
+
+template<typename Stream>
+void Unserialize(Stream& s, signed char& a, int, int)
+{
+	READDATA(s, a);
+}
+
+template<typename Stream>
+void Unserialize(Stream& s, unsigned char& a, int, int)
+{
+	READDATA(s, a);
+}
+
+template<typename Stream>
+void Unserialize(Stream& s, signed short& a, int, int)
+{
+	READDATA(s, a);
+}
+
+template<typename Stream>
+void Unserialize(Stream& s, unsigned short& a, int, int)
+{
+	READDATA(s, a);
+}
+
+template<typename Stream>
+void Unserialize(Stream& s, signed int& a, int, int)
+{
+	READDATA(s, a);
+}
+
+template<typename Stream>
+void Unserialize(Stream& s, unsigned int& a, int, int)
+{
+	READDATA(s, a);
+}
+
+template<typename Stream>
+void Unserialize(Stream& s, signed long& a, int, int)
+{
+	READDATA(s, a);
+}
+
+template<typename Stream>
+void Unserialize(Stream& s, unsigned long& a, int, int)
+{
+	READDATA(s, a);
+}
+
+template<typename Stream>
+void Unserialize(Stream& s, signed long long& a, int, int)
+{
+	READDATA(s, a);
+}
+
+template<typename Stream>
+void Unserialize(Stream& s, unsigned long long& a, int, int)
+{
+	READDATA(s, a);
+}
+
+template<typename Stream>
+void Unserialize(Stream& s, float& a, int, int)
+{
+	READDATA(s, a);
+}
+
+template<typename Stream>
+void Unserialize(Stream& s, double& a, int, int)
+{
+	READDATA(s, a);
+}
+
+template<typename Stream>
+void Unserialize(Stream& s, bool& a, int, int)
+{
+	char f;
+	
+	READDATA(s, f);
+	
+	a = f;
+}
+
+template<typename Stream, typename T>
+void Unserialize(Stream& is, T& a, long nType, int nVersion)
+{
+	a.Unserialize(is, (int)nType, nVersion);
+}
+
+template<typename Stream>
+uint64_t ReadCompactSize(Stream& is)
+{
+    unsigned char chSize;
+    uint64_t nSizeRet = 0;
+    
+	READDATA(is, chSize);
+    
+	if (chSize < 253)
+    {
+        nSizeRet = chSize;
+    }
+    else if (chSize == 253)
+    {
+        unsigned short xSize;
+        
+		READDATA(is, xSize);
+        nSizeRet = xSize;
+        
+		if (nSizeRet < 253)
+		{
+            throw std::ios_base::failure("non-canonical ReadCompactSize()");
+		}
+    }
+    else if (chSize == 254)
+    {
+        unsigned int xSize;
+        
+		READDATA(is, xSize);
+        nSizeRet = xSize;
+        
+		if (nSizeRet < 0x10000u)
+		{
+            throw std::ios_base::failure("non-canonical ReadCompactSize()");
+		}
+    }
+    else
+    {
+        uint64_t xSize;
+        
+		READDATA(is, xSize);
+        nSizeRet = xSize;
+        
+		if (nSizeRet < 0x100000000ULL)
+		{
+            throw std::ios_base::failure("non-canonical ReadCompactSize()");
+		}
+    }
+	
+    if (nSizeRet > (uint64_t)MAX_MESSAGE_SIZE)
+	{
+        throw std::ios_base::failure("ReadCompactSize() : size too large");
+	}
+	
+    return nSizeRet;
+}
+
+#endif // SERIALIZE_READ_IMPL_H
@@ -1,10 +1,10 @@
-#include "base.h"
-#include "read.h"
-#include "write.h"
-#include "string.h"
-#include "cdatastream.h"
+#ifndef SERIALIZE_SET_IMPL_H
+#define SERIALIZE_SET_IMPL_H
 
-#include "set.h"
+#include "serialize/base.h"
+#include "serialize/read.h"
+#include "serialize/write.h"
+#include "serialize/set.h"
 
 template<typename K, typename Pred, typename A>
 unsigned int GetSerializeSize(const std::set<K, Pred, A>& m, int nType, int nVersion)
@@ -48,24 +48,4 @@ void Unserialize(Stream& is, std::set<K, Pred, A>& m, int nType, int nVersion)
 	}
 }
 
-// GetSerializeSize
-#define TmpGetSerializeSize(A)	template unsigned int GetSerializeSize<A, std::less<A>, std::allocator<A>>( \
-		std::set<A, std::less<A>, std::allocator<A>> const&, int, int);
-
-TmpGetSerializeSize(int);
-TmpGetSerializeSize(std::string);
-
-// Serialize
-#define TmpSerialize(A)		template void Serialize<CDataStream, A, std::less<A>, std::allocator<A>>( \
-		CDataStream&, std::set<A, std::less<A>, std::allocator<A>> const&, int, int);
-
-TmpSerialize(int);
-TmpSerialize(std::string);
-
-// Unserialize
-#define TmpUnserialize(A)		template void Unserialize<CDataStream, A, std::less<A>, std::allocator<A>>( \
-		CDataStream&, std::set<A, std::less<A>, std::allocator<A>>&, int, int);
-
-TmpUnserialize(int);
-TmpUnserialize(std::string);
-
+#endif // SERIALIZE_SET_IMPL_H
@@ -0,0 +1,39 @@
+#ifndef SERIALIZE_STRING_IMPL_H
+#define SERIALIZE_STRING_IMPL_H
+
+#include "serialize/base.h"
+#include "serialize/read.h"
+#include "serialize/write.h"
+#include "serialize/string.h"
+
+template<typename C>
+unsigned int GetSerializeSize(const std::basic_string<C>& str, int, int)
+{
+	return GetSizeOfCompactSize(str.size()) + str.size() * sizeof(str[0]);
+}
+
+template<typename Stream, typename C>
+void Serialize(Stream& os, const std::basic_string<C>& str, int, int)
+{
+	WriteCompactSize(os, str.size());
+
+	if (!str.empty())
+	{
+		os.write((char*)&str[0], str.size() * sizeof(str[0]));
+	}
+}
+
+template<typename Stream, typename C>
+void Unserialize(Stream& is, std::basic_string<C>& str, int, int)
+{
+	unsigned int nSize = ReadCompactSize(is);
+
+	str.resize(nSize);
+
+	if (nSize != 0)
+	{
+		is.read((char*)&str[0], nSize * sizeof(str[0]));
+	}
+}
+
+#endif // SERIALIZE_STRING_IMPL_H
@@ -1,12 +1,7 @@
+#ifndef SERIALIZE_TUPLE_IMPL_H
+#define SERIALIZE_TUPLE_IMPL_H
 
-#include <boost/core/ref.hpp>
-#include <boost/tuple/detail/tuple_basic.hpp>
-
-#include "write.h"
-#include "string.h"
-#include "cdatastream.h"
-
-#include "tuple.h"
+#include "serialize/tuple.h"
 
 //
 // 3 tuple
@@ -73,14 +68,4 @@ void Unserialize(Stream& is, boost::tuple<T0, T1, T2, T3>& item, int nType, int
 	Unserialize(is, boost::get<3>(item), nType, nVersion);
 }
 
-
-
-//
-// Generate Templates
-//
-
-// Serialize
-template void Serialize<CDataStream, std::string, std::string, unsigned long>(CDataStream&,
-	boost::tuples::tuple<std::string, std::string, unsigned long> const&, int, int);
-template void Serialize<CDataStream, std::string, std::string, unsigned long long>(CDataStream&,
-	boost::tuples::tuple<std::string, std::string, unsigned long long> const&, int, int);
\ No newline at end of file
+#endif // SERIALIZE_TUPLE_IMPL_H
@@ -8,6 +8,9 @@
 
 class CScript;
 
+template<unsigned int N, typename T, typename Size, typename Diff>
+class prevector;
+
 template<typename T, typename A>
 unsigned int GetSerializeSize_impl(const std::vector<T, A>& v, int nType, int nVersion, const boost::true_type&);
 template<typename T, typename A>
@@ -27,8 +30,16 @@ void Unserialize_impl(Stream& is, std::vector<T, A>& v, int nType, int nVersion,
 template<typename Stream, typename T, typename A>
 void Unserialize(Stream& is, std::vector<T, A>& v, int nType, int nVersion);
 
+// prevector, only of types that are written as raw bytes
+template<unsigned int N, typename T, typename Size, typename Diff>
+unsigned int GetSerializeSize(const prevector<N, T, Size, Diff>& v, int nType, int nVersion);
+template<typename Stream, unsigned int N, typename T, typename Size, typename Diff>
+void Serialize(Stream& os, const prevector<N, T, Size, Diff>& v, int nType, int nVersion);
+template<typename Stream, unsigned int N, typename T, typename Size, typename Diff>
+void Unserialize(Stream& is, prevector<N, T, Size, Diff>& v, int nType, int nVersion);
+
 // others derived from vector
-extern unsigned int GetSerializeSize(const CScript& v, int nType, int nVersion);
+inline unsigned int GetSerializeSize(const CScript& v, int nType, int nVersion);
 template<typename Stream>
 void Serialize(Stream& os, const CScript& v, int nType, int nVersion);
 template<typename Stream>
@@ -0,0 +1,190 @@
+#ifndef SERIALIZE_VECTOR_IMPL_H
+#define SERIALIZE_VECTOR_IMPL_H
+
+#include <algorithm>
+#include <boost/type_traits/is_fundamental.hpp>
+
+#include "cscript.h"
+#include "serialize/base.h"
+#include "serialize/read.h"
+#include "serialize/write.h"
+#include "serialize/vector.h"
+
+template<typename T, typename A>
+unsigned int GetSerializeSize_impl(const std::vector<T, A>& v, int nType, int nVersion, const boost::true_type&)
+{
+	return (GetSizeOfCompactSize(v.size()) + v.size() * sizeof(T));
+}
+
+template<typename T, typename A>
+unsigned int GetSerializeSize_impl(const std::vector<T, A>& v, int nType, int nVersion, const boost::false_type&)
+{
+	unsigned int nSize = GetSizeOfCompactSize(v.size());
+
+	if (CFixedSerializeSize<T>::value != 0)
+	{
+		return nSize + v.size() * CFixedSerializeSize<T>::value;
+	}
+
+	for (typename std::vector<T, A>::const_iterator vi = v.begin(); vi != v.end(); ++vi)
+	{
+		nSize += GetSerializeSize((*vi), nType, nVersion);
+	}
+
+	return nSize;
+}
+
+template<typename T, typename A>
+unsigned int GetSerializeSize(const std::vector<T, A>& v, int nType, int nVersion)
+{
+	return GetSerializeSize_impl(v, nType, nVersion, boost::is_fundamental<T>());
+}
+
+template<typename Stream, typename T, typename A>
+void Serialize_impl(Stream& os, const std::vector<T, A>& v, int nType, int nVersion, const boost::true_type&)
+{
+	WriteCompactSize(os, v.size());
+	
+	if (!v.empty())
+	{
+		os.write((char*)&v[0], v.size() * sizeof(T));
+	}
+}
+
+template<typename Stream, typename T, typename A>
+void Serialize_impl(Stream& os, const std::vector<T, A>& v, int nType, int nVersion, const boost::false_type&)
+{
+	WriteCompactSize(os, v.size());
+
+	for (typename std::vector<T, A>::const_iterator vi = v.begin(); vi != v.end(); ++vi)
+	{
+		::Serialize(os, (*vi), nType, nVersion);
+	}
+}
+
+template<typename Stream, typename T, typename A>
+void Serialize(Stream& os, const std::vector<T, A>& v, int nType, int nVersion)
+{
+	Serialize_impl(os, v, nType, nVersion, boost::is_fundamental<T>());
+}
+
+template<typename Stream, typename T, typename A>
+void Unserialize_impl(Stream& is, std::vector<T, A>& v, int nType, int nVersion, const boost::true_type&)
+{
+	// Limit size per read so bogus size value won't cause out of memory
+	v.clear();
+
+	unsigned int nSize = ReadCompactSize(is);
+	unsigned int i = 0;
+
+	while (i < nSize)
+	{
+		unsigned int blk = std::min(nSize - i, (unsigned int)(1 + 4999999 / sizeof(T)));
+		
+		v.resize(i + blk);
+		
+		is.read((char*)&v[i], blk * sizeof(T));
+		
+		i += blk;
+	}
+}
+
+template<typename Stream, typename T, typename A>
+void Unserialize_impl(Stream& is, std::vector<T, A>& v, int nType, int nVersion, const boost::false_type&)
+{
+    v.clear();
+	
+    unsigned int nSize = ReadCompactSize(is);
+    unsigned int i = 0;
+    unsigned int nMid = 0;
+	
+    while (nMid < nSize)
+    {
+        nMid += 5000000 / sizeof(T);
+		
+        if (nMid > nSize)
+		{
+            nMid = nSize;
+		}
+		
+        v.resize(nMid);
+        
+		for (; i < nMid; i++)
+		{
+            Unserialize(is, v[i], nType, nVersion);
+		}
+    }
+}
+
+template<typename Stream, typename T, typename A>
+void Unserialize(Stream& is, std::vector<T, A>& v, int nType, int nVersion)
+{
+	Unserialize_impl(is, v, nType, nVersion, boost::is_fundamental<T>());
+}
+
+
+
+//
+// prevector, the same format as a vector of the same elements
+//
+template<unsigned int N, typename T, typename Size, typename Diff>
+unsigned int GetSerializeSize(const prevector<N, T, Size, Diff>& v, int nType, int nVersion)
+{
+	return (GetSizeOfCompactSize(v.size()) + v.size() * sizeof(T));
+}
+
+template<typename Stream, unsigned int N, typename T, typename Size, typename Diff>
+void Serialize(Stream& os, const prevector<N, T, Size, Diff>& v, int nType, int nVersion)
+{
+	WriteCompactSize(os, v.size());
+	
+	if (!v.empty())
+	{
+		os.write((char*)&v[0], v.size() * sizeof(T));
+	}
+}
+
+template<typename Stream, unsigned int N, typename T, typename Size, typename Diff>
+void Unserialize(Stream& is, prevector<N, T, Size, Diff>& v, int nType, int nVersion)
+{
+	// Limit size per read so bogus size value won't cause out of memory
+	v.clear();
+
+	unsigned int nSize = ReadCompactSize(is);
+	unsigned int i = 0;
+
+	while (i < nSize)
+	{
+		unsigned int blk = std::min(nSize - i, (unsigned int)(1 + 4999999 / sizeof(T)));
+		
+		v.resize(i + blk);
+		
+		is.read((char*)&v[i], blk * sizeof(T));
+		
+		i += blk;
+	}
+}
+
+
+
+//
+// others derived from vector
+//
+inline unsigned int GetSerializeSize(const CScript& v, int nType, int nVersion)
+{
+	return GetSerializeSize((const CScriptBase&)v, nType, nVersion);
+}
+
+template<typename Stream>
+void Serialize(Stream& os, const CScript& v, int nType, int nVersion)
+{
+	Serialize(os, (const CScriptBase&)v, nType, nVersion);
+}
+
+template<typename Stream>
+void Unserialize(Stream& is, CScript& v, int nType, int nVersion)
+{
+	Unserialize(is, (CScriptBase&)v, nType, nVersion);
+}
+
+#endif // SERIALIZE_VECTOR_IMPL_H
@@ -0,0 +1,137 @@
+#ifndef SERIALIZE_WRITE_IMPL_H
+#define SERIALIZE_WRITE_IMPL_H
+
+#include <limits>
+
+#include "serialize/write.h"
+
+template<typename Stream>
+void Serialize(Stream& s, char a, int, int)
+{
+	WRITEDATA(s, a);
+}
+
+template<typename Stream>
+void Serialize(Stream& s, signed char a, int, int)
+{
+	WRITEDATA(s, a);
+}
+
+template<typename Stream>
+void Serialize(Stream& s, unsigned char a, int, int)
+{
+	WRITEDATA(s, a);
+}
+
+template<typename Stream>
+void Serialize(Stream& s, signed short a, int, int)
+{
+	WRITEDATA(s, a);
+}
+
+template<typename Stream>
+void Serialize(Stream& s, unsigned short a, int, int)
+{
+	WRITEDATA(s, a);
+}
+
+template<typename Stream>
+void Serialize(Stream& s, signed int a, int, int)
+{
+	WRITEDATA(s, a);
+}
+
+template<typename Stream>
+void Serialize(Stream& s, unsigned int a, int, int)
+{
+	WRITEDATA(s, a);
+}
+
+template<typename Stream>
+void Serialize(Stream& s, signed long a, int, int)
+{
+	WRITEDATA(s, a);
+}
+
+template<typename Stream>
+void Serialize(Stream& s, unsigned long a, int, int)
+{
+	WRITEDATA(s, a);
+}
+
+template<typename Stream>
+void Serialize(Stream& s, signed long long a, int, int)
+{
+	WRITEDATA(s, a);
+}
+
+template<typename Stream>
+void Serialize(Stream& s, unsigned long long a, int, int)
+{
+	WRITEDATA(s, a);
+}
+
+template<typename Stream>
+void Serialize(Stream& s, float a, int, int)
+{
+	WRITEDATA(s, a);
+}
+
+template<typename Stream>
+void Serialize(Stream& s, double a, int, int)
+{
+	WRITEDATA(s, a);
+}
+
+template<typename Stream>
+void Serialize(Stream& s, bool a, int, int)
+{
+	char f = a;
+	
+	WRITEDATA(s, f);
+}
+
+template<typename Stream, typename T>
+void Serialize(Stream& os, const T& a, long nType, int nVersion)
+{
+	a.Serialize(os, (int)nType, nVersion);
+}
+
+template<typename Stream>
+void WriteCompactSize(Stream& os, uint64_t nSize)
+{
+    if (nSize < 253)
+    {
+        unsigned char chSize = nSize;
+		
+        WRITEDATA(os, chSize);
+    }
+    else if (nSize <= std::numeric_limits<unsigned short>::max())
+    {
+        unsigned char chSize = 253;
+        unsigned short xSize = nSize;
+        
+		WRITEDATA(os, chSize);
+        WRITEDATA(os, xSize);
+    }
+    else if (nSize <= std::numeric_limits<unsigned int>::max())
+    {
+        unsigned char chSize = 254;
+        unsigned int xSize = nSize;
+		
+        WRITEDATA(os, chSize);
+        WRITEDATA(os, xSize);
+    }
+    else
+    {
+        unsigned char chSize = 255;
+        uint64_t xSize = nSize;
+		
+        WRITEDATA(os, chSize);
+        WRITEDATA(os, xSize);
+    }
+	
+    return;
+}
+
+#endif // SERIALIZE_WRITE_IMPL_H
@@ -63,6 +63,9 @@ Notes:
 #include "smsg/cdigitalnoteaddress_b.h"
 #include "smsg/ckeyid_b.h"
 #include "smsg/crypter.h"
+#include "smsg/decryptengine.h"
+#include "smsg/bucketstore.h"
+#include "thread/cthreadpool.h"
 #include "ckey.h"
 #include "hash.h"
 #include "ctxout.h"
@@ -90,6 +93,8 @@ DigitalNote::SMSG::Options						ext_options;
 CCriticalSection								ext_cs;
 CCriticalSection								ext_cs_db;
 leveldb::DB*									ext_db = NULL;
+DigitalNote::SMSG::DecryptEngine				ext_decrypt_engine;
+DigitalNote::SMSG::BucketStore					ext_bucket_store;
 boost::signals2::signal<void (DigitalNote::SMSG::Stored& inboxHdr)>		ext_signal_NotifyInboxChanged;
 boost::signals2::signal<void (json_spirit::Object& inboxHdr)>			ext_signal_NotifyInboxChangedJson;
 boost::signals2::signal<void (DigitalNote::SMSG::Stored& outboxHdr)>	ext_signal_NotifyOutboxChanged;
@@ -133,39 +138,9 @@ void Thread()
 						LogPrint("smsg", "Removing bucket %d \n", it->first);
 					}
 					
-					std::string fileName = boost::lexical_cast<std::string>(it->first);
-
-					boost::filesystem::path fullPath = GetDataDir() / "smsgStore" / (fileName + "_01.dat");
-					
-					if (boost::filesystem::exists(fullPath))
-					{
-						try
-						{
-							boost::filesystem::remove(fullPath);
-						}
-						catch (const boost::filesystem::filesystem_error& ex)
-						{
-							LogPrint("smsg", "Error removing bucket file %s.\n", ex.what());
-						}
-					}
-					else
-					{
-						LogPrint("smsg", "Path %s does not exist \n", fullPath.string().c_str());
-					}
-					
-					// -- look for a wl file, it stores incoming messages when wallet is locked
-					fullPath = GetDataDir() / "smsgStore" / (fileName + "_01_wl.dat");
-					if (boost::filesystem::exists(fullPath))
-					{
-						try
-						{
-							boost::filesystem::remove(fullPath);
-						}
-						catch (const boost::filesystem::filesystem_error& ex)
-						{
-							LogPrint("smsg", "Error removing wallet locked file %s.\n", ex.what());
-						}
-					}
+					// -- drops every data and index file of the bucket, and the wl files
+					//    which store incoming messages when wallet is locked
+					DigitalNote::SMSG::ext_bucket_store.Drop(it->first);
 
 					DigitalNote::SMSG::ext_buckets.erase(it++);
 				}
@@ -378,16 +353,14 @@ static int _InsertAddress(CKeyID& hashKey, CPubKey& pubKey, DigitalNote::SMSG::D
 	return 0;
 }
 
-static bool _ScanBlock(CBlock& block, CTxDB& txdb, DigitalNote::SMSG::DB& addrpkdb,
-		uint32_t& nTransactions, uint32_t& nElements, uint32_t& nPubkeys, uint32_t& nDuplicates)
+static void _ExtractPublicKeys(const CBlock& block, std::map<CKeyID, CPubKey>& mapKeys,
+		uint32_t& nTransactions, uint32_t& nElements)
 {
-	AssertLockHeld(DigitalNote::SMSG::ext_cs_db);
-
 	valtype vch;
 	opcodetype opcode;
 
 	// -- only scan inputs of standard txns and coinstakes
-	for(CTransaction& tx : block.vtx)
+	for (const CTransaction& tx : block.vtx)
 	{
 		std::string sReason;
 		
@@ -415,18 +388,7 @@ static bool _ScanBlock(CBlock& block, CTxDB& txdb, DigitalNote::SMSG::DB& addrpk
 						continue;
 					}
 					
-					CKeyID addrKey = pubKey.GetID();
-					
-					switch (DigitalNote::SMSG::_InsertAddress(addrKey, pubKey, addrpkdb))
-					{
-						case 0:
-							nPubkeys++;
-						break;      // added key
-						
-						case 4:
-							nDuplicates++;
-						break;   // duplicate key
-					}
+					mapKeys.insert(std::make_pair(pubKey.GetID(), pubKey));
 					
 					break;
 				}
@@ -438,13 +400,10 @@ static bool _ScanBlock(CBlock& block, CTxDB& txdb, DigitalNote::SMSG::DB& addrpk
 		{
 			for (uint32_t i = 0; i < tx.vin.size(); i++)
 			{
-				CScript *script = &tx.vin[i].scriptSig;
+				const CScript *script = &tx.vin[i].scriptSig;
 				CScript::const_iterator pc = script->begin();
 				CScript::const_iterator pend = script->end();
 
-				uint256 prevoutHash;
-				CKey key;
-
 				while (pc < pend)
 				{
 					if (!script->GetOp(pc, opcode, vch))
@@ -464,17 +423,7 @@ static bool _ScanBlock(CBlock& block, CTxDB& txdb, DigitalNote::SMSG::DB& addrpk
 							continue;
 						}
 						
-						CKeyID addrKey = pubKey.GetID();
-						switch (DigitalNote::SMSG::_InsertAddress(addrKey, pubKey, addrpkdb))
-						{
-							case 0:
-								nPubkeys++;
-							break;      // added key
-							
-							case 4:
-								nDuplicates++;
-							break;   // duplicate key
-						}
+						mapKeys.insert(std::make_pair(pubKey.GetID(), pubKey));
 						
 						break;
 					}
@@ -487,10 +436,31 @@ static bool _ScanBlock(CBlock& block, CTxDB& txdb, DigitalNote::SMSG::DB& addrpk
 		}
 		
 		nTransactions++;
+	}
+}
+
+static bool _ScanBlock(CBlock& block, DigitalNote::SMSG::DB& addrpkdb,
+		uint32_t& nTransactions, uint32_t& nElements, uint32_t& nPubkeys, uint32_t& nDuplicates)
+{
+	AssertLockHeld(DigitalNote::SMSG::ext_cs_db);
+
+	std::map<CKeyID, CPubKey> mapKeys;
+	
+	_ExtractPublicKeys(block, mapKeys, nTransactions, nElements);
 
-		if (nTransactions % 10000 == 0) // for ScanChainForPublicKeys
+	for (std::map<CKeyID, CPubKey>::iterator it = mapKeys.begin(); it != mapKeys.end(); ++it)
+	{
+		CKeyID addrKey = it->first;
+		
+		switch (DigitalNote::SMSG::_InsertAddress(addrKey, it->second, addrpkdb))
 		{
-			LogPrint("smsg", "Scanning transaction no. %u.\n", nTransactions);
+			case 0:
+				nPubkeys++;
+			break;      // added key
+			
+			case 4:
+				nDuplicates++;
+			break;   // duplicate key
 		}
 	}
 
@@ -500,7 +470,7 @@ static bool _ScanBlock(CBlock& block, CTxDB& txdb, DigitalNote::SMSG::DB& addrpk
 int BuildBucketSet()
 {
 	/*
-		Build the bucket set by scanning the files in the smsgStore dir.
+		Build the bucket set from the index of each data file in the smsgStore dir.
 
 		DigitalNote::SMSG::ext_buckets should be empty
 	*/
@@ -533,7 +503,8 @@ int BuildBucketSet()
 		
 		std::string fileType = (*itd).path().extension().string();
 
-		if (fileType.compare(".dat") != 0)
+		if (fileType.compare(".dat") != 0
+			&& fileType.compare(".idx") != 0)
 		{
 			continue;
 		}
@@ -545,19 +516,15 @@ int BuildBucketSet()
 			LogPrint("smsg", "Processing file: %s.\n", fileName.c_str());
 		}
 		
-		nFiles++;
-
-		// TODO files must be split if > 2GB
-		// time_noFile.dat
-		size_t sep = fileName.find_first_of("_");
-		if (sep == std::string::npos)
+		// time_noFile.dat, time_noFile.idx
+		int64_t fileTime;
+		uint32_t nFile;
+		
+		if (!DigitalNote::SMSG::BucketStore::ParseFileName(fileName, fileTime, nFile))
 		{
 			continue;
 		}
 		
-		std::string stime = fileName.substr(0, sep);
-		int64_t fileTime = boost::lexical_cast<int64_t>(stime);
-
 		if (fileTime < now - SMSG_RETENTION)
 		{
 			LogPrint("smsg", "Dropping file %s, expired.\n", fileName.c_str());
@@ -574,6 +541,12 @@ int BuildBucketSet()
 			continue;
 		}
 
+		if (fileType.compare(".idx") == 0)
+		{
+			// -- read with its data file
+			continue;
+		}
+		
 		if (boost::algorithm::ends_with(fileName, "_wl.dat"))
 		{
 			if (fDebugSmsg)
@@ -584,72 +557,24 @@ int BuildBucketSet()
 			continue;
 		}
 
+		nFiles++;
+
 		size_t nTokenSetSize = 0;
-		SecureMessage smsg;
 		
 		{
 			LOCK(DigitalNote::SMSG::ext_cs);
 			
-			std::set<DigitalNote::SMSG::Token>& tokenSet = DigitalNote::SMSG::ext_buckets[fileTime].setTokens;	
-			FILE *fp;
-
-			if (!(fp = fopen((*itd).path().string().c_str(), "rb")))
-			{
-				LogPrint("smsg", "Error opening file: %s\n", strerror(errno));
-				
-				continue;
-			}
-
-			for (;;)
+			std::set<DigitalNote::SMSG::Token>& tokenSet = DigitalNote::SMSG::ext_buckets[fileTime].setTokens;
+			size_t nBefore = tokenSet.size();
+			
+			if (DigitalNote::SMSG::ext_bucket_store.Load(fileTime, nFile, tokenSet) != 0)
 			{
-				long int ofs = ftell(fp);
-				DigitalNote::SMSG::Token token;
-				token.offset = ofs;
-				errno = 0;
-				
-				if (fread(&smsg.hash[0], sizeof(uint8_t), SMSG_HDR_LEN, fp) != (size_t)SMSG_HDR_LEN)
-				{
-					if (errno != 0)
-					{
-						LogPrint("smsg", "fread header failed: %s\n", strerror(errno));
-					}
-					else
-					{
-						//LogPrint("smsg", "End of file.\n");
-					}
-					
-					break;
-				}
-				
-				token.timestamp = smsg.timestamp;
-
-				if (smsg.nPayload < 8)
-				{
-					continue;
-				}
-				
-				if (fread(token.sample, sizeof(uint8_t), 8, fp) != 8)
-				{
-					LogPrint("smsg", "fread data failed: %s\n", strerror(errno));
-					
-					break;
-				}
-
-				if (fseek(fp, smsg.nPayload-8, SEEK_CUR) != 0)
-				{
-					LogPrint("smsg", "fseek, strerror: %s.\n", strerror(errno));
-					
-					break;
-				}
-
-				tokenSet.insert(token);
+				LogPrint("smsg", "Error loading bucket file %s.\n", fileName.c_str());
 			}
-
-			fclose(fp);
 			
 			DigitalNote::SMSG::ext_buckets[fileTime].hashBucket();
 			
-			nTokenSetSize = tokenSet.size();
+			nTokenSetSize = tokenSet.size() - nBefore;
 		} // LOCK(DigitalNote::SMSG::ext_cs);
 		
 		nMessages += nTokenSetSize;
@@ -898,6 +823,36 @@ int WriteIni()
 	return 0;
 }
 
+static boost::signals2::connection connWalletStatus;
+
+static void WalletStatusChanged(CCryptoKeyStore* wallet)
+{
+	// -- drop cached private keys as soon as the wallet locks
+	if (wallet->IsLocked())
+	{
+		DigitalNote::SMSG::ext_decrypt_engine.Clear();
+	}
+}
+
+static void StartDecryptEngine()
+{
+	DigitalNote::SMSG::ext_decrypt_engine.Clear();
+	DigitalNote::SMSG::ext_decrypt_engine.StartThreads(GetArg("-smsgscanthreads", CThreadPool::DefaultThreads()));
+	
+	if (pwalletMain)
+	{
+		connWalletStatus = pwalletMain->NotifyStatusChanged.connect(&WalletStatusChanged);
+	}
+}
+
+static void StopDecryptEngine()
+{
+	connWalletStatus.disconnect();
+	
+	DigitalNote::SMSG::ext_decrypt_engine.StopThreads();
+	DigitalNote::SMSG::ext_decrypt_engine.Clear();
+}
+
 /** called from AppInit2() in init.cpp */
 bool Start(bool fDontStart, bool fScanChain)
 {
@@ -924,7 +879,7 @@ bool Start(bool fDontStart, bool fScanChain)
 
 	if (fScanChain)
 	{
-		DigitalNote::SMSG::ScanBlockChain();
+		DigitalNote::SMSG::ScanBlockChain(false);
 	}
 
 	if (DigitalNote::SMSG::BuildBucketSet() != 0)
@@ -936,6 +891,8 @@ bool Start(bool fDontStart, bool fScanChain)
 		return false;
 	}
 
+	StartDecryptEngine();
+
 	DigitalNote::SMSG::ext_thread_group.create_thread(
 		boost::bind(
 			&TraceThread<void (*)()>,
@@ -974,6 +931,14 @@ bool Shutdown()
 	DigitalNote::SMSG::ext_thread_group.interrupt_all();
 	DigitalNote::SMSG::ext_thread_group.join_all();
 
+	StopDecryptEngine();
+
+	{
+		LOCK(DigitalNote::SMSG::ext_cs);
+		
+		DigitalNote::SMSG::ext_bucket_store.Close();
+	}
+
 	if (DigitalNote::SMSG::ext_db)
 	{
 		LOCK(DigitalNote::SMSG::ext_cs_db);
@@ -1024,6 +989,8 @@ bool Enable()
 		}
 	}
 
+	StartDecryptEngine();
+
 	// -- start threads
 	DigitalNote::SMSG::ext_thread_group.create_thread(
 		boost::bind(
@@ -1095,8 +1062,11 @@ bool Disable()
 		
 		DigitalNote::SMSG::ext_buckets.clear();
 		DigitalNote::SMSG::ext_addresses.clear();
+		DigitalNote::SMSG::ext_bucket_store.Close();
 	}
 
+	StopDecryptEngine();
+
 	// -- tell each smsg enabled peer that this node is disabling
 	{
 		LOCK(cs_vNodes);
@@ -1591,6 +1561,7 @@ bool ReceiveData(CNode* pfrom, const std::string &strCommand, CDataStream& vRecv
 				{
 					//LogPrint("smsg", "Have message at %d.\n", it->offset); // DEBUG
 					token.offset = it->offset;
+					token.nFile = it->nFile;
 					//LogPrint("smsg", "winb before DigitalNote::SMSG::Retrieve %d.\n", token.timestamp);
 
 					// -- place in vchOne so if DigitalNote::SMSG::Retrieve fails it won't corrupt vchBunch
@@ -1919,7 +1890,6 @@ bool ScanBlock(CBlock& block)
 	{
 		LOCK(DigitalNote::SMSG::ext_cs_db);
 		
-		CTxDB txdb("r");
 		DigitalNote::SMSG::DB addrpkdb;
 		
 		if (!addrpkdb.Open("cw") || !addrpkdb.TxnBegin())
@@ -1927,7 +1897,7 @@ bool ScanBlock(CBlock& block)
 			return false;
 		}
 		
-		_ScanBlock(block, txdb, addrpkdb, nTransactions, nElements, nPubkeys, nDuplicates);
+		_ScanBlock(block, addrpkdb, nTransactions, nElements, nPubkeys, nDuplicates);
 
 		addrpkdb.TxnCommit();
 	}
@@ -1954,48 +1924,158 @@ bool ScanChainForPublicKeys(CBlockIndex* pindexStart)
 	// -- public keys are in txin.scriptSig
 	//    matching addresses are in scriptPubKey of txin's referenced output
 
-	uint32_t nBlocks        = 0;
+	// -- the chain is split into ranges of SMSG_SCAN_CHAIN_RANGE blocks, a window of ranges
+	//    is read and scanned in parallel, then the new keys are written in one batch along
+	//    with the height reached, an interrupted scan resumes from there.
+	class ScanRange
+	{
+	public:
+		std::map<CKeyID, CPubKey>	mapKeys;
+		uint32_t					nTransactions;
+		uint32_t					nInputs;
+		uint32_t					nDuplicates;
+		bool						fError;
+		
+		ScanRange() : nTransactions(0), nInputs(0), nDuplicates(0), fError(false) {}
+	};
+
+	std::vector<CBlockIndex*> vBlocks;
+	
+	for (CBlockIndex* pindex = pindexStart; pindex; pindex = pindex->pnext)
+	{
+		vBlocks.push_back(pindex);
+	}
+
 	uint32_t nTransactions  = 0;
 	uint32_t nInputs        = 0;
 	uint32_t nPubkeys       = 0;
 	uint32_t nDuplicates    = 0;
+	size_t   nScanned       = 0;
 
 	{
 		LOCK(DigitalNote::SMSG::ext_cs_db);
 
-		CTxDB txdb("r");
 		DigitalNote::SMSG::DB addrpkdb;
 		
-		if (!addrpkdb.Open("cw") || !addrpkdb.TxnBegin())
+		if (!addrpkdb.Open("cw"))
 		{
 			return false;
 		}
 		
-		CBlockIndex* pindex = pindexStart;
+		CThreadPool pool("smsg-scan", GetArg("-smsgscanthreads", CThreadPool::DefaultThreads()));
 		
-		while (pindex)
+		size_t nRanges = (vBlocks.size() + SMSG_SCAN_CHAIN_RANGE - 1) / SMSG_SCAN_CHAIN_RANGE;
+		size_t nWindow = 2 * (pool.Size() + 1);
+		
+		for (size_t nFirst = 0; nFirst < nRanges; nFirst += nWindow)
 		{
-			nBlocks++;
+			if (ShutdownRequested())
+			{
+				LogPrint("smsg", "Scan interrupted at height %d.\n", pindexStart->nHeight + (int)nScanned);
+				
+				return false;
+			}
 			
-			CBlock block;
-			block.ReadFromDisk(pindex, true);
-
-			_ScanBlock(block, txdb, addrpkdb, nTransactions, nInputs, nPubkeys, nDuplicates);
-
-			pindex = pindex->pnext;
+			size_t nCount = std::min(nWindow, nRanges - nFirst);
+			std::vector<ScanRange> vRanges(nCount);
+			
+			pool.ParallelFor(nCount, [&](size_t i)
+			{
+				ScanRange& range = vRanges[i];
+				size_t nBegin = (nFirst + i) * SMSG_SCAN_CHAIN_RANGE;
+				size_t nEnd = std::min(nBegin + SMSG_SCAN_CHAIN_RANGE, vBlocks.size());
+				
+				for (size_t n = nBegin; n < nEnd; ++n)
+				{
+					CBlock block;
+					
+					if (!block.ReadFromDisk(vBlocks[n], true))
+					{
+						range.fError = true;
+						
+						return;
+					}
+					
+					_ExtractPublicKeys(block, range.mapKeys, range.nTransactions, range.nInputs);
+				}
+				
+				// -- no batch is active here, ExistsPK is a plain leveldb read and safe on any thread
+				for (std::map<CKeyID, CPubKey>::iterator it = range.mapKeys.begin(); it != range.mapKeys.end(); )
+				{
+					CKeyID addrKey = it->first;
+					
+					if (addrpkdb.ExistsPK(addrKey))
+					{
+						range.nDuplicates++;
+						range.mapKeys.erase(it++);
+					}
+					else
+					{
+						++it;
+					}
+				}
+			});
+			
+			std::map<CKeyID, CPubKey> mapNew;
+			
+			for (ScanRange& range : vRanges)
+			{
+				if (range.fError)
+				{
+					LogPrint("smsg", "Error reading block after height %d.\n", pindexStart->nHeight + (int)nScanned);
+					
+					return false;
+				}
+				
+				nTransactions += range.nTransactions;
+				nInputs += range.nInputs;
+				nDuplicates += range.nDuplicates;
+				
+				for (std::map<CKeyID, CPubKey>::iterator it = range.mapKeys.begin(); it != range.mapKeys.end(); ++it)
+				{
+					if (!mapNew.insert(*it).second)
+					{
+						nDuplicates++;
+					}
+				}
+			}
+			
+			nScanned = std::min((nFirst + nCount) * SMSG_SCAN_CHAIN_RANGE, vBlocks.size());
+			CBlockIndex* pindexLast = vBlocks[nScanned - 1];
+			
+			if (!addrpkdb.TxnBegin())
+			{
+				return false;
+			}
+			
+			for (std::map<CKeyID, CPubKey>::iterator it = mapNew.begin(); it != mapNew.end(); ++it)
+			{
+				CKeyID addrKey = it->first;
+				
+				addrpkdb.WritePK(addrKey, it->second);
+			}
+			
+			addrpkdb.WriteScanHeight(pindexLast->nHeight, pindexLast->GetBlockHash());
+			
+			if (!addrpkdb.TxnCommit())
+			{
+				return false;
+			}
+			
+			nPubkeys += mapNew.size();
+			
+			LogPrint("smsg", "Scanned to height %d, %u public keys found.\n", pindexLast->nHeight, nPubkeys);
 		}
-
-		addrpkdb.TxnCommit();
 	}
 
-	LogPrint("smsg", "Scanned %u blocks, %u transactions, %u inputs\n", nBlocks, nTransactions, nInputs);
+	LogPrint("smsg", "Scanned %u blocks, %u transactions, %u inputs\n", nScanned, nTransactions, nInputs);
 	LogPrint("smsg", "Found %u public keys, %u duplicates.\n", nPubkeys, nDuplicates);
 	LogPrint("smsg", "Took %d ms\n", GetTimeMillis() - nStart);
 
 	return true;
 }
 
-bool ScanBlockChain()
+bool ScanBlockChain(bool fRescan)
 {
 	TRY_LOCK(cs_main, lockMain);
 
@@ -2012,6 +2092,47 @@ bool ScanBlockChain()
 		
 		try
 		{ // -- in try to catch errors opening db,
+			int nHeight;
+			uint256 hashBlock;
+			bool fResume = false;
+			
+			if (!fRescan)
+			{
+				LOCK(DigitalNote::SMSG::ext_cs_db);
+				
+				DigitalNote::SMSG::DB addrpkdb;
+				
+				fResume = addrpkdb.Open("cw") && addrpkdb.ReadScanHeight(nHeight, hashBlock);
+			}
+			
+			if (fResume)
+			{
+				CBlockIndexMap::iterator mi = mapBlockIndex.find(hashBlock);
+				
+				if (mi != mapBlockIndex.end())
+				{
+					// -- step back to the fork if the last scanned block was reorganised away
+					CBlockIndex *pindex = mi->second;
+					
+					while (pindex && !pindex->IsInMainChain())
+					{
+						pindex = pindex->pprev;
+					}
+					
+					if (pindex)
+					{
+						if (!pindex->pnext)
+						{
+							LogPrint("smsg", "Block chain already scanned to height %d.\n", pindex->nHeight);
+							
+							return true;
+						}
+						
+						pindexScan = pindex->pnext;
+					}
+				}
+			}
+			
 			if (!DigitalNote::SMSG::ScanChainForPublicKeys(pindexScan))
 			{
 				return false;
@@ -2034,40 +2155,300 @@ bool ScanBlockChain()
 	return true;
 }
 
-bool ScanBuckets()
+static int _ReceiveMatched(uint8_t *pHeader, uint8_t *pPayload, uint32_t nPayload, bool reportToGui,
+		const DigitalNote::SMSG::DecryptEngine::Result& match)
 {
-	if (fDebugSmsg)
+	/*
+	Decrypt a message the DecryptEngine matched to an owned address and add it to the inbox db.
+	
+	returns
+		0 success,
+		1 error
+		2 no match
+	*/
+	
+	if (!match.fMatch)
 	{
-		LogPrint("smsg", "DigitalNote::SMSG::ScanBuckets()\n");
+		return 2;
 	}
+	
+	std::string addressTo = match.sAddress;
+	DigitalNote::SMSG::Message msg;
+	bool fOwnMessage = false;
 
-	if (!DigitalNote::SMSG::ext_enabled || pwalletMain->IsLocked())
+	// -- have to do full decrypt to see address from
+	if (DigitalNote::SMSG::Decrypt(false, addressTo, pHeader, pPayload, nPayload, msg) == 0)
 	{
-		return false;
+		if (fDebugSmsg)
+		{
+			LogPrint("smsg", "Decrypted message with %s.\n", addressTo.c_str());
+		}
+		
+		if (match.fReceiveAnon || msg.sFromAddress.compare("anon") != 0)
+		{
+			fOwnMessage = true;
+		}
 	}
 
-	int64_t  mStart         = GetTimeMillis();
-	int64_t  now            = GetTime();
-	uint32_t nFiles         = 0;
-	uint32_t nMessages      = 0;
-	uint32_t nFoundMessages = 0;
+	if (!fOwnMessage)
+	{
+		return 2;
+	}
+	
+	// -- save to inbox
+	DigitalNote::SMSG::SecureMessage* psmsg = (DigitalNote::SMSG::SecureMessage*) pHeader;
+	std::string sPrefix("im");
+	
+	uint8_t chKey[18];
+	memcpy(&chKey[0],  sPrefix.data(),    2);
+	memcpy(&chKey[2],  &psmsg->timestamp, 8);
+	memcpy(&chKey[10], pPayload,          8);
 
-	boost::filesystem::path pathSmsgDir = GetDataDir() / "smsgStore";
-	boost::filesystem::directory_iterator itend;
+	DigitalNote::SMSG::Stored smsgInbox;
+	
+	smsgInbox.timeReceived  = GetTime();
+	smsgInbox.status        = (SMSG_MASK_UNREAD) & 0xFF;
+	smsgInbox.sAddrTo       = addressTo;
 
-	if (!boost::filesystem::exists(pathSmsgDir) || !boost::filesystem::is_directory(pathSmsgDir))
+	// -- data may not be contiguous
+	try
 	{
-		LogPrint("smsg", "Message store directory does not exist.\n");
+		smsgInbox.vchMessage.resize(SMSG_HDR_LEN + nPayload);
+	}
+	catch (std::exception& e)
+	{
+		LogPrint("smsg", "DigitalNote::SMSG::ScanMessage(): Could not resize vchData, %u, %s\n", SMSG_HDR_LEN + nPayload, e.what());
 		
-		return 0; // not an error
+		return 1;
 	}
+	
+	memcpy(&smsgInbox.vchMessage[0], pHeader, SMSG_HDR_LEN);
+	memcpy(&smsgInbox.vchMessage[SMSG_HDR_LEN], pPayload, nPayload);
 
-	DigitalNote::SMSG::SecureMessage smsg;
-	std::vector<uint8_t> vchData;
-
-	for (boost::filesystem::directory_iterator itd(pathSmsgDir) ; itd != itend ; ++itd)
 	{
-		if (!boost::filesystem::is_regular_file(itd->status()))
+		LOCK(DigitalNote::SMSG::ext_cs_db);
+		
+		DigitalNote::SMSG::DB dbInbox;
+
+		if (dbInbox.Open("cw"))
+		{
+			if (dbInbox.ExistsSmesg(chKey))
+			{
+				if (fDebugSmsg)
+				{
+					LogPrint("smsg", "Message already exists in inbox db.\n");
+				}
+			}
+			else
+			{
+				dbInbox.WriteSmesg(chKey, smsgInbox);
+
+				if (reportToGui)
+				{
+					DigitalNote::SMSG::ext_signal_NotifyInboxChanged(smsgInbox);
+
+					LogPrint("webwallet", "webwallet: Sending update message in update to webwallet \n");
+					
+					char cbuf[256];
+					json_spirit::Object messageObject;
+					
+					messageObject.push_back(json_spirit::Pair("received", getTimeString(smsgInbox.timeReceived, cbuf, sizeof(cbuf))));
+					messageObject.push_back(json_spirit::Pair("sent", getTimeString(msg.timestamp, cbuf, sizeof(cbuf))));
+					messageObject.push_back(json_spirit::Pair("from", msg.sFromAddress));
+					messageObject.push_back(json_spirit::Pair("to", smsgInbox.sAddrTo));
+					messageObject.push_back(json_spirit::Pair("text", (char*)&msg.vchMessage[0]));
+
+					json_spirit::Object payload;
+					
+					payload.push_back(json_spirit::Pair("type", "messagesIn"));
+					payload.push_back(json_spirit::Pair("data", messageObject));
+					
+					DigitalNote::SMSG::ext_signal_NotifyInboxChangedJson(payload);
+					
+					LogPrint("webwallet", "webwallet: Finished sending update message in update to webwallet \n");
+				}
+				
+				LogPrint("smsg", "SecureMsg saved to inbox, received with %s.\n", addressTo.c_str());
+			}
+		}
+	}
+
+	return 0;
+}
+
+static int _ScanMessageBatch(std::vector<DigitalNote::SMSG::DecryptEngine::Input>& vBatch, bool reportToGui, uint32_t& nFoundMessages)
+{
+	/*
+	Match a batch of messages against all receiving keys in one pass, then
+	decrypt and store the ones that belong to this node.
+	Requires ext_cs and an unlocked wallet.
+	*/
+	
+	if (vBatch.empty())
+	{
+		return 0;
+	}
+	
+	if (!DigitalNote::SMSG::ext_decrypt_engine.IsLoaded()
+		&& !DigitalNote::SMSG::ext_decrypt_engine.Load())
+	{
+		return 1;
+	}
+	
+	std::vector<DigitalNote::SMSG::DecryptEngine::Result> vResults;
+	
+	DigitalNote::SMSG::ext_decrypt_engine.MatchBatch(vBatch, vResults);
+	
+	for (size_t i = 0; i < vBatch.size(); ++i)
+	{
+		if (_ReceiveMatched(vBatch[i].pHeader, vBatch[i].pPayload, vBatch[i].nPayload, reportToGui, vResults[i]) == 0)
+		{
+			nFoundMessages++;
+		}
+	}
+	
+	vBatch.clear();
+	
+	return 0;
+}
+
+static int _ScanFile(const boost::filesystem::path& path, uint32_t& nMessages, uint32_t& nFoundMessages)
+{
+	/*
+	Scan every message in a bucket file, SMSG_SCAN_BATCH messages at a time.
+	Requires ext_cs.
+	
+	returns
+		0 success,
+		1 error
+	*/
+	
+	FILE *fp;
+	errno = 0;
+	
+	if (!(fp = fopen(path.string().c_str(), "rb")))
+	{
+		LogPrint("smsg", "Error opening file: %s\n", strerror(errno));
+		
+		return 1;
+	}
+	
+	std::vector<uint8_t> vchBuffer;
+	std::vector<size_t> vOffsets;
+	std::vector<DigitalNote::SMSG::DecryptEngine::Input> vBatch;
+	
+	for (bool fEOF = false; !fEOF; )
+	{
+		vchBuffer.clear();
+		vOffsets.clear();
+		
+		while (vOffsets.size() < SMSG_SCAN_BATCH)
+		{
+			size_t nOffset = vchBuffer.size();
+			uint32_t nPayload;
+			
+			vchBuffer.resize(nOffset + SMSG_HDR_LEN);
+			errno = 0;
+			
+			if (fread(&vchBuffer[nOffset], sizeof(uint8_t), SMSG_HDR_LEN, fp) != (size_t)SMSG_HDR_LEN)
+			{
+				if (errno != 0)
+				{
+					LogPrint("smsg", "fread header failed: %s\n", strerror(errno));
+				}
+				
+				vchBuffer.resize(nOffset);
+				fEOF = true;
+				
+				break;
+			}
+			
+			nPayload = ((DigitalNote::SMSG::SecureMessage*) &vchBuffer[nOffset])->nPayload;
+			
+			try
+			{
+				vchBuffer.resize(nOffset + SMSG_HDR_LEN + nPayload);
+			}
+			catch (std::exception& e)
+			{
+				LogPrint("smsg", "DigitalNote::SMSG::ScanFile(): Could not resize vchBuffer, %u, %s\n", nPayload, e.what());
+				
+				fclose(fp);
+				
+				return 1;
+			}
+			
+			if (nPayload > 0
+				&& fread(&vchBuffer[nOffset + SMSG_HDR_LEN], sizeof(uint8_t), nPayload, fp) != nPayload)
+			{
+				LogPrint("smsg", "fread data failed: %s\n", strerror(errno));
+				
+				vchBuffer.resize(nOffset);
+				fEOF = true;
+				
+				break;
+			}
+			
+			vOffsets.push_back(nOffset);
+		}
+		
+		// -- buffer may have moved while growing, take pointers once it is complete
+		for (size_t nOffset : vOffsets)
+		{
+			DigitalNote::SMSG::SecureMessage* psmsg = (DigitalNote::SMSG::SecureMessage*) &vchBuffer[nOffset];
+			
+			vBatch.push_back(DigitalNote::SMSG::DecryptEngine::Input(
+				&vchBuffer[nOffset], &vchBuffer[nOffset + SMSG_HDR_LEN], psmsg->nPayload));
+		}
+		
+		nMessages += vBatch.size();
+		
+		// -- don't report to gui
+		if (_ScanMessageBatch(vBatch, false, nFoundMessages) != 0)
+		{
+			fclose(fp);
+			
+			return 1;
+		}
+	}
+	
+	fclose(fp);
+	
+	return 0;
+}
+
+bool ScanBuckets()
+{
+	if (fDebugSmsg)
+	{
+		LogPrint("smsg", "DigitalNote::SMSG::ScanBuckets()\n");
+	}
+
+	if (!DigitalNote::SMSG::ext_enabled || pwalletMain->IsLocked())
+	{
+		return false;
+	}
+
+	int64_t  mStart         = GetTimeMillis();
+	int64_t  now            = GetTime();
+	uint32_t nFiles         = 0;
+	uint32_t nMessages      = 0;
+	uint32_t nFoundMessages = 0;
+	std::set<int64_t> setExpired;
+
+	boost::filesystem::path pathSmsgDir = GetDataDir() / "smsgStore";
+	boost::filesystem::directory_iterator itend;
+
+	if (!boost::filesystem::exists(pathSmsgDir) || !boost::filesystem::is_directory(pathSmsgDir))
+	{
+		LogPrint("smsg", "Message store directory does not exist.\n");
+		
+		return 0; // not an error
+	}
+
+	for (boost::filesystem::directory_iterator itd(pathSmsgDir) ; itd != itend ; ++itd)
+	{
+		if (!boost::filesystem::is_regular_file(itd->status()))
 		{
 			continue;
 		}
@@ -2088,29 +2469,21 @@ bool ScanBuckets()
 		
 		nFiles++;
 
-		// TODO files must be split if > 2GB
 		// time_noFile.dat
-		size_t sep = fileName.find_first_of("_");
-		if (sep == std::string::npos)
+		int64_t fileTime;
+		uint32_t nFile;
+		
+		if (!DigitalNote::SMSG::BucketStore::ParseFileName(fileName, fileTime, nFile))
 		{
 			continue;
 		}
-		
-		std::string stime = fileName.substr(0, sep);
-		int64_t fileTime = boost::lexical_cast<int64_t>(stime);
 
 		if (fileTime < now - SMSG_RETENTION)
 		{
 			LogPrint("smsg", "Dropping file %s, expired.\n", fileName.c_str());
 			
-			try
-			{
-				boost::filesystem::remove((*itd).path());
-			}
-			catch (const boost::filesystem::filesystem_error& ex)
-			{
-				LogPrint("smsg", "Error removing bucket file %s, %s.\n", fileName.c_str(), ex.what());
-			}
+			// -- dropped with its index once the directory has been read
+			setExpired.insert(fileTime);
 			
 			continue;
 		}
@@ -2128,72 +2501,22 @@ bool ScanBuckets()
 		{
 			LOCK(DigitalNote::SMSG::ext_cs);
 			
-			FILE *fp;
-			errno = 0;
-			
-			if (!(fp = fopen((*itd).path().string().c_str(), "rb")))
+			// -- bucket files stay in the store, they are still served to peers
+			if (_ScanFile((*itd).path(), nMessages, nFoundMessages) != 0)
 			{
-				LogPrint("smsg", "Error opening file: %s\n", strerror(errno));
-				
 				continue;
 			}
+		}
+	}
 
-			for (;;)
-			{
-				errno = 0;
-				
-				if (fread(&smsg.hash[0], sizeof(uint8_t), SMSG_HDR_LEN, fp) != (size_t)SMSG_HDR_LEN)
-				{
-					if (errno != 0)
-					{
-						LogPrint("smsg", "fread header failed: %s\n", strerror(errno));
-					}
-					
-					break;
-				}
-
-				try
-				{
-					vchData.resize(smsg.nPayload);
-				}
-				catch (std::exception& e)
-				{
-					LogPrint("smsg", "DigitalNote::SMSG::WalletUnlocked(): Could not resize vchData, %u, %s\n", smsg.nPayload, e.what());
-					
-					fclose(fp);
-					
-					return 1;
-				}
-
-				if (fread(&vchData[0], sizeof(uint8_t), smsg.nPayload, fp) != smsg.nPayload)
-				{
-					LogPrint("smsg", "fread data failed: %s\n", strerror(errno));
-					
-					break;
-				}
-
-				// -- don't report to gui,
-				int rv = DigitalNote::SMSG::ScanMessage(&smsg.hash[0], &vchData[0], smsg.nPayload, false);
-
-				if (rv == 0)
-				{
-					nFoundMessages++;
-				}
-
-				nMessages ++;
-			}
-
-			fclose(fp);
-
-			try {
-				boost::filesystem::remove((*itd).path());
-			}
-			catch (const boost::filesystem::filesystem_error& ex)
-			{
-				LogPrint("smsg", "Error removing wl file %s - %s\n", fileName.c_str(), ex.what());
-				
-				return 1;
-			}
+	if (!setExpired.empty())
+	{
+		LOCK(DigitalNote::SMSG::ext_cs);
+		
+		for (int64_t bucket : setExpired)
+		{
+			DigitalNote::SMSG::ext_bucket_store.Drop(bucket);
+			DigitalNote::SMSG::ext_buckets.erase(bucket);
 		}
 	}
 
@@ -2238,9 +2561,6 @@ int WalletUnlocked()
 		return 0; // not an error
 	}
 
-	DigitalNote::SMSG::SecureMessage smsg;
-	std::vector<uint8_t> vchData;
-
 	for (boost::filesystem::directory_iterator itd(pathSmsgDir) ; itd != itend ; ++itd)
 	{
 		if (!boost::filesystem::is_regular_file(itd->status()))
@@ -2261,17 +2581,14 @@ int WalletUnlocked()
 		
 		nFiles++;
 
-		// TODO files must be split if > 2GB
 		// time_noFile_wl.dat
-		size_t sep = fileName.find_first_of("_");
+		int64_t fileTime;
+		uint32_t nFile;
 		
-		if (sep == std::string::npos)
+		if (!DigitalNote::SMSG::BucketStore::ParseFileName(fileName, fileTime, nFile))
 		{
 			continue;
 		}
-		
-		std::string stime = fileName.substr(0, sep);
-		int64_t fileTime = boost::lexical_cast<int64_t>(stime);
 
 		if (fileTime < now - SMSG_RETENTION)
 		{
@@ -2294,59 +2611,11 @@ int WalletUnlocked()
 		{
 			LOCK(DigitalNote::SMSG::ext_cs);
 			
-			FILE *fp;
-			errno = 0;
-			
-			if (!(fp = fopen((*itd).path().string().c_str(), "rb")))
+			if (_ScanFile((*itd).path(), nMessages, nFoundMessages) != 0)
 			{
-				LogPrint("smsg", "Error opening file: %s\n", strerror(errno));
-				
 				continue;
 			}
 
-			for (;;)
-			{
-				errno = 0;
-				
-				if (fread(&smsg.hash[0], sizeof(uint8_t), SMSG_HDR_LEN, fp) != (size_t)SMSG_HDR_LEN)
-				{
-					if (errno != 0)
-					{
-						LogPrint("smsg", "fread header failed: %s\n", strerror(errno));
-					}
-					
-					break;
-				}
-
-				try { vchData.resize(smsg.nPayload); } catch (std::exception& e)
-				{
-					LogPrint("smsg", "DigitalNote::SMSG::WalletUnlocked(): Could not resize vchData, %u, %s\n", smsg.nPayload, e.what());
-					
-					fclose(fp);
-					
-					return 1;
-				}
-
-				if (fread(&vchData[0], sizeof(uint8_t), smsg.nPayload, fp) != smsg.nPayload)
-				{
-					LogPrint("smsg", "fread data failed: %s\n", strerror(errno));
-					
-					break;
-				}
-
-				// -- don't report to gui,
-				int rv = DigitalNote::SMSG::ScanMessage(&smsg.hash[0], &vchData[0], smsg.nPayload, false);
-
-				if (rv == 0)
-				{
-					nFoundMessages++;
-				}
-
-				nMessages ++;
-			}
-
-			fclose(fp);
-
 			try
 			{
 				boost::filesystem::remove((*itd).path());
@@ -2421,6 +2690,9 @@ int WalletKeyChanged(std::string sAddress, std::string sLabel, ChangeType mode)
 				break;
 			}
 		}
+		
+		// -- reloaded with the new address list on next scan
+		DigitalNote::SMSG::ext_decrypt_engine.Clear();
 	}
 
 	return 0;
@@ -2463,136 +2735,23 @@ int ScanMessage(uint8_t *pHeader, uint8_t *pPayload, uint32_t nPayload, bool rep
 		return 3;
 	}
 
-	std::string addressTo;
-	DigitalNote::SMSG::Message msg;
-	bool fOwnMessage = false;
-
-	for (std::vector<DigitalNote::SMSG::Address>::iterator it = DigitalNote::SMSG::ext_addresses.begin(); it != DigitalNote::SMSG::ext_addresses.end(); ++it)
-	{
-		if (!it->fReceiveEnabled)
-		{
-			continue;
-		}
-		
-		CDigitalNoteAddress coinAddress(it->sAddress);
-		addressTo = coinAddress.ToString();
-
-		if (!it->fReceiveAnon)
-		{
-			// -- have to do full decrypt to see address from
-			if (DigitalNote::SMSG::Decrypt(false, addressTo, pHeader, pPayload, nPayload, msg) == 0)
-			{
-				if (fDebugSmsg)
-				{
-					LogPrint("smsg", "Decrypted message with %s.\n", addressTo.c_str());
-				}
-				
-				if (msg.sFromAddress.compare("anon") != 0)
-				{
-					fOwnMessage = true;
-				}
-				
-				break;
-			}
-		}
-		else
-		{
-			if (DigitalNote::SMSG::Decrypt(false, addressTo, pHeader, pPayload, nPayload, msg) == 0)
-			{
-				if (fDebugSmsg)
-				{
-					LogPrint("smsg", "Decrypted message with %s.\n", addressTo.c_str());
-				}
-				
-				fOwnMessage = true;
-				
-				break;
-			}
-		}
-	}
-
-	if (fOwnMessage)
 	{
-		// -- save to inbox
-		DigitalNote::SMSG::SecureMessage* psmsg = (DigitalNote::SMSG::SecureMessage*) pHeader;
-		std::string sPrefix("im");
-		
-		uint8_t chKey[18];
-		memcpy(&chKey[0],  sPrefix.data(),    2);
-		memcpy(&chKey[2],  &psmsg->timestamp, 8);
-		memcpy(&chKey[10], pPayload,          8);
-
-		DigitalNote::SMSG::Stored smsgInbox;
+		LOCK(DigitalNote::SMSG::ext_cs);
 		
-		smsgInbox.timeReceived  = GetTime();
-		smsgInbox.status        = (SMSG_MASK_UNREAD) & 0xFF;
-		smsgInbox.sAddrTo       = addressTo;
-
-		// -- data may not be contiguous
-		try
-		{
-			smsgInbox.vchMessage.resize(SMSG_HDR_LEN + nPayload);
-		}
-		catch (std::exception& e)
+		if (!DigitalNote::SMSG::ext_decrypt_engine.IsLoaded()
+			&& !DigitalNote::SMSG::ext_decrypt_engine.Load())
 		{
-			LogPrint("smsg", "DigitalNote::SMSG::ScanMessage(): Could not resize vchData, %u, %s\n", SMSG_HDR_LEN + nPayload, e.what());
-			
 			return 1;
 		}
-		
-		memcpy(&smsgInbox.vchMessage[0], pHeader, SMSG_HDR_LEN);
-		memcpy(&smsgInbox.vchMessage[SMSG_HDR_LEN], pPayload, nPayload);
-
-		{
-			LOCK(DigitalNote::SMSG::ext_cs_db);
-			
-			DigitalNote::SMSG::DB dbInbox;
-
-			if (dbInbox.Open("cw"))
-			{
-				if (dbInbox.ExistsSmesg(chKey))
-				{
-					if (fDebugSmsg)
-					{
-						LogPrint("smsg", "Message already exists in inbox db.\n");
-					}
-				}
-				else
-				{
-					dbInbox.WriteSmesg(chKey, smsgInbox);
-
-					if (reportToGui)
-					{
-						DigitalNote::SMSG::ext_signal_NotifyInboxChanged(smsgInbox);
-
-						LogPrint("webwallet", "webwallet: Sending update message in update to webwallet \n");
-						
-						char cbuf[256];
-						json_spirit::Object messageObject;
-						
-						messageObject.push_back(json_spirit::Pair("received", getTimeString(smsgInbox.timeReceived, cbuf, sizeof(cbuf))));
-						messageObject.push_back(json_spirit::Pair("sent", getTimeString(msg.timestamp, cbuf, sizeof(cbuf))));
-						messageObject.push_back(json_spirit::Pair("from", msg.sFromAddress));
-						messageObject.push_back(json_spirit::Pair("to", smsgInbox.sAddrTo));
-						messageObject.push_back(json_spirit::Pair("text", (char*)&msg.vchMessage[0]));
-
-						json_spirit::Object payload;
-						
-						payload.push_back(json_spirit::Pair("type", "messagesIn"));
-						payload.push_back(json_spirit::Pair("data", messageObject));
-						
-						DigitalNote::SMSG::ext_signal_NotifyInboxChangedJson(payload);
-						
-						LogPrint("webwallet", "webwallet: Finished sending update message in update to webwallet \n");
-					}
-					
-					LogPrint("smsg", "SecureMsg saved to inbox, received with %s.\n", addressTo.c_str());
-				}
-			}
-		}
 	}
-
-	return 0;
+	
+	DigitalNote::SMSG::DecryptEngine::Result match = DigitalNote::SMSG::ext_decrypt_engine.Match(
+		DigitalNote::SMSG::DecryptEngine::Input(pHeader, pPayload, nPayload)
+	);
+	
+	int rv = _ReceiveMatched(pHeader, pPayload, nPayload, reportToGui, match);
+	
+	return rv == 2 ? 0 : rv;
 }
 
 int GetLocalKey(CKeyID& ckid, CPubKey& cpkOut)
@@ -2757,74 +2916,13 @@ int Retrieve(DigitalNote::SMSG::Token &token, std::vector<uint8_t>& vchData)
 
 	// -- has DigitalNote::SMSG::ext_cs lock from DigitalNote::SMSG::ReceiveData
 
-	boost::filesystem::path pathSmsgDir = GetDataDir() / "smsgStore";
-
-	//LogPrint("smsg", "token.offset %d.\n", token.offset); // DEBUG
-	int64_t bucket = token.timestamp - (token.timestamp % SMSG_BUCKET_LEN);
-	std::string fileName = boost::lexical_cast<std::string>(bucket) + "_01.dat";
-	boost::filesystem::path fullpath = pathSmsgDir / fileName;
-
-	//LogPrint("smsg", "bucket %d.\n", bucket);
-	//LogPrint("smsg", "bucket d %d.\n", bucket);
-	//LogPrint("smsg", "fileName %s.\n", fileName.c_str());
-
-	FILE *fp;
-	errno = 0;
-
-	if (!(fp = fopen(fullpath.string().c_str(), "rb")))
-	{
-		LogPrint("smsg", "Error opening file: %s\nPath %s\n", strerror(errno), fullpath.string().c_str());
-		
-		return 1;
-	}
-
-	errno = 0;
-	if (fseek(fp, token.offset, SEEK_SET) != 0)
-	{
-		LogPrint("smsg", "fseek, strerror: %s.\n", strerror(errno));
-		
-		fclose(fp);
-		
-		return 1;
-	}
-
-	DigitalNote::SMSG::SecureMessage smsg;
-	errno = 0;
-	
-	if (fread(&smsg.hash[0], sizeof(uint8_t), SMSG_HDR_LEN, fp) != (size_t)SMSG_HDR_LEN)
-	{
-		LogPrint("smsg", "fread header failed: %s\n", strerror(errno));
-		
-		fclose(fp);
-		
-		return 1;
-	}
-
-	try
+	if (DigitalNote::SMSG::ext_bucket_store.Read(token, vchData) != 0)
 	{
-		vchData.resize(SMSG_HDR_LEN + smsg.nPayload);
-	}
-	catch (std::exception& e)
-	{	
-		LogPrint("smsg", "DigitalNote::SMSG::Retrieve(): Could not resize vchData, %u, %s\n", SMSG_HDR_LEN + smsg.nPayload, e.what());
+		LogPrint("smsg", "Error reading message %d from bucket file %u, offset %d.\n", token.timestamp, token.nFile, token.offset);
 		
 		return 1;
 	}
 
-	memcpy(&vchData[0], &smsg.hash[0], SMSG_HDR_LEN);
-	errno = 0;
-	
-	if (fread(&vchData[SMSG_HDR_LEN], sizeof(uint8_t), smsg.nPayload, fp) != smsg.nPayload)
-	{
-		LogPrint("smsg", "fread data failed: %s. Wanted %u bytes.\n", strerror(errno), smsg.nPayload);
-		
-		fclose(fp);
-		
-		return 1;
-	}
-	
-	fclose(fp);
-
 	return 0;
 };
 
@@ -2895,6 +2993,7 @@ int Receive(CNode* pfrom, std::vector<uint8_t>& vchData)
 	}
 
 	uint32_t n = 12;
+	std::vector<DigitalNote::SMSG::DecryptEngine::Input> vBatch;
 
 	for (uint32_t i = 0; i < nBunch; ++i)
 	{
@@ -2932,14 +3031,35 @@ int Receive(CNode* pfrom, std::vector<uint8_t>& vchData)
 				// message dropped
 				break; // continue?
 			}
+		}
+		
+		// -- scanned below as one batch, vchData is not modified until then
+		vBatch.push_back(DigitalNote::SMSG::DecryptEngine::Input(&vchData[n], &vchData[n + SMSG_HDR_LEN], psmsg->nPayload));
+		
+		n += SMSG_HDR_LEN + psmsg->nPayload;
+	}
 
-			if (DigitalNote::SMSG::ScanMessage(&vchData[n], &vchData[n + SMSG_HDR_LEN], psmsg->nPayload, true) != 0)
+	if (!vBatch.empty())
+	{
+		LOCK(DigitalNote::SMSG::ext_cs);
+		
+		if (pwalletMain->IsLocked())
+		{
+			for (const DigitalNote::SMSG::DecryptEngine::Input& msg : vBatch)
+			{
+				// -- stores the message for scanning once the wallet is unlocked
+				DigitalNote::SMSG::ScanMessage(msg.pHeader, msg.pPayload, msg.nPayload, true);
+			}
+		}
+		else
+		{
+			uint32_t nFoundMessages = 0;
+			
+			if (_ScanMessageBatch(vBatch, true, nFoundMessages) != 0)
 			{
 				// message recipient is not this node (or failed)
 			}
 		}
-		
-		n += SMSG_HDR_LEN + psmsg->nPayload;
 	}
 
 	{
@@ -3014,31 +3134,13 @@ int StoreUnscanned(uint8_t *pHeader, uint8_t *pPayload, uint32_t nPayload)
 
 	int64_t bucket = psmsg->timestamp - (psmsg->timestamp % SMSG_BUCKET_LEN);
 
-	std::string fileName = boost::lexical_cast<std::string>(bucket) + "_01_wl.dat";
-	boost::filesystem::path fullpath = pathSmsgDir / fileName;
-
-	FILE *fp;
-	errno = 0;
-	
-	if (!(fp = fopen(fullpath.string().c_str(), "ab")))
+	if (DigitalNote::SMSG::ext_bucket_store.AppendUnscanned(bucket, pHeader, pPayload, nPayload) != 0)
 	{
-		LogPrint("smsg", "Error opening file: %s\n", strerror(errno));
+		LogPrint("smsg", "Error storing unscanned message in bucket %d.\n", bucket);
 		
 		return 1;
 	}
 
-	if (fwrite(pHeader, sizeof(uint8_t), SMSG_HDR_LEN, fp) != (size_t)SMSG_HDR_LEN
-		|| fwrite(pPayload, sizeof(uint8_t), nPayload, fp) != nPayload)
-	{
-		LogPrint("smsg", "fwrite failed: %s\n", strerror(errno));
-		
-		fclose(fp);
-		
-		return 1;
-	}
-
-	fclose(fp);
-
 	return 0;
 }
 
@@ -3057,7 +3159,6 @@ int Store(uint8_t *pHeader, uint8_t *pPayload, uint32_t nPayload, bool fUpdateBu
 	}
 
 	DigitalNote::SMSG::SecureMessage* psmsg = (DigitalNote::SMSG::SecureMessage*) pHeader;
-	long int ofs;
 	boost::filesystem::path pathSmsgDir;
 	
 	try
@@ -3125,38 +3226,11 @@ int Store(uint8_t *pHeader, uint8_t *pPayload, uint32_t nPayload, bool fUpdateBu
 		return 1;
 	}
 
-	std::string fileName = boost::lexical_cast<std::string>(bucket) + "_01.dat";
-	boost::filesystem::path fullpath = pathSmsgDir / fileName;
-
-	FILE *fp;
-	errno = 0;
-	
-	if (!(fp = fopen(fullpath.string().c_str(), "ab")))
+	if (DigitalNote::SMSG::ext_bucket_store.Append(bucket, pHeader, pPayload, nPayload, token) != 0)
 	{
-		return errorN(1, "fopen failed: %s.", strerror(errno));
+		return errorN(1, "Failed to store message in bucket %d.", bucket);
 	}
 
-	// -- on windows ftell will always return 0 after fopen(ab), call fseek to set.
-	errno = 0;
-	if (fseek(fp, 0, SEEK_END) != 0)
-	{
-		return errorN(1, "fseek failed: %s.", strerror(errno));
-	}
-
-	ofs = ftell(fp);
-
-	if (fwrite(pHeader, sizeof(uint8_t), SMSG_HDR_LEN, fp) != (size_t)SMSG_HDR_LEN
-		|| fwrite(pPayload, sizeof(uint8_t), nPayload, fp) != nPayload)
-	{
-		fclose(fp);
-		
-		return errorN(1, "fwrite failed: %s.", strerror(errno));
-	}
-
-	fclose(fp);
-
-	token.offset = ofs;
-
 	//LogPrint("smsg", "token.offset: %d\n", token.offset); // DEBUG
 	tokenSet.insert(token);
 
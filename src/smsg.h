@@ -36,7 +36,7 @@ namespace DigitalNote
 		bool SendData(CNode* pto, bool fSendTrickle);
 		bool ScanBlock(CBlock& block);
 		bool ScanChainForPublicKeys(CBlockIndex* pindexStart);
-		bool ScanBlockChain();
+		bool ScanBlockChain(bool fRescan);
 		bool ScanBuckets();
 		int WalletUnlocked();
 		int WalletKeyChanged(std::string sAddress, std::string sLabel, ChangeType mode);
@@ -0,0 +1,558 @@
+#include "compat.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include "util.h"
+#include "tinyformat.h"
+#include "smsg_const.h"
+#include "smsg/securemessage.h"
+#include "smsg/token.h"
+
+#include "smsg/bucketstore.h"
+
+namespace DigitalNote {
+namespace SMSG {
+
+namespace {
+
+// -- index record: timestamp(8) | sample(8) | offset(8) | nPayload(4) | reserved(4)
+const size_t INDEX_RECORD_LEN = 32;
+
+void WriteIndexRecord(uint8_t* p, int64_t timestamp, const uint8_t* pPayload, uint32_t nPayload, int64_t offset)
+{
+	memset(p, 0, INDEX_RECORD_LEN);
+	memcpy(&p[0], &timestamp, 8);
+
+	if (nPayload >= 8)
+	{
+		memcpy(&p[8], pPayload, 8);
+	}
+
+	memcpy(&p[16], &offset, 8);
+	memcpy(&p[24], &nPayload, 4);
+}
+
+bool CheckIndex(const std::vector<uint8_t>& vchIndex, uint64_t nDataSize)
+{
+	// -- records must cover the data file exactly, in order
+	if (vchIndex.size() % INDEX_RECORD_LEN != 0)
+	{
+		return false;
+	}
+
+	uint64_t nExpected = 0;
+
+	for (size_t i = 0; i < vchIndex.size(); i += INDEX_RECORD_LEN)
+	{
+		int64_t offset;
+		uint32_t nPayload;
+
+		memcpy(&offset, &vchIndex[i + 16], 8);
+		memcpy(&nPayload, &vchIndex[i + 24], 4);
+
+		if (offset < 0 || (uint64_t)offset != nExpected)
+		{
+			return false;
+		}
+
+		nExpected += SMSG_HDR_LEN + nPayload;
+	}
+
+	return nExpected == nDataSize;
+}
+
+bool ReadWholeFile(const boost::filesystem::path& path, std::vector<uint8_t>& vchData)
+{
+	boost::system::error_code ec;
+	uintmax_t nSize = boost::filesystem::file_size(path, ec);
+
+	if (ec)
+	{
+		return false;
+	}
+
+	FILE *fp;
+
+	if (!(fp = fopen(path.string().c_str(), "rb")))
+	{
+		return false;
+	}
+
+	vchData.resize(nSize);
+
+	bool fRet = nSize == 0
+		|| fread(&vchData[0], sizeof(uint8_t), nSize, fp) == nSize;
+
+	fclose(fp);
+
+	return fRet;
+}
+
+int AppendToFile(const boost::filesystem::path& path, const uint8_t* p1, size_t n1, const uint8_t* p2, size_t n2, long int* pOffset)
+{
+	FILE *fp;
+	errno = 0;
+
+	if (!(fp = fopen(path.string().c_str(), "ab")))
+	{
+		return errorN(1, "fopen failed: %s.", strerror(errno));
+	}
+
+	if (pOffset)
+	{
+		// -- on windows ftell will always return 0 after fopen(ab), call fseek to set.
+		errno = 0;
+		if (fseek(fp, 0, SEEK_END) != 0)
+		{
+			fclose(fp);
+
+			return errorN(1, "fseek failed: %s.", strerror(errno));
+		}
+
+		*pOffset = ftell(fp);
+	}
+
+	if (fwrite(p1, sizeof(uint8_t), n1, fp) != n1
+		|| (n2 > 0 && fwrite(p2, sizeof(uint8_t), n2, fp) != n2))
+	{
+		fclose(fp);
+
+		return errorN(1, "fwrite failed: %s.", strerror(errno));
+	}
+
+	fclose(fp);
+
+	return 0;
+}
+
+uint32_t SelectFile(int64_t bucket, const std::string& sSuffix, uint32_t nLen)
+{
+	// -- first file with room for nLen more bytes
+	uint32_t nFile = 1;
+
+	for (;; ++nFile)
+	{
+		boost::system::error_code ec;
+		uintmax_t nSize = boost::filesystem::file_size(BucketStore::GetPath(bucket, nFile, sSuffix), ec);
+
+		if (ec || nSize + nLen <= SMSG_MAX_FILE_SIZE)
+		{
+			return nFile;
+		}
+	}
+}
+
+} // namespace
+
+class BucketStore::MappedFile
+{
+public:
+	boost::interprocess::file_mapping	mapping;
+	boost::interprocess::mapped_region	region;
+
+	const uint8_t* Data() const
+	{
+		return (const uint8_t*) region.get_address();
+	}
+
+	uint64_t Size() const
+	{
+		return region.get_size();
+	}
+};
+
+BucketStore::BucketStore()
+{
+
+}
+
+BucketStore::~BucketStore()
+{
+	Close();
+}
+
+boost::filesystem::path BucketStore::GetPath(int64_t bucket, uint32_t nFile, const std::string& sSuffix)
+{
+	return GetDataDir() / "smsgStore" / strprintf("%d_%02u%s", bucket, nFile, sSuffix);
+}
+
+bool BucketStore::ParseFileName(const std::string& fileName, int64_t& bucket, uint32_t& nFile)
+{
+	// time_noFile.dat, time_noFile.idx or time_noFile_wl.dat
+	size_t sep = fileName.find_first_of("_");
+	if (sep == std::string::npos)
+	{
+		return false;
+	}
+
+	size_t end = fileName.find_first_of("_.", sep + 1);
+	if (end == std::string::npos)
+	{
+		return false;
+	}
+
+	try
+	{
+		bucket = boost::lexical_cast<int64_t>(fileName.substr(0, sep));
+		nFile = boost::lexical_cast<uint32_t>(fileName.substr(sep + 1, end - sep - 1));
+	}
+	catch (const boost::bad_lexical_cast&)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+std::shared_ptr<BucketStore::MappedFile> BucketStore::Map(int64_t bucket, uint32_t nFile, uint64_t nMinSize)
+{
+	FileId id(bucket, nFile);
+	std::map<FileId, std::shared_ptr<MappedFile> >::iterator it = mapMapped.find(id);
+
+	if (it != mapMapped.end())
+	{
+		if (it->second->Size() >= nMinSize)
+		{
+			return it->second;
+		}
+
+		// -- file has grown since it was mapped
+		mapMapped.erase(it);
+	}
+
+	boost::filesystem::path path = GetPath(bucket, nFile, ".dat");
+	boost::system::error_code ec;
+	uintmax_t nSize = boost::filesystem::file_size(path, ec);
+
+	if (ec || nSize == 0 || nSize < nMinSize)
+	{
+		LogPrint("smsg", "Can't map %s, size %d, wanted %d.\n", path.string().c_str(), ec ? 0 : nSize, nMinSize);
+
+		return std::shared_ptr<MappedFile>();
+	}
+
+	if (mapMapped.size() >= SMSG_MAX_MAPPED_FILES)
+	{
+		mapMapped.erase(mapMapped.begin());
+	}
+
+	std::shared_ptr<MappedFile> file(new MappedFile());
+
+	try
+	{
+		file->mapping = boost::interprocess::file_mapping(path.string().c_str(), boost::interprocess::read_only);
+		file->region = boost::interprocess::mapped_region(file->mapping, boost::interprocess::read_only);
+	}
+	catch (const boost::interprocess::interprocess_exception& e)
+	{
+		LogPrint("smsg", "Error mapping %s: %s\n", path.string().c_str(), e.what());
+
+		return std::shared_ptr<MappedFile>();
+	}
+
+	mapMapped[id] = file;
+
+	return file;
+}
+
+void BucketStore::Unmap(int64_t bucket)
+{
+	std::map<FileId, std::shared_ptr<MappedFile> >::iterator it = mapMapped.lower_bound(FileId(bucket, 0));
+
+	while (it != mapMapped.end() && it->first.first == bucket)
+	{
+		mapMapped.erase(it++);
+	}
+}
+
+int BucketStore::Append(int64_t bucket, const uint8_t* pHeader, const uint8_t* pPayload, uint32_t nPayload,
+		DigitalNote::SMSG::Token& token)
+{
+	uint32_t nFile = SelectFile(bucket, ".dat", SMSG_HDR_LEN + nPayload);
+	long int ofs = 0;
+
+	if (AppendToFile(GetPath(bucket, nFile, ".dat"), pHeader, SMSG_HDR_LEN, pPayload, nPayload, &ofs) != 0)
+	{
+		return 1;
+	}
+
+	token.nFile = nFile;
+	token.offset = ofs;
+
+	const DigitalNote::SMSG::SecureMessage* psmsg = (const DigitalNote::SMSG::SecureMessage*) pHeader;
+	uint8_t record[INDEX_RECORD_LEN];
+
+	WriteIndexRecord(record, psmsg->timestamp, pPayload, nPayload, ofs);
+
+	// -- message is stored, a stale index is rebuilt by Load
+	if (AppendToFile(GetPath(bucket, nFile, ".idx"), record, INDEX_RECORD_LEN, NULL, 0, NULL) != 0)
+	{
+		LogPrint("smsg", "Failed to index message in bucket %d.\n", bucket);
+	}
+
+	return 0;
+}
+
+int BucketStore::AppendUnscanned(int64_t bucket, const uint8_t* pHeader, const uint8_t* pPayload, uint32_t nPayload)
+{
+	uint32_t nFile = SelectFile(bucket, "_wl.dat", SMSG_HDR_LEN + nPayload);
+
+	return AppendToFile(GetPath(bucket, nFile, "_wl.dat"), pHeader, SMSG_HDR_LEN, pPayload, nPayload, NULL);
+}
+
+int BucketStore::Read(const DigitalNote::SMSG::Token& token, std::vector<uint8_t>& vchData)
+{
+	int64_t bucket = token.timestamp - (token.timestamp % SMSG_BUCKET_LEN);
+	uint64_t nOffset = token.offset;
+
+	std::shared_ptr<MappedFile> file = Map(bucket, token.nFile, nOffset + SMSG_HDR_LEN);
+
+	if (!file)
+	{
+		return 1;
+	}
+
+	const DigitalNote::SMSG::SecureMessage* psmsg = (const DigitalNote::SMSG::SecureMessage*) (file->Data() + nOffset);
+	uint64_t nEnd = nOffset + SMSG_HDR_LEN + psmsg->nPayload;
+
+	if (nEnd > file->Size())
+	{
+		if (!(file = Map(bucket, token.nFile, nEnd)))
+		{
+			return 1;
+		}
+	}
+
+	try
+	{
+		vchData.resize(nEnd - nOffset);
+	}
+	catch (std::exception& e)
+	{
+		LogPrint("smsg", "DigitalNote::SMSG::BucketStore::Read(): Could not resize vchData, %u, %s\n", nEnd - nOffset, e.what());
+
+		return 1;
+	}
+
+	memcpy(&vchData[0], file->Data() + nOffset, nEnd - nOffset);
+
+	return 0;
+}
+
+int BucketStore::RebuildIndex(int64_t bucket, uint32_t nFile, std::vector<uint8_t>& vchIndex)
+{
+	boost::filesystem::path pathData = GetPath(bucket, nFile, ".dat");
+	boost::filesystem::path pathIndex = GetPath(bucket, nFile, ".idx");
+	boost::system::error_code ec;
+	uintmax_t nSize = boost::filesystem::file_size(pathData, ec);
+
+	if (ec)
+	{
+		return 1;
+	}
+
+	vchIndex.clear();
+
+	uint64_t nOffset = 0;
+
+	if (nSize > 0)
+	{
+		std::shared_ptr<MappedFile> file = Map(bucket, nFile, nSize);
+
+		if (!file)
+		{
+			return 1;
+		}
+
+		while (nOffset + SMSG_HDR_LEN <= nSize)
+		{
+			const DigitalNote::SMSG::SecureMessage* psmsg = (const DigitalNote::SMSG::SecureMessage*) (file->Data() + nOffset);
+
+			if (nOffset + SMSG_HDR_LEN + psmsg->nPayload > nSize)
+			{
+				break;
+			}
+
+			vchIndex.resize(vchIndex.size() + INDEX_RECORD_LEN);
+			WriteIndexRecord(&vchIndex[vchIndex.size() - INDEX_RECORD_LEN], psmsg->timestamp,
+				file->Data() + nOffset + SMSG_HDR_LEN, psmsg->nPayload, nOffset);
+
+			nOffset += SMSG_HDR_LEN + psmsg->nPayload;
+		}
+	}
+
+	if (nOffset != nSize)
+	{
+		// -- partly written message, drop it so later appends line up with the index
+		LogPrint("smsg", "Truncating %s from %d to %d bytes.\n", pathData.string().c_str(), nSize, nOffset);
+
+		Unmap(bucket);
+
+		try
+		{
+			boost::filesystem::resize_file(pathData, nOffset);
+		}
+		catch (const boost::filesystem::filesystem_error& ex)
+		{
+			LogPrint("smsg", "Error truncating bucket file %s.\n", ex.what());
+
+			return 1;
+		}
+	}
+
+	boost::filesystem::path pathTmp = pathIndex;
+	pathTmp += ".tmp";
+
+	FILE *fp;
+	errno = 0;
+
+	if (!(fp = fopen(pathTmp.string().c_str(), "wb")))
+	{
+		return errorN(1, "fopen failed: %s.", strerror(errno));
+	}
+
+	if (vchIndex.size() > 0
+		&& fwrite(&vchIndex[0], sizeof(uint8_t), vchIndex.size(), fp) != vchIndex.size())
+	{
+		fclose(fp);
+
+		return errorN(1, "fwrite failed: %s.", strerror(errno));
+	}
+
+	fclose(fp);
+
+	try
+	{
+		boost::filesystem::rename(pathTmp, pathIndex);
+	}
+	catch (const boost::filesystem::filesystem_error& ex)
+	{
+		LogPrint("smsg", "Error renaming file %s, %s.\n", pathTmp.string().c_str(), ex.what());
+
+		return 1;
+	}
+
+	return 0;
+}
+
+int BucketStore::Load(int64_t bucket, uint32_t nFile, std::set<DigitalNote::SMSG::Token>& setTokens)
+{
+	boost::system::error_code ec;
+	uintmax_t nDataSize = boost::filesystem::file_size(GetPath(bucket, nFile, ".dat"), ec);
+
+	if (ec)
+	{
+		LogPrint("smsg", "Error reading bucket %d file %u: %s\n", bucket, nFile, ec.message());
+
+		return 1;
+	}
+
+	std::vector<uint8_t> vchIndex;
+
+	if (!ReadWholeFile(GetPath(bucket, nFile, ".idx"), vchIndex)
+		|| !CheckIndex(vchIndex, nDataSize))
+	{
+		LogPrint("smsg", "Rebuilding index for bucket %d file %u.\n", bucket, nFile);
+
+		if (RebuildIndex(bucket, nFile, vchIndex) != 0)
+		{
+			return 1;
+		}
+	}
+
+	for (size_t i = 0; i < vchIndex.size(); i += INDEX_RECORD_LEN)
+	{
+		DigitalNote::SMSG::Token token;
+		uint32_t nPayload;
+
+		memcpy(&nPayload, &vchIndex[i + 24], 4);
+
+		if (nPayload < 8)
+		{
+			continue;
+		}
+
+		memcpy(&token.timestamp, &vchIndex[i], 8);
+		memcpy(token.sample, &vchIndex[i + 8], 8);
+		memcpy(&token.offset, &vchIndex[i + 16], 8);
+		token.nFile = nFile;
+
+		setTokens.insert(token);
+	}
+
+	return 0;
+}
+
+uint64_t BucketStore::GetSize(int64_t bucket) const
+{
+	uint64_t nBytes = 0;
+
+	for (uint32_t nFile = 1; ; ++nFile)
+	{
+		boost::system::error_code ec;
+		uintmax_t nSize = boost::filesystem::file_size(GetPath(bucket, nFile, ".dat"), ec);
+
+		if (ec)
+		{
+			break;
+		}
+
+		nBytes += nSize;
+	}
+
+	return nBytes;
+}
+
+void BucketStore::Drop(int64_t bucket)
+{
+	// -- mapped files can't be removed on windows
+	Unmap(bucket);
+
+	boost::filesystem::path pathSmsgDir = GetDataDir() / "smsgStore";
+	std::string sPrefix = boost::lexical_cast<std::string>(bucket) + "_";
+	std::vector<boost::filesystem::path> vRemove;
+
+	try
+	{
+		boost::filesystem::directory_iterator itend;
+
+		for (boost::filesystem::directory_iterator itd(pathSmsgDir); itd != itend; ++itd)
+		{
+			if (boost::algorithm::starts_with((*itd).path().filename().string(), sPrefix))
+			{
+				vRemove.push_back((*itd).path());
+			}
+		}
+	}
+	catch (const boost::filesystem::filesystem_error& ex)
+	{
+		LogPrint("smsg", "Error listing message store %s.\n", ex.what());
+	}
+
+	for (const boost::filesystem::path& path : vRemove)
+	{
+		try
+		{
+			boost::filesystem::remove(path);
+		}
+		catch (const boost::filesystem::filesystem_error& ex)
+		{
+			LogPrint("smsg", "Error removing bucket file %s.\n", ex.what());
+		}
+	}
+}
+
+void BucketStore::Close()
+{
+	mapMapped.clear();
+}
+
+} // namespace SMSG
+} // namespace DigitalNote
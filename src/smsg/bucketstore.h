@@ -0,0 +1,64 @@
+#ifndef SMSG_BUCKETSTORE_H
+#define SMSG_BUCKETSTORE_H
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+#include <boost/filesystem/path.hpp>
+
+namespace DigitalNote {
+namespace SMSG {
+
+class Token;
+
+/** Message files in smsgStore.
+ *  A bucket is stored as data files <bucket>_NN.dat, a new file is started
+ *  before one would grow past SMSG_MAX_FILE_SIZE. Each data file has an index
+ *  <bucket>_NN.idx of fixed size records, one per message, written as messages
+ *  are appended, so token sets load at startup without reading the messages.
+ *  An index that does not match its data file is rebuilt from the data file.
+ *  Messages are read through a read-only mapping kept open per data file.
+ *  Callers hold ext_cs.
+ */
+class BucketStore
+{
+private:
+	class MappedFile;
+	typedef std::pair<int64_t, uint32_t> FileId;
+
+	std::map<FileId, std::shared_ptr<MappedFile> >	mapMapped;
+
+	std::shared_ptr<MappedFile> Map(int64_t bucket, uint32_t nFile, uint64_t nMinSize);
+	void Unmap(int64_t bucket);
+	int RebuildIndex(int64_t bucket, uint32_t nFile, std::vector<uint8_t>& vchIndex);
+
+public:
+	BucketStore();
+	~BucketStore();
+
+	static boost::filesystem::path GetPath(int64_t bucket, uint32_t nFile, const std::string& sSuffix);
+	static bool ParseFileName(const std::string& fileName, int64_t& bucket, uint32_t& nFile);
+
+	/** Append a message to the bucket, sets token.nFile and token.offset. */
+	int Append(int64_t bucket, const uint8_t* pHeader, const uint8_t* pPayload, uint32_t nPayload,
+			DigitalNote::SMSG::Token& token);
+	/** Append a message received while the wallet was locked, to <bucket>_NN_wl.dat */
+	int AppendUnscanned(int64_t bucket, const uint8_t* pHeader, const uint8_t* pPayload, uint32_t nPayload);
+	int Read(const DigitalNote::SMSG::Token& token, std::vector<uint8_t>& vchData);
+	/** Add the tokens of one data file to setTokens, from its index. */
+	int Load(int64_t bucket, uint32_t nFile, std::set<DigitalNote::SMSG::Token>& setTokens);
+
+	uint64_t GetSize(int64_t bucket) const;
+	/** Remove every file of the bucket, including unscanned messages. */
+	void Drop(int64_t bucket);
+	void Close();
+};
+
+} // namespace SMSG
+} // namespace DigitalNote
+
+#endif // SMSG_BUCKETSTORE_H
@@ -8,9 +8,11 @@
 #include "smsg/stored.h"
 #include "ckeyid.h"
 #include "cpubkey.h"
+#include "uint/uint256.h"
 #include "enums/serialize_type.h"
 #include "version.h"
 #include "cdatastream.h"
+#include "csecuredatastream.h"
 
 #include "smsg/db.h"
 
@@ -228,6 +230,67 @@ bool DB::ExistsPK(CKeyID& addr)
     return s.IsNotFound() == false;
 }
 
+bool DB::ReadScanHeight(int& nHeight, uint256& hashBlock)
+{
+    if (!pdb)
+        return false;
+
+    // -- height and hash of the last block ScanChainForPublicKeys finished
+    CDataStream ssKey(SER_DISK, CLIENT_VERSION);
+    ssKey << 's';
+    ssKey << 'h';
+    std::string strValue;
+
+    leveldb::Status s = pdb->Get(leveldb::ReadOptions(), ssKey.str(), &strValue);
+    if (!s.ok())
+    {
+        if (!s.IsNotFound())
+            LogPrint("smsg", "LevelDB read failure: %s\n", s.ToString().c_str());
+        return false;
+    };
+
+    try {
+        CDataStream ssValue(strValue.data(), strValue.data() + strValue.size(), SER_DISK, CLIENT_VERSION);
+        ssValue >> nHeight;
+        ssValue >> hashBlock;
+    } catch (std::exception& e) {
+        LogPrint("smsg", "DigitalNote::SMSG::DB::ReadScanHeight() unserialize threw: %s.\n", e.what());
+        return false;
+    }
+
+    return true;
+}
+
+bool DB::WriteScanHeight(int nHeight, const uint256& hashBlock)
+{
+    if (!pdb)
+        return false;
+
+    CDataStream ssKey(SER_DISK, CLIENT_VERSION);
+    ssKey << 's';
+    ssKey << 'h';
+    CDataStream ssValue(SER_DISK, CLIENT_VERSION);
+    ssValue << nHeight;
+    ssValue << hashBlock;
+
+    if (activeBatch)
+    {
+        activeBatch->Put(ssKey.str(), ssValue.str());
+        return true;
+    };
+
+    leveldb::WriteOptions writeOptions;
+    writeOptions.sync = true;
+    leveldb::Status s = pdb->Put(writeOptions, ssKey.str(), ssValue.str());
+    if (!s.ok())
+    {
+        LogPrint("smsg", "DigitalNote::SMSG::DB write failure: %s\n", s.ToString().c_str());
+        return false;
+    };
+
+    return true;
+}
+
 bool DB::NextSmesg(leveldb::Iterator* it, std::string& prefix, uint8_t* chKey, DigitalNote::SMSG::Stored& smsgStored)
 {
     if (!pdb)
@@ -246,7 +309,7 @@ bool DB::NextSmesg(leveldb::Iterator* it, std::string& prefix, uint8_t* chKey, D
     memcpy(chKey, it->key().data(), 18);
 
     try {
-        CDataStream ssValue(it->value().data(), it->value().data() + it->value().size(), SER_DISK, CLIENT_VERSION);
+        CSecureDataStream ssValue(it->value().data(), it->value().data() + it->value().size(), SER_DISK, CLIENT_VERSION);
         ssValue >> smsgStored;
     } catch (std::exception& e) {
         LogPrint("smsg", "DigitalNote::SMSG::DB::NextSmesg() unserialize threw: %s.\n", e.what());
@@ -308,7 +371,7 @@ bool DB::ReadSmesg(uint8_t* chKey, DigitalNote::SMSG::Stored& smsgStored)
     };
 
     try {
-        CDataStream ssValue(strValue.data(), strValue.data() + strValue.size(), SER_DISK, CLIENT_VERSION);
+        CSecureDataStream ssValue(strValue.data(), strValue.data() + strValue.size(), SER_DISK, CLIENT_VERSION);
         ssValue >> smsgStored;
     } catch (std::exception& e) {
         LogPrint("smsg", "DigitalNote::SMSG::DB::ReadSmesg() unserialize threw: %s.\n", e.what());
@@ -325,7 +388,7 @@ bool DB::WriteSmesg(uint8_t* chKey, DigitalNote::SMSG::Stored& smsgStored)
 
     CDataStream ssKey(SER_DISK, CLIENT_VERSION);
     ssKey.write((const char*)chKey, 18);
-    CDataStream ssValue(SER_DISK, CLIENT_VERSION);
+    CSecureDataStream ssValue(SER_DISK, CLIENT_VERSION);
     ssValue << smsgStored;
 
     if (activeBatch)
@@ -9,6 +9,7 @@
 class CDataStream;
 class CKeyID;
 class CPubKey;
+class uint256;
 
 namespace DigitalNote {
 namespace SMSG {
@@ -31,6 +32,8 @@ public:
     bool ReadPK(CKeyID& addr, CPubKey& pubkey);
     bool WritePK(CKeyID& addr, CPubKey& pubkey);
     bool ExistsPK(CKeyID& addr);
+    bool ReadScanHeight(int& nHeight, uint256& hashBlock);
+    bool WriteScanHeight(int nHeight, const uint256& hashBlock);
     bool NextSmesg(leveldb::Iterator* it, std::string& prefix, uint8_t* vchKey, DigitalNote::SMSG::Stored& smsgStored);
     bool NextSmesgKey(leveldb::Iterator* it, std::string& prefix, uint8_t* vchKey);
     bool ReadSmesg(uint8_t* chKey, DigitalNote::SMSG::Stored& smsgStored);
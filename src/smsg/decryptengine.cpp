@@ -0,0 +1,305 @@
+#include <atomic>
+#include <cstring>
+
+#include "init.h"
+#include "cwallet.h"
+#include "ckey.h"
+#include "ckeyid.h"
+#include "cnodestination.h"
+#include "cscriptid.h"
+#include "cstealthaddress.h"
+#include "cdigitalnoteaddress.h"
+#include "stealth.h"
+#include "util.h"
+#include "thread.h"
+#include "thread/cthreadpool.h"
+#include "crypto/common/sha512.h"
+#include "crypto/common/hmac_sha256.h"
+#include "support/cleanse.h"
+#include "smsg_extern.h"
+#include "smsg/address.h"
+#include "smsg/securemessage.h"
+
+#include "smsg/decryptengine.h"
+
+namespace DigitalNote {
+namespace SMSG {
+
+// -- below this many trials a batch is not worth handing to the pool
+static const size_t MIN_PARALLEL_TRIALS = 64;
+
+DecryptEngine::Input::Input(uint8_t* pHeaderIn, uint8_t* pPayloadIn, uint32_t nPayloadIn)
+		: pHeader(pHeaderIn), pPayload(pPayloadIn), nPayload(nPayloadIn)
+{
+	
+}
+
+DecryptEngine::Result::Result() : fMatch(false), fReceiveAnon(false)
+{
+	
+}
+
+DecryptEngine::DecryptEngine() : fLoaded(false)
+{
+	
+}
+
+DecryptEngine::~DecryptEngine()
+{
+	StopThreads();
+	Wipe();
+}
+
+void DecryptEngine::Wipe()
+{
+	for (Key& key : vKeys)
+	{
+		memory_cleanse(key.chSecret, sizeof(key.chSecret));
+	}
+	
+	vKeys.clear();
+	fLoaded = false;
+}
+
+bool DecryptEngine::Load()
+{
+	AssertLockHeld(DigitalNote::SMSG::ext_cs);
+	
+	if (pwalletMain->IsLocked())
+	{
+		return false;
+	}
+	
+	// -- fetch keys without holding mutex, GetKey may decrypt each secret
+	std::vector<Key> vNew;
+	vNew.reserve(DigitalNote::SMSG::ext_addresses.size());
+	
+	for (const DigitalNote::SMSG::Address& addr : DigitalNote::SMSG::ext_addresses)
+	{
+		if (!addr.fReceiveEnabled)
+		{
+			continue;
+		}
+		
+		CDigitalNoteAddress coinAddress(addr.sAddress);
+		CKeyID ckid;
+		CKey key;
+		
+		if (!coinAddress.GetKeyID(ckid)
+			|| !pwalletMain->GetKey(ckid, key))
+		{
+			continue;
+		}
+		
+		Key k;
+		
+		k.sAddress = coinAddress.ToString();
+		k.fReceiveAnon = addr.fReceiveAnon;
+		memcpy(k.chSecret, key.begin(), sizeof(k.chSecret));
+		
+		vNew.push_back(k);
+		
+		memory_cleanse(k.chSecret, sizeof(k.chSecret));
+	}
+	
+	{
+		boost::unique_lock<boost::mutex> lock(mutex);
+		
+		Wipe();
+		vKeys.swap(vNew);
+		fLoaded = true;
+	}
+	
+	for (Key& key : vNew)
+	{
+		memory_cleanse(key.chSecret, sizeof(key.chSecret));
+	}
+	
+	if (fDebugSmsg)
+	{
+		LogPrint("smsg", "DecryptEngine: loaded %u receiving keys.\n", vKeys.size());
+	}
+	
+	return true;
+}
+
+void DecryptEngine::Clear()
+{
+	boost::unique_lock<boost::mutex> lock(mutex);
+	
+	Wipe();
+}
+
+bool DecryptEngine::IsLoaded() const
+{
+	boost::unique_lock<boost::mutex> lock(mutex);
+	
+	return fLoaded;
+}
+
+size_t DecryptEngine::Size() const
+{
+	boost::unique_lock<boost::mutex> lock(mutex);
+	
+	return vKeys.size();
+}
+
+void DecryptEngine::StartThreads(int nThreads)
+{
+	StopThreads();
+	
+	if (nThreads > 1)
+	{
+		pool.reset(new CThreadPool("smsg-scan", nThreads));
+	}
+}
+
+void DecryptEngine::StopThreads()
+{
+	if (pool)
+	{
+		pool->Stop();
+		pool.reset();
+	}
+}
+
+bool DecryptEngine::TestKey(const Key& key, const secp256k1_pubkey& R, const Input& msg) const
+{
+	const DigitalNote::SMSG::SecureMessage* psmsg = (const DigitalNote::SMSG::SecureMessage*) msg.pHeader;
+	const secp256k1_context* ctx = GetStealthContext();
+	
+	// -- P = kR, only the x coordinate is used, as ECDH_compute_key does
+	secp256k1_pubkey P = R;
+	uint8_t vchP[33];
+	size_t nLen = sizeof(vchP);
+	
+	if (!secp256k1_ec_pubkey_tweak_mul(ctx, &P, key.chSecret)
+		|| !secp256k1_ec_pubkey_serialize(ctx, vchP, &nLen, &P, SECP256K1_EC_COMPRESSED))
+	{
+		return false;
+	}
+	
+	// -- H = SHA512(P), key_m is the last 32 bytes
+	uint8_t vchHashed[CSHA512::OUTPUT_SIZE];
+	CSHA512().Write(&vchP[1], 32).Finalize(vchHashed);
+	
+	uint8_t MAC[CHMAC_SHA256::OUTPUT_SIZE];
+	CHMAC_SHA256(&vchHashed[32], 32)
+		.Write((const uint8_t*) &psmsg->timestamp, sizeof(psmsg->timestamp))
+		.Write(msg.pPayload, msg.nPayload)
+		.Finalize(MAC);
+	
+	memory_cleanse(vchP, sizeof(vchP));
+	memory_cleanse(vchHashed, sizeof(vchHashed));
+	
+	return memcmp(MAC, psmsg->mac, sizeof(MAC)) == 0;
+}
+
+int DecryptEngine::MatchKeys(const Input& msg, bool fParallel) const
+{
+	const DigitalNote::SMSG::SecureMessage* psmsg = (const DigitalNote::SMSG::SecureMessage*) msg.pHeader;
+	secp256k1_pubkey R;
+	
+	if (!msg.pHeader
+		|| !msg.pPayload
+		|| psmsg->version[0] != 1
+		|| !secp256k1_ec_pubkey_parse(GetStealthContext(), &R, psmsg->cpkR, sizeof(psmsg->cpkR)))
+	{
+		return -1;
+	}
+	
+	if (!fParallel || !pool || vKeys.size() < MIN_PARALLEL_TRIALS)
+	{
+		for (size_t i = 0; i < vKeys.size(); ++i)
+		{
+			if (TestKey(vKeys[i], R, msg))
+			{
+				return (int)i;
+			}
+		}
+		
+		return -1;
+	}
+	
+	std::atomic<int> nFound(-1);
+	
+	pool->ParallelFor(vKeys.size(), [&](size_t i)
+	{
+		if (nFound.load() >= 0)
+		{
+			return;
+		}
+		
+		if (TestKey(vKeys[i], R, msg))
+		{
+			nFound = (int)i;
+		}
+	});
+	
+	return nFound.load();
+}
+
+DecryptEngine::Result DecryptEngine::Match(const Input& msg)
+{
+	Result result;
+	
+	boost::unique_lock<boost::mutex> lock(mutex);
+	
+	int nKey = MatchKeys(msg, true);
+	
+	if (nKey >= 0)
+	{
+		result.fMatch = true;
+		result.sAddress = vKeys[nKey].sAddress;
+		result.fReceiveAnon = vKeys[nKey].fReceiveAnon;
+	}
+	
+	return result;
+}
+
+void DecryptEngine::MatchBatch(const std::vector<Input>& vMessages, std::vector<Result>& vResults)
+{
+	vResults.assign(vMessages.size(), Result());
+	
+	boost::unique_lock<boost::mutex> lock(mutex);
+	
+	if (vKeys.empty() || vMessages.empty())
+	{
+		return;
+	}
+	
+	std::vector<int> vFound(vMessages.size(), -1);
+	
+	if (pool && vMessages.size() >= (size_t)pool->Size()
+		&& vMessages.size() * vKeys.size() >= MIN_PARALLEL_TRIALS)
+	{
+		// -- enough messages to keep every worker busy, one message per task
+		pool->ParallelFor(vMessages.size(), [&](size_t i)
+		{
+			vFound[i] = MatchKeys(vMessages[i], false);
+		});
+	}
+	else
+	{
+		// -- few messages, spread each one's keys over the pool
+		for (size_t i = 0; i < vMessages.size(); ++i)
+		{
+			vFound[i] = MatchKeys(vMessages[i], true);
+		}
+	}
+	
+	for (size_t i = 0; i < vMessages.size(); ++i)
+	{
+		if (vFound[i] < 0)
+		{
+			continue;
+		}
+		
+		vResults[i].fMatch = true;
+		vResults[i].sAddress = vKeys[vFound[i]].sAddress;
+		vResults[i].fReceiveAnon = vKeys[vFound[i]].fReceiveAnon;
+	}
+}
+
+} // namespace SMSG
+} // namespace DigitalNote
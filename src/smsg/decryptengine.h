@@ -0,0 +1,83 @@
+#ifndef SMSG_DECRYPTENGINE_H
+#define SMSG_DECRYPTENGINE_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <boost/thread/mutex.hpp>
+#include <secp256k1.h>
+
+class CThreadPool;
+
+namespace DigitalNote {
+namespace SMSG {
+
+/** Finds which receiving address, if any, a message was sent to.
+ *  Private keys of all receive-enabled addresses are fetched from the wallet
+ *  once and kept until Clear() (address list changed or wallet locked).
+ *  A trial is ECDH + SHA512 + HMAC-SHA256, the same test Decrypt() does before
+ *  decrypting; trials are spread over a worker pool with early exit.
+ */
+class DecryptEngine
+{
+public:
+	class Input
+	{
+	public:
+		uint8_t*	pHeader;
+		uint8_t*	pPayload;
+		uint32_t	nPayload;
+		
+		Input(uint8_t* pHeaderIn, uint8_t* pPayloadIn, uint32_t nPayloadIn);
+	};
+	
+	class Result
+	{
+	public:
+		bool		fMatch;
+		std::string	sAddress;
+		bool		fReceiveAnon;
+		
+		Result();
+	};
+
+private:
+	class Key
+	{
+	public:
+		std::string	sAddress;
+		bool		fReceiveAnon;
+		uint8_t		chSecret[32];
+	};
+	
+	mutable boost::mutex			mutex;
+	std::vector<Key>				vKeys;
+	bool							fLoaded;
+	std::unique_ptr<CThreadPool>	pool;
+	
+	bool TestKey(const Key& key, const secp256k1_pubkey& R, const Input& msg) const;
+	int MatchKeys(const Input& msg, bool fParallel) const;
+	void Wipe();
+
+public:
+	DecryptEngine();
+	~DecryptEngine();
+	
+	/** Reads receive-enabled addresses, requires ext_cs and an unlocked wallet. */
+	bool Load();
+	void Clear();
+	bool IsLoaded() const;
+	size_t Size() const;
+	
+	void StartThreads(int nThreads);
+	void StopThreads();
+	
+	Result Match(const Input& msg);
+	void MatchBatch(const std::vector<Input>& vMessages, std::vector<Result>& vResults);
+};
+
+} // namespace SMSG
+} // namespace DigitalNote
+
+#endif // SMSG_DECRYPTENGINE_H
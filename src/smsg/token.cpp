@@ -7,7 +7,7 @@ namespace SMSG {
 
 Token::Token()
 {
-	
+	nFile = 1;
 }
 
 Token::Token(int64_t ts, uint8_t* p, int np, long int o)
@@ -24,6 +24,7 @@ Token::Token(int64_t ts, uint8_t* p, int np, long int o)
 	}
 	
 	offset = o;
+	nFile = 1;
 }
 
 Token::~Token()
@@ -12,6 +12,7 @@ public:
     int64_t               timestamp;    // doesn't need to be full 64 bytes?
     uint8_t               sample[8];    // first 8 bytes of payload - a hash
     int64_t               offset;       // offset
+    uint32_t              nFile;        // data file number in the bucket, <bucket>_NN.dat
 	
 	Token();
 	Token(int64_t ts, uint8_t* p, int np, long int o);
@@ -13,6 +13,10 @@ const unsigned int SMSG_THREAD_LOG_GAP  = 6;
 const unsigned int SMSG_TIME_LEEWAY     = 60;
 const unsigned int SMSG_TIME_IGNORE     = 90;                // seconds that a peer is ignored for if they fail to deliver messages for a smsgWant
 const unsigned int SMSG_MAX_MSG_BYTES   = 4096;              // the user input part
+const unsigned int SMSG_SCAN_BATCH      = 256;               // messages trial-decrypted together when scanning buckets
+const unsigned int SMSG_MAX_FILE_SIZE   = 1 << 30;           // bucket data files are split before passing this size
+const unsigned int SMSG_MAX_MAPPED_FILES = 64;               // bucket data files kept mapped for Retrieve
+const unsigned int SMSG_SCAN_CHAIN_RANGE = 500;              // blocks scanned by one worker in ScanChainForPublicKeys
 
 // max size of payload worst case compression
 const unsigned int SMSG_MAX_MSG_WORST = LZ4_COMPRESSBOUND(SMSG_MAX_MSG_BYTES+SMSG_PL_HDR_LEN);
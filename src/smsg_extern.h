@@ -20,6 +20,8 @@ namespace DigitalNote
 		class Stored;
 		class Options;
 		class Bucket;
+		class DecryptEngine;
+		class BucketStore;
 		
 		// Extern
 		extern boost::thread_group							ext_thread_group;
@@ -30,6 +32,8 @@ namespace DigitalNote
 		extern CCriticalSection								ext_cs;            // all except inbox and outbox
 		extern CCriticalSection								ext_cs_db;
 		extern leveldb::DB*									ext_db;
+		extern DigitalNote::SMSG::DecryptEngine				ext_decrypt_engine;
+		extern DigitalNote::SMSG::BucketStore				ext_bucket_store;
 	} // namespace SMSG
 } // namespace DigitalNote
 
@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <string>
 #include <vector>
+#include <secp256k1.h>
 
 #include "types/ec_point.h"
 
@@ -35,6 +36,9 @@ T from_little_endian(Iterator in);
 void AppendChecksum(data_chunk& data);
 bool VerifyChecksum(const data_chunk& data);
 int GenerateRandomSecret(ec_secret& out);
+const secp256k1_context* GetStealthContext();
+int SerializeCompressed(const secp256k1_context* ctx, const secp256k1_pubkey& pubkey, ec_point& out);
+int StealthSharedSecret(const secp256k1_context* ctx, const ec_secret& secret, const secp256k1_pubkey& pubkey, ec_secret& sharedSOut);
 int SecretToPublicKey(const ec_secret& secret, ec_point& out);
 int StealthSecret(ec_secret& secret, ec_point& pubkey, const ec_point& pkSpend, ec_secret& sharedSOut, ec_point& pkOut);
 int StealthSecretSpend(ec_secret& scanSecret, ec_point& ephemPubkey, ec_secret& spendSecret, ec_secret& secretOut);
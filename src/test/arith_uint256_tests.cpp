@@ -0,0 +1,180 @@
+#include <boost/test/unit_test.hpp>
+
+#include "cbignum.h"
+#include "uint/arith_uint256.h"
+#include "uint/uint256.h"
+#include "util.h"
+
+BOOST_AUTO_TEST_SUITE(arith_uint256_tests)
+
+/** Random value of a random bit length */
+static uint256 RandomUint256()
+{
+	uint256 n;
+	for (unsigned char* p = n.begin(); p != n.end(); ++p)
+		*p = (unsigned char)(insecure_rand() & 0xff);
+	return n >> (insecure_rand() % 256);
+}
+
+/** Random compact value, mostly with an exponent that fits 256 bits */
+static uint32_t RandomCompact()
+{
+	uint32_t nSize = insecure_rand() % 40;
+	if (insecure_rand() % 16 == 0)
+		nSize = insecure_rand() % 256;
+	return (nSize << 24) | (insecure_rand() & 0x00ffffff);
+}
+
+/** Random value that can be a coin amount, up to 2^63 - 1 */
+static int64_t RandomValue()
+{
+	uint64_t n = ((uint64_t)insecure_rand() << 32) | insecure_rand();
+	return (int64_t)((n >> (insecure_rand() % 64)) & 0x7fffffffffffffffULL);
+}
+
+static const CBigNum bnMax(~uint256(0));
+
+BOOST_AUTO_TEST_CASE(arith_compact_matches_bignum)
+{
+	const uint32_t vCompacts[] = {0, 0x00123456, 0x01003456, 0x01123456, 0x02000056, 0x02123456, 0x03000000,
+			0x03123456, 0x04000000, 0x04923456, 0x04123456, 0x05009234, 0x20123456, 0xff123456,
+			0x1d00ffff, 0x1f03ffff, 0x1e0fffff, 0x01fedcba, 0x00800000, 0x01800000, 0x22000001, 0x23000001};
+
+	std::vector<uint32_t> vTests(vCompacts, vCompacts + sizeof(vCompacts) / sizeof(vCompacts[0]));
+	for (int i = 0; i < 20000; ++i)
+		vTests.push_back(RandomCompact());
+
+	for (uint32_t nCompact : vTests)
+	{
+		CBigNum bn;
+		bn.SetCompact(nCompact);
+
+		bool fNegative, fOverflow;
+		arith_uint256 n;
+		n.SetCompact(nCompact, &fNegative, &fOverflow);
+
+		BOOST_CHECK_EQUAL(fNegative, bn < 0);
+		BOOST_CHECK_EQUAL(fOverflow, bn > bnMax || bn < CBigNum(0) - bnMax);
+		if (fOverflow)
+			continue;
+
+		BOOST_CHECK(uint256(n) == bn.getuint256());
+		BOOST_CHECK_EQUAL(n.GetCompact(fNegative), bn.GetCompact());
+	}
+
+	// values to compact and back
+	for (int i = 0; i < 20000; ++i)
+	{
+		uint256 hash = RandomUint256();
+		arith_uint256 n(hash);
+		CBigNum bn(hash);
+
+		BOOST_CHECK_EQUAL(n.GetCompact(), bn.GetCompact());
+		BOOST_CHECK_EQUAL(n.GetCompact(true), (CBigNum(0) - bn).GetCompact());
+	}
+}
+
+BOOST_AUTO_TEST_CASE(arith_operators_match_bignum)
+{
+	for (int i = 0; i < 20000; ++i)
+	{
+		uint256 a = RandomUint256();
+		uint256 b = RandomUint256();
+		uint32_t n32 = insecure_rand();
+
+		// products are compared modulo 2^256, getuint256 keeps the low bits
+		BOOST_CHECK(uint256(arith_uint256(a) * arith_uint256(b)) == (CBigNum(a) * CBigNum(b)).getuint256());
+		BOOST_CHECK(uint256(arith_uint256(a) * n32) == (CBigNum(a) * CBigNum(n32)).getuint256());
+		if (b != 0)
+			BOOST_CHECK(uint256(arith_uint256(a) / arith_uint256(b)) == (CBigNum(a) / CBigNum(b)).getuint256());
+
+		unsigned int nBits = arith_uint256(a).bits();
+		BOOST_CHECK(nBits == 256 || (a >> nBits) == 0);
+		BOOST_CHECK(nBits == 0 || (a >> (nBits - 1)) == 1);
+	}
+
+	BOOST_CHECK_THROW(arith_uint256(1) / arith_uint256(0), arith_uint256_error);
+	BOOST_CHECK(uint256(~arith_uint256(0) / arith_uint256(1)) == ~uint256(0));
+	BOOST_CHECK(uint256(arith_uint256(0) / arith_uint256(7)) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(arith_block_trust_matches_bignum)
+{
+	for (int i = 0; i < 20000; ++i)
+	{
+		uint32_t nCompact = RandomCompact();
+
+		CBigNum bnTarget;
+		bnTarget.SetCompact(nCompact);
+		uint256 trustBig = bnTarget <= 0 ? uint256(0) : ((CBigNum(1) << 256) / (bnTarget + 1)).getuint256();
+
+		bool fNegative, fOverflow;
+		arith_uint256 target;
+		target.SetCompact(nCompact, &fNegative, &fOverflow);
+		uint256 trust = 0;
+		if (!fNegative && !fOverflow && target != 0)
+			trust = (~target / (target + 1)) + 1;
+
+		BOOST_CHECK(trust == trustBig);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(arith_weighted_target_matches_bignum)
+{
+	for (int i = 0; i < 20000; ++i)
+	{
+		uint32_t nCompact = RandomCompact() & ~0x00800000;
+		int64_t nValue = RandomValue();
+
+		CBigNum bnTarget;
+		bnTarget.SetCompact(nCompact);
+		bnTarget *= CBigNum(nValue);
+
+		bool fOverflow;
+		arith_uint256 target;
+		target.SetCompact(nCompact, NULL, &fOverflow);
+		if (fOverflow)
+		{
+			BOOST_CHECK(nValue == 0 || bnTarget > bnMax);
+			continue;
+		}
+
+		arith_uint256 product = target;
+		bool fFits = product.MulChecked(nValue);
+
+		BOOST_CHECK_EQUAL(!fFits, bnTarget > bnMax);
+		BOOST_CHECK(uint256(target * arith_uint256(nValue)) == bnTarget.getuint256());
+		if (fFits)
+			BOOST_CHECK(uint256(product) == bnTarget.getuint256());
+		else
+			BOOST_CHECK(product == target);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(arith_retarget_matches_bignum)
+{
+	const arith_uint256 limit = ~arith_uint256(0) >> 14;
+
+	for (int i = 0; i < 20000; ++i)
+	{
+		uint32_t nCompact = arith_uint256(RandomUint256() >> 14).GetCompact();
+		int64_t nFactor = 1 + insecure_rand() % 20000;
+
+		CBigNum bnNew;
+		bnNew.SetCompact(nCompact);
+		bnNew = bnNew / nFactor;
+		bnNew *= 10000;
+		if (bnNew > CBigNum(uint256(limit)))
+			bnNew = CBigNum(uint256(limit));
+
+		arith_uint256 target;
+		target.SetCompact(nCompact);
+		target /= arith_uint256(nFactor);
+		if (!target.MulChecked(10000) || target > limit)
+			target = limit;
+
+		BOOST_CHECK_EQUAL(target.GetCompact(), bnNew.GetCompact());
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,163 @@
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include "cblockindex.h"
+#include "cblockindexmap.h"
+#include "util.h"
+
+BOOST_AUTO_TEST_SUITE(blockindexmap_tests)
+
+static uint256 RandomHash()
+{
+	uint256 n;
+	for (unsigned char* p = n.begin(); p != n.end(); ++p)
+		*p = (unsigned char)(insecure_rand() & 0xff);
+	return n;
+}
+
+BOOST_AUTO_TEST_CASE(blockindexmap_matches_map)
+{
+	CBlockIndexMap mapIndex;
+	std::map<uint256, CBlockIndex*> mapRef;
+	std::vector<uint256> vKeys;
+
+	BOOST_CHECK(mapIndex.empty());
+	BOOST_CHECK(mapIndex.find(RandomHash()) == mapIndex.end());
+
+	for (int i = 0; i < 20000; ++i)
+	{
+		// mostly new keys, some repeated ones
+		uint256 hash = (vKeys.empty() || insecure_rand() % 4) ? RandomHash() : vKeys[insecure_rand() % vKeys.size()];
+		CBlockIndex* pindex = (CBlockIndex*)(size_t)(i + 1);
+
+		std::pair<CBlockIndexMap::iterator, bool> ret = mapIndex.insert(std::make_pair(hash, pindex));
+		bool fNew = mapRef.insert(std::make_pair(hash, pindex)).second;
+
+		BOOST_CHECK_EQUAL(ret.second, fNew);
+		BOOST_CHECK(ret.first->first == hash);
+		BOOST_CHECK(ret.first->second == mapRef[hash]);
+
+		if (fNew)
+			vKeys.push_back(hash);
+	}
+
+	BOOST_CHECK_EQUAL(mapIndex.size(), mapRef.size());
+
+	// iteration is in insertion order
+	size_t n = 0;
+	for (CBlockIndexMap::iterator mi = mapIndex.begin(); mi != mapIndex.end(); ++mi, ++n)
+		BOOST_CHECK(mi->first == vKeys[n]);
+
+	for (const uint256& hash : vKeys)
+	{
+		BOOST_CHECK_EQUAL(mapIndex.count(hash), 1U);
+		BOOST_CHECK(mapIndex.find(hash)->second == mapRef[hash]);
+		BOOST_CHECK(mapIndex[hash] == mapRef[hash]);
+	}
+
+	for (int i = 0; i < 1000; ++i)
+		BOOST_CHECK_EQUAL(mapIndex.count(RandomHash()), 0U);
+
+	// operator[] adds missing keys
+	uint256 hash = RandomHash();
+	BOOST_CHECK(mapIndex[hash] == NULL);
+	BOOST_CHECK_EQUAL(mapIndex.size(), mapRef.size() + 1);
+
+	mapIndex.clear();
+	BOOST_CHECK(mapIndex.empty());
+	BOOST_CHECK_EQUAL(mapIndex.count(hash), 0U);
+}
+
+BOOST_AUTO_TEST_CASE(blockindexmap_keys_stay_put)
+{
+	// phashBlock points at the key, growing the table must not move it
+	CBlockIndexMap mapIndex;
+	std::vector<const uint256*> vKeys;
+
+	for (int i = 0; i < 10000; ++i)
+		vKeys.push_back(&mapIndex.insert(std::make_pair(RandomHash(), (CBlockIndex*)NULL)).first->first);
+
+	for (CBlockIndexMap::iterator mi = mapIndex.begin(); mi != mapIndex.end(); ++mi)
+		BOOST_CHECK(&mi->first == vKeys[mi - mapIndex.begin()]);
+}
+
+BOOST_AUTO_TEST_CASE(blockindex_arena)
+{
+	// consecutive entries share chunks and start on a cache line
+	std::vector<CBlockIndex*> vIndex;
+	for (int i = 0; i < 10000; ++i)
+		vIndex.push_back(new CBlockIndex());
+
+	size_t nAdjacent = 0;
+	for (size_t i = 0; i < vIndex.size(); ++i)
+	{
+		BOOST_CHECK_EQUAL((size_t)vIndex[i] % 64, 0U);
+		BOOST_CHECK(vIndex[i]->pprev == NULL && vIndex[i]->nHeight == 0);
+		if (i > 0 && (char*)vIndex[i] - (char*)vIndex[i - 1] == (sizeof(CBlockIndex) + 63) / 64 * 64)
+			nAdjacent++;
+	}
+
+	BOOST_CHECK(nAdjacent >= vIndex.size() - 5);
+}
+
+BOOST_AUTO_TEST_CASE(blockindexmap_benchmark, *boost::unit_test::disabled())
+{
+	const size_t nBlocks = 500000;
+	const size_t nLookups = 2000000;
+
+	std::vector<uint256> vKeys;
+	for (size_t i = 0; i < nBlocks; ++i)
+		vKeys.push_back(RandomHash());
+
+	std::vector<uint256> vLookups;
+	for (size_t i = 0; i < nLookups; ++i)
+		vLookups.push_back(vKeys[insecure_rand() % nBlocks]);
+
+	std::map<uint256, CBlockIndex*> mapRef;
+	CBlockIndexMap mapIndex;
+
+	int64_t nStart = GetTimeMicros();
+	for (const uint256& hash : vKeys)
+		mapRef.insert(std::make_pair(hash, (CBlockIndex*)NULL));
+	int64_t nElapsed = std::max<int64_t>(GetTimeMicros() - nStart, 1);
+
+	BOOST_TEST_MESSAGE(strprintf("std::map insert: %.0f ns/entry", nElapsed * 1000.0 / nBlocks));
+
+	nStart = GetTimeMicros();
+	for (const uint256& hash : vKeys)
+		mapIndex.insert(std::make_pair(hash, (CBlockIndex*)NULL));
+	nElapsed = std::max<int64_t>(GetTimeMicros() - nStart, 1);
+
+	BOOST_TEST_MESSAGE(strprintf("CBlockIndexMap insert: %.0f ns/entry", nElapsed * 1000.0 / nBlocks));
+
+	size_t nFound = 0;
+	nStart = GetTimeMicros();
+	for (const uint256& hash : vLookups)
+		nFound += mapRef.count(hash);
+	nElapsed = std::max<int64_t>(GetTimeMicros() - nStart, 1);
+
+	BOOST_TEST_MESSAGE(strprintf("std::map lookup: %.0f ns", nElapsed * 1000.0 / nLookups));
+
+	nStart = GetTimeMicros();
+	for (const uint256& hash : vLookups)
+		nFound -= mapIndex.count(hash);
+	nElapsed = std::max<int64_t>(GetTimeMicros() - nStart, 1);
+
+	BOOST_TEST_MESSAGE(strprintf("CBlockIndexMap lookup: %.0f ns", nElapsed * 1000.0 / nLookups));
+	BOOST_CHECK_EQUAL(nFound, 0U);
+
+	// a red-black tree node is three pointers and a colour ahead of the
+	// value, each node and each CBlockIndex is a heap block with at least
+	// 8 bytes of malloc header
+	size_t nMapEntry = (32 + sizeof(CBlockIndexMap::value_type) + 15) / 16 * 16;
+	size_t nIndexEntry = (sizeof(CBlockIndex) + 8 + 15) / 16 * 16;
+
+	BOOST_TEST_MESSAGE(strprintf("memory per entry, std::map and new: %u + %u bytes", nMapEntry, nIndexEntry));
+	BOOST_TEST_MESSAGE(strprintf("memory per entry, CBlockIndexMap and arena: %.1f + %u bytes",
+			(double)mapIndex.MemoryUsage() / nBlocks, (sizeof(CBlockIndex) + 63) / 64 * 64));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
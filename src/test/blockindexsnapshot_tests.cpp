@@ -0,0 +1,151 @@
+#include <boost/test/unit_test.hpp>
+
+#include <cstring>
+#include <vector>
+
+#include "chash256.h"
+#include "cblockindex.h"
+#include "cblockindexmap.h"
+#include "cblockindexsnapshot.h"
+#include "util.h"
+
+BOOST_AUTO_TEST_SUITE(blockindexsnapshot_tests)
+
+static uint256 RandomHash()
+{
+	uint256 n;
+	for (unsigned char* p = n.begin(); p != n.end(); ++p)
+		*p = (unsigned char)(insecure_rand() & 0xff);
+	return n;
+}
+
+/** A main chain of nBlocks with a short fork every 50 blocks */
+static void MakeIndex(size_t nBlocks, CBlockIndexMap& mapIndex, uint256& hashBest)
+{
+	CBlockIndex* pindexPrev = NULL;
+
+	for (size_t i = 0; i < nBlocks; ++i)
+	{
+		CBlockIndex* pindex = new CBlockIndex();
+		pindex->pprev = pindexPrev;
+		pindex->nFile = 1;
+		pindex->nBlockPos = insecure_rand();
+		pindex->nHeight = i;
+		pindex->nMint = ((int64_t)insecure_rand() << 16) | insecure_rand();
+		pindex->nMoneySupply = -((int64_t)insecure_rand() << 20);
+		pindex->nFlags = insecure_rand() & 7;
+		pindex->nStakeModifier = ((uint64_t)insecure_rand() << 32) | insecure_rand();
+		pindex->bnStakeModifierV2 = RandomHash();
+		pindex->prevoutStake = COutPoint(RandomHash(), insecure_rand() % 10);
+		pindex->nStakeTime = insecure_rand();
+		pindex->hashProof = RandomHash();
+		pindex->nVersion = 7;
+		pindex->hashMerkleRoot = RandomHash();
+		pindex->nTime = insecure_rand();
+		pindex->nBits = insecure_rand();
+		pindex->nNonce = insecure_rand();
+		pindex->nChainTrust = RandomHash();
+
+		// every 50th block is a stale fork off the previous one
+		bool fFork = i % 50 == 49;
+		if (pindexPrev && !fFork)
+			pindexPrev->pnext = pindex;
+
+		CBlockIndexMap::iterator mi = mapIndex.insert(std::make_pair(RandomHash(), pindex)).first;
+		pindex->phashBlock = &((*mi).first);
+
+		if (!fFork)
+		{
+			pindexPrev = pindex;
+			hashBest = mi->first;
+		}
+	}
+}
+
+static bool SameIndex(const CBlockIndex* a, const CBlockIndex* b)
+{
+	return a->GetBlockHash() == b->GetBlockHash() &&
+		(a->pprev ? a->pprev->GetBlockHash() : 0) == (b->pprev ? b->pprev->GetBlockHash() : 0) &&
+		(a->pnext ? a->pnext->GetBlockHash() : 0) == (b->pnext ? b->pnext->GetBlockHash() : 0) &&
+		a->nFile == b->nFile && a->nBlockPos == b->nBlockPos && a->nHeight == b->nHeight &&
+		a->nMint == b->nMint && a->nMoneySupply == b->nMoneySupply && a->nFlags == b->nFlags &&
+		a->nStakeModifier == b->nStakeModifier && a->bnStakeModifierV2 == b->bnStakeModifierV2 &&
+		a->prevoutStake == b->prevoutStake && a->nStakeTime == b->nStakeTime && a->hashProof == b->hashProof &&
+		a->nVersion == b->nVersion && a->hashMerkleRoot == b->hashMerkleRoot && a->nTime == b->nTime &&
+		a->nBits == b->nBits && a->nNonce == b->nNonce && a->nChainTrust == b->nChainTrust;
+}
+
+BOOST_AUTO_TEST_CASE(snapshot_roundtrip)
+{
+	CBlockIndexMap mapIndex;
+	uint256 hashBest;
+	MakeIndex(1000, mapIndex, hashBest);
+
+	std::vector<unsigned char> vchData;
+	CBlockIndexSnapshot::Serialize(mapIndex, hashBest, 42, vchData);
+	BOOST_CHECK_EQUAL(vchData.size(), 64 + 1000 * CBlockIndexSnapshot::RECORD_SIZE + 32);
+
+	CBlockIndexMap mapLoaded;
+	BOOST_CHECK_EQUAL(CBlockIndexSnapshot::Deserialize(vchData, hashBest, 42, mapLoaded), CBlockIndexSnapshot::Ok);
+	BOOST_CHECK_EQUAL(mapLoaded.size(), mapIndex.size());
+
+	for (CBlockIndexMap::iterator mi = mapIndex.begin(); mi != mapIndex.end(); ++mi)
+	{
+		BOOST_CHECK(mapLoaded.count(mi->first));
+		BOOST_CHECK(SameIndex(mi->second, mapLoaded[mi->first]));
+	}
+
+	// the map can be loaded only into an empty map
+	BOOST_CHECK_EQUAL(CBlockIndexSnapshot::Deserialize(vchData, hashBest, 42, mapLoaded), CBlockIndexSnapshot::IncorrectFormat);
+}
+
+BOOST_AUTO_TEST_CASE(snapshot_rejected)
+{
+	CBlockIndexMap mapIndex;
+	uint256 hashBest;
+	MakeIndex(100, mapIndex, hashBest);
+
+	std::vector<unsigned char> vchData;
+	CBlockIndexSnapshot::Serialize(mapIndex, hashBest, 42, vchData);
+
+	CBlockIndexMap mapLoaded;
+
+	// taken at another best block or by another shutdown
+	BOOST_CHECK_EQUAL(CBlockIndexSnapshot::Deserialize(vchData, RandomHash(), 42, mapLoaded), CBlockIndexSnapshot::Stale);
+	BOOST_CHECK_EQUAL(CBlockIndexSnapshot::Deserialize(vchData, hashBest, 43, mapLoaded), CBlockIndexSnapshot::Stale);
+
+	// a flipped bit anywhere
+	for (int i = 0; i < 100; ++i)
+	{
+		std::vector<unsigned char> vchBad(vchData);
+		vchBad[insecure_rand() % vchBad.size()] ^= 1 << (insecure_rand() % 8);
+		BOOST_CHECK_EQUAL(CBlockIndexSnapshot::Deserialize(vchBad, hashBest, 42, mapLoaded), CBlockIndexSnapshot::IncorrectHash);
+	}
+
+	// truncated
+	std::vector<unsigned char> vchShort(vchData.begin(), vchData.begin() + 50);
+	BOOST_CHECK_EQUAL(CBlockIndexSnapshot::Deserialize(vchShort, hashBest, 42, mapLoaded), CBlockIndexSnapshot::IncorrectFormat);
+
+	BOOST_CHECK(mapLoaded.empty());
+}
+
+BOOST_AUTO_TEST_CASE(snapshot_duplicate_hash)
+{
+	CBlockIndexMap mapIndex;
+	uint256 hashBest;
+	MakeIndex(10, mapIndex, hashBest);
+
+	std::vector<unsigned char> vchData;
+	CBlockIndexSnapshot::Serialize(mapIndex, hashBest, 42, vchData);
+
+	// the last record gets the hash of the first, with a checksum that matches
+	size_t nRecords = vchData.size() - 64 - 32;
+	memcpy(&vchData[64 + nRecords - CBlockIndexSnapshot::RECORD_SIZE], &vchData[64], 32);
+	CHash256().Write(&vchData[0], vchData.size() - 32).Finalize(&vchData[vchData.size() - 32]);
+
+	CBlockIndexMap mapLoaded;
+	BOOST_CHECK_EQUAL(CBlockIndexSnapshot::Deserialize(vchData, hashBest, 42, mapLoaded), CBlockIndexSnapshot::IncorrectFormat);
+	BOOST_CHECK(mapLoaded.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,124 @@
+#include <boost/test/unit_test.hpp>
+
+#include <cstring>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "crypto/bmw/bmw512.h"
+#include "crypto/common/common.h"
+#include "util.h"
+
+BOOST_AUTO_TEST_SUITE(bmw512_tests)
+
+static const char* vImplementations[] = {"generic", "sse4.1", "avx2"};
+
+static void RandomHeaders(std::vector<unsigned char>& vHeaders, size_t nCount)
+{
+    vHeaders.resize(80 * nCount);
+    for (size_t i = 0; i < vHeaders.size(); ++i)
+        vHeaders[i] = (unsigned char)(insecure_rand() & 0xff);
+}
+
+BOOST_AUTO_TEST_CASE(bmw512_80_vectors)
+{
+    unsigned char header[80];
+
+    memset(header, 0, sizeof(header));
+    BOOST_CHECK(Hash_bmw512_80(header) == uint256("0x59e822bed5157e522f0dd5dc70b8544e4056797b1798051ce08e185397eca176"));
+
+    for (int i = 0; i < 80; ++i)
+        header[i] = i;
+    BOOST_CHECK(Hash_bmw512_80(header) == uint256("0x5bbb4acdb22c3b30106f16f73c90801edb82f975b7bca5d86a5c5ec4de0cd9c2"));
+
+    memset(header, 0xff, sizeof(header));
+    BOOST_CHECK(Hash_bmw512_80(header) == uint256("0x31ccb17bc60bef78a33ae6ecedf2cb06e4f2d02c58fc55c55ed34ffef5327295"));
+
+    // mainnet genesis block header
+    uint256 hashMerkleRoot("0x3b9d152cb1370d54d1ea30d5e334a83a41ca9403011495b8743a53d53423004a");
+    memset(header, 0, sizeof(header));
+    WriteLE32(header, 1);
+    memcpy(header + 36, hashMerkleRoot.begin(), 32);
+    WriteLE32(header + 68, 1547848800);
+    WriteLE32(header + 72, 0x1f03ffff);
+    WriteLE32(header + 76, 14180);
+    BOOST_CHECK(Hash_bmw512_80(header) == uint256("0x00000d8e7d39218c4c02132e95a3896d46939b9b95624cf9dd2b0b794e6c216a"));
+}
+
+BOOST_AUTO_TEST_CASE(bmw512_80_matches_sph)
+{
+    std::vector<unsigned char> vHeaders;
+    RandomHeaders(vHeaders, 67);
+
+    std::vector<uint256> vExpected(67);
+    for (size_t i = 0; i < vExpected.size(); ++i)
+    {
+        const unsigned char* p = &vHeaders[80 * i];
+        vExpected[i] = Hash_bmw512(p, p + 80);
+        BOOST_CHECK(Hash_bmw512_80(p) == vExpected[i]);
+    }
+
+    for (const char* pszName : vImplementations)
+    {
+        if (!BMW512SelectImplementation(pszName))
+        {
+            BOOST_TEST_MESSAGE(strprintf("bmw512 %s not supported by this CPU", pszName));
+            continue;
+        }
+
+        BOOST_CHECK_EQUAL(BMW512Implementation(), pszName);
+
+        // every count up to 67, so each kernel width and remainder is used
+        for (size_t nCount = 0; nCount <= vExpected.size(); ++nCount)
+        {
+            std::vector<uint256> vHashes(nCount);
+            if (nCount > 0)
+                Hash_bmw512_80(&vHeaders[0], nCount, &vHashes[0]);
+            BOOST_CHECK(std::equal(vHashes.begin(), vHashes.end(), vExpected.begin()));
+        }
+
+        uint256 hashes[8];
+        Hash_bmw512_80x4(&vHeaders[0], hashes);
+        BOOST_CHECK(std::equal(hashes, hashes + 4, vExpected.begin()));
+        Hash_bmw512_80x8(&vHeaders[80], hashes);
+        BOOST_CHECK(std::equal(hashes, hashes + 8, vExpected.begin() + 1));
+    }
+
+    BOOST_CHECK(!BMW512SelectImplementation("none"));
+    BOOST_CHECK(BMW512SelectImplementation(""));
+}
+
+BOOST_AUTO_TEST_CASE(bmw512_80_benchmark, *boost::unit_test::disabled())
+{
+    const size_t nCount = 1024;
+    const int nRounds = 100;
+
+    std::vector<unsigned char> vHeaders;
+    RandomHeaders(vHeaders, nCount);
+    std::vector<uint256> vHashes(nCount);
+
+    int64_t nStart = GetTimeMicros();
+    for (int r = 0; r < nRounds; ++r)
+        for (size_t i = 0; i < nCount; ++i)
+            vHashes[i] = Hash_bmw512(&vHeaders[80 * i], &vHeaders[80 * i] + 80);
+    int64_t nElapsed = std::max<int64_t>(GetTimeMicros() - nStart, 1);
+
+    BOOST_TEST_MESSAGE(strprintf("bmw512 sph: %.0f headers/s", nCount * nRounds * 1000000.0 / nElapsed));
+
+    for (const char* pszName : vImplementations)
+    {
+        if (!BMW512SelectImplementation(pszName))
+            continue;
+
+        nStart = GetTimeMicros();
+        for (int r = 0; r < nRounds; ++r)
+            Hash_bmw512_80(&vHeaders[0], nCount, &vHashes[0]);
+        nElapsed = std::max<int64_t>(GetTimeMicros() - nStart, 1);
+
+        BOOST_TEST_MESSAGE(strprintf("bmw512 %s: %.0f headers/s", pszName, nCount * nRounds * 1000000.0 / nElapsed));
+    }
+
+    BMW512SelectImplementation("");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
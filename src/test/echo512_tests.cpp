@@ -0,0 +1,144 @@
+#include <boost/test/unit_test.hpp>
+
+#include <cstring>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "crypto/common/common.h"
+#include "crypto/echo/echo512.h"
+#include "util.h"
+
+BOOST_AUTO_TEST_SUITE(echo512_tests)
+
+static const char* vImplementations[] = {"generic", "aesni"};
+
+static uint256 SphEcho512(const unsigned char* p, size_t len)
+{
+    sph_echo512_context ctx;
+    uint512 hash;
+
+    sph_echo512_init(&ctx);
+    sph_echo512(&ctx, p, len);
+    sph_echo512_close(&ctx, &hash);
+
+    return hash.trim256();
+}
+
+static void RandomBytes(unsigned char* p, size_t len)
+{
+    for (size_t i = 0; i < len; ++i)
+        p[i] = (unsigned char)(insecure_rand() & 0xff);
+}
+
+BOOST_AUTO_TEST_CASE(echo512_vectors)
+{
+    const std::string strFox = "The quick brown fox jumps over the lazy dog";
+    unsigned char zero[128];
+    memset(zero, 0, sizeof(zero));
+
+    for (const char* pszName : vImplementations)
+    {
+        if (!Echo512SelectImplementation(pszName))
+        {
+            BOOST_TEST_MESSAGE(strprintf("echo512 %s not supported by this CPU", pszName));
+            continue;
+        }
+
+        BOOST_CHECK_EQUAL(Echo512Implementation(), pszName);
+        BOOST_CHECK(Hash_echo512(zero, zero) == uint256("0x02a7f4ae9fdd4bc40e6d7231b98aa251d0759204152529aaa900d379cc588f15"));
+        BOOST_CHECK(Hash_echo512(zero, zero + 76) == uint256("0x161f68a940c3df3cf69b5b99059b32c761e8f2d4000a1da3ead06edddcb0d85a"));
+        BOOST_CHECK(Hash_echo512(zero, zero + 128) == uint256("0xecdb66418caf30cfd78a0738665a7f2325f75800d67e630772d34b89f158c18a"));
+        BOOST_CHECK(Hash_echo512(strFox.begin(), strFox.end()) == uint256("0x50d71ae7767c18a7b4d7969544970b90cb3f885f4ad4de27a0cadf7ba9eb61fe"));
+    }
+
+    BOOST_CHECK(!Echo512SelectImplementation("none"));
+    BOOST_CHECK(Echo512SelectImplementation(""));
+}
+
+BOOST_AUTO_TEST_CASE(echo512_matches_sph)
+{
+    std::vector<unsigned char> vData(600);
+    RandomBytes(&vData[0], vData.size());
+
+    for (const char* pszName : vImplementations)
+    {
+        if (!Echo512SelectImplementation(pszName))
+            continue;
+
+        // every length up to several blocks, including the ones where the
+        // padding does not fit the last block
+        for (size_t nLen = 0; nLen <= vData.size(); ++nLen)
+            BOOST_CHECK(Hash_echo512_bytes(&vData[0], nLen) == SphEcho512(&vData[0], nLen));
+    }
+
+    Echo512SelectImplementation("");
+}
+
+BOOST_AUTO_TEST_CASE(echo512_kernel_matches_sph)
+{
+    const uint32_t vTimes[] = {0, 1, 1547848800, 0xffffffff};
+
+    for (const char* pszName : vImplementations)
+    {
+        if (!Echo512SelectImplementation(pszName))
+            continue;
+
+        for (int i = 0; i < 50; ++i)
+        {
+            unsigned char data[CEcho512Kernel::PREFIX_SIZE + 4];
+            RandomBytes(data, CEcho512Kernel::PREFIX_SIZE);
+
+            CEcho512Kernel kernel;
+            kernel.Init(data);
+
+            for (uint32_t nTimeTx : vTimes)
+            {
+                WriteLE32(data + CEcho512Kernel::PREFIX_SIZE, nTimeTx);
+                BOOST_CHECK(kernel.Hash(nTimeTx) == SphEcho512(data, sizeof(data)));
+            }
+        }
+    }
+
+    Echo512SelectImplementation("");
+}
+
+BOOST_AUTO_TEST_CASE(echo512_kernel_benchmark, *boost::unit_test::disabled())
+{
+    const uint32_t nKernels = 100000;
+    unsigned char prefix[CEcho512Kernel::PREFIX_SIZE];
+    RandomBytes(prefix, sizeof(prefix));
+
+    uint256 hashSum;
+    int64_t nStart = GetTimeMicros();
+    for (uint32_t n = 0; n < nKernels; ++n)
+    {
+        unsigned char data[CEcho512Kernel::PREFIX_SIZE + 4];
+        memcpy(data, prefix, sizeof(prefix));
+        WriteLE32(data + CEcho512Kernel::PREFIX_SIZE, n);
+        hashSum ^= SphEcho512(data, sizeof(data));
+    }
+    int64_t nElapsed = std::max<int64_t>(GetTimeMicros() - nStart, 1);
+
+    BOOST_TEST_MESSAGE(strprintf("echo512 kernel sph: %.0f kernels/s", nKernels * 1000000.0 / nElapsed));
+
+    for (const char* pszName : vImplementations)
+    {
+        if (!Echo512SelectImplementation(pszName))
+            continue;
+
+        CEcho512Kernel kernel;
+        kernel.Init(prefix);
+
+        nStart = GetTimeMicros();
+        for (uint32_t n = 0; n < nKernels; ++n)
+            hashSum ^= kernel.Hash(n);
+        nElapsed = std::max<int64_t>(GetTimeMicros() - nStart, 1);
+
+        BOOST_TEST_MESSAGE(strprintf("echo512 kernel %s: %.0f kernels/s", pszName, nKernels * 1000000.0 / nElapsed));
+    }
+
+    Echo512SelectImplementation("");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
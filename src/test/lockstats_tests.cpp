@@ -0,0 +1,152 @@
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <boost/thread.hpp>
+
+#include "thread.h"
+#include "thread/clocksite.h"
+#include "thread/clockstats.h"
+#include "types/ccriticalsection.h"
+
+BOOST_AUTO_TEST_SUITE(lockstats_tests)
+
+static const CLockSite* FindSite(const std::string& strName)
+{
+	for (const CLockSite* pSite : lockStats.GetSites())
+	{
+		if (pSite->strName == strName)
+		{
+			return pSite;
+		}
+	}
+
+	return NULL;
+}
+
+BOOST_AUTO_TEST_CASE(histogram_buckets)
+{
+	BOOST_CHECK_EQUAL(CLockSite::Bucket(0), 0);
+	BOOST_CHECK_EQUAL(CLockSite::Bucket(1), 1);
+	BOOST_CHECK_EQUAL(CLockSite::Bucket(2), 2);
+	BOOST_CHECK_EQUAL(CLockSite::Bucket(3), 2);
+	BOOST_CHECK_EQUAL(CLockSite::Bucket(4), 3);
+	BOOST_CHECK_EQUAL(CLockSite::Bucket(1023), 10);
+	BOOST_CHECK_EQUAL(CLockSite::Bucket(1024), 11);
+	BOOST_CHECK_EQUAL(CLockSite::Bucket(INT64_MAX), CLockSite::HISTOGRAM_BUCKETS - 1);
+}
+
+BOOST_AUTO_TEST_CASE(site_counts)
+{
+	CLockSite site("cs_test", "test.cpp", 1);
+
+	site.RecordLock(0, false);
+	site.RecordLock(5, true);
+	site.RecordLock(100, true);
+	site.RecordHold(3);
+	site.RecordHold(40);
+	site.RecordTryFailed();
+
+	CLockSite::Counts counts = site.GetCounts();
+
+	BOOST_CHECK_EQUAL(counts.nLocks, 3U);
+	BOOST_CHECK_EQUAL(counts.nContended, 2U);
+	BOOST_CHECK_EQUAL(counts.nTryFailed, 1U);
+	BOOST_CHECK_EQUAL(counts.nWaitMicros, 105U);
+	BOOST_CHECK_EQUAL(counts.nMaxWaitMicros, 100U);
+	BOOST_CHECK_EQUAL(counts.nHoldMicros, 43U);
+	BOOST_CHECK_EQUAL(counts.nMaxHoldMicros, 40U);
+	BOOST_CHECK_EQUAL(counts.vWaitHistogram[0], 1U);
+	BOOST_CHECK_EQUAL(counts.vWaitHistogram[CLockSite::Bucket(5)], 1U);
+	BOOST_CHECK_EQUAL(counts.vHoldHistogram[CLockSite::Bucket(40)], 1U);
+
+	CLockSite::Counts total;
+
+	total.Add(counts);
+	total.Add(counts);
+
+	BOOST_CHECK_EQUAL(total.nLocks, 6U);
+	BOOST_CHECK_EQUAL(total.nMaxWaitMicros, 100U);
+	BOOST_CHECK_EQUAL(total.vWaitHistogram[0], 2U);
+}
+
+BOOST_AUTO_TEST_CASE(locks_are_recorded)
+{
+	CCriticalSection cs_lockstats_a;
+	CCriticalSection cs_lockstats_b;
+
+	fLockStats = true;
+
+	for (int i = 0; i < 10; i++)
+	{
+		LOCK(cs_lockstats_a);
+	}
+
+	{
+		boost::unique_lock<boost::recursive_mutex> held(cs_lockstats_b);
+		boost::thread thread([&cs_lockstats_b]()
+		{
+			TRY_LOCK(cs_lockstats_b, lockB);
+		});
+
+		thread.join();
+	}
+
+	fLockStats = false;
+
+	// taken while stats were off, not counted
+	{
+		LOCK(cs_lockstats_a);
+	}
+
+	const CLockSite* pSiteA = FindSite("cs_lockstats_a");
+	const CLockSite* pSiteB = FindSite("cs_lockstats_b");
+
+	BOOST_REQUIRE(pSiteA != NULL);
+	BOOST_REQUIRE(pSiteB != NULL);
+	BOOST_CHECK_EQUAL(pSiteA->GetCounts().nLocks, 10U);
+	BOOST_CHECK_EQUAL(pSiteA->GetCounts().nContended, 0U);
+	BOOST_CHECK_EQUAL(pSiteB->GetCounts().nLocks, 0U);
+	BOOST_CHECK_EQUAL(pSiteB->GetCounts().nTryFailed, 1U);
+}
+
+BOOST_AUTO_TEST_CASE(recursive_hold_counted_once)
+{
+	CCriticalSection cs_lockstats_r;
+
+	fLockStats = true;
+
+	{
+		LOCK(cs_lockstats_r);
+		LOCK2(cs_lockstats_r, cs_lockstats_r);
+		TRY_LOCK(cs_lockstats_r, lockR);
+		bool fLocked = lockR;
+
+		BOOST_CHECK(fLocked);
+	}
+
+	fLockStats = false;
+
+	CLockSite::Counts total;
+
+	for (const CLockSite* pSite : lockStats.GetSites())
+	{
+		if (pSite->strName == "cs_lockstats_r")
+		{
+			total.Add(pSite->GetCounts());
+		}
+	}
+
+	uint64_t nHolds = 0;
+
+	for (int i = 0; i < CLockSite::HISTOGRAM_BUCKETS; i++)
+	{
+		nHolds += total.vHoldHistogram[i];
+	}
+
+	BOOST_CHECK_EQUAL(total.nLocks, 4U);
+	BOOST_CHECK_EQUAL(nHolds, 1U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,263 @@
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include "prevector.h"
+#include "cscript.h"
+#include "cblock.h"
+#include "ctransaction.h"
+#include "ctxin.h"
+#include "ctxout.h"
+#include "cdatastream.h"
+#include "enums/serialize_type.h"
+#include "serialize.h"
+#include "version.h"
+#include "util.h"
+
+// operator new calls, prevector itself allocates with malloc
+static std::atomic<size_t> nNewCalls(0);
+
+void* operator new(size_t n)
+{
+	nNewCalls++;
+
+	void* p = malloc(n ? n : 1);
+	if (!p)
+		throw std::bad_alloc();
+	return p;
+}
+
+void operator delete(void* p) noexcept
+{
+	free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+	free(p);
+}
+
+BOOST_AUTO_TEST_SUITE(prevector_tests)
+
+typedef prevector<28, unsigned char> prevec;
+
+static void CheckSame(const prevec& p, const std::vector<unsigned char>& v)
+{
+	BOOST_REQUIRE_EQUAL(p.size(), v.size());
+	BOOST_CHECK(p.capacity() >= p.size());
+	BOOST_CHECK_EQUAL(p.allocated_memory() == 0, p.capacity() == 28);
+	for (size_t i = 0; i < v.size(); ++i)
+		BOOST_REQUIRE_EQUAL(p[i], v[i]);
+	BOOST_CHECK(std::vector<unsigned char>(p.begin(), p.end()) == v);
+}
+
+BOOST_AUTO_TEST_CASE(prevector_matches_vector)
+{
+	for (int nRun = 0; nRun < 50; ++nRun)
+	{
+		prevec p;
+		std::vector<unsigned char> v;
+
+		for (int i = 0; i < 2000; ++i)
+		{
+			unsigned char c = insecure_rand() & 0xff;
+			size_t nPos = v.empty() ? 0 : insecure_rand() % (v.size() + 1);
+
+			switch (insecure_rand() % 12)
+			{
+			case 0: case 1: case 2:
+				p.push_back(c);
+				v.push_back(c);
+				break;
+			case 3:
+				p.insert(p.begin() + nPos, c);
+				v.insert(v.begin() + nPos, c);
+				break;
+			case 4:
+			{
+				std::vector<unsigned char> vIns(insecure_rand() % 40, c);
+				p.insert(p.begin() + nPos, vIns.begin(), vIns.end());
+				v.insert(v.begin() + nPos, vIns.begin(), vIns.end());
+				break;
+			}
+			case 5:
+			{
+				size_t nCount = insecure_rand() % 5;
+				p.insert(p.begin() + nPos, nCount, c);
+				v.insert(v.begin() + nPos, nCount, c);
+				break;
+			}
+			case 6:
+				if (nPos < v.size())
+				{
+					size_t nEnd = nPos + insecure_rand() % (v.size() - nPos + 1);
+					p.erase(p.begin() + nPos, p.begin() + nEnd);
+					v.erase(v.begin() + nPos, v.begin() + nEnd);
+				}
+				break;
+			case 7:
+			{
+				size_t nSize = insecure_rand() % 80;
+				p.resize(nSize);
+				v.resize(nSize);
+				break;
+			}
+			case 8:
+				if (!v.empty())
+				{
+					p.pop_back();
+					v.pop_back();
+				}
+				break;
+			case 9:
+				if (insecure_rand() % 2)
+					p.shrink_to_fit();
+				else
+					p.reserve(insecure_rand() % 100);
+				break;
+			case 10:
+			{
+				// copies, moves and swaps go through the same storage
+				prevec pCopy(p);
+				prevec pOther(v.begin(), v.begin() + nPos);
+				pCopy.swap(pOther);
+				CheckSame(pOther, v);
+				p = std::move(pOther);
+				break;
+			}
+			case 11:
+				if (!v.empty())
+				{
+					// an element of the vector itself
+					p.insert(p.begin() + nPos, p[0]);
+					v.insert(v.begin() + nPos, v[0]);
+				}
+				break;
+			}
+
+			CheckSame(p, v);
+		}
+
+		prevec pSame(v.begin(), v.end());
+		BOOST_CHECK(pSame == p);
+		BOOST_CHECK(!(pSame != p));
+		BOOST_CHECK(!(pSame < p) && !(p < pSame));
+
+		p.clear();
+		BOOST_CHECK(p.empty());
+	}
+}
+
+BOOST_AUTO_TEST_CASE(prevector_order)
+{
+	// same order as std::vector, scripts are map keys
+	for (int i = 0; i < 10000; ++i)
+	{
+		std::vector<unsigned char> a(insecure_rand() % 40, insecure_rand() % 3);
+		std::vector<unsigned char> b(insecure_rand() % 40, insecure_rand() % 3);
+
+		BOOST_CHECK_EQUAL(prevec(a.begin(), a.end()) < prevec(b.begin(), b.end()), a < b);
+		BOOST_CHECK_EQUAL(prevec(a.begin(), a.end()) == prevec(b.begin(), b.end()), a == b);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(script_serialize_format)
+{
+	// the same bytes as the std::vector it replaces, on either side of the
+	// inline size and past the 5 MB read chunk
+	size_t nSizes[] = { 0, 1, 25, 28, 29, 107, 252, 253, 65536, 5000001 };
+
+	for (size_t nSize : nSizes)
+	{
+		std::vector<unsigned char> v(nSize);
+		for (size_t i = 0; i < nSize; ++i)
+			v[i] = insecure_rand() & 0xff;
+
+		CScript script(v.begin(), v.end());
+
+		CDataStream ssVector(SER_NETWORK, PROTOCOL_VERSION);
+		ssVector << v;
+		CDataStream ssScript(SER_NETWORK, PROTOCOL_VERSION);
+		ssScript << script;
+
+		BOOST_CHECK(ssScript.str() == ssVector.str());
+		BOOST_CHECK_EQUAL(::GetSerializeSize(script, SER_NETWORK, PROTOCOL_VERSION), ssVector.size());
+
+		CScript scriptRead;
+		ssVector >> scriptRead;
+		BOOST_CHECK(scriptRead == script);
+		BOOST_CHECK_EQUAL(scriptRead.allocated_memory() == 0, nSize <= 28);
+	}
+
+	BOOST_CHECK_EQUAL(sizeof(CScript), 32U);
+}
+
+/** A block of nTx transactions spending two P2PKH outputs each to two P2PKH outputs */
+static CBlock MakeBlock(int nTx)
+{
+	CBlock block;
+
+	for (int i = 0; i < nTx; ++i)
+	{
+		CTransaction tx;
+
+		for (int j = 0; j < 2; ++j)
+		{
+			// DER signature and compressed public key
+			std::vector<unsigned char> vchSig(72, insecure_rand() & 0xff);
+			std::vector<unsigned char> vchPubKey(33, insecure_rand() & 0xff);
+			tx.vin.push_back(CTxIn(uint256(insecure_rand()), j, CScript() << vchSig << vchPubKey));
+
+			std::vector<unsigned char> vchHash(20, insecure_rand() & 0xff);
+			tx.vout.push_back(CTxOut(insecure_rand(), CScript() << OP_DUP << OP_HASH160 << vchHash << OP_EQUALVERIFY << OP_CHECKSIG));
+		}
+
+		block.vtx.push_back(tx);
+	}
+
+	return block;
+}
+
+BOOST_AUTO_TEST_CASE(block_deserialize_allocations)
+{
+	const int nTx = 2000;
+
+	CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+	ss << MakeBlock(nTx);
+	std::string strBlock = ss.str();
+
+	CDataStream ssRead(strBlock.data(), strBlock.data() + strBlock.size(), SER_NETWORK, PROTOCOL_VERSION);
+	CBlock block;
+
+	size_t nBefore = nNewCalls;
+	ssRead >> block;
+	size_t nNew = nNewCalls - nBefore;
+
+	size_t nScriptHeap = 0;
+	for (const CTransaction& tx : block.vtx)
+	{
+		for (const CTxIn& txin : tx.vin)
+		{
+			nScriptHeap += txin.scriptSig.allocated_memory() != 0;
+		}
+
+		for (const CTxOut& txout : tx.vout)
+		{
+			nScriptHeap += txout.scriptPubKey.allocated_memory() != 0;
+			BOOST_CHECK_EQUAL(txout.scriptPubKey.size(), 25U);
+		}
+	}
+
+	// the signature scripts are 107 bytes and still go to the heap, the
+	// output scripts stay inside the CTxOut
+	BOOST_CHECK_EQUAL(nScriptHeap, (size_t)nTx * 2);
+
+	// one for vtx and two per transaction for vin and vout, a std::vector
+	// script would add a heap block for each script
+	BOOST_CHECK(nNew <= 1 + (size_t)nTx * 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
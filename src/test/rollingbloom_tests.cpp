@@ -0,0 +1,60 @@
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+#include "crollingbloomfilter.h"
+#include "uint/uint256.h"
+#include "util.h"
+
+BOOST_AUTO_TEST_SUITE(rollingbloom_tests)
+
+static uint256 RandomHash()
+{
+	uint256 n;
+	for (unsigned char* p = n.begin(); p != n.end(); ++p)
+		*p = (unsigned char)(insecure_rand() & 0xff);
+	return n;
+}
+
+BOOST_AUTO_TEST_CASE(rollingbloom)
+{
+	CRollingBloomFilter rb(100, 0.01);
+	std::vector<uint256> vData;
+
+	// the last 100 entries are always there
+	for (int i = 0; i < 1000; ++i)
+	{
+		vData.push_back(RandomHash());
+		rb.insert(vData.back());
+
+		for (int j = std::max(0, i - 99); j <= i; ++j)
+			BOOST_CHECK(rb.contains(vData[j]));
+	}
+
+	// and the false positive rate stays near 1%
+	int nHits = 0;
+	for (int i = 0; i < 10000; ++i)
+		if (rb.contains(RandomHash()))
+			nHits++;
+
+	BOOST_CHECK(nHits < 175);
+
+	// entries older than 1.5 times the size are gone
+	nHits = 0;
+	for (int i = 0; i < 800; ++i)
+		if (rb.contains(vData[i]))
+			nHits++;
+
+	BOOST_CHECK(nHits < 25);
+
+	rb.reset();
+
+	nHits = 0;
+	for (const uint256& hash : vData)
+		if (rb.contains(hash))
+			nHits++;
+
+	BOOST_CHECK_EQUAL(nHits, 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
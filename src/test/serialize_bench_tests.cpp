@@ -0,0 +1,163 @@
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+
+#include "cscript.h"
+#include "cblock.h"
+#include "ctransaction.h"
+#include "ctxin.h"
+#include "ctxout.h"
+#include "cdatastream.h"
+#include "enums/serialize_type.h"
+#include "uint/uint256.h"
+#include "serialize.h"
+#include "version.h"
+#include "util.h"
+
+/** Throughput of the serializers on the shapes that matter for a node:
+ * blocks, transactions, hash lists and compact sizes. The numbers go to
+ * the test log (--log_level=message); the checks only make sure every
+ * pass produced the same bytes. The suite only runs when asked for with
+ * --run_test=serialize_bench_tests.
+ */
+
+BOOST_AUTO_TEST_SUITE(serialize_bench_tests, *boost::unit_test::disabled())
+
+/** A block of nTx transactions spending two P2PKH outputs each to two P2PKH outputs */
+static CBlock MakeBlock(int nTx)
+{
+	CBlock block;
+
+	for (int i = 0; i < nTx; ++i)
+	{
+		CTransaction tx;
+
+		for (int j = 0; j < 2; ++j)
+		{
+			std::vector<unsigned char> vchSig(72, insecure_rand() & 0xff);
+			std::vector<unsigned char> vchPubKey(33, insecure_rand() & 0xff);
+			tx.vin.push_back(CTxIn(uint256(insecure_rand()), j, CScript() << vchSig << vchPubKey));
+
+			std::vector<unsigned char> vchHash(20, insecure_rand() & 0xff);
+			tx.vout.push_back(CTxOut(insecure_rand(), CScript() << OP_DUP << OP_HASH160 << vchHash << OP_EQUALVERIFY << OP_CHECKSIG));
+		}
+
+		block.vtx.push_back(tx);
+	}
+
+	return block;
+}
+
+static void Report(const char* pszName, int nRuns, size_t nBytes, int64_t nMicros)
+{
+	nMicros = std::max<int64_t>(nMicros, 1);
+
+	BOOST_TEST_MESSAGE(strprintf("%-28s %6d runs %9.1f us/run %8.1f MB/s", pszName, nRuns,
+			(double)nMicros / nRuns, (double)nBytes * nRuns / nMicros));
+}
+
+BOOST_AUTO_TEST_CASE(block_throughput)
+{
+	const int nRuns = 50;
+	CBlock block = MakeBlock(2000);
+
+	CDataStream ssRef(SER_NETWORK, PROTOCOL_VERSION);
+	ssRef << block;
+	std::string strBlock = ssRef.str();
+
+	int64_t nStart = GetTimeMicros();
+	for (int i = 0; i < nRuns; ++i)
+	{
+		CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+		ss << block;
+		BOOST_CHECK(ss.size() == strBlock.size());
+	}
+	Report("block serialize", nRuns, strBlock.size(), GetTimeMicros() - nStart);
+
+	unsigned int nSize = 0;
+	nStart = GetTimeMicros();
+	for (int i = 0; i < nRuns; ++i)
+	{
+		nSize = ::GetSerializeSize(block, SER_NETWORK, PROTOCOL_VERSION);
+	}
+	Report("block GetSerializeSize", nRuns, strBlock.size(), GetTimeMicros() - nStart);
+	BOOST_CHECK_EQUAL(nSize, strBlock.size());
+
+	nStart = GetTimeMicros();
+	for (int i = 0; i < nRuns; ++i)
+	{
+		CDataStream ss(strBlock.data(), strBlock.data() + strBlock.size(), SER_NETWORK, PROTOCOL_VERSION);
+		CBlock blockRead;
+		ss >> blockRead;
+		BOOST_CHECK(blockRead.vtx.size() == block.vtx.size());
+	}
+	Report("block unserialize", nRuns, strBlock.size(), GetTimeMicros() - nStart);
+
+	// ConnectBlock asks each transaction for its size
+	nStart = GetTimeMicros();
+	size_t nTotal = 0;
+	for (int i = 0; i < nRuns; ++i)
+	{
+		for (const CTransaction& tx : block.vtx)
+		{
+			nTotal += ::GetSerializeSize(tx, SER_DISK, CLIENT_VERSION);
+		}
+	}
+	Report("per-tx GetSerializeSize", nRuns, strBlock.size(), GetTimeMicros() - nStart);
+	BOOST_CHECK(nTotal > 0);
+}
+
+BOOST_AUTO_TEST_CASE(hashes_throughput)
+{
+	const int nRuns = 200;
+	std::vector<uint256> vHashes;
+	for (int i = 0; i < 50000; ++i)
+	{
+		vHashes.push_back(uint256(insecure_rand()));
+	}
+
+	size_t nBytes = ::GetSerializeSize(vHashes, SER_NETWORK, PROTOCOL_VERSION);
+
+	int64_t nStart = GetTimeMicros();
+	for (int i = 0; i < nRuns; ++i)
+	{
+		CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+		ss << vHashes;
+		BOOST_CHECK(ss.size() == nBytes);
+	}
+	Report("vector<uint256> serialize", nRuns, nBytes, GetTimeMicros() - nStart);
+
+	nStart = GetTimeMicros();
+	for (int i = 0; i < nRuns; ++i)
+	{
+		nBytes = ::GetSerializeSize(vHashes, SER_NETWORK, PROTOCOL_VERSION);
+	}
+	Report("vector<uint256> size", nRuns, nBytes, GetTimeMicros() - nStart);
+}
+
+BOOST_AUTO_TEST_CASE(compactsize_throughput)
+{
+	const int nCount = 1000000;
+	CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+	ss.reserve(nCount * 5);
+
+	int64_t nStart = GetTimeMicros();
+	for (int i = 0; i < nCount; ++i)
+	{
+		WriteCompactSize(ss, (uint64_t)i * 7);
+	}
+	Report("WriteCompactSize", 1, ss.size(), GetTimeMicros() - nStart);
+
+	size_t nBytes = ss.size();
+	uint64_t nSum = 0;
+	nStart = GetTimeMicros();
+	for (int i = 0; i < nCount; ++i)
+	{
+		nSum += ReadCompactSize(ss);
+	}
+	Report("ReadCompactSize", 1, nBytes, GetTimeMicros() - nStart);
+	BOOST_CHECK_EQUAL(nSum, (uint64_t)7 * nCount * (nCount - 1) / 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
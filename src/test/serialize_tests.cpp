@@ -4,6 +4,20 @@
 #include <vector>
 
 #include "serialize.h"
+#include "cdatastream.h"
+#include "cvarint.h"
+#include "cscript.h"
+#include "coutpoint.h"
+#include "cinv.h"
+#include "cdisktxpos.h"
+#include "ctxin.h"
+#include "ctxout.h"
+#include "ctransaction.h"
+#include "enums/serialize_type.h"
+#include "uint/uint160.h"
+#include "uint/uint256.h"
+#include "version.h"
+#include "util.h"
 
 using namespace std;
 
@@ -21,7 +35,7 @@ BOOST_AUTO_TEST_CASE(varints)
         BOOST_CHECK(size == ss.size());
     }
 
-    for (uint64 i = 0;  i < 100000000000ULL; i += 999999937) {
+    for (uint64_t i = 0;  i < 100000000000ULL; i += 999999937) {
         ss << VARINT(i);
         size += ::GetSerializeSize(VARINT(i), 0, 0);
         BOOST_CHECK(size == ss.size());
@@ -34,12 +48,68 @@ BOOST_AUTO_TEST_CASE(varints)
         BOOST_CHECK_MESSAGE(i == j, "decoded:" << j << " expected:" << i);
     }
 
-    for (uint64 i = 0;  i < 100000000000ULL; i += 999999937) {
-        uint64 j;
+    for (uint64_t i = 0;  i < 100000000000ULL; i += 999999937) {
+        uint64_t j;
         ss >> VARINT(j);
         BOOST_CHECK_MESSAGE(i == j, "decoded:" << j << " expected:" << i);
     }
 
 }
 
+BOOST_AUTO_TEST_CASE(compactsize)
+{
+    const uint64_t sizes[] = { 0, 252, 253, 0xffff, 0x10000, 0xffffffffULL, 0x100000000ULL };
+    const char* hex[] = { "00", "fc", "fdfd00", "fdffff", "fe00000100", "feffffffff", "ff0000000001000000" };
+
+    for (unsigned int i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+        WriteCompactSize(ss, sizes[i]);
+        BOOST_CHECK_EQUAL(HexStr(ss.begin(), ss.end()), hex[i]);
+        BOOST_CHECK_EQUAL(GetSizeOfCompactSize(sizes[i]), ss.size());
+    }
+
+    // known at compile time
+    static_assert(GetSizeOfCompactSize(0xffff) == 3, "compact size of 0xffff");
+    static_assert(GetSerializeSize((int64_t)0, SER_NETWORK) == 8, "size of int64_t");
+}
+
+BOOST_AUTO_TEST_CASE(fixed_sizes)
+{
+    // must agree with what the classes themselves compute
+    BOOST_CHECK_EQUAL(CFixedSerializeSize<uint160>::value, uint160(1).GetSerializeSize(SER_NETWORK, PROTOCOL_VERSION));
+    BOOST_CHECK_EQUAL(CFixedSerializeSize<uint256>::value, uint256(1).GetSerializeSize(SER_NETWORK, PROTOCOL_VERSION));
+    BOOST_CHECK_EQUAL(CFixedSerializeSize<COutPoint>::value, COutPoint(1, 2).GetSerializeSize(SER_DISK, CLIENT_VERSION));
+    BOOST_CHECK_EQUAL(CFixedSerializeSize<CInv>::value, CInv(1, 2).GetSerializeSize(SER_NETWORK, PROTOCOL_VERSION));
+    BOOST_CHECK_EQUAL(CFixedSerializeSize<CDiskTxPos>::value, CDiskTxPos(1, 2, 3).GetSerializeSize(SER_DISK, CLIENT_VERSION));
+
+    std::vector<uint256> vHashes(300, uint256(5));
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss << vHashes;
+    BOOST_CHECK_EQUAL(::GetSerializeSize(vHashes, SER_NETWORK, PROTOCOL_VERSION), ss.size());
+    BOOST_CHECK_EQUAL(ss.size(), 3 + 300 * 32);
+}
+
+BOOST_AUTO_TEST_CASE(transaction_bytes)
+{
+    CTransaction tx;
+    tx.nVersion = 1;
+    tx.nTime = 0x12345678;
+    tx.vin.push_back(CTxIn(uint256(7), 2, CScript() << OP_TRUE));
+    tx.vout.push_back(CTxOut(5000000000LL, CScript() << OP_DUP));
+    tx.nLockTime = 0;
+
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss << tx;
+    BOOST_CHECK_EQUAL(HexStr(ss.begin(), ss.end()),
+        "01000000" "78563412"
+        "01" "0700000000000000000000000000000000000000000000000000000000000000" "02000000" "0151" "ffffffff"
+        "01" "00f2052a01000000" "0176"
+        "00000000");
+    BOOST_CHECK_EQUAL(::GetSerializeSize(tx, SER_NETWORK, PROTOCOL_VERSION), ss.size());
+
+    CTransaction tx2;
+    ss >> tx2;
+    BOOST_CHECK(tx2.GetHash() == tx.GetHash());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
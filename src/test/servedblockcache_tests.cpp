@@ -0,0 +1,69 @@
+#include <boost/test/unit_test.hpp>
+
+#include <memory>
+
+#include "cservedblockcache.h"
+#include "uint/uint256.h"
+
+BOOST_AUTO_TEST_SUITE(servedblockcache_tests)
+
+static std::shared_ptr<const CServedBlock> MakeBlock(size_t nSize, char ch)
+{
+	std::shared_ptr<CServedBlock> pblock = std::make_shared<CServedBlock>();
+
+	pblock->vchData.assign(nSize, ch);
+	pblock->nChecksum = ch;
+
+	return pblock;
+}
+
+BOOST_AUTO_TEST_CASE(lru_order)
+{
+	CServedBlockCache cache;
+
+	cache.Insert(uint256(1), MakeBlock(100, 'a'), 300);
+	cache.Insert(uint256(2), MakeBlock(100, 'b'), 300);
+	cache.Insert(uint256(3), MakeBlock(100, 'c'), 300);
+	BOOST_CHECK_EQUAL(cache.size(), 3U);
+	BOOST_CHECK_EQUAL(cache.GetBytes(), 300U);
+
+	// 1 is now the most recently used, so 2 goes first
+	BOOST_CHECK(cache.Get(uint256(1)));
+	cache.Insert(uint256(4), MakeBlock(100, 'd'), 300);
+
+	BOOST_CHECK(!cache.Get(uint256(2)));
+	BOOST_CHECK(cache.Get(uint256(1)));
+	BOOST_CHECK(cache.Get(uint256(3)));
+	BOOST_CHECK_EQUAL(cache.Get(uint256(4))->vchData[0], 'd');
+	BOOST_CHECK_EQUAL(cache.GetBytes(), 300U);
+	BOOST_CHECK_EQUAL(cache.GetHits(), 4U);
+	BOOST_CHECK_EQUAL(cache.GetMisses(), 1U);
+}
+
+BOOST_AUTO_TEST_CASE(bounded)
+{
+	CServedBlockCache cache;
+
+	// Too big to keep at all
+	cache.Insert(uint256(1), MakeBlock(1000, 'a'), 500);
+	BOOST_CHECK_EQUAL(cache.size(), 0U);
+
+	cache.Insert(uint256(2), MakeBlock(200, 'b'), 500);
+	cache.Insert(uint256(3), MakeBlock(200, 'c'), 500);
+
+	// Held by a sender while the cache drops it
+	std::shared_ptr<const CServedBlock> pblock = cache.Get(uint256(2));
+	cache.Insert(uint256(4), MakeBlock(400, 'd'), 500);
+
+	BOOST_CHECK(!cache.Get(uint256(2)));
+	BOOST_CHECK(!cache.Get(uint256(3)));
+	BOOST_CHECK_EQUAL(cache.GetBytes(), 400U);
+	BOOST_CHECK_EQUAL(pblock->vchData.size(), 200U);
+	BOOST_CHECK_EQUAL(pblock->vchData[199], 'b');
+
+	cache.Clear();
+	BOOST_CHECK_EQUAL(cache.size(), 0U);
+	BOOST_CHECK_EQUAL(cache.GetBytes(), 0U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
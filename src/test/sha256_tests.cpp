@@ -0,0 +1,230 @@
+#include <boost/test/unit_test.hpp>
+
+#include <cstring>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "crypto/common/sha256.h"
+#include "cblock.h"
+#include "ctransaction.h"
+#include "ctxin.h"
+#include "ctxout.h"
+#include "hash.h"
+#include "util.h"
+
+BOOST_AUTO_TEST_SUITE(sha256_tests)
+
+static const char* vImplementations[] = {"generic", "avx2", "shani", "shani+avx2"};
+
+static void RandomBytes(unsigned char* p, size_t len)
+{
+    for (size_t i = 0; i < len; ++i)
+        p[i] = (unsigned char)(insecure_rand() & 0xff);
+}
+
+static uint256 HashSHA256(const std::string& str)
+{
+    uint256 hash;
+
+    CSHA256().Write((const unsigned char*)str.data(), str.size()).Finalize(hash.begin());
+
+    return hash;
+}
+
+/** Merkle root the way BuildMerkleTree computed it before SHA256D64 */
+static uint256 ReferenceMerkleRoot(std::vector<uint256> vTree)
+{
+    int j = 0;
+    for (int nSize = vTree.size(); nSize > 1; nSize = (nSize + 1) / 2)
+    {
+        for (int i = 0; i < nSize; i += 2)
+        {
+            int i2 = std::min(i + 1, nSize - 1);
+            vTree.push_back(Hash(BEGIN(vTree[j + i]), END(vTree[j + i]), BEGIN(vTree[j + i2]), END(vTree[j + i2])));
+        }
+        j += nSize;
+    }
+
+    return vTree.empty() ? 0 : vTree.back();
+}
+
+/** The levels BuildMerkleTree appends to the txids in vTree */
+static void BatchedMerkleTree(std::vector<uint256>& vTree)
+{
+    int j = 0;
+    for (int nSize = vTree.size(); nSize > 1; nSize = (nSize + 1) / 2)
+    {
+        unsigned char pair[64];
+
+        vTree.resize(j + nSize + (nSize + 1) / 2);
+        SHA256D64(vTree[j + nSize].begin(), vTree[j].begin(), nSize / 2);
+        if (nSize & 1)
+        {
+            memcpy(pair, vTree[j + nSize - 1].begin(), 32);
+            memcpy(pair + 32, vTree[j + nSize - 1].begin(), 32);
+            SHA256D64(vTree.back().begin(), pair, 1);
+        }
+        j += nSize;
+    }
+}
+
+static void MakeBlock(CBlock& block, size_t nTx)
+{
+    block.SetNull();
+    block.vtx.resize(nTx);
+    for (size_t i = 0; i < nTx; ++i)
+    {
+        block.vtx[i].nTime = insecure_rand();
+        block.vtx[i].nLockTime = i;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(sha256_vectors)
+{
+    const std::string strMillion(1000000, 'a');
+
+    for (const char* pszName : vImplementations)
+    {
+        if (!SHA256SelectImplementation(pszName))
+        {
+            BOOST_TEST_MESSAGE(strprintf("sha256 %s not supported by this CPU", pszName));
+            continue;
+        }
+
+        // uint256 is little endian, the digests are read back to front
+        BOOST_CHECK_EQUAL(SHA256Implementation(), pszName);
+        BOOST_CHECK(HashSHA256("") == uint256("0x55b852781b9995a44c939b64e441ae2724b96f99c8f4fb9a141cfc9842c4b0e3"));
+        BOOST_CHECK(HashSHA256("abc") == uint256("0xad1500f261ff10b49c7a1796a36103b02322ae5dde404141eacf018fbf1678ba"));
+        BOOST_CHECK(HashSHA256(strMillion) == uint256("0xd02c11c7cc396d040e2097a4489a80f1673ed784e2c7a18192fb14995c6ec7cd"));
+    }
+
+    BOOST_CHECK(!SHA256SelectImplementation("none"));
+    BOOST_CHECK(SHA256SelectImplementation(""));
+}
+
+BOOST_AUTO_TEST_CASE(sha256d64_matches_hash)
+{
+    std::vector<unsigned char> vData(64 * 67);
+    RandomBytes(&vData[0], vData.size());
+
+    std::vector<uint256> vExpected(67);
+    for (size_t i = 0; i < vExpected.size(); ++i)
+        vExpected[i] = Hash(vData.begin() + 64 * i, vData.begin() + 64 * (i + 1));
+
+    for (const char* pszName : vImplementations)
+    {
+        if (!SHA256SelectImplementation(pszName))
+            continue;
+
+        // every count up to 67, so the 8-way kernels and their remainders are used
+        for (size_t nCount = 0; nCount <= vExpected.size(); ++nCount)
+        {
+            std::vector<uint256> vHashes(nCount);
+            if (nCount > 0)
+                SHA256D64(vHashes[0].begin(), &vData[0], nCount);
+            BOOST_CHECK(std::equal(vHashes.begin(), vHashes.end(), vExpected.begin()));
+        }
+
+        // CSHA256 over lengths around the block size, written in two parts
+        for (size_t nLen = 0; nLen <= 200; ++nLen)
+        {
+            uint256 hash1, hash2;
+            CSHA256().Write(&vData[0], nLen).Finalize(hash1.begin());
+            CSHA256().Write(&vData[0], nLen / 3).Write(&vData[nLen / 3], nLen - nLen / 3).Finalize(hash2.begin());
+            BOOST_CHECK(hash1 == hash2);
+            if (SHA256Implementation() != "generic")
+            {
+                SHA256SelectImplementation("generic");
+                CSHA256().Write(&vData[0], nLen).Finalize(hash2.begin());
+                SHA256SelectImplementation(pszName);
+                BOOST_CHECK(hash1 == hash2);
+            }
+        }
+    }
+
+    SHA256SelectImplementation("");
+}
+
+BOOST_AUTO_TEST_CASE(merkle_root_matches_reference)
+{
+    for (size_t nTx = 0; nTx <= 40; ++nTx)
+    {
+        CBlock block;
+        MakeBlock(block, nTx);
+
+        std::vector<uint256> vLeaves;
+        for (const CTransaction& tx : block.vtx)
+            vLeaves.push_back(tx.GetHash());
+        uint256 hashRoot = ReferenceMerkleRoot(vLeaves);
+
+        for (const char* pszName : vImplementations)
+        {
+            if (!SHA256SelectImplementation(pszName))
+                continue;
+
+            BOOST_CHECK(block.BuildMerkleTree() == hashRoot);
+
+            // branches of the batched tree still lead to the root
+            for (size_t i = 0; i < nTx; ++i)
+                BOOST_CHECK(CBlock::CheckMerkleBranch(block.vtx[i].GetHash(), block.GetMerkleBranch(i), i) == hashRoot);
+        }
+    }
+
+    SHA256SelectImplementation("");
+}
+
+BOOST_AUTO_TEST_CASE(merkle_root_benchmark, *boost::unit_test::disabled())
+{
+    const size_t vSizes[] = {1000, 10000};
+
+    for (size_t nTx : vSizes)
+    {
+        CBlock block;
+        MakeBlock(block, nTx);
+
+        std::vector<uint256> vLeaves;
+        for (const CTransaction& tx : block.vtx)
+            vLeaves.push_back(tx.GetHash());
+
+        const int nRounds = 100000 / nTx;
+        uint256 hashRoot;
+
+        int64_t nStart = GetTimeMicros();
+        for (int r = 0; r < nRounds; ++r)
+            hashRoot = ReferenceMerkleRoot(vLeaves);
+        int64_t nElapsed = std::max<int64_t>(GetTimeMicros() - nStart, 1);
+
+        BOOST_TEST_MESSAGE(strprintf("merkle root of %u tx, pairwise Hash: %.1f us", nTx, (double)nElapsed / nRounds));
+
+        for (const char* pszName : vImplementations)
+        {
+            if (!SHA256SelectImplementation(pszName))
+                continue;
+
+            // tree levels only, the txids are what BuildMerkleTree starts from
+            std::vector<uint256> vTree;
+            nStart = GetTimeMicros();
+            for (int r = 0; r < nRounds; ++r)
+            {
+                vTree = vLeaves;
+                BatchedMerkleTree(vTree);
+            }
+            nElapsed = std::max<int64_t>(GetTimeMicros() - nStart, 1);
+            BOOST_CHECK(vTree.back() == hashRoot);
+
+            BOOST_TEST_MESSAGE(strprintf("merkle root of %u tx, SHA256D64 %s: %.1f us", nTx, pszName, (double)nElapsed / nRounds));
+
+            nStart = GetTimeMicros();
+            for (int r = 0; r < nRounds; ++r)
+                BOOST_CHECK(block.BuildMerkleTree() == hashRoot);
+            nElapsed = std::max<int64_t>(GetTimeMicros() - nStart, 1);
+
+            BOOST_TEST_MESSAGE(strprintf("BuildMerkleTree of %u tx, %s: %.1f us", nTx, pszName, (double)nElapsed / nRounds));
+        }
+    }
+
+    SHA256SelectImplementation("");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
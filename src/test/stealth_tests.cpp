@@ -0,0 +1,135 @@
+#include <boost/test/unit_test.hpp>
+
+#include <cstring>
+#include <algorithm>
+#include <vector>
+
+#include "stealth.h"
+#include "cstealthscanner.h"
+#include "util.h"
+
+BOOST_AUTO_TEST_SUITE(stealth_tests)
+
+static void MakeKeyPair(ec_secret& secret, ec_point& pubkey)
+{
+    BOOST_REQUIRE(GenerateRandomSecret(secret) == 0);
+    BOOST_REQUIRE(SecretToPublicKey(secret, pubkey) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(stealth_send_receive)
+{
+    for (int i = 0; i < 32; ++i)
+    {
+        ec_secret scan, spend, ephem;
+        ec_point scanPub, spendPub, ephemPub;
+
+        MakeKeyPair(scan, scanPub);
+        MakeKeyPair(spend, spendPub);
+        MakeKeyPair(ephem, ephemPub);
+
+        // -- sender
+        ec_secret sharedSend;
+        ec_point pkSendTo;
+        BOOST_CHECK(StealthSecret(ephem, scanPub, spendPub, sharedSend, pkSendTo) == 0);
+        BOOST_CHECK(pkSendTo.size() == ec_compressed_size);
+
+        // -- recipient, single address
+        ec_secret sharedRecv;
+        ec_point pkExtracted;
+        BOOST_CHECK(StealthSecret(scan, ephemPub, spendPub, sharedRecv, pkExtracted) == 0);
+        BOOST_CHECK(memcmp(&sharedSend.e[0], &sharedRecv.e[0], ec_secret_size) == 0);
+        BOOST_CHECK(pkExtracted == pkSendTo);
+
+        // -- recipient, spend key
+        ec_secret spendR;
+        ec_point pkSpendR;
+        BOOST_CHECK(StealthSecretSpend(scan, ephemPub, spend, spendR) == 0);
+        BOOST_CHECK(SecretToPublicKey(spendR, pkSpendR) == 0);
+        BOOST_CHECK(pkSpendR == pkSendTo);
+
+        // -- recipient, batched scanner with decoy addresses around the owned one
+        CStealthScanner scanner;
+        for (size_t k = 0; k < 4; ++k)
+        {
+            ec_secret s, f;
+            ec_point sp, fp;
+            MakeKeyPair(s, sp);
+            MakeKeyPair(f, fp);
+            BOOST_CHECK(scanner.Add(k, data_chunk(&s.e[0], &s.e[0] + ec_secret_size), fp));
+        }
+        BOOST_CHECK(scanner.Add(4, data_chunk(&scan.e[0], &scan.e[0] + ec_secret_size), spendPub));
+
+        std::vector<CStealthScanMatch> vMatches;
+        BOOST_CHECK(scanner.Scan(ephemPub, vMatches));
+        BOOST_CHECK(vMatches.size() == 5);
+
+        int nFound = 0;
+        for (const CStealthScanMatch& match : vMatches)
+        {
+            if (match.pkExtracted != pkSendTo)
+                continue;
+            nFound++;
+            BOOST_CHECK(match.nIndex == 4);
+            BOOST_CHECK(memcmp(&match.sShared.e[0], &sharedSend.e[0], ec_secret_size) == 0);
+        }
+        BOOST_CHECK(nFound == 1);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(stealth_scan_invalid)
+{
+    CStealthScanner scanner;
+    ec_secret scan, spend;
+    ec_point scanPub, spendPub;
+
+    MakeKeyPair(scan, scanPub);
+    MakeKeyPair(spend, spendPub);
+
+    BOOST_CHECK(!scanner.Add(0, data_chunk(16, 0x01), spendPub));
+    BOOST_CHECK(!scanner.Add(0, data_chunk(&scan.e[0], &scan.e[0] + ec_secret_size), ec_point(33, 0x00)));
+    BOOST_CHECK(scanner.IsEmpty());
+
+    BOOST_CHECK(scanner.Add(0, data_chunk(&scan.e[0], &scan.e[0] + ec_secret_size), spendPub));
+
+    std::vector<CStealthScanMatch> vMatches;
+    BOOST_CHECK(!scanner.Scan(ec_point(33, 0x00), vMatches));
+    BOOST_CHECK(!scanner.Scan(ec_point(32, 0x02), vMatches));
+    BOOST_CHECK(vMatches.empty());
+}
+
+// Throughput of FindStealthTransactions' inner step: one ephemeral key
+// checked against every owned address.
+BOOST_AUTO_TEST_CASE(stealth_scan_benchmark, *boost::unit_test::disabled())
+{
+    const size_t vAddressCounts[] = {1, 10, 100};
+
+    for (size_t nAddresses : vAddressCounts)
+    {
+        CStealthScanner scanner;
+        for (size_t k = 0; k < nAddresses; ++k)
+        {
+            ec_secret s, f;
+            ec_point sp, fp;
+            MakeKeyPair(s, sp);
+            MakeKeyPair(f, fp);
+            scanner.Add(k, data_chunk(&s.e[0], &s.e[0] + ec_secret_size), fp);
+        }
+
+        ec_secret ephem;
+        ec_point ephemPub;
+        MakeKeyPair(ephem, ephemPub);
+
+        std::vector<CStealthScanMatch> vMatches;
+        int nTx = 2000 / nAddresses + 10;
+
+        int64_t nStart = GetTimeMicros();
+        for (int i = 0; i < nTx; ++i)
+            scanner.Scan(ephemPub, vMatches);
+        int64_t nElapsed = std::max<int64_t>(GetTimeMicros() - nStart, 1);
+
+        BOOST_TEST_MESSAGE(strprintf("stealth scan, %u addresses: %.0f tx/s",
+            (unsigned int)nAddresses, nTx * 1000000.0 / nElapsed));
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
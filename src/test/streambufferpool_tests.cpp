@@ -0,0 +1,79 @@
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+
+#include "allocators/streambufferpool.h"
+#include "cdatastream.h"
+#include "csecuredatastream.h"
+#include "enums/serialize_type.h"
+#include "version.h"
+#include "util.h"
+
+BOOST_AUTO_TEST_SUITE(streambufferpool_tests)
+
+BOOST_AUTO_TEST_CASE(pool_recycles)
+{
+	StreamBufferPool& pool = StreamBufferPool::Instance();
+
+	// 100 and 120 bytes are both in the 128 byte class
+	void* p = pool.Allocate(100);
+	size_t nCached = pool.GetStats().nCachedBytes;
+	pool.Release(p, 100);
+
+	// unless other tests left the pool full
+	StreamBufferPool::Stats stats = pool.GetStats();
+	if (stats.nCachedBytes == nCached + 128)
+	{
+		BOOST_CHECK(pool.Allocate(120) == p);
+		BOOST_CHECK_EQUAL(pool.GetStats().nHits, stats.nHits + 1);
+		pool.Release(p, 120);
+	}
+
+	// past the largest class buffers go straight back to the heap
+	size_t nHuge = ((size_t)1 << StreamBufferPool::MAX_CLASS_BITS) + 1;
+	stats = pool.GetStats();
+	pool.Release(pool.Allocate(nHuge), nHuge);
+	BOOST_CHECK_EQUAL(pool.GetStats().nOversize, stats.nOversize + 1);
+	BOOST_CHECK_EQUAL(pool.GetStats().nCachedBytes, stats.nCachedBytes);
+}
+
+BOOST_AUTO_TEST_CASE(pool_bounded)
+{
+	StreamBufferPool& pool = StreamBufferPool::Instance();
+	std::vector<void*> vBuffers;
+
+	for (int i = 0; i < 100; ++i)
+		vBuffers.push_back(pool.Allocate(1024 * 1024));
+	for (void* p : vBuffers)
+		pool.Release(p, 1024 * 1024);
+
+	BOOST_CHECK(pool.GetStats().nCachedBytes <= StreamBufferPool::MAX_CACHED_BYTES);
+}
+
+BOOST_AUTO_TEST_CASE(secure_stream_not_pooled)
+{
+	StreamBufferPool& pool = StreamBufferPool::Instance();
+	StreamBufferPool::Stats stats = pool.GetStats();
+
+	{
+		CSecureDataStream ss(SER_DISK, CLIENT_VERSION);
+		ss << std::string(5000, 'k');
+
+		// the buffer keeps its zeroing allocator when it moves to a plain stream
+		CDataStream ssMoved(std::move(ss));
+		ssMoved << std::string(5000, 'k');
+
+		CDataStream ssAssigned(SER_DISK, CLIENT_VERSION);
+		ssAssigned = std::move(ssMoved);
+	}
+
+	BOOST_CHECK_EQUAL(pool.GetStats().nAllocs, stats.nAllocs);
+	BOOST_CHECK_EQUAL(pool.GetStats().nCachedBytes, stats.nCachedBytes);
+
+	CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+	ss << std::string(5000, 'b');
+	BOOST_CHECK(pool.GetStats().nAllocs > stats.nAllocs);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,117 @@
+#include <algorithm>
+
+#include "util.h"
+
+#include "clocksite.h"
+
+static void AtomicMax(std::atomic<uint64_t>& nMax, uint64_t nValue)
+{
+	uint64_t nCurrent = nMax.load(std::memory_order_relaxed);
+
+	while (nValue > nCurrent && !nMax.compare_exchange_weak(nCurrent, nValue, std::memory_order_relaxed))
+	{
+
+	}
+}
+
+CLockSite::Counts::Counts() : nLocks(0), nContended(0), nTryFailed(0), nWaitMicros(0), nMaxWaitMicros(0),
+		nHoldMicros(0), nMaxHoldMicros(0)
+{
+	for (int i = 0; i < HISTOGRAM_BUCKETS; i++)
+	{
+		vWaitHistogram[i] = 0;
+		vHoldHistogram[i] = 0;
+	}
+}
+
+void CLockSite::Counts::Add(const Counts& counts)
+{
+	nLocks += counts.nLocks;
+	nContended += counts.nContended;
+	nTryFailed += counts.nTryFailed;
+	nWaitMicros += counts.nWaitMicros;
+	nMaxWaitMicros = std::max(nMaxWaitMicros, counts.nMaxWaitMicros);
+	nHoldMicros += counts.nHoldMicros;
+	nMaxHoldMicros = std::max(nMaxHoldMicros, counts.nMaxHoldMicros);
+
+	for (int i = 0; i < HISTOGRAM_BUCKETS; i++)
+	{
+		vWaitHistogram[i] += counts.vWaitHistogram[i];
+		vHoldHistogram[i] += counts.vHoldHistogram[i];
+	}
+}
+
+CLockSite::CLockSite(const std::string& strNameIn, const std::string& strFileIn, int nLineIn)
+		: strName(strNameIn), strFile(strFileIn), nLine(nLineIn), nLocks(0), nContended(0), nTryFailed(0),
+		nWaitMicros(0), nMaxWaitMicros(0), nHoldMicros(0), nMaxHoldMicros(0)
+{
+	for (int i = 0; i < HISTOGRAM_BUCKETS; i++)
+	{
+		vWaitHistogram[i] = 0;
+		vHoldHistogram[i] = 0;
+	}
+}
+
+void CLockSite::RecordLock(int64_t nMicros, bool fContended)
+{
+	nLocks.fetch_add(1, std::memory_order_relaxed);
+	vWaitHistogram[Bucket(nMicros)].fetch_add(1, std::memory_order_relaxed);
+
+	if (fContended)
+	{
+		nContended.fetch_add(1, std::memory_order_relaxed);
+		nWaitMicros.fetch_add(nMicros, std::memory_order_relaxed);
+		AtomicMax(nMaxWaitMicros, nMicros);
+	}
+}
+
+void CLockSite::RecordHold(int64_t nMicros)
+{
+	nHoldMicros.fetch_add(nMicros, std::memory_order_relaxed);
+	vHoldHistogram[Bucket(nMicros)].fetch_add(1, std::memory_order_relaxed);
+	AtomicMax(nMaxHoldMicros, nMicros);
+}
+
+void CLockSite::RecordTryFailed()
+{
+	nTryFailed.fetch_add(1, std::memory_order_relaxed);
+}
+
+CLockSite::Counts CLockSite::GetCounts() const
+{
+	Counts counts;
+
+	counts.nLocks = nLocks.load(std::memory_order_relaxed);
+	counts.nContended = nContended.load(std::memory_order_relaxed);
+	counts.nTryFailed = nTryFailed.load(std::memory_order_relaxed);
+	counts.nWaitMicros = nWaitMicros.load(std::memory_order_relaxed);
+	counts.nMaxWaitMicros = nMaxWaitMicros.load(std::memory_order_relaxed);
+	counts.nHoldMicros = nHoldMicros.load(std::memory_order_relaxed);
+	counts.nMaxHoldMicros = nMaxHoldMicros.load(std::memory_order_relaxed);
+
+	for (int i = 0; i < HISTOGRAM_BUCKETS; i++)
+	{
+		counts.vWaitHistogram[i] = vWaitHistogram[i].load(std::memory_order_relaxed);
+		counts.vHoldHistogram[i] = vHoldHistogram[i].load(std::memory_order_relaxed);
+	}
+
+	return counts;
+}
+
+std::string CLockSite::ToString() const
+{
+	return strprintf("%s:%d", strFile, nLine);
+}
+
+int CLockSite::Bucket(int64_t nMicros)
+{
+	int nBucket = 0;
+
+	while (nMicros > 0 && nBucket < HISTOGRAM_BUCKETS - 1)
+	{
+		nMicros >>= 1;
+		nBucket++;
+	}
+
+	return nBucket;
+}
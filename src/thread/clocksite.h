@@ -0,0 +1,69 @@
+#ifndef CLOCKSITE_H
+#define CLOCKSITE_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/** One LOCK, LOCK2 or TRY_LOCK call site and how it has fared (-lockstats).
+ *  Every field is a relaxed atomic, so the threads taking the lock only add
+ *  to them and never wait on each other to do it.
+ */
+class CLockSite
+{
+public:
+	// bucket 0 is under 1us, bucket n is [2^(n-1), 2^n) us and the last one holds the rest
+	static const int HISTOGRAM_BUCKETS = 24;
+
+	/** A copy of the counters, or the sum of several sites */
+	class Counts
+	{
+	public:
+		uint64_t	nLocks;
+		uint64_t	nContended;
+		uint64_t	nTryFailed;
+		uint64_t	nWaitMicros;
+		uint64_t	nMaxWaitMicros;
+		uint64_t	nHoldMicros;
+		uint64_t	nMaxHoldMicros;
+		uint64_t	vWaitHistogram[HISTOGRAM_BUCKETS];
+		uint64_t	vHoldHistogram[HISTOGRAM_BUCKETS];
+
+		Counts();
+
+		void Add(const Counts& counts);
+	};
+
+	const std::string	strName;
+	const std::string	strFile;
+	const int			nLine;
+
+private:
+	std::atomic<uint64_t>	nLocks;
+	// acquisitions that found the lock taken and had to wait for it
+	std::atomic<uint64_t>	nContended;
+	// TRY_LOCKs that found the lock taken and gave up
+	std::atomic<uint64_t>	nTryFailed;
+	std::atomic<uint64_t>	nWaitMicros;
+	std::atomic<uint64_t>	nMaxWaitMicros;
+	std::atomic<uint64_t>	nHoldMicros;
+	std::atomic<uint64_t>	nMaxHoldMicros;
+	std::atomic<uint64_t>	vWaitHistogram[HISTOGRAM_BUCKETS];
+	std::atomic<uint64_t>	vHoldHistogram[HISTOGRAM_BUCKETS];
+
+public:
+	CLockSite(const std::string& strNameIn, const std::string& strFileIn, int nLineIn);
+
+	/** The lock was taken, after waiting nMicros for it if fContended */
+	void RecordLock(int64_t nMicros, bool fContended);
+	/** The lock was released after being held for nMicros */
+	void RecordHold(int64_t nMicros);
+	void RecordTryFailed();
+
+	Counts GetCounts() const;
+	std::string ToString() const;
+
+	static int Bucket(int64_t nMicros);
+};
+
+#endif // CLOCKSITE_H
@@ -0,0 +1,149 @@
+#include <algorithm>
+#include <iterator>
+#include <boost/thread/tss.hpp>
+
+#include "util.h"
+#include "thread/clocksite.h"
+
+#include "clockstats.h"
+
+// sites logged by DumpLockStats
+static const size_t DUMP_LOCK_SITES = 10;
+
+typedef std::tuple<const char*, const char*, int> LockSiteKey;
+
+std::atomic<bool> fLockStats(false);
+
+// Declared before lockStats so they are destroyed after it
+static boost::thread_specific_ptr<std::map<LockSiteKey, CLockSite*>> ptrSiteCache;
+static boost::thread_specific_ptr<std::vector<const void*>> ptrHeld;
+
+CLockStats lockStats;
+
+CLockStats::~CLockStats()
+{
+	// Locks can still be taken by the destructors of other globals. The sites
+	// themselves are never freed, so a lock timed before this keeps its site.
+	fLockStats = false;
+}
+
+CLockSite* CLockStats::GetSite(const char* pszName, const char* pszFile, int nLine)
+{
+	std::map<LockSiteKey, CLockSite*>* pcache = ptrSiteCache.get();
+
+	if (pcache == NULL)
+	{
+		pcache = new std::map<LockSiteKey, CLockSite*>();
+
+		ptrSiteCache.reset(pcache);
+	}
+
+	LockSiteKey key(pszName, pszFile, nLine);
+	std::map<LockSiteKey, CLockSite*>::iterator it = pcache->find(key);
+
+	if (it != pcache->end())
+	{
+		return it->second;
+	}
+
+	// A header's __FILE__ is a different string in every file including it
+	CLockSite* pSite = NULL;
+
+	{
+		boost::unique_lock<boost::mutex> lock(mutex);
+
+		CLockSite*& pSiteShared = mapSites[std::make_tuple(std::string(pszName), std::string(pszFile), nLine)];
+
+		if (pSiteShared == NULL)
+		{
+			pSiteShared = new CLockSite(pszName, pszFile, nLine);
+
+			vSites.push_back(pSiteShared);
+		}
+
+		pSite = pSiteShared;
+	}
+
+	(*pcache)[key] = pSite;
+
+	return pSite;
+}
+
+std::vector<const CLockSite*> CLockStats::GetSites()
+{
+	boost::unique_lock<boost::mutex> lock(mutex);
+
+	return std::vector<const CLockSite*>(vSites.begin(), vSites.end());
+}
+
+bool CLockStats::IsHeld(const void* pmutex)
+{
+	std::vector<const void*>* pvHeld = ptrHeld.get();
+
+	return pvHeld != NULL && std::find(pvHeld->begin(), pvHeld->end(), pmutex) != pvHeld->end();
+}
+
+void CLockStats::SetHeld(const void* pmutex, bool fHeld)
+{
+	std::vector<const void*>* pvHeld = ptrHeld.get();
+
+	if (pvHeld == NULL)
+	{
+		pvHeld = new std::vector<const void*>();
+
+		ptrHeld.reset(pvHeld);
+	}
+
+	if (fHeld)
+	{
+		pvHeld->push_back(pmutex);
+
+		return;
+	}
+
+	// locks are mostly released in the reverse order
+	std::vector<const void*>::reverse_iterator it = std::find(pvHeld->rbegin(), pvHeld->rend(), pmutex);
+
+	if (it != pvHeld->rend())
+	{
+		pvHeld->erase(std::next(it).base());
+	}
+}
+
+void DumpLockStats()
+{
+	std::vector<std::pair<uint64_t, const CLockSite*>> vWaited;
+
+	for (const CLockSite* pSite : lockStats.GetSites())
+	{
+		CLockSite::Counts counts = pSite->GetCounts();
+
+		if (counts.nContended > 0)
+		{
+			vWaited.push_back(std::make_pair(counts.nWaitMicros, pSite));
+		}
+	}
+
+	std::sort(vWaited.rbegin(), vWaited.rend());
+
+	LogPrintf("Lock stats: %u of the call sites had to wait\n", vWaited.size());
+
+	for (size_t i = 0; i < vWaited.size() && i < DUMP_LOCK_SITES; i++)
+	{
+		const CLockSite* pSite = vWaited[i].second;
+		CLockSite::Counts counts = pSite->GetCounts();
+
+		LogPrintf(
+			"  %s %s locks=%u contended=%u tryfailed=%u wait=%uus maxwait=%uus hold=%uus maxhold=%uus\n",
+			pSite->strName,
+			pSite->ToString(),
+			counts.nLocks,
+			counts.nContended,
+			counts.nTryFailed,
+			counts.nWaitMicros,
+			counts.nMaxWaitMicros,
+			counts.nHoldMicros,
+			counts.nMaxHoldMicros
+		);
+	}
+}
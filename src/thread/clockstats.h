@@ -0,0 +1,57 @@
+#ifndef CLOCKSTATS_H
+#define CLOCKSTATS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <boost/thread/mutex.hpp>
+
+class CLockSite;
+
+/** Whether CMutexLock times its locks, set from -lockstats */
+extern std::atomic<bool> fLockStats;
+
+/** The call sites of every lock taken while -lockstats is on.
+ *
+ * A site is registered the first time its lock is taken and then kept for
+ * the life of the process. Each thread remembers the sites it has seen by
+ * the address of their name and file strings, so past the first call a lock
+ * costs two clock reads and a few relaxed atomic adds.
+ */
+class CLockStats
+{
+private:
+	boost::mutex mutex;
+	std::map<std::tuple<std::string, std::string, int>, CLockSite*> mapSites;
+	std::vector<CLockSite*> vSites;
+
+public:
+	~CLockStats();
+
+	CLockSite* GetSite(const char* pszName, const char* pszFile, int nLine);
+	std::vector<const CLockSite*> GetSites();
+	
+	/** Whether this thread holds pmutex through a timed lock. A recursive
+	 *  lock taken again is not timed, its hold is the outermost one's.
+	 */
+	static bool IsHeld(const void* pmutex);
+	static void SetHeld(const void* pmutex, bool fHeld);
+
+	static int64_t NowMicros()
+	{
+		return std::chrono::duration_cast<std::chrono::microseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()
+		).count();
+	}
+};
+
+extern CLockStats lockStats;
+
+/** Logs the call sites that have waited longest for their locks */
+void DumpLockStats();
+
+#endif // CLOCKSTATS_H
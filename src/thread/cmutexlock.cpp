@@ -1,12 +1,14 @@
 #include "types/ccriticalsection.h"
 
 #include "thread.h"
+#include "thread/clocksite.h"
+#include "thread/clockstats.h"
 
 #include "cmutexlock.h"
 
 template<typename Mutex>
 CMutexLock<Mutex>::CMutexLock(Mutex& mutexIn, const char* pszName, const char* pszFile, int nLine, bool fTry)
-		: lock(mutexIn, boost::defer_lock)
+		: lock(mutexIn, boost::defer_lock), pSite(NULL), nTimeLocked(0)
 {
 	if (fTry)
 	{
@@ -23,6 +25,12 @@ CMutexLock<Mutex>::~CMutexLock()
 {
 	if (lock.owns_lock())
 	{
+		if (pSite != NULL)
+		{
+			pSite->RecordHold(CLockStats::NowMicros() - nTimeLocked);
+			CLockStats::SetHeld(lock.mutex(), false);
+		}
+		
 		LeaveCritical();
 	}
 }
@@ -38,6 +46,13 @@ void CMutexLock<Mutex>::Enter(const char* pszName, const char* pszFile, int nLin
 {
 	EnterCritical(pszName, pszFile, nLine, (void*)(lock.mutex()));
 	
+	if (fLockStats)
+	{
+		EnterTimed(pszName, pszFile, nLine);
+		
+		return;
+	}
+	
 #ifdef DEBUG_LOCKCONTENTION
 	if (!lock.try_lock())
 	{
@@ -52,11 +67,51 @@ void CMutexLock<Mutex>::Enter(const char* pszName, const char* pszFile, int nLin
 
 }
 
+template<typename Mutex>
+void CMutexLock<Mutex>::EnterTimed(const char* pszName, const char* pszFile, int nLine)
+{
+	CLockSite* pSiteLocked = lockStats.GetSite(pszName, pszFile, nLine);
+	
+	if (CLockStats::IsHeld(lock.mutex()))
+	{
+		lock.lock();
+		pSiteLocked->RecordLock(0, false);
+		
+		return;
+	}
+	
+	// the clock is only read around the wait when there is one
+	if (lock.try_lock())
+	{
+		nTimeLocked = CLockStats::NowMicros();
+		pSiteLocked->RecordLock(0, false);
+	}
+	else
+	{
+#ifdef DEBUG_LOCKCONTENTION
+		PrintLockContention(pszName, pszFile, nLine);
+#endif
+		
+		int64_t nTimeStart = CLockStats::NowMicros();
+		
+		lock.lock();
+		
+		nTimeLocked = CLockStats::NowMicros();
+		pSiteLocked->RecordLock(nTimeLocked - nTimeStart, true);
+	}
+	
+	pSite = pSiteLocked;
+	CLockStats::SetHeld(lock.mutex(), true);
+}
+
 template<typename Mutex>
 bool CMutexLock<Mutex>::TryEnter(const char* pszName, const char* pszFile, int nLine)
 {
 	EnterCritical(pszName, pszFile, nLine, (void*)(lock.mutex()), true);
 	
+	bool fStats = fLockStats;
+	bool fHeld = fStats && CLockStats::IsHeld(lock.mutex());
+	
 	lock.try_lock();
 	
 	if (!lock.owns_lock())
@@ -64,6 +119,27 @@ bool CMutexLock<Mutex>::TryEnter(const char* pszName, const char* pszFile, int n
 		LeaveCritical();
 	}
 	
+	if (fStats)
+	{
+		CLockSite* pSiteLocked = lockStats.GetSite(pszName, pszFile, nLine);
+		
+		if (!lock.owns_lock())
+		{
+			pSiteLocked->RecordTryFailed();
+		}
+		else
+		{
+			pSiteLocked->RecordLock(0, false);
+			
+			if (!fHeld)
+			{
+				nTimeLocked = CLockStats::NowMicros();
+				pSite = pSiteLocked;
+				CLockStats::SetHeld(lock.mutex(), true);
+			}
+		}
+	}
+	
 	return lock.owns_lock();
 }
 
@@ -1,14 +1,21 @@
 #ifndef CMUTEXLOCK_H
 #define CMUTEXLOCK_H
 
+#include <cstdint>
 #include <boost/thread/locks.hpp>
 
+class CLockSite;
+
 /** Wrapper around boost::unique_lock<Mutex> */
 template<typename Mutex>
 class CMutexLock
 {
 private:
 	boost::unique_lock<Mutex> lock;
+	// where and when the lock was taken, only with -lockstats and not
+	// when the thread already held it
+	CLockSite* pSite;
+	int64_t nTimeLocked;
 
 public:
 	CMutexLock(Mutex& mutexIn, const char* pszName, const char* pszFile, int nLine, bool fTry = false);
@@ -18,6 +25,7 @@ public:
 
 private:
 	void Enter(const char* pszName, const char* pszFile, int nLine);
+	void EnterTimed(const char* pszName, const char* pszFile, int nLine);
 	bool TryEnter(const char* pszName, const char* pszFile, int nLine);
 };
 
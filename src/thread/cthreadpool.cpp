@@ -0,0 +1,251 @@
+#include <atomic>
+#include <exception>
+#include <memory>
+
+#include "util.h"
+
+#include "cthreadpool.h"
+
+CThreadPool::CThreadPool(const std::string& strNameIn, int nThreadsIn) : strName(strNameIn), nThreads(0), nActive(0), fStop(false)
+{
+	for (int i = 0; i < nThreadsIn; i++)
+	{
+		threads.create_thread(boost::bind(&CThreadPool::Worker, this));
+		
+		nThreads++;
+	}
+}
+
+CThreadPool::~CThreadPool()
+{
+	Stop();
+}
+
+int CThreadPool::Size() const
+{
+	return nThreads;
+}
+
+void CThreadPool::Worker()
+{
+	RenameThread(("DigitalNote-" + strName).c_str());
+	
+	for (;;)
+	{
+		std::function<void()> task;
+		
+		{
+			boost::unique_lock<boost::mutex> lock(mutex);
+			
+			while (!fStop && queue.empty())
+			{
+				condWork.wait(lock);
+			}
+			
+			if (queue.empty())
+			{
+				return; // stopping and nothing left to run
+			}
+			
+			task = queue.front();
+			queue.pop_front();
+			nActive++;
+		}
+		
+		try
+		{
+			task();
+		}
+		catch (std::exception& e)
+		{
+			PrintExceptionContinue(&e, strName.c_str());
+		}
+		catch (...)
+		{
+			PrintExceptionContinue(NULL, strName.c_str());
+		}
+		
+		{
+			boost::unique_lock<boost::mutex> lock(mutex);
+			
+			nActive--;
+			
+			if (nActive == 0 && queue.empty())
+			{
+				condIdle.notify_all();
+			}
+		}
+	}
+}
+
+void CThreadPool::Submit(const std::function<void()>& task)
+{
+	{
+		boost::unique_lock<boost::mutex> lock(mutex);
+		
+		if (nThreads == 0 || fStop)
+		{
+			lock.unlock();
+			
+			task(); // no workers, run inline
+			
+			return;
+		}
+		
+		queue.push_back(task);
+	}
+	
+	condWork.notify_one();
+}
+
+void CThreadPool::WaitIdle()
+{
+	boost::unique_lock<boost::mutex> lock(mutex);
+	
+	while (nActive > 0 || !queue.empty())
+	{
+		condIdle.wait(lock);
+	}
+}
+
+void CThreadPool::Stop()
+{
+	{
+		boost::unique_lock<boost::mutex> lock(mutex);
+		
+		if (fStop)
+		{
+			return;
+		}
+		
+		fStop = true;
+	}
+	
+	condWork.notify_all();
+	threads.join_all();
+}
+
+void CThreadPool::ParallelFor(size_t nCount, const std::function<void(size_t)>& fn)
+{
+	if (nCount == 0)
+	{
+		return;
+	}
+	
+	if (nCount == 1 || nThreads == 0)
+	{
+		for (size_t i = 0; i < nCount; i++)
+		{
+			fn(i);
+		}
+		
+		return;
+	}
+	
+	struct State
+	{
+		std::atomic<size_t> nNext;
+		boost::mutex mutex;
+		boost::condition_variable cond;
+		int nRunning;
+		bool fDone;
+		std::exception_ptr error;
+	};
+	
+	std::shared_ptr<State> state = std::make_shared<State>();
+	state->nNext = 0;
+	state->nRunning = 0;
+	state->fDone = false;
+	
+	// -- every participant claims indices until none are left
+	auto run = [state, &fn, nCount]()
+	{
+		size_t i;
+		
+		while ((i = state->nNext++) < nCount)
+		{
+			try
+			{
+				fn(i);
+			}
+			catch (...)
+			{
+				boost::unique_lock<boost::mutex> lock(state->mutex);
+				
+				if (!state->error)
+				{
+					state->error = std::current_exception();
+				}
+				
+				state->nNext = nCount; // stop handing out work
+			}
+		}
+	};
+	
+	int nHelpers = (int)std::min<size_t>(nThreads, nCount - 1);
+	
+	for (int i = 0; i < nHelpers; i++)
+	{
+		Submit([state, run]()
+		{
+			// -- a helper that only starts once the caller is done has nothing to do,
+			//    and fn may be gone by then
+			{
+				boost::unique_lock<boost::mutex> lock(state->mutex);
+				
+				if (state->fDone)
+				{
+					return;
+				}
+				
+				state->nRunning++;
+			}
+			
+			run();
+			
+			boost::unique_lock<boost::mutex> lock(state->mutex);
+			
+			if (--state->nRunning == 0)
+			{
+				state->cond.notify_all();
+			}
+		});
+	}
+	
+	run();
+	
+	// -- only wait for the helpers that are running. Waiting for queued ones
+	//    could block forever when every worker is itself inside a ParallelFor.
+	{
+		boost::unique_lock<boost::mutex> lock(state->mutex);
+		
+		state->fDone = true;
+		
+		while (state->nRunning > 0)
+		{
+			state->cond.wait(lock);
+		}
+	}
+	
+	if (state->error)
+	{
+		std::rethrow_exception(state->error);
+	}
+}
+
+int CThreadPool::DefaultThreads()
+{
+	int nCores = boost::thread::hardware_concurrency();
+	
+	if (nCores < 1)
+	{
+		nCores = 1;
+	}
+	
+	if (nCores > 16)
+	{
+		nCores = 16;
+	}
+	
+	return nCores;
+}
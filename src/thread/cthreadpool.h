@@ -0,0 +1,48 @@
+#ifndef CTHREADPOOL_H
+#define CTHREADPOOL_H
+
+#include <deque>
+#include <functional>
+#include <string>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+/** Fixed set of worker threads draining a FIFO of tasks.
+ *  ParallelFor runs on the calling thread as well as the workers and only
+ *  waits for the workers that picked up part of its work, so it may be
+ *  called from inside a task without deadlocking the pool.
+ */
+class CThreadPool
+{
+private:
+	std::string strName;
+	boost::thread_group threads;
+	boost::mutex mutex;
+	boost::condition_variable condWork;
+	boost::condition_variable condIdle;
+	std::deque<std::function<void()>> queue;
+	int nThreads;
+	int nActive;
+	bool fStop;
+	
+	void Worker();
+
+public:
+	CThreadPool(const std::string& strNameIn, int nThreadsIn);
+	~CThreadPool();
+	
+	int Size() const;
+	void Submit(const std::function<void()>& task);
+	void WaitIdle();
+	void Stop();
+	
+	/** Calls fn(i) for every i in [0, nCount) and returns when all calls are done.
+	 *  The first exception thrown by fn is rethrown on the calling thread. */
+	void ParallelFor(size_t nCount, const std::function<void(size_t)>& fn);
+	
+	/** Number of worker threads to use when the user did not configure one. */
+	static int DefaultThreads();
+};
+
+#endif // CTHREADPOOL_H
@@ -1,6 +1,9 @@
 #include "compat.h"
 
+#include <algorithm>
+#include <atomic>
 #include <map>
+#include <memory>
 #include <boost/filesystem.hpp>
 #include <boost/filesystem/fstream.hpp>
 #include <boost/thread.hpp>
@@ -24,9 +27,20 @@
 #include "util.h"
 #include "enums/serialize_type.h"
 #include "cdatastream.h"
+#include "cblockindexsnapshot.h"
+#include "thread/cthreadpool.h"
+#include "ui_interface.h"
+#include "ui_translate.h"
 
 leveldb::DB *txdb; // global pointer for LevelDB object instance
 
+// Block index entries read per batch in LoadBlockIndex
+static const size_t BLOCKINDEX_LOAD_BATCH = 1024;
+
+// Blocks checked ahead of the one being merged, per thread, when verifying
+// the best chain at startup
+static const size_t VERIFY_BLOCKS_AHEAD = 16;
+
 class CBatchScanner : public leveldb::WriteBatch::Handler
 {
 public:
@@ -115,7 +129,7 @@ static CBlockIndex* InsertBlockIndex(uint256 hash)
 	}
 
 	// Return existing
-	std::map<uint256, CBlockIndex*>::iterator mi = mapBlockIndex.find(hash);
+	CBlockIndexMap::iterator mi = mapBlockIndex.find(hash);
 	if (mi != mapBlockIndex.end())
 	{
 		return (*mi).second;
@@ -428,6 +442,76 @@ bool CTxDB::ReadTxIndex(uint256 hash, CTxIndex& txindex)
 	return Read(std::make_pair(std::string("tx"), hash), txindex);
 }
 
+bool CTxDB::ReadTxIndexes(const std::vector<uint256>& vHash, std::map<uint256, CTxIndex>& mapTxIndex)
+{
+	if (activeBatch)
+	{
+		// pending writes have to be looked at key by key
+		for (const uint256& hash : vHash)
+		{
+			CTxIndex txindex;
+			
+			if (ReadTxIndex(hash, txindex))
+			{
+				mapTxIndex[hash] = txindex;
+			}
+		}
+		
+		return true;
+	}
+	
+	std::vector<std::pair<std::string, uint256> > vKey;
+	vKey.reserve(vHash.size());
+	
+	for (const uint256& hash : vHash)
+	{
+		CDataStream ssKey(SER_DISK, CLIENT_VERSION);
+		ssKey << std::make_pair(std::string("tx"), hash);
+		vKey.push_back(std::make_pair(ssKey.str(), hash));
+	}
+	
+	// Seeking forward in key order keeps one iterator on neighbouring
+	// table blocks instead of starting every lookup from the top
+	std::sort(vKey.begin(), vKey.end());
+	vKey.erase(std::unique(vKey.begin(), vKey.end()), vKey.end());
+	
+	leveldb::Iterator *iterator = pdb->NewIterator(leveldb::ReadOptions());
+	
+	for (const std::pair<std::string, uint256>& key : vKey)
+	{
+		iterator->Seek(key.first);
+		
+		if (!iterator->Valid() || iterator->key() != leveldb::Slice(key.first))
+		{
+			continue;
+		}
+		
+		try
+		{
+			CDataStream ssValue(iterator->value().data(), iterator->value().data() + iterator->value().size(),
+								SER_DISK, CLIENT_VERSION);
+			ssValue >> mapTxIndex[key.second];
+		}
+		catch (std::exception &e)
+		{
+			mapTxIndex.erase(key.second);
+		}
+	}
+	
+	leveldb::Status status = iterator->status();
+	
+	delete iterator;
+	
+	if (!status.ok())
+	{
+		LogPrintf("LevelDB read failure: %s\n", status.ToString());
+		
+		return false;
+	}
+	
+	return true;
+}
+
 bool CTxDB::UpdateTxIndex(uint256 hash, const CTxIndex& txindex)
 {
 	return Write(std::make_pair(std::string("tx"), hash), txindex);
@@ -511,15 +595,23 @@ bool CTxDB::WriteBestInvalidTrust(CBigNum bnBestInvalidTrust)
 	return Write(std::string("bnBestInvalidTrust"), bnBestInvalidTrust);
 }
 
-bool CTxDB::LoadBlockIndex()
+bool CTxDB::ReadBlockIndexSnapshotId(uint64_t& nId)
+{
+	return Read(std::string("blockindexsnapshot"), nId);
+}
+
+bool CTxDB::WriteBlockIndexSnapshotId(uint64_t nId)
+{
+	return Write(std::string("blockindexsnapshot"), nId);
+}
+
+bool CTxDB::EraseBlockIndexSnapshotId()
+{
+	return Erase(std::string("blockindexsnapshot"));
+}
+
+bool CTxDB::LoadBlockIndexGuts()
 {
-	if (mapBlockIndex.size() > 0)
-	{
-		// Already loaded once in this session. It can happen during migration
-		// from BDB.
-		return true;
-	}
-	
 	// The block index is an in-memory structure that maps hashes to on-disk
 	// locations where the contents of the block can be found. Here, we scan it
 	// out of the DB and into mapBlockIndex.
@@ -530,73 +622,96 @@ bool CTxDB::LoadBlockIndex()
 	ssStartKey << std::make_pair(std::string("blockindex"), uint256(0));
 	iterator->Seek(ssStartKey.str());
 	
-	// Now read each entry.
-	while (iterator->Valid())
+	// Now read each entry. Entries are read in batches so that their block
+	// hashes are computed several headers at a time.
+	std::vector<CDiskBlockIndex> vDiskIndex;
+	std::vector<uint256> vBlockHash;
+	bool fEnd = false;
+	
+	while (!fEnd)
 	{
-		boost::this_thread::interruption_point();
+		vDiskIndex.clear();
 		
-		// Unpack keys and values.
-		CDataStream ssKey(SER_DISK, CLIENT_VERSION);
-		ssKey.write(iterator->key().data(), iterator->key().size());
-		
-		CDataStream ssValue(SER_DISK, CLIENT_VERSION);
-		ssValue.write(iterator->value().data(), iterator->value().size());
-		
-		std::string strType;
-		ssKey >> strType;
-		
-		// Did we reach the end of the data to read?
-		if (strType != "blockindex")
+		while (vDiskIndex.size() < BLOCKINDEX_LOAD_BATCH)
 		{
-			break;
+			if (!iterator->Valid())
+			{
+				fEnd = true;
+				break;
+			}
+			
+			boost::this_thread::interruption_point();
+			
+			// Unpack keys and values.
+			CDataStream ssKey(SER_DISK, CLIENT_VERSION);
+			ssKey.write(iterator->key().data(), iterator->key().size());
+			
+			CDataStream ssValue(SER_DISK, CLIENT_VERSION);
+			ssValue.write(iterator->value().data(), iterator->value().size());
+			
+			std::string strType;
+			ssKey >> strType;
+			
+			// Did we reach the end of the data to read?
+			if (strType != "blockindex")
+			{
+				fEnd = true;
+				break;
+			}
+			
+			vDiskIndex.push_back(CDiskBlockIndex());
+			ssValue >> vDiskIndex.back();
+			
+			iterator->Next();
 		}
 		
-		CDiskBlockIndex diskindex;
-		ssValue >> diskindex;
-
-		uint256 blockHash = diskindex.GetBlockHash();
-
-		// Construct block index object
-		CBlockIndex* pindexNew    = InsertBlockIndex(blockHash);
-		pindexNew->pprev          = InsertBlockIndex(diskindex.hashPrev);
-		pindexNew->pnext          = InsertBlockIndex(diskindex.hashNext);
-		pindexNew->nFile          = diskindex.nFile;
-		pindexNew->nBlockPos      = diskindex.nBlockPos;
-		pindexNew->nHeight        = diskindex.nHeight;
-		pindexNew->nMint          = diskindex.nMint;
-		pindexNew->nMoneySupply   = diskindex.nMoneySupply;
-		pindexNew->nFlags         = diskindex.nFlags;
-		pindexNew->nStakeModifier = diskindex.nStakeModifier;
-		pindexNew->bnStakeModifierV2 = diskindex.bnStakeModifierV2;
-		pindexNew->prevoutStake   = diskindex.prevoutStake;
-		pindexNew->nStakeTime     = diskindex.nStakeTime;
-		pindexNew->hashProof      = diskindex.hashProof;
-		pindexNew->nVersion       = diskindex.nVersion;
-		pindexNew->hashMerkleRoot = diskindex.hashMerkleRoot;
-		pindexNew->nTime          = diskindex.nTime;
-		pindexNew->nBits          = diskindex.nBits;
-		pindexNew->nNonce         = diskindex.nNonce;
-
-		// Watch for genesis block
-		if (pindexGenesisBlock == NULL && blockHash == Params().HashGenesisBlock())
-		{
-			pindexGenesisBlock = pindexNew;
-		}
+		CDiskBlockIndex::GetBlockHashes(vDiskIndex, vBlockHash);
 		
-		if (!pindexNew->CheckIndex())
+		for (size_t i = 0; i < vDiskIndex.size(); i++)
 		{
-			delete iterator;
+			const CDiskBlockIndex& diskindex = vDiskIndex[i];
+			const uint256& blockHash = vBlockHash[i];
+
+			// Construct block index object
+			CBlockIndex* pindexNew    = InsertBlockIndex(blockHash);
+			pindexNew->pprev          = InsertBlockIndex(diskindex.hashPrev);
+			pindexNew->pnext          = InsertBlockIndex(diskindex.hashNext);
+			pindexNew->nFile          = diskindex.nFile;
+			pindexNew->nBlockPos      = diskindex.nBlockPos;
+			pindexNew->nHeight        = diskindex.nHeight;
+			pindexNew->nMint          = diskindex.nMint;
+			pindexNew->nMoneySupply   = diskindex.nMoneySupply;
+			pindexNew->nFlags         = diskindex.nFlags;
+			pindexNew->nStakeModifier = diskindex.nStakeModifier;
+			pindexNew->bnStakeModifierV2 = diskindex.bnStakeModifierV2;
+			pindexNew->prevoutStake   = diskindex.prevoutStake;
+			pindexNew->nStakeTime     = diskindex.nStakeTime;
+			pindexNew->hashProof      = diskindex.hashProof;
+			pindexNew->nVersion       = diskindex.nVersion;
+			pindexNew->hashMerkleRoot = diskindex.hashMerkleRoot;
+			pindexNew->nTime          = diskindex.nTime;
+			pindexNew->nBits          = diskindex.nBits;
+			pindexNew->nNonce         = diskindex.nNonce;
+
+			// Watch for genesis block
+			if (pindexGenesisBlock == NULL && blockHash == Params().HashGenesisBlock())
+			{
+				pindexGenesisBlock = pindexNew;
+			}
+		
+			if (!pindexNew->CheckIndex())
+			{
+				delete iterator;
 			
-			return error("LoadBlockIndex() : CheckIndex failed at %d", pindexNew->nHeight);
-		}
+				return error("LoadBlockIndex() : CheckIndex failed at %d", pindexNew->nHeight);
+			}
 
-		// NovaCoin: build setStakeSeen
-		if (pindexNew->IsProofOfStake())
-		{
-			setStakeSeen.insert(std::make_pair(pindexNew->prevoutStake, pindexNew->nStakeTime));
+			// NovaCoin: build setStakeSeen
+			if (pindexNew->IsProofOfStake())
+			{
+				setStakeSeen.insert(std::make_pair(pindexNew->prevoutStake, pindexNew->nStakeTime));
+			}
 		}
-		
-		iterator->Next();
 	}
 	
 	delete iterator;
@@ -620,7 +735,251 @@ bool CTxDB::LoadBlockIndex()
 		CBlockIndex* pindex = item.second;
 		pindex->nChainTrust = (pindex->pprev ? pindex->pprev->nChainTrust : 0) + pindex->GetBlockTrust();
 	}
+	
+	return true;
+}
+
+/** What the pool found out about one block checked at startup */
+struct CBlockVerifyResult
+{
+	CBlock block;
+	bool fDone;
+	bool fRead;
+	bool fBad;
+	std::vector<std::string> vMessages;
+	
+	CBlockVerifyResult() : fDone(false), fRead(false), fBad(false)
+	{
+		
+	}
+};
+
+/** Reads a block checked at startup and, from check level 2 on, checks the
+ * transaction index against it. The index entries of the block are read in
+ * two sorted batches, one for its transactions and one for their inputs.
+ * mapBlockPos holds the height of every block being checked by its position.
+ */
+static void VerifyBlockAt(CTxDB& txdb, CBlockIndex* pindex, int nCheckLevel,
+		const std::map<std::pair<unsigned int, unsigned int>, int>& mapBlockPos, CBlockVerifyResult& result)
+{
+	if (!result.block.ReadFromDisk(pindex))
+	{
+		return;
+	}
+	
+	result.fRead = true;
+	
+	// check level 2: verify transaction index validity
+	if (nCheckLevel<=1)
+	{
+		return;
+	}
+	
+	const CBlock& block = result.block;
+	std::vector<uint256> vHashTx;
+	std::vector<uint256> vHashPrev;
+	
+	for (const CTransaction &tx : block.vtx)
+	{
+		vHashTx.push_back(tx.GetHash());
+		
+		if (nCheckLevel>4)
+		{
+			for (const CTxIn &txin : tx.vin)
+			{
+				vHashPrev.push_back(txin.prevout.hash);
+			}
+		}
+	}
+	
+	std::map<uint256, CTxIndex> mapTxIndex;
+	std::map<uint256, CTxIndex> mapPrevIndex;
+	
+	txdb.ReadTxIndexes(vHashTx, mapTxIndex);
+	txdb.ReadTxIndexes(vHashPrev, mapPrevIndex);
+	
+	for (size_t i = 0; i < block.vtx.size(); i++)
+	{
+		const CTransaction &tx = block.vtx[i];
+		const uint256& hashTx = vHashTx[i];
+		std::map<uint256, CTxIndex>::const_iterator mi = mapTxIndex.find(hashTx);
+		
+		if (mi != mapTxIndex.end())
+		{
+			const CTxIndex& txindex = mi->second;
+			
+			// check level 3: checker transaction hashes
+			if (nCheckLevel>2 || pindex->nFile != txindex.pos.nFile || pindex->nBlockPos != txindex.pos.nBlockPos)
+			{
+				// either an error or a duplicate transaction
+				CTransaction txFound;
+				
+				if (!txFound.ReadFromDisk(txindex.pos))
+				{
+					result.vMessages.push_back(strprintf("LoadBlockIndex() : *** cannot read mislocated transaction %s\n", hashTx.ToString()));
+					result.fBad = true;
+				}
+				else if (txFound.GetHash() != hashTx) // not a duplicate tx
+				{
+					result.vMessages.push_back(strprintf("LoadBlockIndex(): *** invalid tx position for %s\n", hashTx.ToString()));
+					result.fBad = true;
+				}
+			}
+			
+			// check level 4: check whether spent txouts were spent within the main chain
+			unsigned int nOutput = 0;
+			if (nCheckLevel>3)
+			{
+				for(const CDiskTxPos &txpos : txindex.vSpent)
+				{
+					if (!txpos.IsNull())
+					{
+						// spent by this block or one above it
+						std::map<std::pair<unsigned int, unsigned int>, int>::const_iterator mp =
+								mapBlockPos.find(std::make_pair(txpos.nFile, txpos.nBlockPos));
+						
+						if (mp == mapBlockPos.end() || mp->second < pindex->nHeight)
+						{
+							result.vMessages.push_back(strprintf("LoadBlockIndex(): *** found bad spend at %d, hashBlock=%s, hashTx=%s\n", pindex->nHeight, pindex->GetBlockHash().ToString(), hashTx.ToString()));
+							result.fBad = true;
+						}
+						
+						// check level 6: check whether spent txouts were spent by a valid transaction that consume them
+						if (nCheckLevel>5)
+						{
+							CTransaction txSpend;
+							
+							if (!txSpend.ReadFromDisk(txpos))
+							{
+								result.vMessages.push_back(strprintf("LoadBlockIndex(): *** cannot read spending transaction of %s:%i from disk\n", hashTx.ToString(), nOutput));
+								result.fBad = true;
+							}
+							else if (!txSpend.CheckTransaction())
+							{
+								result.vMessages.push_back(strprintf("LoadBlockIndex(): *** spending transaction of %s:%i is invalid\n", hashTx.ToString(), nOutput));
+								result.fBad = true;
+							}
+							else
+							{
+								bool fFound = false;
+								
+								for(const CTxIn &txin : txSpend.vin)
+								{
+									if (txin.prevout.hash == hashTx && txin.prevout.n == nOutput)
+									{
+										fFound = true;
+									}
+								}
+								
+								if (!fFound)
+								{
+									result.vMessages.push_back(strprintf("LoadBlockIndex(): *** spending transaction of %s:%i does not spend it\n", hashTx.ToString(), nOutput));
+									result.fBad = true;
+								}
+							}
+						}
+					}
+					
+					nOutput++;
+				}
+			}
+		}
+		
+		// check level 5: check whether all prevouts are marked spent
+		if (nCheckLevel>4)
+		{
+			for(const CTxIn &txin : tx.vin)
+			{
+				std::map<uint256, CTxIndex>::const_iterator mp = mapPrevIndex.find(txin.prevout.hash);
+				
+				if (mp == mapPrevIndex.end())
+				{
+					continue;
+				}
+				
+				const CTxIndex& txindex = mp->second;
+				
+				if (txin.prevout.n >= txindex.vSpent.size() || txindex.vSpent[txin.prevout.n].IsNull())
+				{
+					result.vMessages.push_back(strprintf("LoadBlockIndex(): *** found unspent prevout %s:%i in %s\n", txin.prevout.hash.ToString(), txin.prevout.n, hashTx.ToString()));
+					result.fBad = true;
+				}
+			}
+		}
+	}
+}
 
+static void VerifyBlockTask(CTxDB& txdb, CBlockIndex* pindex, int nCheckLevel,
+		const std::map<std::pair<unsigned int, unsigned int>, int>& mapBlockPos, const std::atomic<bool>& fStop,
+		boost::mutex& mutex, boost::condition_variable& cond, CBlockVerifyResult& result)
+{
+	// the results of the blocks still queued are not looked at any more
+	if (!fStop)
+	{
+		try
+		{
+			VerifyBlockAt(txdb, pindex, nCheckLevel, mapBlockPos, result);
+		}
+		catch (std::exception& e)
+		{
+			PrintExceptionContinue(&e, "VerifyBlockTask()");
+			
+			result.fRead = false;
+		}
+	}
+	
+	boost::unique_lock<boost::mutex> lock(mutex);
+	
+	result.fDone = true;
+	cond.notify_all();
+}
+
+bool CTxDB::LoadBlockIndex()
+{
+	if (mapBlockIndex.size() > 0)
+	{
+		// Already loaded once in this session. It can happen during migration
+		// from BDB.
+		return true;
+	}
+	
+	// A snapshot written at the last clean shutdown holds the whole index
+	// including chain trust, otherwise every record is read from the DB
+	bool fSnapshot = false;
+	
+	if (GetBoolArg("-blockindexsnapshot", true))
+	{
+		fSnapshot = CBlockIndexSnapshot().Read(*this) == CBlockIndexSnapshot::Ok;
+	}
+	else
+	{
+		// this session changes the DB, an older snapshot must not be used after it
+		EraseBlockIndexSnapshotId();
+	}
+	
+	if (fSnapshot)
+	{
+		for (const std::pair<const uint256, CBlockIndex*>& item : mapBlockIndex)
+		{
+			CBlockIndex* pindex = item.second;
+			
+			if (pindexGenesisBlock == NULL && item.first == Params().HashGenesisBlock())
+			{
+				pindexGenesisBlock = pindex;
+			}
+			
+			// NovaCoin: build setStakeSeen
+			if (pindex->IsProofOfStake())
+			{
+				setStakeSeen.insert(std::make_pair(pindex->prevoutStake, pindex->nStakeTime));
+			}
+		}
+	}
+	else if (!LoadBlockIndexGuts())
+	{
+		return false;
+	}
+	
 	// Load hashBestChain pointer to end of best chain
 	if (!ReadHashBestChain(hashBestChain))
 	{
@@ -668,149 +1027,112 @@ bool CTxDB::LoadBlockIndex()
 	LogPrintf("Verifying last %i blocks at level %i\n", nCheckDepth, nCheckLevel);
 	
 	CBlockIndex* pindexFork = NULL;
-	std::map<std::pair<unsigned int, unsigned int>, CBlockIndex*> mapBlockPos;
+	std::vector<CBlockIndex*> vCheck;
+	std::map<std::pair<unsigned int, unsigned int>, int> mapBlockPos;
 	
 	for (CBlockIndex* pindex = pindexBest; pindex && pindex->pprev; pindex = pindex->pprev)
 	{
-		boost::this_thread::interruption_point();
-		
 		if (pindex->nHeight < nBestHeight-nCheckDepth)
 		{
 			break;
 		}
 		
-		CBlock block;
-		if (!block.ReadFromDisk(pindex))
-		{
-			return error("LoadBlockIndex() : block.ReadFromDisk failed");
-		}
-		
-		// check level 1: verify block validity
-		// check level 7: verify block signature too
-		if (nCheckLevel>0 && !block.CheckBlock(true, true, (nCheckLevel>6)))
-		{
-			LogPrintf("LoadBlockIndex() : *** found bad block at %d, hash=%s\n", pindex->nHeight, pindex->GetBlockHash().ToString());
-			pindexFork = pindex->pprev;
-		}
-		
-		// check level 2: verify transaction index validity
-		if (nCheckLevel>1)
+		vCheck.push_back(pindex);
+		mapBlockPos[std::make_pair(pindex->nFile, pindex->nBlockPos)] = pindex->nHeight;
+	}
+	
+	// Blocks are read and their transaction index checked by the pool,
+	// then merged here from the best block down like a serial walk would.
+	// CheckBlock stays on this thread as it takes cs_main.
+	int nThreads = GetArg("-checkblockthreads", CThreadPool::DefaultThreads());
+	size_t nAhead = VERIFY_BLOCKS_AHEAD * std::max(nThreads, 1);
+	
+	std::vector<std::unique_ptr<CBlockVerifyResult> > vResult(vCheck.size());
+	boost::mutex mutex;
+	boost::condition_variable cond;
+	std::atomic<bool> fStop(false);
+	CThreadPool pool("checkblk", nThreads);
+	
+	size_t nSubmitted = 0;
+	int nProgress = -1;
+	
+	try
+	{
+		for (size_t i = 0; i < vCheck.size(); i++)
 		{
-			std::pair<unsigned int, unsigned int> pos = std::make_pair(pindex->nFile, pindex->nBlockPos);
-			mapBlockPos[pos] = pindex;
+			boost::this_thread::interruption_point();
 			
-			for(const CTransaction &tx : block.vtx)
+			while (nSubmitted < vCheck.size() && nSubmitted < i + nAhead)
 			{
-				uint256 hashTx = tx.GetHash();
-				CTxIndex txindex;
+				vResult[nSubmitted].reset(new CBlockVerifyResult());
 				
-				if (ReadTxIndex(hashTx, txindex))
-				{
-					// check level 3: checker transaction hashes
-					if (nCheckLevel>2 || pindex->nFile != txindex.pos.nFile || pindex->nBlockPos != txindex.pos.nBlockPos)
-					{
-						// either an error or a duplicate transaction
-						CTransaction txFound;
-						
-						if (!txFound.ReadFromDisk(txindex.pos))
-						{
-							LogPrintf("LoadBlockIndex() : *** cannot read mislocated transaction %s\n", hashTx.ToString());
-							
-							pindexFork = pindex->pprev;
-						}
-						else
-						{
-							if (txFound.GetHash() != hashTx) // not a duplicate tx
-							{
-								LogPrintf("LoadBlockIndex(): *** invalid tx position for %s\n", hashTx.ToString());
-								
-								pindexFork = pindex->pprev;
-							}
-						}
-					}
-					
-					// check level 4: check whether spent txouts were spent within the main chain
-					unsigned int nOutput = 0;
-					if (nCheckLevel>3)
-					{
-						for(const CDiskTxPos &txpos : txindex.vSpent)
-						{
-							if (!txpos.IsNull())
-							{
-								std::pair<unsigned int, unsigned int> posFind = std::make_pair(txpos.nFile, txpos.nBlockPos);
-								
-								if (!mapBlockPos.count(posFind))
-								{
-									LogPrintf("LoadBlockIndex(): *** found bad spend at %d, hashBlock=%s, hashTx=%s\n", pindex->nHeight, pindex->GetBlockHash().ToString(), hashTx.ToString());
-									
-									pindexFork = pindex->pprev;
-								}
-								
-								// check level 6: check whether spent txouts were spent by a valid transaction that consume them
-								if (nCheckLevel>5)
-								{
-									CTransaction txSpend;
-									
-									if (!txSpend.ReadFromDisk(txpos))
-									{
-										LogPrintf("LoadBlockIndex(): *** cannot read spending transaction of %s:%i from disk\n", hashTx.ToString(), nOutput);
-										
-										pindexFork = pindex->pprev;
-									}
-									else if (!txSpend.CheckTransaction())
-									{
-										LogPrintf("LoadBlockIndex(): *** spending transaction of %s:%i is invalid\n", hashTx.ToString(), nOutput);
-										
-										pindexFork = pindex->pprev;
-									}
-									else
-									{
-										bool fFound = false;
-										
-										for(const CTxIn &txin : txSpend.vin)
-										{
-											if (txin.prevout.hash == hashTx && txin.prevout.n == nOutput)
-											{
-												fFound = true;
-											}
-										}
-										
-										if (!fFound)
-										{
-											LogPrintf("LoadBlockIndex(): *** spending transaction of %s:%i does not spend it\n", hashTx.ToString(), nOutput);
-											
-											pindexFork = pindex->pprev;
-										}
-									}
-								}
-							}
-							
-							nOutput++;
-						}
-					}
-				}
+				pool.Submit(std::bind(&VerifyBlockTask, std::ref(*this), vCheck[nSubmitted], nCheckLevel,
+						std::cref(mapBlockPos), std::cref(fStop), std::ref(mutex), std::ref(cond),
+						std::ref(*vResult[nSubmitted])));
+				
+				nSubmitted++;
+			}
+			
+			CBlockIndex* pindex = vCheck[i];
+			CBlockVerifyResult& result = *vResult[i];
+			
+			{
+				boost::unique_lock<boost::mutex> lock(mutex);
 				
-				// check level 5: check whether all prevouts are marked spent
-				if (nCheckLevel>4)
+				while (!result.fDone)
 				{
-					for(const CTxIn &txin : tx.vin)
-					{
-						CTxIndex txindex;
-
-						if (ReadTxIndex(txin.prevout.hash, txindex))
-						{
-							if (txindex.vSpent.size()-1 < txin.prevout.n || txindex.vSpent[txin.prevout.n].IsNull())
-							{
-								LogPrintf("LoadBlockIndex(): *** found unspent prevout %s:%i in %s\n", txin.prevout.hash.ToString(), txin.prevout.n, hashTx.ToString());
-								
-								pindexFork = pindex->pprev;
-							}
-						}
-					}
+					cond.wait(lock);
 				}
 			}
+			
+			if (!result.fRead)
+			{
+				fStop = true;
+				
+				return error("LoadBlockIndex() : block.ReadFromDisk failed");
+			}
+			
+			// check level 1: verify block validity
+			// check level 7: verify block signature too
+			if (nCheckLevel>0 && !result.block.CheckBlock(true, true, (nCheckLevel>6)))
+			{
+				LogPrintf("LoadBlockIndex() : *** found bad block at %d, hash=%s\n", pindex->nHeight, pindex->GetBlockHash().ToString());
+				pindexFork = pindex->pprev;
+			}
+			
+			// check levels 2 to 6, found by the pool
+			for (const std::string& strMessage : result.vMessages)
+			{
+				LogPrintf("%s", strMessage);
+			}
+			
+			if (result.fBad)
+			{
+				pindexFork = pindex->pprev;
+			}
+			
+			vResult[i].reset();
+			
+			int nPercent = (i + 1) * 100 / vCheck.size();
+			
+			if (nPercent != nProgress)
+			{
+				nProgress = nPercent;
+				uiInterface.ShowProgress(ui_translate("Verifying blocks..."), std::min(nPercent, 99));
+			}
 		}
 	}
+	catch (...)
+	{
+		fStop = true;
+		
+		throw;
+	}
+	
+	if (nProgress >= 0)
+	{
+		uiInterface.ShowProgress("", 100);
+	}
 	
 	if (pindexFork)
 	{
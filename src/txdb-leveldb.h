@@ -1,6 +1,7 @@
 #ifndef TXDB_LEVELDB_H
 #define TXDB_LEVELDB_H
 
+#include <map>
 #include <string>
 #include <vector>
 #include <leveldb/options.h>
@@ -76,6 +77,9 @@ public:
     bool ReadAddrIndex(uint160 addrHash, std::vector<uint256>& txHashes);
     bool WriteAddrIndex(uint160 addrHash, uint256 txHash);
     bool ReadTxIndex(uint256 hash, CTxIndex& txindex);
+    // Reads the entries of vHash found in the index in key order, missing
+    // ones are left out of mapTxIndex
+    bool ReadTxIndexes(const std::vector<uint256>& vHash, std::map<uint256, CTxIndex>& mapTxIndex);
     bool UpdateTxIndex(uint256 hash, const CTxIndex& txindex);
     bool AddTxIndex(const CTransaction& tx, const CDiskTxPos& pos, int nHeight);
     bool EraseTxIndex(const CTransaction& tx);
@@ -89,6 +93,9 @@ public:
     bool WriteHashBestChain(uint256 hashBestChain);
     bool ReadBestInvalidTrust(CBigNum& bnBestInvalidTrust);
     bool WriteBestInvalidTrust(CBigNum bnBestInvalidTrust);
+    bool ReadBlockIndexSnapshotId(uint64_t& nId);
+    bool WriteBlockIndexSnapshotId(uint64_t nId);
+    bool EraseBlockIndexSnapshotId();
     bool LoadBlockIndex();
 private:
     bool LoadBlockIndexGuts();
@@ -3,8 +3,8 @@
 
 #include <vector>
 
-#include "allocators/zero_after_free_allocator.h"
+#include "allocators/stream_allocator.h"
 
-typedef std::vector<char, zero_after_free_allocator<char> > CSerializeData;
+typedef std::vector<char, stream_allocator<char> > CSerializeData;
 
 #endif // CSERIALIZEDATA_H
\ No newline at end of file
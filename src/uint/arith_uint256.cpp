@@ -0,0 +1,281 @@
+#include "uint/arith_uint256.h"
+
+arith_uint256::arith_uint256()
+{
+	for (int i = 0; i < WIDTH; i++)
+		pn[i] = 0;
+}
+
+arith_uint256::arith_uint256(const uint_base256& b)
+{
+	for (int i = 0; i < WIDTH; i++)
+		pn[i] = b.pn[i];
+}
+
+arith_uint256::arith_uint256(uint64_t b)
+{
+	pn[0] = (unsigned int)b;
+	pn[1] = (unsigned int)(b >> 32);
+	for (int i = 2; i < WIDTH; i++)
+		pn[i] = 0;
+}
+
+arith_uint256::arith_uint256(const std::string& str)
+{
+	SetHex(str);
+}
+
+arith_uint256& arith_uint256::operator=(const uint_base256& b)
+{
+	for (int i = 0; i < WIDTH; i++)
+		pn[i] = b.pn[i];
+	return *this;
+}
+
+arith_uint256& arith_uint256::operator=(uint64_t b)
+{
+	pn[0] = (unsigned int)b;
+	pn[1] = (unsigned int)(b >> 32);
+	for (int i = 2; i < WIDTH; i++)
+		pn[i] = 0;
+	return *this;
+}
+
+const arith_uint256 arith_uint256::operator~() const
+{
+	arith_uint256 ret;
+	for (int i = 0; i < WIDTH; i++)
+		ret.pn[i] = ~pn[i];
+	return ret;
+}
+
+arith_uint256& arith_uint256::operator*=(uint32_t b32)
+{
+	uint64_t carry = 0;
+	for (int i = 0; i < WIDTH; i++)
+	{
+		uint64_t n = carry + (uint64_t)b32 * pn[i];
+		pn[i] = n & 0xffffffff;
+		carry = n >> 32;
+	}
+	return *this;
+}
+
+arith_uint256& arith_uint256::operator*=(const arith_uint256& b)
+{
+	arith_uint256 a;
+	for (int j = 0; j < WIDTH; j++)
+	{
+		uint64_t carry = 0;
+		for (int i = 0; i + j < WIDTH; i++)
+		{
+			uint64_t n = carry + a.pn[i + j] + (uint64_t)pn[j] * b.pn[i];
+			a.pn[i + j] = n & 0xffffffff;
+			carry = n >> 32;
+		}
+	}
+	*this = a;
+	return *this;
+}
+
+// Long division by 32-bit words, Knuth's algorithm D (TAOCP vol. 2, 4.3.1)
+arith_uint256& arith_uint256::operator/=(const arith_uint256& b)
+{
+	int n = WIDTH;
+	while (n > 0 && b.pn[n - 1] == 0)
+		n--;
+	if (n == 0)
+		throw arith_uint256_error("arith_uint256 : division by zero");
+	int m = WIDTH;
+	while (m > 0 && pn[m - 1] == 0)
+		m--;
+	if (m < n)
+		return *this = 0;
+
+	unsigned int q[WIDTH] = {0};
+
+	if (n == 1)
+	{
+		uint64_t rem = 0;
+		for (int j = m - 1; j >= 0; j--)
+		{
+			uint64_t cur = (rem << 32) | pn[j];
+			q[j] = (unsigned int)(cur / b.pn[0]);
+			rem = cur % b.pn[0];
+		}
+	}
+	else
+	{
+		// Normalize so the top word of the divisor has its high bit set
+		int s = 0;
+		while (!(b.pn[n - 1] & (0x80000000U >> s)))
+			s++;
+		unsigned int vn[WIDTH];
+		unsigned int un[WIDTH + 1];
+		for (int i = n - 1; i > 0; i--)
+			vn[i] = (b.pn[i] << s) | (s ? b.pn[i - 1] >> (32 - s) : 0);
+		vn[0] = b.pn[0] << s;
+		un[m] = s ? pn[m - 1] >> (32 - s) : 0;
+		for (int i = m - 1; i > 0; i--)
+			un[i] = (pn[i] << s) | (s ? pn[i - 1] >> (32 - s) : 0);
+		un[0] = pn[0] << s;
+
+		for (int j = m - n; j >= 0; j--)
+		{
+			// Estimate the quotient word, at most one too large after this
+			uint64_t num = ((uint64_t)un[j + n] << 32) | un[j + n - 1];
+			uint64_t qhat = num / vn[n - 1];
+			uint64_t rhat = num % vn[n - 1];
+			while (qhat > 0xffffffffULL || qhat * vn[n - 2] > ((rhat << 32) | un[j + n - 2]))
+			{
+				qhat--;
+				rhat += vn[n - 1];
+				if (rhat > 0xffffffffULL)
+					break;
+			}
+
+			// Subtract qhat times the divisor
+			int64_t borrow = 0;
+			int64_t t;
+			for (int i = 0; i < n; i++)
+			{
+				uint64_t p = qhat * vn[i];
+				t = (int64_t)un[i + j] - borrow - (int64_t)(p & 0xffffffffULL);
+				un[i + j] = (unsigned int)t;
+				borrow = (int64_t)(p >> 32) - (t >> 32);
+			}
+			t = (int64_t)un[j + n] - borrow;
+			un[j + n] = (unsigned int)t;
+
+			// Went negative, add one divisor back
+			if (t < 0)
+			{
+				qhat--;
+				uint64_t carry = 0;
+				for (int i = 0; i < n; i++)
+				{
+					uint64_t sum = (uint64_t)un[i + j] + vn[i] + carry;
+					un[i + j] = (unsigned int)sum;
+					carry = sum >> 32;
+				}
+				un[j + n] += (unsigned int)carry;
+			}
+			q[j] = (unsigned int)qhat;
+		}
+	}
+
+	for (int i = 0; i < WIDTH; i++)
+		pn[i] = q[i];
+	return *this;
+}
+
+unsigned int arith_uint256::bits() const
+{
+	for (int pos = WIDTH - 1; pos >= 0; pos--)
+	{
+		if (pn[pos])
+		{
+			for (int nbits = 31; nbits > 0; nbits--)
+			{
+				if (pn[pos] & (1U << nbits))
+					return 32 * pos + nbits + 1;
+			}
+			return 32 * pos + 1;
+		}
+	}
+	return 0;
+}
+
+// The compact format is the size in bytes and the top three bytes of the
+// OpenSSL MPI encoding, whose first byte carries the sign. This is the
+// encoding CBigNum::SetCompact and CBigNum::GetCompact go through.
+arith_uint256& arith_uint256::SetCompact(uint32_t nCompact, bool* pfNegative, bool* pfOverflow)
+{
+	int nSize = nCompact >> 24;
+	uint32_t nWord = nCompact & 0x007fffff;
+	if (nSize <= 3)
+	{
+		nWord >>= 8 * (3 - nSize);
+		*this = nWord;
+	}
+	else
+	{
+		*this = nWord;
+		*this <<= 8 * (nSize - 3);
+	}
+	if (pfNegative)
+		*pfNegative = nWord != 0 && (nCompact & 0x00800000) != 0;
+	if (pfOverflow)
+		*pfOverflow = nWord != 0 && ((nSize > 34) ||
+				(nWord > 0xff && nSize > 33) ||
+				(nWord > 0xffff && nSize > 32));
+	return *this;
+}
+
+uint32_t arith_uint256::GetCompact(bool fNegative) const
+{
+	int nSize = (bits() + 7) / 8;
+	uint32_t nCompact = 0;
+	if (nSize <= 3)
+	{
+		nCompact = Get64() << 8 * (3 - nSize);
+	}
+	else
+	{
+		arith_uint256 bn = *this >> 8 * (nSize - 3);
+		nCompact = bn.Get64();
+	}
+	// The 0x00800000 bit denotes the sign, so if it is already set, divide
+	// the mantissa by 256 and increase the exponent.
+	if (nCompact & 0x00800000)
+	{
+		nCompact >>= 8;
+		nSize++;
+	}
+	nCompact |= nSize << 24;
+	nCompact |= (fNegative && (nCompact & 0x007fffff) ? 0x00800000 : 0);
+	return nCompact;
+}
+
+bool arith_uint256::MulChecked(uint64_t b)
+{
+	if (b != 0 && *this > ~arith_uint256(0) / arith_uint256(b))
+		return false;
+	*this *= arith_uint256(b);
+	return true;
+}
+
+const arith_uint256 operator<<(const arith_uint256& a, unsigned int shift)
+{
+	return arith_uint256(a) <<= shift;
+}
+
+const arith_uint256 operator>>(const arith_uint256& a, unsigned int shift)
+{
+	return arith_uint256(a) >>= shift;
+}
+
+const arith_uint256 operator+(const arith_uint256& a, const arith_uint256& b)
+{
+	return arith_uint256(a) += b;
+}
+
+const arith_uint256 operator-(const arith_uint256& a, const arith_uint256& b)
+{
+	return arith_uint256(a) -= b;
+}
+
+const arith_uint256 operator*(const arith_uint256& a, const arith_uint256& b)
+{
+	return arith_uint256(a) *= b;
+}
+
+const arith_uint256 operator*(const arith_uint256& a, uint32_t b)
+{
+	return arith_uint256(a) *= b;
+}
+
+const arith_uint256 operator/(const arith_uint256& a, const arith_uint256& b)
+{
+	return arith_uint256(a) /= b;
+}
@@ -0,0 +1,59 @@
+#ifndef ARITH_UINT256_H
+#define ARITH_UINT256_H
+
+#include <stdexcept>
+#include <string>
+
+#include "uint/uint_base.h"
+
+/** Errors thrown by arith_uint256 */
+class arith_uint256_error : public std::runtime_error
+{
+public:
+	explicit arith_uint256_error(const std::string& str) : std::runtime_error(str)
+	{
+		
+	}
+};
+
+/** 256-bit unsigned integer with the multiplication, division and compact
+ * encoding needed for targets and chain trust. Gives the same results as
+ * CBigNum for values that fit in 256 bits, without heap allocations.
+ */
+class arith_uint256 : public uint_base256
+{
+public:
+	arith_uint256();
+	arith_uint256(const uint_base256& b);
+	arith_uint256(uint64_t b);
+	explicit arith_uint256(const std::string& str);
+
+	arith_uint256& operator=(const uint_base256& b);
+	arith_uint256& operator=(uint64_t b);
+	const arith_uint256 operator~() const;
+	arith_uint256& operator*=(uint32_t b32);
+	arith_uint256& operator*=(const arith_uint256& b);
+	arith_uint256& operator/=(const arith_uint256& b);
+
+	/** Number of bits up to and including the highest set one, 0 for zero */
+	unsigned int bits() const;
+
+	/** Decode the nBits compact format. pfNegative is set for a nonzero value
+	 * with the sign bit, pfOverflow for one that does not fit in 256 bits.
+	 */
+	arith_uint256& SetCompact(uint32_t nCompact, bool* pfNegative = NULL, bool* pfOverflow = NULL);
+	uint32_t GetCompact(bool fNegative = false) const;
+
+	/** Multiply by b, false and *this unchanged if the product needs more than 256 bits */
+	bool MulChecked(uint64_t b);
+};
+
+const arith_uint256 operator<<(const arith_uint256& a, unsigned int shift);
+const arith_uint256 operator>>(const arith_uint256& a, unsigned int shift);
+const arith_uint256 operator+(const arith_uint256& a, const arith_uint256& b);
+const arith_uint256 operator-(const arith_uint256& a, const arith_uint256& b);
+const arith_uint256 operator*(const arith_uint256& a, const arith_uint256& b);
+const arith_uint256 operator*(const arith_uint256& a, uint32_t b);
+const arith_uint256 operator/(const arith_uint256& a, const arith_uint256& b);
+
+#endif // ARITH_UINT256_H
@@ -80,6 +80,7 @@ public:
 	friend class uint160;
 	friend class uint256;
 	friend class uint512;
+	friend class arith_uint256;
 
 	friend bool operator<  <>(const uint_base<BITS>& a, const uint_base<BITS>& b);
 	friend bool operator<= <>(const uint_base<BITS>& a, const uint_base<BITS>& b);
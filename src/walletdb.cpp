@@ -1,5 +1,6 @@
 #include "compat.h"
 
+#include <deque>
 #include <boost/filesystem.hpp>
 #include <boost/thread.hpp>
 
@@ -30,7 +31,8 @@
 #include "cscriptid.h"
 #include "cstealthaddress.h"
 #include "thread.h"
-#include "cdatastream.h"
+#include "csecuredatastream.h"
+#include "thread/cthreadpool.h"
 
 #include "walletdb.h"
 
@@ -277,14 +279,14 @@ void CWalletDB::ListAccountCreditDebit(const std::string& strAccount, std::list<
     while (true)
     {
         // Read next record
-        CDataStream ssKey(SER_DISK, CLIENT_VERSION);
+        CSecureDataStream ssKey(SER_DISK, CLIENT_VERSION);
 		
         if (fFlags == DB_SET_RANGE)
         {
 			ssKey << boost::make_tuple(std::string("acentry"), (fAllAccounts? std::string("") : strAccount), uint64_t(0));
 		}
 	
-        CDataStream ssValue(SER_DISK, CLIENT_VERSION);
+        CSecureDataStream ssValue(SER_DISK, CLIENT_VERSION);
         int ret = ReadAtCursor(pcursor, ssKey, ssValue, fFlags);
         fFlags = DB_NEXT;
 		
@@ -423,6 +425,139 @@ DBErrors CWalletDB::ReorderTransactions(CWallet* pwallet)
     return DB_LOAD_OK;
 }
 
+/** Reads a "tx" record after its type, fUpgraded is set if the record was
+ * written by 0.3.16 to 0.3.17 and has to be written again.
+ */
+static bool ReadTxRecord(CDataStream& ssKey, CDataStream& ssValue, uint256& hash, CWalletTx& wtx, bool& fUpgraded,
+		std::string& strErr)
+{
+    fUpgraded = false;
+	
+    ssKey >> hash;
+    ssValue >> wtx;
+    
+    if (!(wtx.CheckTransaction() && (wtx.GetHash() == hash)))
+	{
+        return false;
+	}
+	
+    // Undo serialize changes in 31600
+    if (31404 <= wtx.fTimeReceivedIsTxTime && wtx.fTimeReceivedIsTxTime <= 31703)
+    {
+        if (!ssValue.empty())
+        {
+            char fTmp;
+            char fUnused;
+            
+			ssValue >> fTmp >> fUnused >> wtx.strFromAccount;
+            
+			strErr = strprintf("LoadWallet() upgrading tx ver=%d %d '%s' %s",
+                               wtx.fTimeReceivedIsTxTime, fTmp, wtx.strFromAccount, hash.ToString());
+            
+			wtx.fTimeReceivedIsTxTime = fTmp;
+        }
+        else
+        {
+            strErr = strprintf("LoadWallet() repairing tx ver=%d %s", wtx.fTimeReceivedIsTxTime, hash.ToString());
+            
+			wtx.fTimeReceivedIsTxTime = 0;
+        }
+		
+        fUpgraded = true;
+    }
+	
+    return true;
+}
+
+static void LoadTxRecord(CWallet* pwallet, const uint256& hash, CWalletTx& wtx, bool fUpgraded, CWalletScanState &wss)
+{
+    if (fUpgraded)
+	{
+        wss.vWalletUpgrade.push_back(hash);
+	}
+	
+    if (wtx.nOrderPos == -1)
+	{
+        wss.fAnyUnordered = true;
+	}
+	
+    pwallet->LoadToWallet(hash, wtx);
+}
+
+/** Reads a "key" or "wkey" record after its type and checks the private key
+ * against the public key.
+ */
+static bool ReadKeyRecord(const std::string& strType, CDataStream& ssKey, CDataStream& ssValue, CPubKey& vchPubKey,
+		CKey& key, std::string& strErr)
+{
+    ssKey >> vchPubKey;
+    
+    if (!vchPubKey.IsValid())
+    {
+        strErr = "Error reading wallet database: CPubKey corrupt";
+        
+		return false;
+    }
+	
+    CPrivKey pkey;
+    uint256 hash = 0;
+
+    if (strType == "key")
+    {
+		ssValue >> pkey;
+    } else {
+        CWalletKey wkey;
+        
+		ssValue >> wkey;
+        
+		pkey = wkey.vchPrivKey;
+    }
+
+    // Old wallets store keys as "key" [pubkey] => [privkey]
+    // ... which was slow for wallets with lots of keys, because the public key is re-derived from the private key
+    // using EC operations as a checksum.
+    // Newer wallets store keys as "key"[pubkey] => [privkey][hash(pubkey,privkey)], which is much faster while
+    // remaining backwards-compatible.
+    try
+    {
+        ssValue >> hash;
+    }
+    catch(...)
+	{
+		
+	}
+
+    bool fSkipCheck = false;
+
+    if (hash != 0)
+    {
+        // hash pubkey/privkey to accelerate wallet load
+        std::vector<unsigned char> vchKey;
+        
+		vchKey.reserve(vchPubKey.size() + pkey.size());
+        vchKey.insert(vchKey.end(), vchPubKey.begin(), vchPubKey.end());
+        vchKey.insert(vchKey.end(), pkey.begin(), pkey.end());
+
+        if (Hash(vchKey.begin(), vchKey.end()) != hash)
+        {
+            strErr = "Error reading wallet database: CPubKey/CPrivKey corrupt";
+            
+			return false;
+        }
+
+        fSkipCheck = true;
+    }
+
+    if (!key.Load(pkey, vchPubKey, fSkipCheck))
+    {
+        strErr = "Error reading wallet database: CPrivKey corrupt";
+        
+		return false;
+    }
+	
+    return true;
+}
+
 bool ReadKeyValue(CWallet* pwallet, CDataStream& ssKey, CDataStream& ssValue, CWalletScanState &wss,
 		std::string& strType, std::string& strErr)
 {
@@ -443,57 +578,15 @@ bool ReadKeyValue(CWallet* pwallet, CDataStream& ssKey, CDataStream& ssValue, CW
         else if (strType == "tx")
         {
             uint256 hash;
+            CWalletTx wtx;
+            bool fUpgraded;
 			
-			ssKey >> hash;
-			
-            CWalletTx& wtx = pwallet->mapWallet[hash];
-			
-			ssValue >> wtx;
-            
-			if (!(wtx.CheckTransaction() && (wtx.GetHash() == hash)))
+            if (!ReadTxRecord(ssKey, ssValue, hash, wtx, fUpgraded, strErr))
 			{
                 return false;
 			}
 			
-            // Undo serialize changes in 31600
-            if (31404 <= wtx.fTimeReceivedIsTxTime && wtx.fTimeReceivedIsTxTime <= 31703)
-            {
-                if (!ssValue.empty())
-                {
-                    char fTmp;
-                    char fUnused;
-                    
-					ssValue >> fTmp >> fUnused >> wtx.strFromAccount;
-                    
-					strErr = strprintf("LoadWallet() upgrading tx ver=%d %d '%s' %s",
-                                       wtx.fTimeReceivedIsTxTime, fTmp, wtx.strFromAccount, hash.ToString());
-                    
-					wtx.fTimeReceivedIsTxTime = fTmp;
-                }
-                else
-                {
-                    strErr = strprintf("LoadWallet() repairing tx ver=%d %s", wtx.fTimeReceivedIsTxTime, hash.ToString());
-                    
-					wtx.fTimeReceivedIsTxTime = 0;
-                }
-				
-                wss.vWalletUpgrade.push_back(hash);
-            }
-
-            if (wtx.nOrderPos == -1)
-			{
-                wss.fAnyUnordered = true;
-			}
-
-            pwallet->AddToWallet(wtx, true);
-
-            //// debug print
-            //LogPrintf("LoadWallet  %s\n", wtx.GetHash().ToString());
-            //LogPrintf(" %12d  %s  %s  %s\n",
-            //    wtx.vout[0].nValue,
-            //    DateTimeStrFormat("%x %H:%M:%S", wtx.GetBlockTime()),
-            //    wtx.hashBlock.ToString(),
-            //    wtx.mapValue["message"]);
+            LoadTxRecord(pwallet, hash, wtx, fUpgraded, wss);
         } 
         else if (strType == "sxAddr")
         {
@@ -553,74 +646,17 @@ bool ReadKeyValue(CWallet* pwallet, CDataStream& ssKey, CDataStream& ssValue, CW
         else if (strType == "key" || strType == "wkey")
         {
             CPubKey vchPubKey;
-            
-			ssKey >> vchPubKey;
-            
-			if (!vchPubKey.IsValid())
-            {
-                strErr = "Error reading wallet database: CPubKey corrupt";
-                
-				return false;
-            }
-			
             CKey key;
-            CPrivKey pkey;
-            uint256 hash = 0;
-
+			
             if (strType == "key")
-            {
+			{
                 wss.nKeys++;
-                
-				ssValue >> pkey;
-            } else {
-                CWalletKey wkey;
-                
-				ssValue >> wkey;
-                
-				pkey = wkey.vchPrivKey;
-            }
-
-            // Old wallets store keys as "key" [pubkey] => [privkey]
-            // ... which was slow for wallets with lots of keys, because the public key is re-derived from the private key
-            // using EC operations as a checksum.
-            // Newer wallets store keys as "key"[pubkey] => [privkey][hash(pubkey,privkey)], which is much faster while
-            // remaining backwards-compatible.
-            try
-            {
-                ssValue >> hash;
-            }
-            catch(...)
+			}
+			
+            if (!ReadKeyRecord(strType, ssKey, ssValue, vchPubKey, key, strErr))
 			{
-				
+                return false;
 			}
-
-            bool fSkipCheck = false;
-
-            if (hash != 0)
-            {
-                // hash pubkey/privkey to accelerate wallet load
-                std::vector<unsigned char> vchKey;
-                
-				vchKey.reserve(vchPubKey.size() + pkey.size());
-                vchKey.insert(vchKey.end(), vchPubKey.begin(), vchPubKey.end());
-                vchKey.insert(vchKey.end(), pkey.begin(), pkey.end());
-
-                if (Hash(vchKey.begin(), vchKey.end()) != hash)
-                {
-                    strErr = "Error reading wallet database: CPubKey/CPrivKey corrupt";
-                    
-					return false;
-                }
-
-                fSkipCheck = true;
-            }
-
-            if (!key.Load(pkey, vchPubKey, fSkipCheck))
-            {
-                strErr = "Error reading wallet database: CPrivKey corrupt";
-                
-				return false;
-            }
 			
             if (!pwallet->LoadKey(key, vchPubKey))
             {
@@ -764,6 +800,36 @@ bool ReadKeyValue(CWallet* pwallet, CDataStream& ssKey, CDataStream& ssValue, CW
     return true;
 }
 
+// Transaction and key records read before they are parsed on the pool
+static const size_t WALLET_LOAD_BATCH_RECORDS = 10000;
+
+// Or fewer when they add up to this many bytes
+static const size_t WALLET_LOAD_BATCH_BYTES = 64 * 1024 * 1024;
+
+/** A "tx", "key" or "wkey" record, read from the database on the loading
+ * thread and parsed on the pool.
+ */
+struct CWalletLoadRecord
+{
+	std::string strType;
+	CSecureDataStream ssKey;
+	CSecureDataStream ssValue;
+	bool fOk;
+	std::string strErr;
+	
+	uint256 hash;
+	CWalletTx wtx;
+	bool fUpgraded;
+	
+	CPubKey vchPubKey;
+	CKey key;
+	
+	CWalletLoadRecord() : ssKey(SER_DISK, CLIENT_VERSION), ssValue(SER_DISK, CLIENT_VERSION), fOk(false), fUpgraded(false)
+	{
+		
+	}
+};
+
 static bool IsKeyType(const std::string &strType)
 {
     return (strType == "key" ||
@@ -772,6 +838,100 @@ static bool IsKeyType(const std::string &strType)
 			strType == "ckey");
 }
 
+/** The records whose parsing is worth spreading over threads: transactions
+ * are large, and keys written without the pubkey/privkey hash need an EC
+ * multiplication to check.
+ */
+static bool IsParallelType(const CDataStream& ssKey)
+{
+	return (ssKey.size() >= 3 && memcmp(&ssKey[0], "\x02tx", 3) == 0) ||
+			(ssKey.size() >= 4 && memcmp(&ssKey[0], "\x03key", 4) == 0) ||
+			(ssKey.size() >= 5 && memcmp(&ssKey[0], "\x04wkey", 5) == 0);
+}
+
+static void ParseLoadRecord(CWalletLoadRecord& rec)
+{
+	try
+	{
+		rec.ssKey >> rec.strType;
+		
+		if (rec.strType == "tx")
+		{
+			rec.fOk = ReadTxRecord(rec.ssKey, rec.ssValue, rec.hash, rec.wtx, rec.fUpgraded, rec.strErr);
+		}
+		else
+		{
+			rec.fOk = ReadKeyRecord(rec.strType, rec.ssKey, rec.ssValue, rec.vchPubKey, rec.key, rec.strErr);
+		}
+	}
+	catch (...)
+	{
+		rec.fOk = false;
+	}
+	
+	// the streams are not needed any more, free them while the batch is parsed
+	rec.ssKey = CSecureDataStream(SER_DISK, CLIENT_VERSION);
+	rec.ssValue = CSecureDataStream(SER_DISK, CLIENT_VERSION);
+}
+
+/** Parses the queued records on the pool, then adds them to the wallet in
+ * the order they were read. Returns false if a key was lost.
+ */
+static bool FlushLoadRecords(CWallet* pwallet, CThreadPool& pool, std::deque<CWalletLoadRecord>& vRecords,
+		CWalletScanState &wss, bool& fNoncriticalErrors)
+{
+	bool fKeysOk = true;
+	
+	pool.ParallelFor(vRecords.size(), [&vRecords](size_t i) {
+		ParseLoadRecord(vRecords[i]);
+	});
+	
+	for (CWalletLoadRecord& rec : vRecords)
+	{
+		if (rec.strType == "key")
+		{
+			wss.nKeys++;
+		}
+		
+		if (rec.fOk)
+		{
+			if (rec.strType == "tx")
+			{
+				LoadTxRecord(pwallet, rec.hash, rec.wtx, rec.fUpgraded, wss);
+			}
+			else if (!pwallet->LoadKey(rec.key, rec.vchPubKey))
+			{
+				rec.strErr = "Error reading wallet database: LoadKey failed";
+				rec.fOk = false;
+			}
+		}
+		
+		if (!rec.fOk)
+		{
+			if (IsKeyType(rec.strType))
+			{
+				fKeysOk = false;
+			}
+			else
+			{
+				fNoncriticalErrors = true;
+				
+				// Rescan if there is a bad transaction record:
+				SoftSetBoolArg("-rescan", true);
+			}
+		}
+		
+		if (!rec.strErr.empty())
+		{
+			LogPrintf("%s\n", rec.strErr);
+		}
+	}
+	
+	vRecords.clear();
+	
+	return fKeysOk;
+}
+
 DBErrors CWalletDB::LoadWallet(CWallet* pwallet)
 {
     CWalletScanState wss;
@@ -806,11 +966,15 @@ DBErrors CWalletDB::LoadWallet(CWallet* pwallet)
             return DB_CORRUPT;
         }
 
+        CThreadPool pool("walletload", CThreadPool::DefaultThreads());
+        std::deque<CWalletLoadRecord> vRecords;
+        size_t nRecordBytes = 0;
+		
         while (true)
         {
             // Read next record
-            CDataStream ssKey(SER_DISK, CLIENT_VERSION);
-            CDataStream ssValue(SER_DISK, CLIENT_VERSION);
+            CSecureDataStream ssKey(SER_DISK, CLIENT_VERSION);
+            CSecureDataStream ssValue(SER_DISK, CLIENT_VERSION);
             int ret = ReadAtCursor(pcursor, ssKey, ssValue);
 			
             if (ret == DB_NOTFOUND)
@@ -823,6 +987,41 @@ DBErrors CWalletDB::LoadWallet(CWallet* pwallet)
                 
 				return DB_CORRUPT;
             }
+			
+            // Transactions and keys are parsed on the pool, in batches
+            if (IsParallelType(ssKey))
+            {
+                nRecordBytes += ssKey.size() + ssValue.size();
+				
+                vRecords.push_back(CWalletLoadRecord());
+                vRecords.back().ssKey = std::move(ssKey);
+                vRecords.back().ssValue = std::move(ssValue);
+				
+                if (vRecords.size() >= WALLET_LOAD_BATCH_RECORDS || nRecordBytes >= WALLET_LOAD_BATCH_BYTES)
+                {
+                    if (!FlushLoadRecords(pwallet, pool, vRecords, wss, fNoncriticalErrors))
+                    {
+                        result = DB_CORRUPT;
+                    }
+					
+                    nRecordBytes = 0;
+                }
+				
+                continue;
+            }
+			
+            // Records are sorted by type, so this only happens at the end of
+            // a run of transactions or keys, and keeps them in file order
+            // with the records around them
+            if (!vRecords.empty())
+            {
+                if (!FlushLoadRecords(pwallet, pool, vRecords, wss, fNoncriticalErrors))
+                {
+                    result = DB_CORRUPT;
+                }
+				
+                nRecordBytes = 0;
+            }
 
             // Try to be tolerant of single corrupt records:
             std::string strType, strErr;
@@ -855,6 +1054,11 @@ DBErrors CWalletDB::LoadWallet(CWallet* pwallet)
         }
 		
         pcursor->close();
+		
+        if (!FlushLoadRecords(pwallet, pool, vRecords, wss, fNoncriticalErrors))
+        {
+            result = DB_CORRUPT;
+        }
     }
     catch (boost::thread_interrupted)
 	{
@@ -951,6 +1155,11 @@ void ThreadFlushWalletDB(const std::string& strFile)
         {
             nLastSeen = nWalletDBUpdated;
             nLastWalletUpdate = GetTime();
+
+            // Group commit: transactions commit without syncing the log,
+            // whatever committed since the last tick reaches the disk with
+            // one sync here
+            bitdb.dbenv.log_flush(NULL);
         }
 
         if (nLastFlushed != nWalletDBUpdated && GetTime() - nLastWalletUpdate >= 2)
@@ -1113,8 +1322,8 @@ bool CWalletDB::Recover(CDBEnv& dbenv, std::string filename, bool fOnlyKeys)
     {
         if (fOnlyKeys)
         {
-            CDataStream ssKey(row.first, SER_DISK, CLIENT_VERSION);
-            CDataStream ssValue(row.second, SER_DISK, CLIENT_VERSION);
+            CSecureDataStream ssKey(row.first, SER_DISK, CLIENT_VERSION);
+            CSecureDataStream ssValue(row.second, SER_DISK, CLIENT_VERSION);
             std::string strType, strErr;
             bool fReadOK = ReadKeyValue(&dummyWallet, ssKey, ssValue,
                                         wss, strType, strErr);